@@ -49,6 +49,12 @@ public:
     return m_u0 * std::asinh(val);
   }
 
+  /// Returns the derivative of the residual with respect to the model value
+  double derivative(double real, double model, double weight) const {
+    float val =  weight * (real - model) / m_u0;
+    return -weight / std::sqrt(1. + val * val);
+  }
+
 private:
 
   double m_u0;
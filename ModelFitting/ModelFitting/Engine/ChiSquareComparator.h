@@ -47,6 +47,11 @@ public:
   double operator()(double real, double model, double weight) const {
     return weight * (real - model);
   }
+
+  /// Returns the derivative of the residual with respect to the model value
+  double derivative(double /*real*/, double /*model*/, double weight) const {
+    return -weight;
+  }
   
 }; // end of class ChiSquareComparator
 
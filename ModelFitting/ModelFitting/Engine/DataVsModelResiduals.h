@@ -24,9 +24,11 @@
 #define	MODELFITTING_DATAVSMODELRESIDUALS_H
 
 #include <memory>
+#include <type_traits>
 #include "ElementsKernel/Exception.h"
 #include "ModelFitting/Engine/ResidualBlockProvider.h"
 #include "ModelFitting/Engine/DataVsModelInputTraits.h"
+#include "ModelFitting/Image/ImageTraits.h"
 
 namespace ModelFitting {
 
@@ -65,6 +67,10 @@ namespace ModelFitting {
  * of the DataVsModelInputTraits (see the DataVsModelInputTraits documentation
  * for more details).
  * 
+ * If the ModelType can compute its derivatives as an image (like the FrameModel
+ * does) and the Comparator provides a derivative(d, m, w) method, the residual
+ * derivatives are computed analytically. Otherwise they are left to the engine.
+ *
  * @tparam DataType
  *    The type used for accessing the data point values
  * @tparam ModelType
@@ -115,6 +121,14 @@ public:
   
   /// Updates the values where the iterator points with the residuals
   void populateResidualBlock(IterType output_iter) override;
+
+  /// Returns the parameters of the model, if it provides derivatives, or an
+  /// empty list otherwise
+  std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() override;
+
+  /// Populates the derivatives of the residuals, using the chain rule on the
+  /// comparator and the model derivatives
+  void populateJacobianBlock(IterType output_iter, const std::vector<bool>& active) override;
   
 private:
   
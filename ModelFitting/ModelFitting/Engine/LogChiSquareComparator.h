@@ -62,6 +62,12 @@ public:
     return val>0. ? m_u0 * std::log1p(val) : -1. * m_u0 * std::log1p(-val);
   }
 
+  /// Returns the derivative of the residual with respect to the model value
+  double derivative(double real, double model, double weight) const {
+    double val =  weight * (real - model) / m_u0;
+    return -weight / (1. + std::abs(val));
+  }
+
 private:
 
   double m_u0;
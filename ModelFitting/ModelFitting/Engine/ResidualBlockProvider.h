@@ -23,6 +23,10 @@
 #ifndef MODELFITTING_RESIDUALBLOCKPROVIDER_H
 #define	MODELFITTING_RESIDUALBLOCKPROVIDER_H
 
+#include <memory>
+#include <vector>
+#include "ModelFitting/Parameters/BasicParameter.h"
+
 namespace ModelFitting {
 
 /**
@@ -69,6 +73,37 @@ public:
    *    The iterator to use for returning the residual values
    */
   virtual void populateResidualBlock(IterType output_iter) = 0;
+
+  /**
+   * @brief Returns the parameters the residuals can be differentiated against
+   *
+   * @details
+   * Providers which can compute their derivatives analytically return here
+   * the (world) parameters their residuals depend on, and implement the
+   * populateJacobianBlock() method. The default, an empty list, means that
+   * the derivatives are not available, and they will be approximated by
+   * finite differences.
+   */
+  virtual std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() {
+    return {};
+  }
+
+  /**
+   * @brief Provides the derivatives of the residuals
+   *
+   * @details
+   * The derivatives are stored column by column: the derivative of the
+   * residual i with respect to the getDerivativeParameters() element k goes
+   * to output_iter[k * numberOfResiduals() + i]. Only the columns flagged in
+   * the active vector need to be populated; the rest are ignored.
+   *
+   * @param output_iter
+   *    The iterator to use for returning the derivatives
+   * @param active
+   *    Which of the getDerivativeParameters() the derivatives are required for
+   */
+  virtual void populateJacobianBlock(IterType /*output_iter*/, const std::vector<bool>& /*active*/) {
+  }
   
   /// Destructor
   virtual ~ResidualBlockProvider() = default;
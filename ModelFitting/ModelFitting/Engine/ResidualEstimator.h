@@ -27,6 +27,8 @@
 #include <memory>
 #include <algorithm>
 #include "ModelFitting/Engine/ResidualBlockProvider.h"
+#include "ModelFitting/Engine/EngineParameterManager.h"
+#include "SEUtils/ParallelFor.h"
 
 namespace ModelFitting {
 
@@ -56,6 +58,11 @@ public:
   
   /// Registers a ResidualBlockProvider to the ResidualEstimator
   void registerBlockProvider(std::unique_ptr<ResidualBlockProvider> provider);
+
+  /// Sets the executor used to compute the residual blocks (typically one per frame) concurrently,
+  /// both for the residuals and the Jacobian. The block providers must then be safe to evaluate
+  /// concurrently, which is the case as long as they only read the shared parameters.
+  void setTaskExecutor(SourceXtractor::TaskExecutor executor);
   
   /// Returns the total number of residuals. It is equal with the sum of the
   /// sizes of all the registered block providers.
@@ -76,11 +83,31 @@ public:
   /// Specialization of the populateResiduals() method for vector of doubles,
   /// which avoids alocating intermediate memory for the residuals.
   void populateResiduals(std::vector<double>::iterator output_iter) const;
+
+  /// Returns true if any of the registered block providers can compute its
+  /// derivatives analytically, in which case the engines should use the
+  /// populateJacobian() method instead of finite differences.
+  bool providesJacobian() const;
+
+  /// Populates the Jacobian of the residuals with respect to the engine
+  /// parameters, in row major order (numberOfResiduals() rows and
+  /// manager.numberOfParameters() columns), for the given engine values.
+  ///
+  /// The block providers with analytic derivatives give them with respect to
+  /// world parameters. These are chained with the derivatives of the world
+  /// parameters with respect to the engine ones, which are obtained
+  /// numerically, but only require updating the parameter values. The
+  /// residuals of the rest of the providers are differentiated with forward
+  /// differences. When the method returns, the parameters are left with the
+  /// given engine values.
+  void populateJacobian(EngineParameterManager& manager, const double* engine_values, double* jacobian) const;
   
 private:
   
   std::size_t m_residual_no {0};
   std::vector<std::unique_ptr<ResidualBlockProvider>> m_block_provider_list {};
+  std::vector<std::size_t> m_block_offsets {};
+  SourceXtractor::TaskExecutor m_executor {};
   
 };
 
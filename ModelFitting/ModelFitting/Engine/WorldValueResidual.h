@@ -74,10 +74,17 @@ public:
   /// Updates the value where the iterator points with the value of the residual
   /// for the current value of the parameter
   void populateResidualBlock(IterType output_iter) override;
+
+  /// The residual depends only on the parameter
+  std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() override;
+
+  /// The derivative is the weight
+  void populateJacobianBlock(IterType output_iter, const std::vector<bool>& active) override;
   
 private:
   
   std::shared_ptr<BasicParameter> m_parameter;
+  double m_weight;
   std::size_t m_observer_id;
 
   double m_residual;
@@ -29,13 +29,27 @@ public:
   double getValue(double x, double y) const override;
   ImageType getRasterizedImage(double pixel_scale, std::size_t size_x, std::size_t size_y) const override;
 
+  /// i0, the profile parameters, flux, x scale, y scale and rotation
+  std::vector<std::shared_ptr<BasicParameter>> getShapeParameters() const override;
+
+  /// Flux, k, x scale, y scale and rotation. i0 is absent as the image is renormalized to the flux.
+  std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() const override;
+
+  ImageType getRasterizedDerivatives(double pixel_scale, std::size_t size_x, std::size_t size_y,
+                                     std::vector<ImageType>& derivatives) const override;
+
 private:
   using CompactModelBase<ImageType>::getMaxRadiusSqr;
   using CompactModelBase<ImageType>::getCombinedTransform;
+  using CompactModelBase<ImageType>::getTransformParameters;
   using CompactModelBase<ImageType>::m_jacobian;
+  using CompactModelBase<ImageType>::m_vectorized;
   using CompactModelBase<ImageType>::samplePixel;
   using CompactModelBase<ImageType>::adaptiveSamplePixel;
   using CompactModelBase<ImageType>::renormalize;
+  using CompactModelBase<ImageType>::rasterizeScalar;
+  using CompactModelBase<ImageType>::rasterizeBatched;
+  using CompactModelBase<ImageType>::makeSersicKernel;
 
   struct ExponentialModelEvaluator {
     Mat22 transform;
@@ -55,6 +69,29 @@ private:
     }
   };
 
+  /// Evaluates the same profile as ExponentialModelEvaluator, differentiated with respect to
+  /// k, x scale, y scale and rotation, in that order
+  struct ExponentialDerivativeEvaluator {
+    std::array<DualNumber<4>, 4> transform;
+    float i0;
+    DualNumber<4> k;
+    double max_r_sqr;
+
+    inline DualNumber<4> evaluateModel(float x, float y) const {
+      auto x2 = x * transform[0] + y * transform[1];
+      auto y2 = x * transform[2] + y * transform[3];
+      auto r_sqr = x2*x2 + y2*y2;
+      if (r_sqr.value < max_r_sqr) {
+        if (r_sqr.value <= 0.f) {
+          return DualNumber<4>(i0);
+        }
+        return i0 * exp(-k * sqrt(r_sqr));
+      } else {
+        return DualNumber<4>(0.f);
+      }
+    }
+  };
+
   float m_sharp_radius_squared;
 
   // Exponential parameters
@@ -10,6 +10,8 @@
 
 #include "ModelFitting/Parameters/BasicParameter.h"
 #include "ModelFitting/Models/PositionedModel.h"
+#include "ModelFitting/Models/DualNumber.h"
+#include "ModelFitting/Models/SersicKernel.h"
 
 #include "SEUtils/Mat22.h"
 
@@ -28,9 +30,28 @@ public:
 
   virtual ~CompactModelBase() = default;
 
+  /**
+   * Selects how the models that support it are rasterized: in batches, with a vectorized evaluation of
+   * the profile (the default), or pixel by pixel with the scalar evaluator
+   */
+  void setVectorized(bool vectorized) {
+    m_vectorized = vectorized;
+  }
+
 protected:
   Mat22 getCombinedTransform(double pixel_scale) const;
 
+  /// Same as getCombinedTransform(), differentiated with respect to the x scale, y scale and rotation,
+  /// which are seeded as the given variables of the dual numbers
+  template<std::size_t N>
+  std::array<DualNumber<N>, 4> getCombinedTransformDerivatives(double pixel_scale, std::size_t x_scale_index,
+      std::size_t y_scale_index, std::size_t rotation_index) const;
+
+  /// The x scale, y scale and rotation parameters, in that order
+  std::vector<std::shared_ptr<BasicParameter>> getTransformParameters() const {
+    return {m_x_scale, m_y_scale, m_rotation};
+  }
+
   template<typename ModelEvaluator>
   float samplePixel(const ModelEvaluator& model_eval, int x, int y, unsigned int subsampling) const;
 
@@ -38,7 +59,54 @@ protected:
   float sampleStochastic(const ModelEvaluator& model_eval, int x, int y, unsigned int samples=100) const;
 
   template<typename ModelEvaluator>
-  float adaptiveSamplePixel(const ModelEvaluator& model_eval, int x, int y, unsigned int max_subsampling, float threshold=1.1) const;
+  float adaptiveSamplePixel(const ModelEvaluator& model_eval, int x, int y, unsigned int max_subsampling, float threshold=1.1,
+                            unsigned int* used_subsampling=nullptr) const;
+
+  /// Same as samplePixel(), for an evaluator returning DualNumber<N>
+  template<std::size_t N, typename DerivativeEvaluator>
+  DualNumber<N> samplePixelDerivatives(const DerivativeEvaluator& derivative_eval, int x, int y,
+                                       unsigned int subsampling) const;
+
+  /**
+   * Rasterizes the model the same way the compact models do in getRasterizedImage(), renormalized to
+   * @p flux, together with its derivatives. @p derivative_eval must evaluate the same profile as
+   * @p model_eval over DualNumber<N>, and it is sampled with the subsampling chosen for the value, so
+   * the derivatives are those of the returned image. If @p kernel is not null, the value is rasterized
+   * with it, as rasterizeBatched() does. @p derivatives receives N+1 images: the derivative with respect
+   * to the flux first, then one per dual variable.
+   */
+  template<std::size_t N, typename ModelEvaluator, typename DerivativeEvaluator>
+  ImageType rasterizeWithDerivatives(const ModelEvaluator& model_eval, const DerivativeEvaluator& derivative_eval,
+                                     const SersicKernel* kernel, std::size_t size_x, std::size_t size_y, float sharp_radius_squared,
+                                     float area_correction, double flux, std::vector<ImageType>& derivatives) const;
+
+  /**
+   * Writes model_eval, scaled by area_correction, into image inside its 4 pixels border. Each pixel is
+   * evaluated at its centre, except those closer to the centre than the sharp radius, which are sampled
+   * with adaptiveSamplePixel().
+   */
+  template<typename ModelEvaluator>
+  void rasterizeScalar(const ModelEvaluator& model_eval, ImageType& image, std::size_t size_x, std::size_t size_y,
+                       float sharp_radius_squared, float area_correction) const;
+
+  /**
+   * Same as rasterizeScalar(), but the profile is evaluated in batches by kernel, which must provide
+   * evaluate(const float* x, const float* y, std::size_t count, float* out): whole rows first, then for
+   * each adaptive sampling level the samples of all the pixels that have not converged yet.
+   * If @p used_subsampling is given, it receives the subsampling used for each pixel, row by row.
+   */
+  template<typename ProfileKernel>
+  void rasterizeBatched(const ProfileKernel& kernel, ImageType& image, std::size_t size_x, std::size_t size_y,
+                        float sharp_radius_squared, float area_correction,
+                        std::vector<unsigned int>* used_subsampling = nullptr) const;
+
+  /// The batched equivalent of a Sersic profile evaluator with the given parameters
+  static SersicKernel makeSersicKernel(const Mat22& transform, double i0, double k, double n, double max_r_sqr) {
+    return {
+      {float(transform[0]), float(transform[1]), float(transform[2]), float(transform[3])},
+      float(i0), float(k), float(n), float(max_r_sqr)
+    };
+  }
 
   double getMaxRadiusSqr(std::size_t size_x, std::size_t size_y, const Mat22& transform) const;
 
@@ -48,6 +116,8 @@ protected:
   Mat22 m_jacobian;
   Mat22 m_inv_jacobian;
 
+  bool m_vectorized = true;
+
 private:
   double computeSqrDistanceLineToOrigin(double x1, double y1, double x2, double y2) const;
 
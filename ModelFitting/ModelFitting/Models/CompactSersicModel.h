@@ -32,6 +32,15 @@ public:
 
   ImageType getRasterizedImage(double pixel_scale, std::size_t size_x, std::size_t size_y) const override;
 
+  /// i0, the profile parameters, flux, x scale, y scale and rotation
+  std::vector<std::shared_ptr<BasicParameter>> getShapeParameters() const override;
+
+  /// Flux, k, n, x scale, y scale and rotation. i0 is absent as the image is renormalized to the flux.
+  std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() const override;
+
+  ImageType getRasterizedDerivatives(double pixel_scale, std::size_t size_x, std::size_t size_y,
+                                     std::vector<ImageType>& derivatives) const override;
+
 
   struct SersicModelEvaluator {
     Mat22 transform;
@@ -51,15 +60,44 @@ public:
     }
   };
 
+  /// Evaluates the same profile as SersicModelEvaluator, differentiated with respect to
+  /// k, n, x scale, y scale and rotation, in that order
+  struct SersicDerivativeEvaluator {
+    std::array<DualNumber<5>, 4> transform;
+    float i0;
+    DualNumber<5> k, n;
+    double max_r_sqr;
+
+    inline DualNumber<5> evaluateModel(float x, float y) const {
+      auto x2 = x * transform[0] + y * transform[1];
+      auto y2 = x * transform[2] + y * transform[3];
+      auto r_sqr = x2*x2 + y2*y2;
+      if (r_sqr.value < max_r_sqr) {
+        if (r_sqr.value <= 0.f) {
+          return DualNumber<5>(i0);
+        }
+        // r^(1/n) = exp(log(r^2) / 2n)
+        return i0 * exp(-k * exp(0.5f * log(r_sqr) / n));
+      } else {
+        return DualNumber<5>(0.f);
+      }
+    }
+  };
+
 private:
   using CompactModelBase<ImageType>::getMaxRadiusSqr;
   using CompactModelBase<ImageType>::getCombinedTransform;
+  using CompactModelBase<ImageType>::getTransformParameters;
   using CompactModelBase<ImageType>::samplePixel;
   using CompactModelBase<ImageType>::adaptiveSamplePixel;
   using CompactModelBase<ImageType>::sampleStochastic;
   using CompactModelBase<ImageType>::renormalize;
+  using CompactModelBase<ImageType>::rasterizeScalar;
+  using CompactModelBase<ImageType>::rasterizeBatched;
+  using CompactModelBase<ImageType>::makeSersicKernel;
 
   using CompactModelBase<ImageType>::m_jacobian;
+  using CompactModelBase<ImageType>::m_vectorized;
 
   float m_sharp_radius_squared;
 
@@ -38,6 +38,10 @@ public:
   virtual ~ConstantModel();
   
   double getValue() const;
+
+  const std::shared_ptr<BasicParameter>& getValueParameter() const {
+    return m_value;
+  }
   
 private:
   std::shared_ptr<BasicParameter> m_value;
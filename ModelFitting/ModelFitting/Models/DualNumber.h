@@ -0,0 +1,138 @@
+/*
+ * DualNumber.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _MODELFITTING_MODELS_DUALNUMBER_H_
+#define _MODELFITTING_MODELS_DUALNUMBER_H_
+
+#include <array>
+#include <cmath>
+
+namespace ModelFitting {
+
+/**
+ * @class DualNumber
+ *
+ * @brief
+ * Minimal forward-mode automatic differentiation scalar
+ *
+ * @details
+ * Carries a value and its gradient with respect to N seed variables. Only the
+ * operations needed to evaluate the compact model profiles are provided.
+ * Single precision is used, as for the profile evaluation itself.
+ */
+template <std::size_t N>
+struct DualNumber {
+  float value;
+  std::array<float, N> grad;
+
+  DualNumber(float v = 0.f) : value{v} {
+    grad.fill(0.f);
+  }
+
+  /// Creates the seed variable number i
+  static DualNumber variable(float v, std::size_t i) {
+    DualNumber d{v};
+    d.grad[i] = 1.f;
+    return d;
+  }
+
+  DualNumber& operator+=(const DualNumber& o) {
+    value += o.value;
+    for (std::size_t i = 0; i < N; ++i)
+      grad[i] += o.grad[i];
+    return *this;
+  }
+
+  DualNumber& operator*=(float s) {
+    value *= s;
+    for (std::size_t i = 0; i < N; ++i)
+      grad[i] *= s;
+    return *this;
+  }
+};
+
+template <std::size_t N>
+inline DualNumber<N> operator+(DualNumber<N> a, const DualNumber<N>& b) {
+  return a += b;
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator-(const DualNumber<N>& a) {
+  DualNumber<N> r{a};
+  return r *= -1.f;
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator-(const DualNumber<N>& a, const DualNumber<N>& b) {
+  return a + (-b);
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator*(const DualNumber<N>& a, const DualNumber<N>& b) {
+  DualNumber<N> r{a.value * b.value};
+  for (std::size_t i = 0; i < N; ++i)
+    r.grad[i] = a.grad[i] * b.value + a.value * b.grad[i];
+  return r;
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator*(DualNumber<N> a, float s) {
+  return a *= s;
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator*(float s, DualNumber<N> a) {
+  return a *= s;
+}
+
+template <std::size_t N>
+inline DualNumber<N> operator/(const DualNumber<N>& a, const DualNumber<N>& b) {
+  float inv = 1.f / b.value;
+  DualNumber<N> r{a.value * inv};
+  for (std::size_t i = 0; i < N; ++i)
+    r.grad[i] = (a.grad[i] - r.value * b.grad[i]) * inv;
+  return r;
+}
+
+/// Applies the chain rule for a function with value f and derivative df at a
+template <std::size_t N>
+inline DualNumber<N> chain(const DualNumber<N>& a, float f, float df) {
+  DualNumber<N> r{f};
+  for (std::size_t i = 0; i < N; ++i)
+    r.grad[i] = df * a.grad[i];
+  return r;
+}
+
+template <std::size_t N>
+inline DualNumber<N> exp(const DualNumber<N>& a) {
+  float e = std::exp(a.value);
+  return chain(a, e, e);
+}
+
+template <std::size_t N>
+inline DualNumber<N> log(const DualNumber<N>& a) {
+  return chain(a, std::log(a.value), 1.f / a.value);
+}
+
+template <std::size_t N>
+inline DualNumber<N> sqrt(const DualNumber<N>& a) {
+  float s = std::sqrt(a.value);
+  return chain(a, s, 0.5f / s);
+}
+
+template <std::size_t N>
+inline DualNumber<N> sin(const DualNumber<N>& a) {
+  return chain(a, std::sin(a.value), std::cos(a.value));
+}
+
+template <std::size_t N>
+inline DualNumber<N> cos(const DualNumber<N>& a) {
+  return chain(a, std::cos(a.value), -std::sin(a.value));
+}
+
+} // end of namespace ModelFitting
+
+#endif /* _MODELFITTING_MODELS_DUALNUMBER_H_ */
@@ -52,6 +52,31 @@ public:
   virtual double getValue(double x, double y) const;
   
   virtual ImageType getRasterizedImage(double pixel_scale, std::size_t size_x, std::size_t size_y) const;
+
+  /**
+   * Parameters the rasterized image depends on, which are all but the position. The FrameModel
+   * uses them to rasterize and convolve the model again only when one of them changes. An empty
+   * list, the default, means they are not known, so the model is rasterized on every evaluation.
+   */
+  virtual std::vector<std::shared_ptr<BasicParameter>> getShapeParameters() const {
+    return {};
+  }
+
+  /**
+   * Parameters the rasterized image can be differentiated against by getRasterizedDerivatives().
+   * The position is not part of the list, as shifting the image is done (and differentiated)
+   * by the FrameModel. An empty list, the default, means the model does not provide derivatives.
+   */
+  virtual std::vector<std::shared_ptr<BasicParameter>> getDerivativeParameters() const {
+    return {};
+  }
+
+  /**
+   * Same as getRasterizedImage(), but also rasterizes the derivatives of the image with respect
+   * to each of the getDerivativeParameters(), in the same order, into @p derivatives.
+   */
+  virtual ImageType getRasterizedDerivatives(double pixel_scale, std::size_t size_x, std::size_t size_y,
+                                             std::vector<ImageType>& derivatives) const;
   
   double getWidth() const {
     return m_width;
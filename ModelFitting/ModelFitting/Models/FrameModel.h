@@ -24,7 +24,12 @@
 #define	MODELFITTING_FRAMEMODEL_H
 
 #include <vector>
+#include <array>
+#include <map>
+#include <algorithm>
 #include <cmath>
+#include "ElementsKernel/Exception.h"
+#include "ModelFitting/Parameters/BasicParameter.h"
 #include "ModelFitting/Models/ConstantModel.h"
 #include "ModelFitting/Models/PointModel.h"
 #include "ModelFitting/Models/ExtendedModel.h"
@@ -141,6 +146,7 @@ private:
 public:
 
   using const_iterator = typename ImageTraits<ImageType>::iterator;
+  using image_type = ImageType;
   
   FrameModel(double pixel_scale, std::size_t width, std::size_t height,
              std::vector<ConstantModel> constant_model_list,
@@ -158,12 +164,41 @@ public:
   
   virtual ~FrameModel();
   
+  /**
+   * Renders the model image again, unless none of the parameters it depends on changed since the
+   * last call. Extended models whose shape parameters did not change are not rasterized nor
+   * convolved again, their cached image is only placed at their current position. When only the
+   * parameters of a few sources change, as when the engine perturbs a single parameter to
+   * estimate the Jacobian, only those sources are rendered again.
+   */
   void recomputeImage();
   
   const ImageType& getImage();
 
+  /// Renders all the models into the given image, without using nor updating the cached images
   void rasterToImage(ImageType&);
   
+  /// True if computeDerivatives() can be used, which requires all the extended models to provide derivatives
+  bool providesDerivatives() const;
+
+  /**
+   * Parameters the model image can be differentiated against with computeDerivatives(), without
+   * duplicates: the value of the constant models, the position and value of the point models, and
+   * the position and ExtendedModel::getDerivativeParameters() of the extended models.
+   */
+  const std::vector<std::shared_ptr<BasicParameter>>& getDerivativeParameters();
+
+  /**
+   * Renders the model image into @p model_image, and into @p derivatives its derivatives with respect
+   * to the getDerivativeParameters() flagged in @p active (the rest are left empty).
+   *
+   * Constant and point model values are differentiated exactly, as the image is linear on them. The
+   * extended models provide their own derivatives, which are convolved with the PSF as the model is.
+   * Position derivatives differentiate the placement (resampling) of the already convolved images,
+   * so they cost no additional rasterization nor convolution.
+   */
+  void computeDerivatives(const std::vector<bool>& active, ImageType& model_image, std::vector<ImageType>& derivatives);
+
   const_iterator begin();
   
   const_iterator end();
@@ -180,6 +215,32 @@ private:
   std::vector<std::shared_ptr<ExtendedModel<ImageType>>> m_extended_model_list;
   psf_container_t m_psf;
   std::unique_ptr<ImageType> m_model_image {};
+
+  // Convolved image of an extended model, and the values of its shape parameters when it was rendered
+  struct ExtendedModelCache {
+    std::vector<std::shared_ptr<BasicParameter>> parameters;
+    std::vector<double> values;
+    ImageType image;
+    bool valid;
+  };
+  std::vector<ExtendedModelCache> m_extended_model_cache {};
+
+  // Values of all the parameters of the frame when m_model_image was rendered
+  std::vector<double> m_frame_values {};
+
+  void initializeCache();
+
+  bool updateFrameValues();
+
+  const ImageType& getExtendedModelImage(std::size_t i);
+
+  void indexDerivativeParameters();
+
+  // Indexes inside m_derivative_parameters, filled lazily by indexDerivativeParameters()
+  std::vector<std::shared_ptr<BasicParameter>> m_derivative_parameters {};
+  std::vector<std::size_t> m_constant_derivative_indexes {};
+  std::vector<std::array<std::size_t, 3>> m_point_derivative_indexes {};
+  std::vector<std::vector<std::size_t>> m_extended_derivative_indexes {};
   
 }; // end of class FrameModel
 
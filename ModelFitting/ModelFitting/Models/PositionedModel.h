@@ -40,6 +40,14 @@ public:
   double getX() const;
   
   double getY() const;
+
+  const std::shared_ptr<BasicParameter>& getXParameter() const {
+    return m_x;
+  }
+
+  const std::shared_ptr<BasicParameter>& getYParameter() const {
+    return m_y;
+  }
   
 private:
   std::shared_ptr<BasicParameter> m_x;
@@ -68,8 +68,9 @@ public:
   virtual ~DependentParameter() = default;
 
   double getValue() const override {
+    // Computed on the fly, without storing it, so concurrent readers do not race
     if (!this->isObserved()) {
-      const_cast<DependentParameter*>(this)->update((*m_params)[0]->getValue());
+      return compute((*m_params)[0]->getValue());
     }
     return m_value;
   }
@@ -109,6 +110,15 @@ private:
     update(values..., (*m_params)[sizeof...(values)]->getValue());
   }
 
+  template <typename... ParamValues>
+  double compute(ParamValues... values) const {
+    return compute(values..., (*m_params)[sizeof...(values)]->getValue());
+  }
+
+  double compute(decltype(std::declval<Parameters>()->getValue())... values) const {
+    return (*m_calculator)(values...);
+  }
+
   void update(decltype(std::declval<Parameters>()->getValue())... values) {
     /* Beware that it is the updated value (m_calculator(values...)) that
      * is passed to the setValue
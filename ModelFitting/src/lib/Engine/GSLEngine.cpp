@@ -165,9 +165,26 @@ LeastSquareSummary GSLEngine::solveProblem(ModelFitting::EngineParameterManager&
     re.populateResiduals(GslVectorIterator{f});
     return GSL_SUCCESS;
   };
+  // Jacobian, used when the residuals provide their derivatives
+  auto jacobian = [](const gsl_vector *x, void *extra, gsl_matrix *J) -> int {
+    auto *extra_ptr = (decltype(adata) *) extra;
+    EngineParameterManager& pm = std::get<0>(*extra_ptr);
+    ResidualEstimator& re = std::get<1>(*extra_ptr);
+    std::vector<double> engine_values(x->size);
+    for (size_t i = 0; i < x->size; ++i) {
+      engine_values[i] = gsl_vector_get(x, i);
+    }
+    std::vector<double> values(J->size1 * J->size2);
+    re.populateJacobian(pm, engine_values.data(), values.data());
+    gsl_matrix_const_view values_view = gsl_matrix_const_view_array(values.data(), J->size1, J->size2);
+    return gsl_matrix_memcpy(J, &values_view.matrix);
+  };
   gsl_multifit_nlinear_fdf fdf;
   fdf.f = function;
   fdf.df = nullptr;
+  if (residual_estimator.providesJacobian()) {
+    fdf.df = jacobian;
+  }
   fdf.fvv = nullptr;
   fdf.n = residual_estimator.numberOfResiduals();
   fdf.p = parameter_manager.numberOfParameters();
@@ -141,6 +141,23 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
 #endif
     };
 
+  // The function which computes the Jacobian, used when the residuals provide their derivatives
+  auto levmar_jac_func = [](double *p, double *jac, int, int, void *extra) {
+#ifdef LINSOLVERS_RETAIN_MEMORY
+    levmar_mutex.unlock();
+#endif
+
+    auto* extra_ptr = (decltype(adata)*)extra;
+    EngineParameterManager& pm = std::get<0>(*extra_ptr);
+    ResidualEstimator& re = std::get<1>(*extra_ptr);
+    re.populateJacobian(pm, p, jac);
+
+#ifdef LINSOLVERS_RETAIN_MEMORY
+    levmar_mutex.lock();
+#endif
+  };
+  bool analytic_jacobian = residual_estimator.providesJacobian();
+
   // Create the vector which will be used for keeping the parameter values
   // and initialize it to the current values of the parameters
   std::vector<double> param_values (parameter_manager.numberOfParameters());
@@ -156,8 +173,9 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
 #endif
 
   std::unique_ptr<double[]> workarea;
-  size_t workarea_size = LM_DIF_WORKSZ(parameter_manager.numberOfParameters(),
-                                       residual_estimator.numberOfResiduals());
+  size_t workarea_size = analytic_jacobian ?
+                         LM_DER_WORKSZ(parameter_manager.numberOfParameters(), residual_estimator.numberOfResiduals()) :
+                         LM_DIF_WORKSZ(parameter_manager.numberOfParameters(), residual_estimator.numberOfResiduals());
 
   if (workarea_size <= LEVMAR_WORKAREA_MAX_SIZE / sizeof(double)) {
     try {
@@ -177,18 +195,36 @@ LeastSquareSummary LevmarEngine::solveProblem(EngineParameterManager& parameter_
 
   // Call the levmar library
   auto start = std::chrono::steady_clock::now();
-  auto res = dlevmar_dif(levmar_res_func, // The function called from the levmar algorithm
-                         param_values.data(), // The pointer where the parameter values are
-                         NULL, // We don't use any measurement vector
-                         parameter_manager.numberOfParameters(), // The number of free parameters
-                         residual_estimator.numberOfResiduals(), // The number of residuals
-                         m_itmax, // The maximum number of iterations
-                         m_opts.data(), // The minimization options
-                         info.data(), // Where the information of the minimization is stored
-                         workarea.get(), // Working memory is allocated internally
-                         covariance_matrix.data(),
-                         &adata // No additional data needed
-  );
+  int res;
+  if (analytic_jacobian) {
+    res = dlevmar_der(levmar_res_func, // The function called from the levmar algorithm
+                      levmar_jac_func, // The function computing the Jacobian
+                      param_values.data(), // The pointer where the parameter values are
+                      NULL, // We don't use any measurement vector
+                      parameter_manager.numberOfParameters(), // The number of free parameters
+                      residual_estimator.numberOfResiduals(), // The number of residuals
+                      m_itmax, // The maximum number of iterations
+                      m_opts.data(), // The minimization options (the difference delta is not used)
+                      info.data(), // Where the information of the minimization is stored
+                      workarea.get(), // Working memory is allocated internally
+                      covariance_matrix.data(),
+                      &adata // No additional data needed
+    );
+  }
+  else {
+    res = dlevmar_dif(levmar_res_func, // The function called from the levmar algorithm
+                      param_values.data(), // The pointer where the parameter values are
+                      NULL, // We don't use any measurement vector
+                      parameter_manager.numberOfParameters(), // The number of free parameters
+                      residual_estimator.numberOfResiduals(), // The number of residuals
+                      m_itmax, // The maximum number of iterations
+                      m_opts.data(), // The minimization options
+                      info.data(), // Where the information of the minimization is stored
+                      workarea.get(), // Working memory is allocated internally
+                      covariance_matrix.data(),
+                      &adata // No additional data needed
+    );
+  }
   auto end     = std::chrono::steady_clock::now();
   std::chrono::duration<float> elapsed = end - start;
 #ifdef LINSOLVERS_RETAIN_MEMORY
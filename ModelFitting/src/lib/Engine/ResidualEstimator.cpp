@@ -20,33 +20,161 @@
  * @author Nikolaos Apostolakos
  */
 
+#include <cmath>
+#include <map>
 #include "ModelFitting/Engine/ResidualEstimator.h"
 
 namespace ModelFitting {
 
+namespace {
+
+// Same step levmar uses for its finite differences
+double differenceStep(double value) {
+  return std::max(std::abs(1E-04 * value), 1E-06);
+}
+
+}
+
 ResidualEstimator::~ResidualEstimator() = default;
 
 void ResidualEstimator::registerBlockProvider(std::unique_ptr<ResidualBlockProvider> provider) {
+  m_block_offsets.push_back(m_residual_no);
   m_residual_no += provider->numberOfResiduals();
   m_block_provider_list.push_back(std::move(provider));
 }
 
+void ResidualEstimator::setTaskExecutor(SourceXtractor::TaskExecutor executor) {
+  m_executor = std::move(executor);
+}
+
 std::size_t ResidualEstimator::numberOfResiduals() const {
   return m_residual_no;
 }
 
 void ResidualEstimator::populateResiduals(double* output_iter) const {
-  for (auto& block_prov_ptr : m_block_provider_list) {
-    block_prov_ptr->populateResidualBlock(output_iter);
-    output_iter += block_prov_ptr->numberOfResiduals();
-  }
+  SourceXtractor::parallelFor(m_executor, m_block_provider_list.size(), [this, output_iter](std::size_t b) {
+    m_block_provider_list[b]->populateResidualBlock(output_iter + m_block_offsets[b]);
+  });
 }
 
 void ResidualEstimator::populateResiduals(std::vector<double>::iterator output_iter) const {
-  for (auto& block_prov_ptr : m_block_provider_list) {
-    block_prov_ptr->populateResidualBlock(&*output_iter);
-    output_iter += block_prov_ptr->numberOfResiduals();
+  populateResiduals(&*output_iter);
+}
+
+bool ResidualEstimator::providesJacobian() const {
+  return std::any_of(m_block_provider_list.begin(), m_block_provider_list.end(),
+                     [](const std::unique_ptr<ResidualBlockProvider>& provider) {
+                       return !provider->getDerivativeParameters().empty();
+                     });
+}
+
+void ResidualEstimator::populateJacobian(EngineParameterManager& manager, const double* engine_values,
+                                         double* jacobian) const {
+  std::size_t parameter_no = manager.numberOfParameters();
+  std::vector<double> values(engine_values, engine_values + parameter_no);
+
+  // Collect the world parameters the providers differentiate against
+  std::vector<std::shared_ptr<BasicParameter>> world_parameters;
+  std::map<BasicParameter*, std::size_t> world_indexes;
+  std::vector<std::vector<std::size_t>> block_indexes(m_block_provider_list.size());
+  for (std::size_t b = 0; b < m_block_provider_list.size(); ++b) {
+    for (auto& parameter : m_block_provider_list[b]->getDerivativeParameters()) {
+      auto inserted = world_indexes.emplace(parameter.get(), world_parameters.size());
+      if (inserted.second) {
+        world_parameters.emplace_back(parameter);
+      }
+      block_indexes[b].emplace_back(inserted.first->second);
+    }
+  }
+
+  // Derivatives of the world parameters with respect to the engine parameters, using central differences
+  std::vector<double> world_derivatives(world_parameters.size() * parameter_no, 0.);
+  if (!world_parameters.empty()) {
+    std::vector<double> plus(world_parameters.size());
+    for (std::size_t j = 0; j < parameter_no; ++j) {
+      double h = differenceStep(engine_values[j]);
+      values[j] = engine_values[j] + h;
+      manager.updateEngineValues(values.data());
+      for (std::size_t w = 0; w < world_parameters.size(); ++w) {
+        plus[w] = world_parameters[w]->getValue();
+      }
+      values[j] = engine_values[j] - h;
+      manager.updateEngineValues(values.data());
+      for (std::size_t w = 0; w < world_parameters.size(); ++w) {
+        world_derivatives[w * parameter_no + j] = (plus[w] - world_parameters[w]->getValue()) / (2 * h);
+      }
+      values[j] = engine_values[j];
+    }
+  }
+  manager.updateEngineValues(engine_values);
+
+  std::fill(jacobian, jacobian + m_residual_no * parameter_no, 0.);
+
+  std::vector<std::size_t> analytic_blocks, difference_blocks;
+  for (std::size_t b = 0; b < m_block_provider_list.size(); ++b) {
+    (block_indexes[b].empty() ? difference_blocks : analytic_blocks).emplace_back(b);
+  }
+
+  // Analytic blocks, chained with the world parameter derivatives. Each block fills its own rows.
+  SourceXtractor::parallelFor(m_executor, analytic_blocks.size(), [&](std::size_t a) {
+    std::size_t b = analytic_blocks[a];
+    auto& provider = m_block_provider_list[b];
+    auto& indexes = block_indexes[b];
+    std::size_t residual_no = provider->numberOfResiduals();
+    std::size_t offset = m_block_offsets[b];
+
+    // Skip the parameters that do not depend on any engine parameter
+    std::vector<bool> active(indexes.size());
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+      auto first = world_derivatives.begin() + indexes[k] * parameter_no;
+      active[k] = std::any_of(first, first + parameter_no, [](double d) { return d != 0.; });
+    }
+
+    std::vector<double> columns(residual_no * indexes.size(), 0.);
+    provider->populateJacobianBlock(columns.data(), active);
+
+    for (std::size_t k = 0; k < indexes.size(); ++k) {
+      if (!active[k]) {
+        continue;
+      }
+      const double* column = columns.data() + k * residual_no;
+      const double* derivatives = world_derivatives.data() + indexes[k] * parameter_no;
+      for (std::size_t j = 0; j < parameter_no; ++j) {
+        if (derivatives[j] == 0.) {
+          continue;
+        }
+        for (std::size_t i = 0; i < residual_no; ++i) {
+          jacobian[(offset + i) * parameter_no + j] += column[i] * derivatives[j];
+        }
+      }
+    }
+  });
+
+  // The rest use forward differences. The parameters are shared, so the columns are computed one
+  // after the other, but the blocks of each column concurrently.
+  if (!difference_blocks.empty()) {
+    std::vector<double> residuals(m_residual_no), perturbed(m_residual_no);
+    SourceXtractor::parallelFor(m_executor, difference_blocks.size(), [&](std::size_t d) {
+      std::size_t b = difference_blocks[d];
+      m_block_provider_list[b]->populateResidualBlock(residuals.data() + m_block_offsets[b]);
+    });
+    for (std::size_t j = 0; j < parameter_no; ++j) {
+      double h = differenceStep(engine_values[j]);
+      values[j] = engine_values[j] + h;
+      manager.updateEngineValues(values.data());
+      SourceXtractor::parallelFor(m_executor, difference_blocks.size(), [&](std::size_t d) {
+        std::size_t b = difference_blocks[d];
+        auto& provider = m_block_provider_list[b];
+        std::size_t first = m_block_offsets[b];
+        provider->populateResidualBlock(perturbed.data() + first);
+        for (std::size_t i = first; i < first + provider->numberOfResiduals(); ++i) {
+          jacobian[i * parameter_no + j] = (perturbed[i] - residuals[i]) / h;
+        }
+      });
+      values[j] = engine_values[j];
+    }
+    manager.updateEngineValues(engine_values);
   }
 }
 
-} // end of namespace ModelFitting
\ No newline at end of file
+} // end of namespace ModelFitting
@@ -34,7 +34,7 @@ static double computeResidual(double current, double expected, double weight) {
 
 WorldValueResidual::WorldValueResidual(std::shared_ptr<BasicParameter> parameter,
                                        double expected_value, double weight)
-        : m_parameter(parameter), m_residual{computeResidual(parameter->getValue(), expected_value, weight)} {
+        : m_parameter(parameter), m_weight{weight}, m_residual{computeResidual(parameter->getValue(), expected_value, weight)} {
     m_observer_id = parameter->addObserver(
       [this, expected_value, weight](double new_value){
         m_residual = computeResidual(new_value, expected_value, weight);
@@ -50,4 +50,12 @@ void WorldValueResidual::populateResidualBlock(IterType output_iter) {
   *output_iter = m_residual;
 }
 
+std::vector<std::shared_ptr<BasicParameter>> WorldValueResidual::getDerivativeParameters() {
+  return {m_parameter};
+}
+
+void WorldValueResidual::populateJacobianBlock(IterType output_iter, const std::vector<bool>&) {
+  *output_iter = m_weight;
+}
+
 } // end of namespace ModelFitting
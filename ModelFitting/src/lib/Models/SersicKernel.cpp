@@ -0,0 +1,112 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SersicKernel.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "ModelFitting/Models/SersicKernel.h"
+
+// Function multi-versioning: one clone per instruction set, dispatched when the library is loaded.
+// The x86-64-v3 and x86-64-v4 levels are known to GCC 11 and later only
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11 && defined(__x86_64__) && defined(__linux__)
+#define SERSIC_KERNEL_CLONES __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+#define SERSIC_KERNEL_CLONES
+#endif
+
+// The helpers must be inlined into every clone, or the loop can not be vectorized
+#if defined(__GNUC__)
+#define SERSIC_KERNEL_INLINE __attribute__((always_inline)) inline
+#else
+#define SERSIC_KERNEL_INLINE inline
+#endif
+
+namespace ModelFitting {
+
+namespace {
+
+SERSIC_KERNEL_INLINE std::uint32_t floatBits(float v) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+SERSIC_KERNEL_INLINE float bitsFloat(std::uint32_t bits) {
+  float v;
+  std::memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+/// log2(x) for x > 0. x = 2^e * m with m in [sqrt(1/2), sqrt(2)), and ln(m) from the atanh series
+SERSIC_KERNEL_INLINE float fastLog2(float x) {
+  std::uint32_t bits = floatBits(x);
+  std::int32_t e = std::int32_t(bits >> 23) - 127;
+  float m = bitsFloat((bits & 0x007fffffu) | 0x3f800000u);
+  bool high = m > 1.41421356f;
+  m = high ? m * 0.5f : m;
+  e += high;
+  float f = (m - 1.f) / (m + 1.f);
+  float f2 = f * f;
+  float ln_m = 2.f * f * (1.f + f2 * (1.f / 3.f + f2 * (1.f / 5.f + f2 * (1.f / 7.f))));
+  return float(e) + ln_m * 1.44269504f;
+}
+
+/// 2^x, flushed to 0 below 2^-126. 2^x = 2^i * e^(f ln 2) with i the nearest integer, |f| <= 1/2
+SERSIC_KERNEL_INLINE float fastExp2(float x) {
+  float clamped = x < -127.f ? -127.f : (x > 127.f ? 127.f : x);
+  // clamped + 128.5 is positive, so the truncation rounds clamped to the nearest integer
+  std::int32_t i = std::int32_t(clamped + 128.5f) - 128;
+  float f = (clamped - float(i)) * 0.693147181f;
+  float p = 1.f + f * (1.f + f * (1.f / 2.f + f * (1.f / 6.f + f * (1.f / 24.f + f * (1.f / 120.f +
+            f * (1.f / 720.f + f * (1.f / 5040.f)))))));
+  float scale = bitsFloat(std::uint32_t(i + 127) << 23);
+  return x < -126.f ? 0.f : p * scale;
+}
+
+SERSIC_KERNEL_CLONES
+void evaluateSersic(const SersicKernel& kernel, const float* x, const float* y, std::size_t count, float* out) {
+  const float t0 = kernel.transform[0], t1 = kernel.transform[1];
+  const float t2 = kernel.transform[2], t3 = kernel.transform[3];
+  const float i0 = kernel.i0;
+  const float half_inv_n = 0.5f / kernel.n;
+  const float minus_k_log2e = -kernel.k * 1.44269504f;
+  const float max_r_sqr = kernel.max_r_sqr;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    float x2 = x[i] * t0 + y[i] * t1;
+    float y2 = x[i] * t2 + y[i] * t3;
+    float r_sqr = x2 * x2 + y2 * y2;
+    // r^(1/n) = 2^(log2(r^2) / 2n)
+    float r_pow = fastExp2(fastLog2(r_sqr) * half_inv_n);
+    r_pow = r_sqr > 0.f ? r_pow : 0.f;
+    float value = i0 * fastExp2(minus_k_log2e * r_pow);
+    out[i] = r_sqr < max_r_sqr ? value : 0.f;
+  }
+}
+
+} // end of anonymous namespace
+
+void SersicKernel::evaluate(const float* x, const float* y, std::size_t count, float* out) const {
+  evaluateSersic(*this, x, y, count, out);
+}
+
+} // end of namespace ModelFitting
@@ -0,0 +1,157 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FrameModel_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "AlexandriaKernel/memory_tools.h"
+#include "ModelFitting/Parameters/ManualParameter.h"
+#include "ModelFitting/Models/FrameModel.h"
+#include "ModelFitting/Models/CompactExponentialModel.h"
+#include "TestHelper.h"
+
+using namespace ModelFitting;
+
+namespace {
+
+struct FrameModelFixture {
+  std::shared_ptr<std::size_t> convolutions = std::make_shared<std::size_t>(0);
+  std::shared_ptr<ManualParameter> i0 = std::make_shared<ManualParameter>(1.);
+  std::shared_ptr<ManualParameter> k1 = std::make_shared<ManualParameter>(1.2);
+  std::shared_ptr<ManualParameter> k2 = std::make_shared<ManualParameter>(0.8);
+  std::shared_ptr<ManualParameter> scale = std::make_shared<ManualParameter>(1.);
+  std::shared_ptr<ManualParameter> rotation = std::make_shared<ManualParameter>(0.);
+  std::shared_ptr<ManualParameter> x1 = std::make_shared<ManualParameter>(12.);
+  std::shared_ptr<ManualParameter> y1 = std::make_shared<ManualParameter>(14.);
+  std::shared_ptr<ManualParameter> x2 = std::make_shared<ManualParameter>(25.);
+  std::shared_ptr<ManualParameter> y2 = std::make_shared<ManualParameter>(27.);
+  std::shared_ptr<ManualParameter> flux1 = std::make_shared<ManualParameter>(100.);
+  std::shared_ptr<ManualParameter> flux2 = std::make_shared<ManualParameter>(50.);
+  std::shared_ptr<ManualParameter> background = std::make_shared<ManualParameter>(2.);
+  std::tuple<double, double, double, double> jacobian {1., 0., 0., 1.};
+
+  FrameModel<TestPsf, TestImage> makeFrameModel(
+      std::vector<std::shared_ptr<ExtendedModel<TestImage>>> extra_models = {}) {
+    std::vector<ConstantModel> constant_models;
+    constant_models.emplace_back(background);
+    std::vector<std::shared_ptr<ExtendedModel<TestImage>>> extended_models {
+      std::make_shared<CompactExponentialModel<TestImage>>(
+        2., i0, k1, scale, scale, rotation, 11, 11, x1, y1, flux1, jacobian),
+      std::make_shared<CompactExponentialModel<TestImage>>(
+        2., i0, k2, scale, scale, rotation, 11, 11, x2, y2, flux2, jacobian)
+    };
+    for (auto& model : extra_models) {
+      extended_models.emplace_back(model);
+    }
+    return FrameModel<TestPsf, TestImage>(1., 40, 40, std::move(constant_models), {}, std::move(extended_models),
+                                          TestPsf{convolutions});
+  }
+
+  // The image must be the same as when rendering everything from scratch
+  void checkImage(FrameModel<TestPsf, TestImage>& frame_model) {
+    auto expected = ImageTraits<TestImage>::factory(40, 40);
+    auto before = *convolutions;
+    frame_model.rasterToImage(expected);
+    *convolutions = before;
+    auto& image = frame_model.getImage();
+    BOOST_REQUIRE_EQUAL(image.data.size(), expected.data.size());
+    for (std::size_t i = 0; i < expected.data.size(); ++i) {
+      BOOST_CHECK_CLOSE(image.data[i], expected.data[i], 1e-8);
+    }
+  }
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (FrameModel_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (Unchanged_test, FrameModelFixture) {
+  auto frame_model = makeFrameModel();
+  frame_model.getImage();
+  BOOST_CHECK_EQUAL(*convolutions, 2);
+
+  // Setting the same values does not render anything again
+  k1->setValue(k1->getValue());
+  x2->setValue(x2->getValue());
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (ShapeChange_test, FrameModelFixture) {
+  auto frame_model = makeFrameModel();
+  frame_model.getImage();
+
+  // Only the model which depends on the parameter is rendered again
+  k2->setValue(1.);
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 3);
+
+  flux1->setValue(120.);
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 4);
+
+  // Shared by both
+  scale->setValue(1.1);
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 6);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (PositionChange_test, FrameModelFixture) {
+  auto frame_model = makeFrameModel();
+  frame_model.getImage();
+
+  // Moving a model or changing the background only places the cached images again
+  x1->setValue(12.3);
+  checkImage(frame_model);
+  y2->setValue(26.6);
+  checkImage(frame_model);
+  background->setValue(3.);
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (UnknownParameters_test, FrameModelFixture) {
+  // A model based on components does not list its shape parameters, so it is always rendered
+  std::vector<std::unique_ptr<ModelComponent>> components;
+  components.emplace_back(Euclid::make_unique<LinearModelComponent>(3., 1.));
+  auto x3 = std::make_shared<ManualParameter>(20.);
+  auto extended = std::make_shared<ExtendedModel<TestImage>>(std::move(components), scale, scale, rotation,
+                                                              5, 5, x3, x3);
+  auto frame_model = makeFrameModel({extended});
+  frame_model.getImage();
+  BOOST_CHECK_EQUAL(*convolutions, 3);
+
+  checkImage(frame_model);
+  BOOST_CHECK_EQUAL(*convolutions, 4);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
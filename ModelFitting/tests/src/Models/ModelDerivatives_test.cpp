@@ -0,0 +1,247 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ModelDerivatives_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <functional>
+#include <thread>
+#include "AlexandriaKernel/memory_tools.h"
+#include "ModelFitting/Parameters/ManualParameter.h"
+#include "ModelFitting/Parameters/EngineParameter.h"
+#include "ModelFitting/Parameters/DependentParameter.h"
+#include "ModelFitting/Parameters/NeutralConverter.h"
+#include "ModelFitting/Parameters/ExpSigmoidConverter.h"
+#include "ModelFitting/Engine/ResidualEstimator.h"
+#include "ModelFitting/Engine/DataVsModelResiduals.h"
+#include "ModelFitting/Engine/ChiSquareComparator.h"
+#include "ModelFitting/Engine/WorldValueResidual.h"
+#include "ModelFitting/Engine/EngineValueResidual.h"
+#include "ModelFitting/Image/ImageTraits.h"
+#include "ModelFitting/Models/FrameModel.h"
+#include "ModelFitting/Models/CompactSersicModel.h"
+#include "ModelFitting/Models/CompactExponentialModel.h"
+#include "TestHelper.h"
+
+using namespace ModelFitting;
+
+namespace {
+
+// Relative L2 distance between the analytic derivative and a central difference of render
+double compareWithDifferences(const TestImage& derivative, ManualParameter& parameter, double step,
+                              std::function<TestImage()> render) {
+  double value = parameter.getValue();
+  parameter.setValue(value + step);
+  auto plus = render();
+  parameter.setValue(value - step);
+  auto minus = render();
+  parameter.setValue(value);
+
+  double diff = 0., norm = 0.;
+  for (std::size_t i = 0; i < derivative.data.size(); ++i) {
+    double numeric = (plus.data[i] - minus.data[i]) / (2 * step);
+    diff += (derivative.data[i] - numeric) * (derivative.data[i] - numeric);
+    norm += numeric * numeric;
+  }
+  return std::sqrt(diff / norm);
+}
+
+struct ModelFixture {
+  std::shared_ptr<ManualParameter> i0 = std::make_shared<ManualParameter>(1.);
+  std::shared_ptr<ManualParameter> k = std::make_shared<ManualParameter>(1.2);
+  std::shared_ptr<ManualParameter> n = std::make_shared<ManualParameter>(1.5);
+  std::shared_ptr<ManualParameter> x_scale = std::make_shared<ManualParameter>(1.);
+  std::shared_ptr<ManualParameter> y_scale = std::make_shared<ManualParameter>(.7);
+  std::shared_ptr<ManualParameter> rotation = std::make_shared<ManualParameter>(.4);
+  std::shared_ptr<ManualParameter> x = std::make_shared<ManualParameter>(20.3);
+  std::shared_ptr<ManualParameter> y = std::make_shared<ManualParameter>(18.6);
+  std::shared_ptr<ManualParameter> flux = std::make_shared<ManualParameter>(100.);
+  std::tuple<double, double, double, double> jacobian {1., 0., 0., 1.};
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ModelDerivatives_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (CompactSersic_test, ModelFixture) {
+  // Steep enough for the truncation at the border of the raster to be negligible
+  k->setValue(3.);
+  CompactSersicModel<TestImage> model(3., i0, k, n, x_scale, y_scale, rotation, 21, 21, x, y, flux, jacobian);
+
+  std::vector<TestImage> derivatives;
+  auto image = model.getRasterizedDerivatives(1., 21, 21, derivatives);
+  auto reference = model.getRasterizedImage(1., 21, 21);
+  BOOST_REQUIRE_EQUAL(derivatives.size(), model.getDerivativeParameters().size());
+  for (std::size_t i = 0; i < image.data.size(); ++i) {
+    BOOST_CHECK_CLOSE(image.data[i] + 1, reference.data[i] + 1, 1e-4);
+  }
+
+  auto render = [&model]() { return model.getRasterizedImage(1., 21, 21); };
+  std::vector<ManualParameter*> parameters {flux.get(), k.get(), n.get(), x_scale.get(), y_scale.get(), rotation.get()};
+  for (std::size_t i = 0; i < parameters.size(); ++i) {
+    BOOST_CHECK_EQUAL(model.getDerivativeParameters()[i].get(), parameters[i]);
+    BOOST_CHECK_LT(compareWithDifferences(derivatives[i], *parameters[i], 1e-3, render), 1e-2);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (CompactExponential_test, ModelFixture) {
+  CompactExponentialModel<TestImage> model(2., i0, k, x_scale, y_scale, rotation, 21, 21, x, y, flux, jacobian);
+
+  std::vector<TestImage> derivatives;
+  model.getRasterizedDerivatives(1., 21, 21, derivatives);
+
+  auto render = [&model]() { return model.getRasterizedImage(1., 21, 21); };
+  std::vector<ManualParameter*> parameters {flux.get(), k.get(), x_scale.get(), y_scale.get(), rotation.get()};
+  BOOST_REQUIRE_EQUAL(derivatives.size(), parameters.size());
+  for (std::size_t i = 0; i < parameters.size(); ++i) {
+    BOOST_CHECK_LT(compareWithDifferences(derivatives[i], *parameters[i], 1e-3, render), 1e-2);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (FrameModel_test, ModelFixture) {
+  auto background = std::make_shared<ManualParameter>(0.5);
+  auto point_x = std::make_shared<ManualParameter>(10.3);
+  auto point_y = std::make_shared<ManualParameter>(12.2);
+  auto point_flux = std::make_shared<ManualParameter>(40.);
+
+  std::vector<ConstantModel> constant_models;
+  constant_models.emplace_back(background);
+  std::vector<PointModel> point_models;
+  point_models.emplace_back(point_x, point_y, point_flux);
+  std::vector<std::shared_ptr<ExtendedModel<TestImage>>> extended_models;
+  extended_models.emplace_back(std::make_shared<CompactExponentialModel<TestImage>>(
+    2., i0, k, x_scale, y_scale, rotation, 21, 21, x, y, flux, jacobian));
+
+  FrameModel<TestPsf, TestImage> frame_model(1., 40, 40, std::move(constant_models), std::move(point_models),
+                                             std::move(extended_models));
+  BOOST_REQUIRE(frame_model.providesDerivatives());
+
+  auto parameters = frame_model.getDerivativeParameters();
+  // background, point x, y and flux, extended x and y, and the 5 model parameters
+  BOOST_REQUIRE_EQUAL(parameters.size(), 11);
+
+  std::vector<bool> active(parameters.size(), true);
+  active[0] = false;
+  TestImage image;
+  std::vector<TestImage> derivatives;
+  frame_model.computeDerivatives(active, image, derivatives);
+  BOOST_CHECK(derivatives[0].data.empty());
+
+  auto render = [&frame_model]() { return frame_model.getImage(); };
+  auto reference = render();
+  for (std::size_t i = 0; i < image.data.size(); ++i) {
+    BOOST_CHECK_CLOSE(image.data[i], reference.data[i], 1e-6);
+  }
+
+  for (std::size_t i = 1; i < parameters.size(); ++i) {
+    auto parameter = std::dynamic_pointer_cast<ManualParameter>(parameters[i]);
+    BOOST_REQUIRE(parameter);
+    BOOST_CHECK_LT(compareWithDifferences(derivatives[i], *parameter, 1e-3, render), 1e-2);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (ResidualEstimator_test, ModelFixture) {
+  auto engine_x = std::make_shared<EngineParameter>(20.3, Euclid::make_unique<NeutralConverter>());
+  auto engine_flux = std::make_shared<EngineParameter>(100., Euclid::make_unique<ExpSigmoidConverter>(1., 1e4));
+  auto radius = std::make_shared<EngineParameter>(1.5, Euclid::make_unique<ExpSigmoidConverter>(.1, 10.));
+  auto engine_k = createDependentParameter([](double r) { return 1.678 / r; }, radius);
+
+  EngineParameterManager manager;
+  manager.registerParameter(engine_x);
+  manager.registerParameter(engine_flux);
+  manager.registerParameter(radius);
+
+  auto make_frame_model = [&]() {
+    std::vector<std::shared_ptr<ExtendedModel<TestImage>>> extended_models;
+    extended_models.emplace_back(std::make_shared<CompactExponentialModel<TestImage>>(
+      2., i0, engine_k, x_scale, y_scale, rotation, 21, 21, engine_x, y, engine_flux, jacobian));
+    return FrameModel<TestPsf, TestImage>(1., 40, 40, {}, {}, std::move(extended_models));
+  };
+
+  // Fit data from slightly different values
+  auto data_model = make_frame_model();
+  engine_x->setValue(19.8);
+  auto data = data_model.getImage().data;
+  engine_x->setValue(20.3);
+  std::vector<double> weights(data.size(), 1.);
+
+  ResidualEstimator estimator;
+  estimator.registerBlockProvider(createDataVsModelResiduals(data, make_frame_model(), weights, ChiSquareComparator{}));
+  estimator.registerBlockProvider(Euclid::make_unique<WorldValueResidual>(radius, 2., 3.));
+  // No derivatives, so this one uses finite differences
+  estimator.registerBlockProvider(Euclid::make_unique<EngineValueResidual>(*engine_flux, 4., 2.));
+  BOOST_REQUIRE(estimator.providesJacobian());
+
+  std::size_t n = estimator.numberOfResiduals(), m = manager.numberOfParameters();
+  std::vector<double> engine_values(m);
+  manager.getEngineValues(engine_values.begin());
+
+  std::vector<double> jacobian(n * m);
+  estimator.populateJacobian(manager, engine_values.data(), jacobian.data());
+
+  // The parameters are left as they were
+  std::vector<double> after(m);
+  manager.getEngineValues(after.begin());
+  BOOST_CHECK(after == engine_values);
+
+  std::vector<double> plus(n), minus(n);
+  for (std::size_t j = 0; j < m; ++j) {
+    double h = 1e-4;
+    auto values = engine_values;
+    values[j] += h;
+    manager.updateEngineValues(values.begin());
+    estimator.populateResiduals(plus.begin());
+    values[j] -= 2 * h;
+    manager.updateEngineValues(values.begin());
+    estimator.populateResiduals(minus.begin());
+
+    double diff = 0., norm = 0.;
+    for (std::size_t i = 0; i < n; ++i) {
+      double numeric = (plus[i] - minus[i]) / (2 * h);
+      diff += (jacobian[i * m + j] - numeric) * (jacobian[i * m + j] - numeric);
+      norm += numeric * numeric;
+    }
+    BOOST_CHECK_LT(std::sqrt(diff / norm), 1e-2);
+  }
+
+  // Evaluating the blocks concurrently gives the same results
+  manager.updateEngineValues(engine_values.begin());
+  std::vector<double> residuals(n), parallel_residuals(n), parallel_jacobian(n * m);
+  estimator.populateResiduals(residuals.begin());
+  estimator.setTaskExecutor([](std::function<void()> task) { std::thread(std::move(task)).detach(); });
+  estimator.populateResiduals(parallel_residuals.begin());
+  estimator.populateJacobian(manager, engine_values.data(), parallel_jacobian.data());
+  BOOST_CHECK(parallel_residuals == residuals);
+  BOOST_CHECK(parallel_jacobian == jacobian);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,122 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * SersicKernel_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "ModelFitting/Parameters/ManualParameter.h"
+#include "ModelFitting/Models/ExtendedModel.h"
+#include "ModelFitting/Models/SersicKernel.h"
+#include "ModelFitting/Models/CompactSersicModel.h"
+#include "ModelFitting/Models/CompactExponentialModel.h"
+#include "TestHelper.h"
+
+using namespace ModelFitting;
+
+namespace {
+
+// Largest difference between the two images, relative to the brightest pixel
+double compareImages(const TestImage& a, const TestImage& b) {
+  double max_value = 0., max_diff = 0.;
+  for (std::size_t i = 0; i < a.data.size(); ++i) {
+    max_value = std::max(max_value, std::abs(a.data[i]));
+    max_diff = std::max(max_diff, std::abs(a.data[i] - b.data[i]));
+  }
+  return max_diff / max_value;
+}
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (SersicKernel_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Accuracy_test) {
+  // Points along a line, from the centre up to past the cut radius, some at the centre itself
+  std::vector<float> xs, ys;
+  for (int i = 0; i < 2000; ++i) {
+    xs.push_back(i * 0.025f);
+    ys.push_back(i * -0.01f);
+  }
+  xs.push_back(0.f);
+  ys.push_back(0.f);
+  std::vector<float> out(xs.size());
+
+  for (float n : {0.5f, 1.f, 2.f, 4.f, 6.f, 8.f}) {
+    // Usual approximation of the Sersic b_n
+    float k = 2.f * n - 1.f / 3.f;
+    SersicKernel kernel {{1.2f, -0.3f, 0.4f, 0.9f}, 5.f, k, n, 2000.f};
+    kernel.evaluate(xs.data(), ys.data(), xs.size(), out.data());
+
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      double x2 = 1.2 * xs[i] - 0.3 * ys[i];
+      double y2 = 0.4 * xs[i] + 0.9 * ys[i];
+      double r_sqr = x2 * x2 + y2 * y2;
+      if (r_sqr >= 2000.) {
+        BOOST_CHECK_EQUAL(out[i], 0.f);
+        continue;
+      }
+      double exponent = k * std::pow(std::sqrt(r_sqr), 1. / n);
+      double expected = 5. * std::exp(-exponent);
+      if (expected < 1e-30) {
+        continue;
+      }
+      BOOST_CHECK_SMALL(std::abs(out[i] - expected) / expected, 1e-6 * std::max(1., exponent));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Rasterization_test) {
+  auto i0 = std::make_shared<ManualParameter>(1.);
+  auto k = std::make_shared<ManualParameter>(1.2);
+  auto x_scale = std::make_shared<ManualParameter>(1.5);
+  auto y_scale = std::make_shared<ManualParameter>(.7);
+  auto rotation = std::make_shared<ManualParameter>(.4);
+  auto x = std::make_shared<ManualParameter>(20.);
+  auto y = std::make_shared<ManualParameter>(20.);
+  auto flux = std::make_shared<ManualParameter>(100.);
+  std::tuple<double, double, double, double> jacobian {1., 0.1, 0., 0.9};
+
+  for (double n_value : {0.5, 1., 2.5, 4., 8.}) {
+    auto n = std::make_shared<ManualParameter>(n_value);
+    CompactSersicModel<TestImage> model(3., i0, k, n, x_scale, y_scale, rotation, 41, 41, x, y, flux, jacobian);
+    auto batched = model.getRasterizedImage(1., 41, 41);
+    model.setVectorized(false);
+    auto scalar = model.getRasterizedImage(1., 41, 41);
+    BOOST_CHECK_SMALL(compareImages(batched, scalar), 1e-4);
+  }
+
+  CompactExponentialModel<TestImage> model(3., i0, k, x_scale, y_scale, rotation, 41, 41, x, y, flux, jacobian);
+  auto batched = model.getRasterizedImage(1., 41, 41);
+  model.setVectorized(false);
+  auto scalar = model.getRasterizedImage(1., 41, 41);
+  BOOST_CHECK_SMALL(compareImages(batched, scalar), 1e-4);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -25,8 +25,10 @@
 #define _TEST_HELPER_H
 
 #include <vector>
+#include <memory>
 #include <cmath>
 #include "ModelFitting/Models/ModelComponent.h"
+#include "ModelFitting/Image/ImageTraits.h"
 
 namespace ModelFitting {
 
@@ -96,6 +98,106 @@ private:
 };
 
 
+/**
+ * Minimal image type, with a bilinear addImageToImage
+ */
+struct TestImage {
+  std::size_t width = 0, height = 0;
+  std::vector<double> data;
+};
+
+template <>
+struct ImageTraits<TestImage> {
+  using iterator = std::vector<double>::iterator;
+
+  static TestImage factory(std::size_t width, std::size_t height) {
+    return {width, height, std::vector<double>(width * height, 0.)};
+  }
+
+  static std::size_t width(const TestImage& image) {
+    return image.width;
+  }
+
+  static std::size_t height(const TestImage& image) {
+    return image.height;
+  }
+
+  static double& at(TestImage& image, std::size_t x, std::size_t y) {
+    return image.data[x + y * image.width];
+  }
+
+  static double at(const TestImage& image, std::size_t x, std::size_t y) {
+    return image.data[x + y * image.width];
+  }
+
+  static iterator begin(TestImage& image) {
+    return image.data.begin();
+  }
+
+  static iterator end(TestImage& image) {
+    return image.data.end();
+  }
+
+  static void addImageToImage(TestImage& target, const TestImage& source, double scale, double x, double y) {
+    for (std::size_t ty = 0; ty < target.height; ++ty) {
+      double sy = (ty + 0.5 - y) / scale + source.height / 2. - 0.5;
+      int iy = std::floor(sy);
+      double fy = sy - iy;
+      for (std::size_t tx = 0; tx < target.width; ++tx) {
+        double sx = (tx + 0.5 - x) / scale + source.width / 2. - 0.5;
+        int ix = std::floor(sx);
+        double fx = sx - ix;
+        if (ix < 0 || iy < 0 || ix + 1 >= int(source.width) || iy + 1 >= int(source.height)) {
+          continue;
+        }
+        double v = (1 - fx) * (1 - fy) * at(source, ix, iy) + fx * (1 - fy) * at(source, ix + 1, iy) +
+                   (1 - fx) * fy * at(source, ix, iy + 1) + fx * fy * at(source, ix + 1, iy + 1);
+        at(target, tx, ty) += v / (scale * scale);
+      }
+    }
+  }
+};
+
+/**
+ * Gaussian kernel, which does not convolve the extended models, but counts into
+ * convolutions how many times it is asked to
+ */
+class TestPsf {
+public:
+  explicit TestPsf(std::shared_ptr<std::size_t> convolutions = std::make_shared<std::size_t>(0))
+    : m_kernel(ImageTraits<TestImage>::factory(7, 7)), m_convolutions(convolutions) {
+    for (int y = 0; y < 7; ++y) {
+      for (int x = 0; x < 7; ++x) {
+        ImageTraits<TestImage>::at(m_kernel, x, y) = std::exp(-((x - 3) * (x - 3) + (y - 3) * (y - 3)) / 2.);
+      }
+    }
+  }
+
+  double getPixelScale() const {
+    return 1.;
+  }
+
+  std::size_t getSize() const {
+    return 7;
+  }
+
+  TestImage getScaledKernel(double scale) const {
+    auto kernel = m_kernel;
+    for (auto& v : kernel.data) {
+      v *= scale;
+    }
+    return kernel;
+  }
+
+  void convolve(TestImage&) const {
+    ++*m_convolutions;
+  }
+
+private:
+  TestImage m_kernel;
+  std::shared_ptr<std::size_t> m_convolutions;
+};
+
 /**
  * Helper function to raster a model component into a vector of doubles.
  * It will use a sampling based approach, if there is any, *or* smooth otherwise.
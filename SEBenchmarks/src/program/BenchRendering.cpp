@@ -22,6 +22,10 @@
  */
 
 
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
 #include <boost/timer/timer.hpp>
 
 #include "ElementsKernel/ProgramHeaders.h"
@@ -47,10 +51,31 @@
 
 #include "SEImplementation/Image/ImageInterfaceTraits.h"
 #include "SEImplementation/Image/ImagePsf.h"
+#include "SEImplementation/Image/ImagePool.h"
 
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
 
+// Every heap allocation made by the program is counted, so the benchmark can report how many a model
+// evaluation does
+static std::atomic<std::size_t> s_allocation_count {0};
+
+void* operator new(std::size_t size) {
+  ++s_allocation_count;
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
 using namespace ModelFitting;
 using namespace SourceXtractor;
 
@@ -338,6 +363,48 @@ public:
   }
 
 
+  FrameModel<ImagePsf, ImageInterfaceTypePtr> makeConvolvedCompactSersicFrameModel(
+      std::shared_ptr<ManualParameter> i0) {
+    std::vector<ConstantModel> constant_models;
+    std::vector<std::shared_ptr<ModelFitting::ExtendedModel<ImageInterfaceTypePtr>>> extended_models;
+    std::vector<PointModel> point_models;
+
+    auto x_param = std::make_shared<ManualParameter>(32);
+    auto y_param = std::make_shared<ManualParameter>(32);
+    auto xs = std::make_shared<ManualParameter>(1);
+    auto ys = std::make_shared<ManualParameter>(1);
+    auto rot = std::make_shared<ManualParameter>(0);
+    auto n = std::make_shared<ManualParameter>(4);
+    auto k = std::make_shared<ManualParameter>(10);
+    auto flux = std::make_shared<ManualParameter>(100000);
+
+    extended_models.emplace_back(std::make_shared<ModelFitting::CompactSersicModel<ImageInterfaceTypePtr>>(
+        3.0, i0, k, n,
+        xs, ys, rot, 32, 32, x_param, y_param, flux, std::make_tuple(1, 0, 0, 1)));
+
+    // Gaussian PSF
+    int psf_size = 15;
+    auto kernel = VectorImage<SeFloat>::create(psf_size, psf_size);
+    for (int y = 0; y < psf_size; ++y) {
+      for (int x = 0; x < psf_size; ++x) {
+        double dx = x - psf_size / 2, dy = y - psf_size / 2;
+        kernel->at(x, y) = std::exp(-(dx * dx + dy * dy) / 8.);
+      }
+    }
+
+    double pixel_scale = 1.0f;
+    int image_size = 64;
+
+    return FrameModel<ImagePsf, ImageInterfaceTypePtr> {
+      pixel_scale,
+      (std::size_t) image_size, (std::size_t) image_size,
+      std::move(constant_models),
+      std::move(point_models),
+      std::move(extended_models),
+      ImagePsf{1., kernel}
+    };
+  }
+
   template<typename T>
   std::shared_ptr<VectorImage<SeFloat>> measureRasterToImage(int iterations, T& frame_model) {
     auto image = VectorImage<SeFloat>::create(256, 256);
@@ -349,6 +416,56 @@ public:
     return image;
   }
 
+  /**
+   * Evaluates the frame model as a fit iteration does, changing a shape parameter each time so the
+   * model is rasterized, convolved and placed again.
+   * @return
+   *    The number of heap allocations done per evaluation, once past the first ones
+   */
+  template<typename T>
+  double measureAllocations(int iterations, T& frame_model, ManualParameter& parameter) {
+    auto evaluate = [&frame_model, &parameter]() {
+      parameter.setValue(parameter.getValue() * 1.0001);
+      frame_model.getImage();
+    };
+
+    // The first evaluations fill the caches
+    for (int i = 0; i < 3; ++i) {
+      evaluate();
+    }
+
+    std::size_t before = s_allocation_count;
+    for (int i = 0; i < iterations; i++) {
+      evaluate();
+    }
+    return double(s_allocation_count - before) / iterations;
+  }
+
+  /**
+   * Rasterizes a compact Sersic model of index @p n, on its own, with either the batched or the
+   * scalar rasterization.
+   */
+  void measureCompactSersic(int iterations, double n, bool vectorized) {
+    auto x_param = std::make_shared<ManualParameter>(128);
+    auto y_param = std::make_shared<ManualParameter>(128);
+    auto xs = std::make_shared<ManualParameter>(1);
+    auto ys = std::make_shared<ManualParameter>(1);
+    auto rot = std::make_shared<ManualParameter>(0);
+    auto n_param = std::make_shared<ManualParameter>(n);
+    auto k = std::make_shared<ManualParameter>(10);
+    auto i0 = std::make_shared<ManualParameter>(1000);
+    auto flux = std::make_shared<ManualParameter>(100000);
+
+    ModelFitting::CompactSersicModel<ImageInterfaceTypePtr> model {
+      3.0, i0, k, n_param, xs, ys, rot, 256, 256, x_param, y_param, flux, std::make_tuple(1, 0, 0, 1)
+    };
+    model.setVectorized(vectorized);
+
+    for (int i = 0; i < iterations; i++) {
+      model.getRasterizedImage(1., 255, 255);
+    }
+  }
+
   Elements::ExitCode mainMethod(std::map<std::string, po::variable_value>& args) override {
     Elements::Logging logger = Elements::Logging::getLogger("BenchRendering");
 
@@ -398,6 +515,35 @@ public:
       measureRasterToImage(iterations, compact_frame_model);
     }
 
+    for (double n : {1., 2., 4., 6., 8.}) {
+      logger.info() << "Testing compact Sersic model rasterization with n=" << n << ", batched";
+      {
+        boost::timer::auto_cpu_timer t;
+        measureCompactSersic(iterations, n, true);
+      }
+      logger.info() << "Testing compact Sersic model rasterization with n=" << n << ", scalar";
+      {
+        boost::timer::auto_cpu_timer t;
+        measureCompactSersic(iterations, n, false);
+      }
+    }
+
+    logger.info() << "Counting allocations with a convolved compact Sersic model";
+    {
+      auto i0 = std::make_shared<ManualParameter>(1000);
+      auto frame_model = makeConvolvedCompactSersicFrameModel(i0);
+      auto allocations = measureAllocations(iterations, frame_model, *i0);
+      logger.info() << "Without image pool: " << allocations << " allocations per evaluation";
+    }
+    {
+      auto i0 = std::make_shared<ManualParameter>(1000);
+      auto frame_model = makeConvolvedCompactSersicFrameModel(i0);
+      ImagePool pool;
+      ImagePool::Scope pool_scope(pool);
+      auto allocations = measureAllocations(iterations, frame_model, *i0);
+      logger.info() << "With image pool: " << allocations << " allocations per evaluation ("
+                    << pool.size() << " pooled images)";
+    }
     return Elements::ExitCode::OK;
   }
 
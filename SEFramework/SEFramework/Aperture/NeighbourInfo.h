@@ -28,6 +28,7 @@
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEUtils/PixelCoordinate.h"
+#include "SEUtils/PixelRunList.h"
 
 namespace SourceXtractor {
 
@@ -36,7 +37,7 @@ public:
   virtual ~NeighbourInfo() = default;
 
   NeighbourInfo(const PixelCoordinate &min_pixel, const PixelCoordinate &max_pixel,
-                const std::vector<PixelCoordinate> &pixel_list,
+                const PixelRunList &pixel_list,
                 const std::shared_ptr<Image<SeFloat>> &threshold_image);
 
 
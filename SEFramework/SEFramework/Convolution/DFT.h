@@ -26,6 +26,7 @@
 #include "AlexandriaKernel/memory_tools.h"
 #include "SEFramework/FFT/FFT.h"
 #include "SEFramework/FFT/FFTHelper.h"
+#include "SEFramework/FFT/FFTKernelCache.h"
 #include "SEFramework/Image/MirrorImage.h"
 #include "SEFramework/Image/PaddedImage.h"
 #include "SEFramework/Image/RecenterImage.h"
@@ -59,7 +60,9 @@ public:
 
   private:
     int m_padded_width, m_padded_height, m_transform_padding;
-    std::vector<real_t> m_kernel_transform, m_work_area;
+    // Shared with the other contexts that use the same kernel and size, through FFTKernelCache
+    typename FFTKernelCache<T>::transform_ptr_t m_kernel_transform;
+    std::vector<real_t> m_work_area;
     typename FFT<T>::plan_ptr_t m_fwd_plan, m_inv_plan;
 
     friend class DFTConvolution<T, TPadding>;
@@ -102,6 +105,9 @@ public:
    *    before transformation
    * @return
    *    A context than can be used by `convolve` to avoid re-computing the kernel multiple times
+   * @note
+   *    The kernel transform is looked up in FFTKernelCache first, so preparing several contexts for the
+   *    same kernel and padded size only transforms the kernel once
    */
   std::unique_ptr<ConvolutionContext> prepare(const std::shared_ptr<const Image<T>>& model_ptr) const {
     auto context = Euclid::make_unique<ConvolutionContext>();
@@ -119,8 +125,7 @@ public:
     context->m_transform_padding = 2 * (context->m_padded_width / 2 + 1) - context->m_padded_width;
     int work_area_size = context->m_padded_height * (context->m_padded_width / 2 + 1) * 2;
 
-    // Pre-allocate buffers for the transformations
-    context->m_kernel_transform.resize(work_area_size);
+    // Pre-allocate the buffer for the transformations
     context->m_work_area.resize(work_area_size);
 
     // Since we already have the buffers, get the plans too
@@ -129,9 +134,16 @@ public:
     context->m_inv_plan = FFT<T>::createInversePlan(context->m_padded_width, context->m_padded_height,
                                                     context->m_work_area);
 
-    // Transform here the kernel into frequency space
-    padKernel(*context);
-    FFT<T>::executeForward(context->m_fwd_plan, context->m_kernel_transform);
+    // Transform here the kernel into frequency space, unless it has been done already
+    std::vector<T> kernel_pixels;
+    dumpKernel(kernel_pixels);
+    context->m_kernel_transform = FFTKernelCache<T>::getInstance().get(
+      m_kernel->getWidth(), m_kernel->getHeight(), kernel_pixels, context->m_padded_width, context->m_padded_height,
+      [this, &context, work_area_size](std::vector<T>& kernel_transform) {
+        kernel_transform.resize(work_area_size);
+        padKernel(*context, kernel_transform);
+        FFT<T>::executeForward(context->m_fwd_plan, kernel_transform);
+      });
 
     return context;
   }
@@ -155,19 +167,16 @@ public:
     assert(image_ptr->getWidth() <= context->m_padded_width);
     assert(image_ptr->getHeight() <= context->m_padded_height);
 
-    // Padded image
-    auto padded = TPadding::create(image_ptr,
-                                   context->m_padded_width, context->m_padded_height,
-                                   std::forward<Args>(padding_args)...);
-
-    // Create a matrix with the padded image
-    dumpImage(padded, context->m_work_area);
+    // Pad the image straight into the work area, so no intermediate image is allocated
+    TPadding::copyPadded(*image_ptr, context->m_padded_width, context->m_padded_height,
+                         context->m_work_area.data(), context->m_padded_width + context->m_transform_padding,
+                         std::forward<Args>(padding_args)...);
 
     // Transform the image
     FFT<T>::executeForward(context->m_fwd_plan, context->m_work_area);
 
     // Multiply the two DFT
-    complex_t* kernel_complex = reinterpret_cast<complex_t*>(context->m_kernel_transform.data());
+    const complex_t* kernel_complex = reinterpret_cast<const complex_t*>(context->m_kernel_transform->data());
     complex_t* img_complex    = reinterpret_cast<complex_t*>(context->m_work_area.data());
     size_t     ncomplex       = (context->m_padded_width / 2 + 1) * context->m_padded_height;
     for (size_t i = 0; i < ncomplex; ++i) {
@@ -220,14 +229,24 @@ public:
   }
 
 protected:
-  void padKernel(ConvolutionContext& context) const {
+  void padKernel(const ConvolutionContext& context, std::vector<T>& kernel_transform) const {
     auto padded = PaddedImage<T>::create(m_kernel, context.m_padded_width, context.m_padded_height);
     auto center = PixelCoordinate{context.m_padded_width / 2, context.m_padded_height / 2};
     if (context.m_padded_width % 2 == 0) center.m_x--;
     if (context.m_padded_height % 2 == 0) center.m_y--;
     auto recenter = RecenterImage<T>::create(padded, center);
 
-    dumpImage(recenter, context.m_kernel_transform);
+    dumpImage(recenter, kernel_transform);
+  }
+
+  void dumpKernel(std::vector<T>& pixels) const {
+    const auto chunk = m_kernel->getChunk(0, 0, m_kernel->getWidth(), m_kernel->getHeight());
+    pixels.resize(m_kernel->getWidth() * m_kernel->getHeight());
+    for (int y = 0; y < m_kernel->getHeight(); ++y) {
+      for (int x = 0; x < m_kernel->getWidth(); ++x) {
+        pixels[x + y * m_kernel->getWidth()] = chunk->getValue(x, y);
+      }
+    }
   }
 
   void dumpImage(const std::shared_ptr<const Image<T>> &img, std::vector<T>& work_area) const {
@@ -26,6 +26,7 @@
 #include <complex>
 #include <fftw3.h>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace SourceXtractor {
@@ -48,12 +49,16 @@ struct FFTTraits<float> {
   typedef decltype(fftwf_destroy_plan)    func_destroy_plan_t;
   typedef decltype(fftwf_execute_dft_r2c) func_execute_fwd_t;
   typedef decltype(fftwf_execute_dft_c2r) func_execute_inv_t;
+  typedef decltype(fftwf_export_wisdom_to_string)   func_export_wisdom_t;
+  typedef decltype(fftwf_import_wisdom_from_string) func_import_wisdom_t;
 
   static func_plan_fwd_t*     func_plan_fwd;
   static func_plan_inv_t*     func_plan_inv;
   static func_destroy_plan_t* func_destroy_plan;
   static func_execute_fwd_t*  func_execute_fwd;
   static func_execute_inv_t*  func_execute_inv;
+  static func_export_wisdom_t* func_export_wisdom;
+  static func_import_wisdom_t* func_import_wisdom;
 };
 
 /**
@@ -68,12 +73,16 @@ struct FFTTraits<double> {
   typedef decltype(fftw_destroy_plan)    func_destroy_plan_t;
   typedef decltype(fftw_execute_dft_r2c) func_execute_fwd_t;
   typedef decltype(fftw_execute_dft_c2r) func_execute_inv_t;
+  typedef decltype(fftw_export_wisdom_to_string)   func_export_wisdom_t;
+  typedef decltype(fftw_import_wisdom_from_string) func_import_wisdom_t;
 
   static func_plan_fwd_t*     func_plan_fwd;
   static func_plan_inv_t*     func_plan_inv;
   static func_destroy_plan_t* func_destroy_plan;
   static func_execute_fwd_t*  func_execute_fwd;
   static func_execute_inv_t*  func_execute_inv;
+  static func_export_wisdom_t* func_export_wisdom;
+  static func_import_wisdom_t* func_import_wisdom;
 };
 
 /**
@@ -103,6 +112,8 @@ struct FFT {
    *    If the memory area is not big enough, createForwardPlan will resize the vector.
    * @return
    *    A pointer to a plan fit to the given dimensions. It can be safely reused between threads.
+   * @note
+   *    Looking up a plan that already exists does not take any lock
    */
   static plan_ptr_t createForwardPlan(int width, int height, std::vector<T>& inout);
 
@@ -118,6 +129,8 @@ struct FFT {
    *    If the memory area is not big enough, createInversePlan will resize the vector.
    * @return
    *    A pointer to a plan fit to the given dimensions. It can be safely reused between threads.
+   * @note
+   *    Looking up a plan that already exists does not take any lock
    */
   static plan_ptr_t createInversePlan(int width, int height, std::vector<T>& inout);
 
@@ -154,6 +167,34 @@ struct FFT {
  */
 int fftRoundDimension(int size);
 
+/**
+ * How much effort FFTW puts on finding a fast plan. Anything other than ESTIMATE runs, and times,
+ * several transforms the first time a size is seen, which only pays off when the same sizes are used
+ * many times (i.e. model fitting), or when the results are kept as wisdom for later runs.
+ * @see http://www.fftw.org/fftw3_doc/Planner-Flags.html
+ */
+enum class FFTPlanningRigor {
+  ESTIMATE, MEASURE, PATIENT
+};
+
+/**
+ * Set the planning rigor used for the plans created from now on
+ */
+void fftSetPlanningRigor(FFTPlanningRigor rigor);
+
+/**
+ * Load FFTW wisdom, for both float and double precision, from a file written by fftExportWisdom
+ * @return
+ *    false if the file could not be read, or its content was not accepted by FFTW
+ */
+bool fftImportWisdom(const std::string& path);
+
+/**
+ * Save the FFTW wisdom accumulated so far, for both float and double precision
+ * @throw Elements::Exception if the file can not be written
+ */
+void fftExportWisdom(const std::string& path);
+
 extern template struct FFT<float>;
 extern template struct FFT<double>;
 
@@ -0,0 +1,135 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FFTKernelCache.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEFRAMEWORK_FFT_FFTKERNELCACHE_H
+#define _SEFRAMEWORK_FFT_FFTKERNELCACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SourceXtractor {
+
+/**
+ * @class FFTKernelCache
+ * @brief Process wide cache of convolution kernel transforms
+ *
+ * @details
+ * DFTConvolution transforms its kernel once per prepared context, and model fitting prepares a context
+ * for each model of each source, on every iteration. Most of these share the same PSF and padded size,
+ * so the transforms are kept here and shared, read only, between all the contexts that need them.
+ *
+ * Kernels are identified by their pixel values, not by the image that holds them, so PSFs that are
+ * rebuilt for each source (i.e. down-sampled, or evaluated from a variable PSF at the same position)
+ * still hit the cache. The least recently used transforms are dropped when the memory limit is reached.
+ * Contexts still using a dropped transform keep it alive until they are destroyed.
+ *
+ * @tparam T
+ *  The pixel type
+ */
+template <typename T>
+class FFTKernelCache {
+public:
+  typedef std::shared_ptr<const std::vector<T>> transform_ptr_t;
+
+  struct Statistics {
+    std::uint64_t m_hits, m_misses, m_evictions;
+    std::size_t m_memory;
+  };
+
+  static FFTKernelCache& getInstance();
+
+  /**
+   * Look up the transform of a kernel padded to the given size, computing and caching it if it is missing
+   * @param kernel_width
+   * @param kernel_height
+   *    The kernel dimensions
+   * @param kernel
+   *    The kernel pixels, in row major order
+   * @param padded_width
+   * @param padded_height
+   *    The dimensions of the transform
+   * @param compute
+   *    Fills the transform of the kernel. Called without holding any lock, so several threads may
+   *    compute the same transform at the same time. Only the first one to finish is kept.
+   * @return
+   *    The transform. It must not be modified, as it is shared.
+   */
+  transform_ptr_t get(int kernel_width, int kernel_height, const std::vector<T>& kernel,
+                      int padded_width, int padded_height, const std::function<void(std::vector<T>&)>& compute);
+
+  /**
+   * Set the maximum memory used by the cached transforms, dropping the least recently used ones
+   * if needed. 0 disables the cache.
+   */
+  void setMaxMemory(std::size_t bytes);
+
+  Statistics getStatistics() const;
+
+  /// Drop all the cached transforms
+  void clear();
+
+private:
+  struct Entry {
+    std::size_t m_hash;
+    int m_kernel_width, m_kernel_height, m_padded_width, m_padded_height;
+    std::vector<T> m_kernel;
+    transform_ptr_t m_transform;
+
+    std::size_t getMemory() const {
+      return (m_kernel.size() + m_transform->size()) * sizeof(T);
+    }
+  };
+
+  typedef std::list<Entry> lru_list_t;
+
+  FFTKernelCache() = default;
+
+  typename lru_list_t::iterator find(std::size_t hash, int kernel_width, int kernel_height,
+                                     const std::vector<T>& kernel, int padded_width, int padded_height);
+  void evict(std::size_t max_memory);
+
+  mutable std::mutex m_mutex;
+  std::size_t m_max_memory = 256 * 1024 * 1024;
+  std::size_t m_memory = 0;
+  std::uint64_t m_hits = 0, m_misses = 0, m_evictions = 0;
+
+  // Most recently used first
+  lru_list_t m_lru;
+  std::unordered_multimap<std::size_t, typename lru_list_t::iterator> m_index;
+};
+
+/**
+ * Set the maximum memory used for caching kernel transforms, for each of float and double precision
+ */
+void fftSetKernelCacheSize(std::size_t bytes);
+
+extern template class FFTKernelCache<float>;
+extern template class FFTKernelCache<double>;
+
+}  // namespace SourceXtractor
+
+#endif  // _SEFRAMEWORK_FFT_FFTKERNELCACHE_H
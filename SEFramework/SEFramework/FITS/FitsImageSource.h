@@ -89,6 +89,10 @@ public:
 
   void setLayer(int layer);
 
+  int getLayer() const {
+    return m_current_layer;
+  }
+
   std::shared_ptr<ImageTile> getImageTile(int x, int y, int width, int height) const override;
 
   void saveTile(ImageTile& tile) override;
@@ -118,17 +122,18 @@ public:
 
   void setMetadata(const std::string& key, const MetadataEntry& value) override;
 
-private:
+protected:
   void switchHdu(fitsfile *fptr, int hdu_number) const;
 
-  int getDataType() const;
-
-  int getImageType() const;
-
   std::string m_filename;
   std::shared_ptr<FileManager> m_file_manager;
   std::shared_ptr<FileHandler> m_handler;
 
+private:
+  int getDataType() const;
+
+  int getImageType() const;
+
   int m_hdu_number;
 
   int m_width;
@@ -0,0 +1,71 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MmapFitsImageSource.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEFRAMEWORK_FITS_MMAPFITSIMAGESOURCE_H_
+#define _SEFRAMEWORK_FITS_MMAPFITSIMAGESOURCE_H_
+
+#include "SEFramework/FITS/FitsImageSource.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class MmapFitsImageSource
+ * @brief
+ *    FitsImageSource that serves tiles straight from a read-only memory map of the HDU data
+ * @details
+ *    Only used when the pixels can be copied as they are stored, apart from the byte order:
+ *    the HDU is not compressed, there is no BSCALE/BZERO scaling, the on-disk BITPIX matches the requested
+ *    type, and the file is a plain file on disk, named without any extended file name syntax.
+ *    Otherwise, it behaves exactly like FitsImageSource.
+ *    Tiles are still copied out of the map, but re-reading an evicted tile costs a copy from the page
+ *    cache, instead of a cfitsio call.
+ *    Writes still go through cfitsio.
+ */
+class MmapFitsImageSource : public FitsImageSource {
+public:
+
+  explicit MmapFitsImageSource(const std::string& filename, int hdu_number = 0,
+                               ImageTile::ImageType image_type = ImageTile::AutoType,
+                               std::shared_ptr<FileManager> manager = FileManager::getDefault());
+
+  virtual ~MmapFitsImageSource();
+
+  std::shared_ptr<ImageTile> getImageTile(int x, int y, int width, int height) const override;
+
+  /// True if the tiles are served from the memory map
+  bool isMapped() const {
+    return m_map != nullptr;
+  }
+
+private:
+  void tryMap();
+
+  void* m_map;
+  std::size_t m_map_size;
+  // First pixel of the data segment, within the map
+  const char* m_data;
+  std::size_t m_element_size;
+};
+
+}
+
+#endif /* _SEFRAMEWORK_FITS_MMAPFITSIMAGESOURCE_H_ */
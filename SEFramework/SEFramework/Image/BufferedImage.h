@@ -57,6 +57,8 @@ public:
 
   std::shared_ptr<ImageChunk<T>> getChunk(int x, int y, int width, int height) const override;
 
+  void prefetch(int x, int y, int width, int height) const override;
+
 protected:
   std::shared_ptr<const ImageSource> m_source;
   std::shared_ptr<TileManager> m_tile_manager;
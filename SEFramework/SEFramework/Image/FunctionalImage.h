@@ -80,6 +80,10 @@ public:
     return chunk;
   }
 
+  void prefetch(int x, int y, int width, int height) const final {
+    m_img->prefetch(x, y, width, height);
+  }
+
 private:
   std::shared_ptr<const Image<I>> m_img;
   FunctorType m_functor;
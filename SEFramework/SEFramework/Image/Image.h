@@ -63,6 +63,13 @@ public:
 
   virtual std::shared_ptr<ImageChunk<T>> getChunk(int x, int y, int width, int height) const = 0;
 
+  /**
+   * Hint that the given region is going to be requested soon, so images backed by slow storage
+   * can start loading it in the background. Images that wrap others should forward it.
+   * It does nothing by default, and it is always safe to ignore.
+   */
+  virtual void prefetch(int /*x*/, int /*y*/, int /*width*/, int /*height*/) const {}
+
   std::shared_ptr<ImageChunk<T>> getChunk(const PixelCoordinate& start,
                                           const PixelCoordinate& end) const {
     assert(isInside(start.m_x, start.m_y) && isInside(end.m_x, end.m_y));
@@ -128,6 +128,10 @@ public:
     return m_image->getChunk(x, y, width, height);
   };
 
+  void prefetch(int x, int y, int width, int height) const override {
+    m_image->prefetch(x, y, width, height);
+  }
+
 private:
   const Image<T>* m_image;
   std::shared_ptr<const Image<T>> m_keep_alive;
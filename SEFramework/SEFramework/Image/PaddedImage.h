@@ -26,6 +26,7 @@
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Image/ImageChunk.h"
 #include "SEFramework/Image/ImageAccessor.h"
+#include "SEFramework/Image/VectorImage.h"
 
 namespace SourceXtractor {
 
@@ -117,7 +118,36 @@ public:
     return chunk;
   }
 
+  /**
+   * Writes the pixels img would have once padded to width x height into buffer, without creating
+   * the padded image nor any chunk when img is a VectorImage
+   * @param stride
+   *    Distance between the first pixels of two consecutive rows in buffer
+   */
+  static void copyPadded(const Image<T>& img, int width, int height, T* buffer, int stride) {
+    if (auto vector_image = dynamic_cast<const VectorImage<T>*>(&img)) {
+      copyPaddedFrom(*vector_image, width, height, buffer, stride);
+    }
+    else {
+      copyPaddedFrom(*img.getChunk(0, 0, img.getWidth(), img.getHeight()), width, height, buffer, stride);
+    }
+  }
+
 private:
+  template<typename Source>
+  static void copyPaddedFrom(const Source& source, int width, int height, T* buffer, int stride) {
+    auto img_w = source.getWidth();
+    auto img_h = source.getHeight();
+    auto lpad = (width - img_w) / 2;
+    auto tpad = (height - img_h) / 2;
+    for (int iy = 0; iy < height; ++iy) {
+      auto img_y = CoordinateInterpolation(img_h, iy - tpad);
+      for (int ix = 0; ix < width; ++ix) {
+        buffer[ix + iy * stride] = source.getValue(CoordinateInterpolation(img_w, ix - lpad), img_y);
+      }
+    }
+  }
+
   std::shared_ptr<const Image<T>> m_img;
   int m_width, m_height;
   int m_lpad, m_tpad;
@@ -179,7 +209,41 @@ public:
     return chunk;
   }
 
+  /**
+   * Writes the pixels img would have once padded to width x height into buffer, without creating
+   * the padded image nor any chunk when img is a VectorImage
+   * @param stride
+   *    Distance between the first pixels of two consecutive rows in buffer
+   */
+  static void copyPadded(const Image<T>& img, int width, int height, T* buffer, int stride, T default_value = {}) {
+    if (auto vector_image = dynamic_cast<const VectorImage<T>*>(&img)) {
+      copyPaddedFrom(*vector_image, width, height, buffer, stride, default_value);
+    }
+    else {
+      copyPaddedFrom(*img.getChunk(0, 0, img.getWidth(), img.getHeight()), width, height, buffer, stride,
+                     default_value);
+    }
+  }
+
 private:
+  template<typename Source>
+  static void copyPaddedFrom(const Source& source, int width, int height, T* buffer, int stride, T default_value) {
+    auto img_w = source.getWidth();
+    auto img_h = source.getHeight();
+    auto lpad = (width - img_w) / 2;
+    auto tpad = (height - img_h) / 2;
+    for (int iy = 0; iy < height; ++iy) {
+      for (int ix = 0; ix < width; ++ix) {
+        if (ix < lpad || iy < tpad || ix >= img_w + lpad || iy >= img_h + tpad) {
+          buffer[ix + iy * stride] = default_value;
+        }
+        else {
+          buffer[ix + iy * stride] = source.getValue(ix - lpad, iy - tpad);
+        }
+      }
+    }
+  }
+
   std::shared_ptr<const Image<T>> m_img;
   int m_width, m_height;
   int m_lpad, m_tpad;
@@ -85,6 +85,11 @@ public:
     return UniversalImageChunk<T>::create(std::move(new_chunk_data), width, height);
   }
 
+  void prefetch(int x, int y, int width, int height) const override {
+    m_image_a->prefetch(x, y, width, height);
+    m_image_b->prefetch(x, y, width, height);
+  }
+
 private:
   std::shared_ptr<const Image<T>> m_image_a;
   std::shared_ptr<const Image<T>> m_image_b;
@@ -72,6 +72,10 @@ public:
     return m_image->getChunk(x + m_offset.m_x, y + m_offset.m_y, width, height);
   }
 
+  void prefetch(int x, int y, int width, int height) const override {
+    m_image->prefetch(x + m_offset.m_x, y + m_offset.m_y, width, height);
+  }
+
 private:
   std::shared_ptr<const Image<T>> m_image;
   PixelCoordinate m_offset;
@@ -84,6 +84,11 @@ public:
     return chunk;
   }
 
+  void prefetch(int x, int y, int width, int height) const override {
+    m_image->prefetch(x, y, width, height);
+    m_variance_map->prefetch(x, y, width, height);
+  }
+
 private:
   std::shared_ptr<const Image<T>> m_image, m_variance_map;
   T m_threshold_multiplier;
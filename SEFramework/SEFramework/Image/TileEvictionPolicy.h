@@ -0,0 +1,145 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * TileEvictionPolicy.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEFRAMEWORK_IMAGE_TILEEVICTIONPOLICY_H_
+#define _SEFRAMEWORK_IMAGE_TILEEVICTIONPOLICY_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "SEFramework/Image/TileKey.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class TileEvictionPolicy
+ * @brief
+ *    Decides which tile the TileManager should drop when it is over its memory limit
+ * @details
+ *    Hits are not notified to the policy, since they happen concurrently under a shared lock (or not
+ *    under a lock at all). Instead, the TileManager flags tiles as referenced when they are accessed,
+ *    and the policy can test (and clear) that flag when looking for a victim.
+ *    All methods are called with exclusive access to the owning shard.
+ */
+class TileEvictionPolicy {
+public:
+
+  enum class Type {
+    FIFO,  ///< Evict in insertion order, ignoring accesses
+    CLOCK, ///< Second chance: referenced tiles are skipped once
+    TWO_Q, ///< 2Q: tiles only reach the main queue if they are requested again after eviction
+  };
+
+  /// Returns true if the tile has been accessed since the last call, and clears the flag
+  typedef std::function<bool(const TileKey&)> ReferencedFunction;
+
+  static std::unique_ptr<TileEvictionPolicy> create(Type type);
+
+  virtual ~TileEvictionPolicy() = default;
+
+  /// A new tile has been added to the cache
+  virtual void insert(const TileKey& key) = 0;
+
+  /// Pick a victim, which is forgotten by the policy. Must not be called when empty.
+  virtual TileKey evict(const ReferencedFunction& referenced) = 0;
+
+  /// Forget all tiles, including any history
+  virtual void clear() = 0;
+
+  virtual bool empty() const = 0;
+};
+
+/**
+ * Plain first in, first out
+ */
+class FifoEvictionPolicy : public TileEvictionPolicy {
+public:
+  virtual ~FifoEvictionPolicy() = default;
+
+  void insert(const TileKey& key) override;
+  TileKey evict(const ReferencedFunction& referenced) override;
+  void clear() override;
+  bool empty() const override;
+
+private:
+  std::list<TileKey> m_queue;
+};
+
+/**
+ * CLOCK, implemented as a FIFO where referenced tiles are moved back to the head instead of being evicted
+ */
+class ClockEvictionPolicy : public TileEvictionPolicy {
+public:
+  virtual ~ClockEvictionPolicy() = default;
+
+  void insert(const TileKey& key) override;
+  TileKey evict(const ReferencedFunction& referenced) override;
+  void clear() override;
+  bool empty() const override;
+
+private:
+  std::list<TileKey> m_queue;
+};
+
+/**
+ * Simplified 2Q (Johnson & Shasha, 1994).
+ * New tiles enter a FIFO (A1in). When evicted from there, only their coordinates are remembered in
+ * a ghost FIFO (A1out). If a tile is loaded again while still remembered, it goes into the main queue (Am),
+ * managed with CLOCK. A single pass over a full image only cycles through A1in, so it can not flush
+ * the tiles that are being actively reused.
+ */
+class TwoQueueEvictionPolicy : public TileEvictionPolicy {
+public:
+  virtual ~TwoQueueEvictionPolicy() = default;
+
+  void insert(const TileKey& key) override;
+  TileKey evict(const ReferencedFunction& referenced) override;
+  void clear() override;
+  bool empty() const override;
+
+private:
+  // The ghost entries do not own the image source, so they do not extend its lifetime
+  struct GhostKey {
+    const ImageSource* m_source;
+    int m_tile_x, m_tile_y;
+
+    bool operator==(const GhostKey& other) const {
+      return m_source == other.m_source && m_tile_x == other.m_tile_x && m_tile_y == other.m_tile_y;
+    }
+  };
+
+  struct GhostKeyHash {
+    std::size_t operator()(const GhostKey& key) const;
+  };
+
+  void remember(const TileKey& key);
+
+  std::list<TileKey> m_a1in, m_am;
+  std::list<GhostKey> m_a1out;
+  std::unordered_map<GhostKey, std::list<GhostKey>::iterator, GhostKeyHash> m_a1out_map;
+};
+
+}
+
+#endif /* _SEFRAMEWORK_IMAGE_TILEEVICTIONPOLICY_H_ */
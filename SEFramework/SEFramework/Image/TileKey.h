@@ -0,0 +1,70 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * TileKey.h
+ *
+ *  Created on: Feb 23, 2018
+ *      Author: mschefer
+ */
+
+#ifndef _SEFRAMEWORK_IMAGE_TILEKEY_H_
+#define _SEFRAMEWORK_IMAGE_TILEKEY_H_
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <boost/functional/hash.hpp>
+
+#include "SEFramework/Image/ImageSource.h"
+
+namespace SourceXtractor {
+
+
+struct TileKey {
+  std::shared_ptr<const ImageSource> m_source;
+  int m_tile_x, m_tile_y;
+
+  bool operator==(const TileKey& other) const;
+
+  std::string getRepr() const;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const TileKey& tk) {
+  out << tk.getRepr();
+  return out;
+}
+
+}
+
+namespace std {
+
+template<>
+struct hash<SourceXtractor::TileKey> {
+  std::size_t operator()(const SourceXtractor::TileKey& key) const {
+    std::size_t local_hash = 0;
+    boost::hash_combine(local_hash, key.m_source);
+    boost::hash_combine(local_hash, key.m_tile_x);
+    boost::hash_combine(local_hash, key.m_tile_y);
+    return local_hash;
+  }
+};
+
+}
+
+
+#endif /* _SEFRAMEWORK_IMAGE_TILEKEY_H_ */
@@ -24,9 +24,14 @@
 #ifndef _SEFRAMEWORK_IMAGE_TILEMANAGER_H_
 #define _SEFRAMEWORK_IMAGE_TILEMANAGER_H_
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <thread>
-#include <list>
 #include <unordered_map>
 
 #include <boost/thread/shared_mutex.hpp>
@@ -35,43 +40,26 @@
 
 #include "SEFramework/Image/ImageTile.h"
 #include "SEFramework/Image/ImageSource.h"
+#include "SEFramework/Image/TileKey.h"
+#include "SEFramework/Image/TileEvictionPolicy.h"
 
 namespace SourceXtractor {
 
-
-struct TileKey {
-  std::shared_ptr<const ImageSource> m_source;
-  int m_tile_x, m_tile_y;
-
-  bool operator==(const TileKey& other) const;
-
-  std::string getRepr() const;
-};
-
-inline std::ostream& operator<<(std::ostream& out, const TileKey& tk) {
-  out << tk.getRepr();
-  return out;
-}
-
-}
-
-namespace std {
-
-template<>
-struct hash<SourceXtractor::TileKey> {
-  std::size_t operator()(const SourceXtractor::TileKey& key) const {
-    std::size_t local_hash = 0;
-    boost::hash_combine(local_hash, key.m_source);
-    boost::hash_combine(local_hash, key.m_tile_x);
-    boost::hash_combine(local_hash, key.m_tile_y);
-    return local_hash;
-  }
-};
-
-}
-
-namespace SourceXtractor {
-
+/**
+ * @class TileManager
+ * @brief
+ *    Cache of image tiles shared by all the BufferedImage instances
+ * @details
+ *    Tiles are distributed over a fixed number of shards, selected by the hash of the TileKey,
+ *    each one with its own lock, so threads working on different regions of the images do not
+ *    contend on a single mutex. On top, each thread keeps a tiny cache of the tiles it has used
+ *    most recently, so repeated lookups of the same tile skip the shared structures altogether.
+ *    The memory limit is global, but it is enforced approximately: the usage is tracked atomically,
+ *    and eviction happens shard by shard. Which tile is evicted within a shard is decided by
+ *    a TileEvictionPolicy.
+ *    Tiles can also be requested ahead of time with prefetch, in which case they are loaded by a
+ *    background thread while the caller keeps working on the tiles it already has.
+ */
 class TileManager {
 public:
 
@@ -79,14 +67,27 @@ public:
 
   virtual ~TileManager();
 
+  struct Statistics {
+    std::uint64_t m_hits, m_misses, m_evictions, m_prefetched;
+    long m_memory_used;
+  };
+
   // Actually not thread safe, call before starting the multi-threading
-  void setOptions(int tile_width, int tile_height, int max_memory);
+  void setOptions(int tile_width, int tile_height, int max_memory,
+                  TileEvictionPolicy::Type eviction_policy = TileEvictionPolicy::Type::TWO_Q);
 
   void flush();
 
   std::shared_ptr<ImageTile>
   getTileForPixel(int x, int y, std::shared_ptr<const ImageSource> source);
 
+  /**
+   * Queue the tiles covering the given region to be loaded by the background read-ahead thread.
+   * Tiles already in the cache are skipped, and requests are dropped if the queue is full,
+   * so this never blocks on I/O.
+   */
+  void prefetch(int x, int y, int width, int height, std::shared_ptr<const ImageSource> source);
+
   static std::shared_ptr<TileManager> getInstance();
 
   void saveAllTiles();
@@ -95,27 +96,85 @@ public:
 
   int getTileHeight() const;
 
+  /**
+   * Counters since the last call to setOptions
+   * @note
+   *    Hits are accumulated per thread and published in batches, so they may lag behind
+   */
+  Statistics getStatistics() const;
+
 private:
 
-  std::shared_ptr<ImageTile> tryTileFromCache(const TileKey& key);
+  static constexpr std::size_t s_shard_count = 32;
+
+  struct CachedTile {
+    explicit CachedTile(std::shared_ptr<ImageTile> tile) : m_tile(std::move(tile)), m_referenced(false) {}
+
+    std::shared_ptr<ImageTile> m_tile;
+    // Set on every access, consumed by the eviction policy
+    std::atomic<bool> m_referenced;
+  };
+
+  struct ThreadCache;
+
+  struct Shard {
+    std::unordered_map<TileKey, std::shared_ptr<CachedTile>> m_tile_map;
+    std::unique_ptr<TileEvictionPolicy> m_policy;
+    long m_memory_used = 0;
+    // Bumped every time a tile leaves the shard, invalidates the per-thread caches
+    std::atomic<unsigned long> m_generation{0};
+    boost::shared_mutex m_mutex;
+  };
+
+  static ThreadCache& getThreadCache();
+
+  std::shared_ptr<ImageTile> tryTileFromThreadCache(const ImageSource* source, int x, int y);
+
+  void putTileInThreadCache(const ImageSource* source, int x, int y, const Shard& shard,
+                            unsigned long generation, const std::shared_ptr<CachedTile>& cached) const;
+
+  void countHit();
 
-  std::shared_ptr<boost::mutex>& getMutexForImageSource(const ImageSource*);
+  void publishHits();
 
-  void removeTile(TileKey tile_key);
+  std::shared_ptr<CachedTile> tryTileFromCache(Shard& shard, const TileKey& key, unsigned long& generation);
 
-  void removeExtraTiles();
+  bool isTileCached(Shard& shard, const TileKey& key);
 
-  void addTile(TileKey key, std::shared_ptr<ImageTile> tile);
+  std::shared_ptr<CachedTile> loadTile(const TileKey& key, std::size_t shard_index,
+                                       unsigned long& generation, bool& loaded);
+
+  void prefetchLoop();
+
+  void stopPrefetching();
+
+  std::shared_ptr<boost::mutex> getMutexForImageSource(const ImageSource*);
+
+  void removeTile(Shard& shard, TileKey tile_key);
+
+  void removeExtraTiles(std::size_t shard_index);
+
+  void addTile(Shard& shard, TileKey key, std::shared_ptr<CachedTile> cached);
 
   int m_tile_width, m_tile_height;
   long m_max_memory;
-  long m_total_memory_used;
+  std::atomic<long> m_total_memory_used;
+  std::atomic<std::uint64_t> m_hits, m_misses, m_evictions, m_prefetched;
 
-  std::unordered_map<TileKey, std::shared_ptr<ImageTile>> m_tile_map;
-  std::unordered_map<const ImageSource*, std::shared_ptr<boost::mutex>> m_mutex_map;
-  std::list<TileKey> m_tile_list;
+  // Unique per instance, never reused, so the per-thread caches can tell managers apart
+  const unsigned long m_instance_id;
 
-  boost::shared_mutex m_mutex;
+  std::array<Shard, s_shard_count> m_shards;
+
+  std::unordered_map<const ImageSource*, std::shared_ptr<boost::mutex>> m_mutex_map;
+  boost::shared_mutex m_mutex_map_mutex;
+
+  // Read-ahead. The thread is only started on the first request.
+  std::deque<TileKey> m_prefetch_queue;
+  std::thread m_prefetch_thread;
+  std::mutex m_prefetch_mutex;
+  std::condition_variable m_prefetch_cv, m_prefetch_idle_cv;
+  bool m_prefetch_busy, m_prefetch_stop;
 };
 
 }
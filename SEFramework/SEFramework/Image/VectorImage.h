@@ -151,6 +151,14 @@ public:
     return *m_data;
   }
 
+  /**
+   * @return
+   *    True if a chunk obtained with getChunk() still refers to the pixel buffer
+   */
+  bool isDataShared() const {
+    return m_data.use_count() > 1;
+  }
+
   /**
    * @brief Destructor
    */
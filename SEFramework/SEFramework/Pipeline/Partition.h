@@ -68,6 +68,11 @@ public:
   void receiveSource(std::unique_ptr<SourceInterface> source) override;
   void receiveProcessSignal(const ProcessSourcesEvent& event) override;
 
+protected:
+  /// Applies all the steps to the source, without notifying anyone. Safe to call concurrently
+  /// as long as the steps are.
+  std::vector<std::unique_ptr<SourceInterface>> applySteps(std::unique_ptr<SourceInterface> source) const;
+
 private:
   std::vector<std::shared_ptr<PartitionStep>> m_steps;
 
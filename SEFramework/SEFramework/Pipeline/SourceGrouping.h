@@ -26,7 +26,10 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
+#include "SEUtils/PixelRectangle.h"
 #include "SEFramework/Pipeline/PipelineStage.h"
 #include "SEFramework/Source/SourceGroupFactory.h"
 #include "SEFramework/Source/SourceGroupInterface.h"
@@ -48,6 +51,17 @@ public:
 
   /// Determines if the given Source must be processed or not
   virtual bool mustBeProcessed(const SourceInterface& source) const = 0;
+
+  /**
+   * Allows skipping a group without looking at its sources.
+   * @param bounds
+   *    Contains the search regions (see GroupingCriteria::getSearchRegion) of all the sources of the group
+   * @return
+   *    false if none of those sources can be selected
+   */
+  virtual bool mayBeProcessed(const PixelRectangle& /*bounds*/) const {
+    return true;
+  }
 };
 
 /**
@@ -79,6 +93,18 @@ public:
 
   /// Return a set of used properties so they can be pre-fetched
   virtual std::set<PropertyId> requiredProperties() const { return {}; }
+
+  /**
+   * Gives a region of the detection image that contains the source and bounds its reach: two sources
+   * whose regions do not overlap must never be grouped together. SourceGrouping then only evaluates
+   * shouldGroup on sources with overlapping regions. An empty rectangle means the source is never grouped.
+   *
+   * @return
+   *    false if the source can not be bounded, then it is compared with all the others
+   */
+  virtual bool getSearchRegion(const SourceInterface& /*source*/, PixelRectangle& /*region*/) const {
+    return false;
+  }
 };
 
 /**
@@ -110,11 +136,56 @@ public:
   void receiveProcessSignal(const ProcessSourcesEvent& event) override;
 
 private:
+  struct SearchRegion {
+    bool bounded;
+    PixelRectangle rect;
+  };
+
+  struct OpenGroup;
+  using CellKey = std::pair<int, int>;
+
+  struct CellKeyHash {
+    std::size_t operator()(const CellKey& key) const {
+      return std::hash<long long>()((static_cast<long long>(key.first) << 32) ^ static_cast<unsigned>(key.second));
+    }
+  };
+
+  /// A source registered in a cell of the spatial index
+  struct IndexEntry {
+    OpenGroup* group;
+    PixelRectangle region;
+  };
+
+  struct OpenGroup {
+    std::unique_ptr<SourceGroupInterface> group;
+    std::list<OpenGroup>::iterator self;
+    unsigned long order;
+    /// Search region of each source, in the same order as the sources of the group
+    std::vector<SearchRegion> regions;
+    /// Cells where the sources are registered
+    std::vector<CellKey> cells;
+    /// Union of the regions, only meaningful if all of them are bounded and not empty
+    PixelRectangle bounds;
+    unsigned int unbounded, empty;
+  };
+
+  void addToGroup(OpenGroup& open_group, std::unique_ptr<SourceInterface> source, const SearchRegion& region);
+  void mergeGroups(OpenGroup& target, OpenGroup& other);
+  void removeFromIndex(OpenGroup& open_group);
+
   std::shared_ptr<GroupingCriteria> m_grouping_criteria;
   std::shared_ptr<SourceGroupFactory> m_group_factory;
-  std::list<std::unique_ptr<SourceGroupInterface>> m_source_groups;
   unsigned int m_hard_limit;
 
+  /// Open groups, in creation order
+  std::list<OpenGroup> m_source_groups;
+  unsigned long m_next_order;
+
+  /// Uniform grid over the search regions of the sources
+  std::unordered_map<CellKey, std::vector<IndexEntry>, CellKeyHash> m_index;
+  /// Groups with at least one unbounded source, which are candidates for every source
+  std::set<OpenGroup*> m_unbounded_groups;
+
 }; /* End of SourceGrouping class */
 
 
@@ -24,6 +24,10 @@
 #ifndef _SEIMPLEMENTATION_PSF_VARIABLEPSF_H_
 #define _SEIMPLEMENTATION_PSF_VARIABLEPSF_H_
 
+#include <list>
+#include <map>
+#include <mutex>
+
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Psf/Psf.h"
 
@@ -44,6 +48,8 @@ namespace SourceXtractor {
  *
  * The coefficients must be given on that order (note that the constant would be the first element)
  *
+ * Optionally, the reconstructed PSFs can be cached (see setCache), so sources that are close to each
+ * other share the same PSF instead of evaluating the polynomial again.
  */
 class VariablePsf final : public Psf {
 public:
@@ -117,6 +123,16 @@ public:
    */
   std::shared_ptr<VectorImage<SeFloat>> getPsf(const std::vector<double>& values) const override;
 
+  /**
+   * Cache the reconstructed PSFs. The component values are binned, and the PSF of each bin is computed
+   * once, at the bin centre, so the result does not depend on the order of the calls.
+   * @param bin_size
+   *    Size of the bins, on the units of the components (i.e. pixels for X_IMAGE). 0 disables the cache.
+   * @param max_memory
+   *    Maximum memory, in bytes, used to keep the PSFs. The least recently used are dropped first.
+   */
+  void setCache(double bin_size, std::size_t max_memory);
+
 private:
   double                                             m_pixel_sampling;
   std::vector<Component>                             m_components;
@@ -125,6 +141,18 @@ private:
   std::vector<std::shared_ptr<VectorImage<SeFloat>>> m_coefficients;
   std::vector<std::vector<int>>                      m_exponents;
 
+  typedef std::list<std::pair<std::vector<long>, std::shared_ptr<const VectorImage<SeFloat>>>> cache_list_t;
+
+  mutable std::mutex                                 m_cache_mutex;
+  double                                             m_cache_bin_size = 0.;
+  std::size_t                                        m_cache_max_entries = 0;
+  // Most recently used first
+  mutable cache_list_t                               m_cache;
+  mutable std::map<std::vector<long>, cache_list_t::iterator> m_cache_index;
+
+  /// Evaluates the polynomial
+  std::shared_ptr<VectorImage<SeFloat>> computePsf(const std::vector<double>& values) const;
+
   /// Verify that the preconditions of getPsf are met at construction time
   void selfTest();
 
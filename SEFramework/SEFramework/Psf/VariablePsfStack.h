@@ -27,18 +27,32 @@
 #include <CCfits/CCfits>
 #include <SEFramework/Image/VectorImage.h>
 #include <SEFramework/Psf/Psf.h>
+#include <SEUtils/KdTree.h>
 
 namespace SourceXtractor {
 
+/// Position of one of the PSFs of a VariablePsfStack
+struct VariablePsfStackPosition {
+  double x, y;
+  long index;
+};
+
+template <>
+struct KdTreeTraits<VariablePsfStackPosition> {
+  static double getCoord(const VariablePsfStackPosition& position, size_t axis) {
+    return axis == 0 ? position.x : position.y;
+  }
+};
+
 /**
  * @class VariablePsfStack
  *
  * @brief
+ * Variable PSF given as a stack of PSF stamps, each valid around a position on the image
  *
  * @details
- *
- * @todo
- *
+ * getPsf returns the stamp closest to the requested position. All the stamps are read into memory
+ * when the stack is created, and the closest one is found with a KdTree, so getPsf does not access the file.
  */
 class VariablePsfStack final : public Psf {
 public:
@@ -48,6 +62,7 @@ public:
   explicit VariablePsfStack(std::shared_ptr<CCfits::FITS> pFits) : m_pFits(pFits), m_psf_size(0), mm_pixel_sampling(0.0) {
     setup(pFits);
     selfTest();
+    preload();
   };
 
   /**
@@ -86,10 +101,12 @@ public:
   /**
    *
    */
+  /**
+   * @return A copy of the PSF stamp closest to the given position
+   */
   virtual std::shared_ptr<VectorImage<SeFloat>> getPsf(const std::vector<double>& values) const;
 
 private:
-  mutable std::mutex m_mutex;
   std::shared_ptr<CCfits::FITS> m_pFits;
 
   int m_psf_size;
@@ -108,6 +125,9 @@ private:
 
   std::vector<std::string> m_components = {"X_IMAGE", "Y_IMAGE"};
 
+  std::vector<std::shared_ptr<const VectorImage<SeFloat>>> m_stamps;
+  std::unique_ptr<KdTree<VariablePsfStackPosition>> m_positions;
+
   /*
    * Check the file, load the positions and so on
    */
@@ -117,6 +137,16 @@ private:
    * consistency of the stackedPSF
    */
   void selfTest();
+
+  /*
+   * Read all the PSF stamps, and index their positions
+   */
+  void preload();
+
+  /*
+   * Index of the PSF closest to the given position
+   */
+  long findNearest(double x, double y) const;
 };
 
 }  // namespace SourceXtractor
@@ -26,7 +26,7 @@ const SeFloat BADAREA_THRESHOLD_APER = 0.1;
 
 Flags computeFlags(const std::shared_ptr<Aperture>& aperture,
                    SeFloat centroid_x, SeFloat centroid_y,
-                   const std::vector<PixelCoordinate>& pix_list,
+                   const PixelRunList& pix_list,
                    const std::shared_ptr<Image<SeFloat>>& detection_img,
                    const std::shared_ptr<Image<SeFloat>>& detection_variance,
                    const std::shared_ptr<Image<SeFloat>>& threshold_image,
@@ -21,12 +21,14 @@
  *      Author: Alejandro Alvarez
  */
 
+#include <algorithm>
+
 #include "SEFramework/Aperture/NeighbourInfo.h"
 
 namespace SourceXtractor {
 
 NeighbourInfo::NeighbourInfo(const PixelCoordinate& min_pixel, const PixelCoordinate& max_pixel,
-                             const std::vector<SourceXtractor::PixelCoordinate>& pixel_list,
+                             const SourceXtractor::PixelRunList& pixel_list,
                              const std::shared_ptr<SourceXtractor::Image<SourceXtractor::SeFloat>>& threshold_image)
   : m_offset{min_pixel} {
   m_offset.clip(threshold_image->getWidth(), threshold_image->getHeight());
@@ -41,11 +43,14 @@ NeighbourInfo::NeighbourInfo(const PixelCoordinate& min_pixel, const PixelCoordi
 
   auto threshold_cutout = threshold_image->getChunk(m_offset, max_pixel_copy);
 
-  for (auto& pixel_coord : pixel_list) {
-    auto act_x = pixel_coord.m_x - m_offset.m_x;
-    auto act_y = pixel_coord.m_y - m_offset.m_y;
-
-    if (act_x >= 0 && act_y >= 0 && act_x < width && act_y < height) {
+  for (auto& run : pixel_list.getRuns()) {
+    auto act_y = run.m_y - m_offset.m_y;
+    if (act_y < 0 || act_y >= height) {
+      continue;
+    }
+    auto act_x_start = std::max(run.m_x_start - m_offset.m_x, 0);
+    auto act_x_end = std::min(run.m_x_end - m_offset.m_x, width - 1);
+    for (auto act_x = act_x_start; act_x <= act_x_end; ++act_x) {
       m_neighbour_image->setValue(act_x, act_y, -1);
     }
   }
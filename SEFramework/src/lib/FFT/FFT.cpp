@@ -21,13 +21,21 @@
  */
 
 #include "SEFramework/FFT/FFT.h"
-#include <boost/thread/shared_mutex.hpp>
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Logging.h"
+#include <array>
+#include <atomic>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
 #include <cassert>
+#include <cstdlib>
 #include <fftw3.h>
-#include <map>
+#include <fstream>
 
 namespace SourceXtractor {
 
+static Elements::Logging logger = Elements::Logging::getLogger("FFT");
+
 /**
  * FFTW3 requires a global mutex when creating a plan. Plan executions
  * are, on the other hand, thread safe.
@@ -39,12 +47,16 @@ typename FFTTraits<float>::func_plan_inv_t*     FFTTraits<float>::func_plan_inv{
 typename FFTTraits<float>::func_destroy_plan_t* FFTTraits<float>::func_destroy_plan{fftwf_destroy_plan};
 typename FFTTraits<float>::func_execute_fwd_t*  FFTTraits<float>::func_execute_fwd{fftwf_execute_dft_r2c};
 typename FFTTraits<float>::func_execute_inv_t*  FFTTraits<float>::func_execute_inv{fftwf_execute_dft_c2r};
+typename FFTTraits<float>::func_export_wisdom_t* FFTTraits<float>::func_export_wisdom{fftwf_export_wisdom_to_string};
+typename FFTTraits<float>::func_import_wisdom_t* FFTTraits<float>::func_import_wisdom{fftwf_import_wisdom_from_string};
 
 typename FFTTraits<double>::func_plan_fwd_t*     FFTTraits<double>::func_plan_fwd{fftw_plan_dft_r2c_2d};
 typename FFTTraits<double>::func_plan_inv_t*     FFTTraits<double>::func_plan_inv{fftw_plan_dft_c2r_2d};
 typename FFTTraits<double>::func_destroy_plan_t* FFTTraits<double>::func_destroy_plan{fftw_destroy_plan};
 typename FFTTraits<double>::func_execute_fwd_t*  FFTTraits<double>::func_execute_fwd{fftw_execute_dft_r2c};
 typename FFTTraits<double>::func_execute_inv_t*  FFTTraits<double>::func_execute_inv{fftw_execute_dft_c2r};
+typename FFTTraits<double>::func_export_wisdom_t* FFTTraits<double>::func_export_wisdom{fftw_export_wisdom_to_string};
+typename FFTTraits<double>::func_import_wisdom_t* FFTTraits<double>::func_import_wisdom{fftw_import_wisdom_from_string};
 
 int fftRoundDimension(int size) {
   // Precomputed lookup table for the optimal dimension
@@ -107,6 +119,99 @@ int fftRoundDimension(int size) {
   return (size / 512 + (size % 512 != 0)) * 512;
 }
 
+/**
+ * Planner flags for new plans
+ */
+static std::atomic<unsigned> fftw_planner_flags{FFTW_ESTIMATE};
+
+void fftSetPlanningRigor(FFTPlanningRigor rigor) {
+  switch (rigor) {
+    case FFTPlanningRigor::ESTIMATE:
+      fftw_planner_flags = FFTW_ESTIMATE;
+      break;
+    case FFTPlanningRigor::MEASURE:
+      fftw_planner_flags = FFTW_MEASURE;
+      break;
+    case FFTPlanningRigor::PATIENT:
+      fftw_planner_flags = FFTW_PATIENT;
+      break;
+  }
+}
+
+/**
+ * Plan cache. Plans are created far less often than they are looked up (once per size, against once per
+ * convolution context), so lookups must not contend. It is an open addressing table, with a fixed size
+ * large enough for any realistic set of sizes, where entries are never removed or replaced: readers keep no lock,
+ * so an entry can not be released while one of them may be reading it. Once the table is full, plans for new sizes
+ * are created on each use, and a warning is logged.
+ * Readers only do atomic loads, while insertions are serialized by fftw_global_plan_mutex.
+ */
+template <typename T>
+class PlanCache {
+public:
+  typedef typename FFT<T>::plan_ptr_t plan_ptr_t;
+
+  ~PlanCache() {
+    for (auto& slot : m_slots) {
+      delete slot.load();
+    }
+  }
+
+  plan_ptr_t find(int width, int height) const {
+    for (size_t i = 0, slot = hash(width, height); i < m_slots.size(); ++i, slot = (slot + 1) % m_slots.size()) {
+      auto entry = m_slots[slot].load(std::memory_order_acquire);
+      if (entry == nullptr) {
+        break;
+      }
+      if (entry->m_width == width && entry->m_height == height) {
+        return entry->m_plan;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @warning The caller must hold fftw_global_plan_mutex
+   */
+  void insert(int width, int height, const plan_ptr_t& plan) {
+    for (size_t i = 0, slot = hash(width, height); i < m_slots.size(); ++i, slot = (slot + 1) % m_slots.size()) {
+      if (m_slots[slot].load(std::memory_order_relaxed) == nullptr) {
+        m_slots[slot].store(new Entry{width, height, plan}, std::memory_order_release);
+        return;
+      }
+    }
+    // The table is full. The plan is still valid, it just will not be reused.
+    if (!m_full) {
+      m_full = true;
+      logger.warn() << "The FFT plan cache is full with " << m_slots.size() << " sizes, plans for new sizes "
+                    << "will be created each time they are needed";
+    }
+  }
+
+private:
+  struct Entry {
+    int m_width, m_height;
+    plan_ptr_t m_plan;
+  };
+
+  std::array<std::atomic<const Entry*>, 1024> m_slots{};
+  // Protected by fftw_global_plan_mutex, as the insertions
+  bool m_full = false;
+
+  size_t hash(int width, int height) const {
+    return (static_cast<size_t>(width) * 7919 + height) % m_slots.size();
+  }
+};
+
+/**
+ * Plans that are not in the cache may be released at any moment, and destroying a plan is not thread safe
+ */
+template <typename T>
+static void destroyPlan(typename FFTTraits<T>::plan_t* plan) {
+  boost::lock_guard<boost::mutex> lock_planner{fftw_global_plan_mutex};
+  FFTTraits<T>::func_destroy_plan(plan);
+}
+
 template <typename T>
 auto FFT<T>::createForwardPlan(int width, int height, std::vector<T>& inout) -> plan_ptr_t {
   size_t phy_height = height;
@@ -119,32 +224,31 @@ auto FFT<T>::createForwardPlan(int width, int height, std::vector<T>& inout) ->
   }
 
   // Cache plan, as they can be reused
-  static boost::shared_mutex                        mutex;
-  static std::map<std::tuple<int, int>, plan_ptr_t> plan_cache;
-
-  boost::upgrade_lock<boost::shared_mutex> read_lock{mutex};
+  static PlanCache<T> plan_cache;
 
-  auto pi = plan_cache.find(std::make_tuple(width, height));
-  if (pi != plan_cache.end()) {
-    return pi->second;
+  auto plan = plan_cache.find(width, height);
+  if (plan) {
+    return plan;
   }
 
-  // No available plan yet, so get one from FFTW
-  boost::upgrade_to_unique_lock<boost::shared_mutex> write_lock{read_lock};
-  boost::lock_guard<boost::mutex>                    lock_planner{fftw_global_plan_mutex};
+  // No available plan yet, so get one from FFTW. Another thread may have done it while we waited for the lock.
+  boost::lock_guard<boost::mutex> lock_planner{fftw_global_plan_mutex};
 
-  pi = plan_cache.emplace(
-    std::make_tuple(width, height),
-    plan_ptr_t{
-      fftw_traits::func_plan_fwd(
-          height, width, // n0, n1
-          inout.data(), reinterpret_cast<complex_t*>(inout.data()), // in, out
-          FFTW_ESTIMATE | FFTW_DESTROY_INPUT // flags
-        ),
-        fftw_traits::func_destroy_plan}
-  ).first;
+  plan = plan_cache.find(width, height);
+  if (plan) {
+    return plan;
+  }
+
+  plan = plan_ptr_t{
+    fftw_traits::func_plan_fwd(
+      height, width, // n0, n1
+      inout.data(), reinterpret_cast<complex_t*>(inout.data()), // in, out
+      fftw_planner_flags | FFTW_DESTROY_INPUT // flags
+    ),
+    destroyPlan<T>};
+  plan_cache.insert(width, height, plan);
 
-  return pi->second;
+  return plan;
 }
 
 template <typename T>
@@ -159,32 +263,31 @@ auto FFT<T>::createInversePlan(int width, int height, std::vector<T>& inout) ->
   }
 
   // Cache plan, as they can be reused
-  static boost::shared_mutex                        mutex;
-  static std::map<std::tuple<int, int>, plan_ptr_t> plan_cache;
-
-  boost::upgrade_lock<boost::shared_mutex> read_lock{mutex};
+  static PlanCache<T> plan_cache;
 
-  auto pi = plan_cache.find(std::make_tuple(width, height));
-  if (pi != plan_cache.end()) {
-    return pi->second;
+  auto plan = plan_cache.find(width, height);
+  if (plan) {
+    return plan;
   }
 
-  // No available plan yet, so get one from FFTW
-  boost::upgrade_to_unique_lock<boost::shared_mutex> write_lock{read_lock};
-  boost::lock_guard<boost::mutex>                    lock_planner{fftw_global_plan_mutex};
+  // No available plan yet, so get one from FFTW. Another thread may have done it while we waited for the lock.
+  boost::lock_guard<boost::mutex> lock_planner{fftw_global_plan_mutex};
 
-  pi = plan_cache.emplace(
-    std::make_tuple(width, height),
-    plan_ptr_t{
-      fftw_traits::func_plan_inv(
-        height, width,       // n0, n1
-        reinterpret_cast<complex_t*>(inout.data()), inout.data(),  // in, out
-        FFTW_ESTIMATE | FFTW_DESTROY_INPUT // flags
-      ),
-      fftw_traits::func_destroy_plan}
- ).first;
+  plan = plan_cache.find(width, height);
+  if (plan) {
+    return plan;
+  }
+
+  plan = plan_ptr_t{
+    fftw_traits::func_plan_inv(
+      height, width,       // n0, n1
+      reinterpret_cast<complex_t*>(inout.data()), inout.data(),  // in, out
+      fftw_planner_flags | FFTW_DESTROY_INPUT // flags
+    ),
+    destroyPlan<T>};
+  plan_cache.insert(width, height, plan);
 
-  return pi->second;
+  return plan;
 }
 
 template <typename T>
@@ -197,6 +300,60 @@ void FFT<T>::executeInverse(plan_ptr_t& plan, std::vector<T>& inout) {
   fftw_traits::func_execute_inv(plan.get(), reinterpret_cast<complex_t*>(inout.data()), inout.data());
 }
 
+/**
+ * Extract the next wisdom from the stream. FFTW wisdom is a single s-expression,
+ * so it ends where its first parenthesis is closed.
+ */
+static std::string readWisdom(std::istream& in) {
+  std::string wisdom;
+  int depth = 0;
+  char c;
+  while (in.get(c)) {
+    if (c == '(') {
+      ++depth;
+    }
+    if (depth > 0) {
+      wisdom.push_back(c);
+    }
+    if (c == ')' && --depth == 0) {
+      break;
+    }
+  }
+  return wisdom;
+}
+
+template <typename T>
+static void writeWisdom(std::ostream& out) {
+  char* wisdom = FFTTraits<T>::func_export_wisdom();
+  out << wisdom << std::endl;
+  free(wisdom);
+}
+
+bool fftImportWisdom(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  auto float_wisdom = readWisdom(in);
+  auto double_wisdom = readWisdom(in);
+
+  boost::lock_guard<boost::mutex> lock_planner{fftw_global_plan_mutex};
+  return FFTTraits<float>::func_import_wisdom(float_wisdom.c_str()) &&
+         FFTTraits<double>::func_import_wisdom(double_wisdom.c_str());
+}
+
+void fftExportWisdom(const std::string& path) {
+  std::ofstream out(path);
+  {
+    boost::lock_guard<boost::mutex> lock_planner{fftw_global_plan_mutex};
+    writeWisdom<float>(out);
+    writeWisdom<double>(out);
+  }
+  if (!out) {
+    throw Elements::Exception() << "Could not write the FFTW wisdom into " << path;
+  }
+}
+
 template struct FFT<float>;
 template struct FFT<double>;
 
@@ -0,0 +1,140 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FFTKernelCache.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SEFramework/FFT/FFTKernelCache.h"
+#include <boost/functional/hash.hpp>
+
+namespace SourceXtractor {
+
+template <typename T>
+FFTKernelCache<T>& FFTKernelCache<T>::getInstance() {
+  static FFTKernelCache<T> instance;
+  return instance;
+}
+
+template <typename T>
+auto FFTKernelCache<T>::find(std::size_t hash, int kernel_width, int kernel_height, const std::vector<T>& kernel,
+                             int padded_width, int padded_height) -> typename lru_list_t::iterator {
+  auto range = m_index.equal_range(hash);
+  for (auto i = range.first; i != range.second; ++i) {
+    auto& entry = *i->second;
+    if (entry.m_kernel_width == kernel_width && entry.m_kernel_height == kernel_height &&
+        entry.m_padded_width == padded_width && entry.m_padded_height == padded_height &&
+        entry.m_kernel == kernel) {
+      return i->second;
+    }
+  }
+  return m_lru.end();
+}
+
+template <typename T>
+auto FFTKernelCache<T>::get(int kernel_width, int kernel_height, const std::vector<T>& kernel,
+                            int padded_width, int padded_height,
+                            const std::function<void(std::vector<T>&)>& compute) -> transform_ptr_t {
+  std::size_t hash = boost::hash_range(kernel.begin(), kernel.end());
+  boost::hash_combine(hash, kernel_width);
+  boost::hash_combine(hash, kernel_height);
+  boost::hash_combine(hash, padded_width);
+  boost::hash_combine(hash, padded_height);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto i = find(hash, kernel_width, kernel_height, kernel, padded_width, padded_height);
+    if (i != m_lru.end()) {
+      ++m_hits;
+      m_lru.splice(m_lru.begin(), m_lru, i);
+      return i->m_transform;
+    }
+    ++m_misses;
+  }
+
+  // The transform is computed without the lock, so other kernels can be looked up meanwhile
+  auto transform = std::make_shared<std::vector<T>>();
+  compute(*transform);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto i = find(hash, kernel_width, kernel_height, kernel, padded_width, padded_height);
+  if (i != m_lru.end()) {
+    // Another thread got here first
+    m_lru.splice(m_lru.begin(), m_lru, i);
+    return i->m_transform;
+  }
+
+  m_lru.push_front(Entry{hash, kernel_width, kernel_height, padded_width, padded_height, kernel, transform});
+  auto memory = m_lru.front().getMemory();
+  if (memory > m_max_memory) {
+    m_lru.pop_front();
+    return transform;
+  }
+  m_index.emplace(hash, m_lru.begin());
+  evict(m_max_memory - memory);
+  m_memory += memory;
+  return transform;
+}
+
+template <typename T>
+void FFTKernelCache<T>::evict(std::size_t max_memory) {
+  while (m_memory > max_memory) {
+    auto& entry = m_lru.back();
+    auto range = m_index.equal_range(entry.m_hash);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (&*i->second == &entry) {
+        m_index.erase(i);
+        break;
+      }
+    }
+    m_memory -= entry.getMemory();
+    m_lru.pop_back();
+    ++m_evictions;
+  }
+}
+
+template <typename T>
+void FFTKernelCache<T>::setMaxMemory(std::size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_max_memory = bytes;
+  evict(m_max_memory);
+}
+
+template <typename T>
+auto FFTKernelCache<T>::getStatistics() const -> Statistics {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return {m_hits, m_misses, m_evictions, m_memory};
+}
+
+template <typename T>
+void FFTKernelCache<T>::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_index.clear();
+  m_lru.clear();
+  m_memory = 0;
+}
+
+void fftSetKernelCacheSize(std::size_t bytes) {
+  FFTKernelCache<float>::getInstance().setMaxMemory(bytes);
+  FFTKernelCache<double>::getInstance().setMaxMemory(bytes);
+}
+
+template class FFTKernelCache<float>;
+template class FFTKernelCache<double>;
+
+}  // namespace SourceXtractor
@@ -77,7 +77,8 @@ FitsImageSource::FitsImageSource(const std::string& filename, int hdu_number,
     : m_filename(filename)
     , m_file_manager(std::move(manager))
     , m_handler(m_file_manager->getFileHandler(filename))
-    , m_hdu_number(hdu_number) {
+    , m_hdu_number(hdu_number)
+    , m_current_layer(0) {
   int status = 0;
   int bitpix, naxis;
   long naxes[3] = {1, 1, 1};
@@ -123,7 +124,9 @@ FitsImageSource::FitsImageSource(const std::string& filename, int width, int hei
     , m_handler(m_file_manager->getFileHandler(filename))
     , m_width(width)
     , m_height(height)
-    , m_image_type(image_type) {
+    , m_depth(1)
+    , m_image_type(image_type)
+    , m_current_layer(0) {
 
   int status = 0;
   fitsfile* fptr = nullptr;
@@ -0,0 +1,199 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MmapFitsImageSource.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <ElementsKernel/Logging.h>
+
+#include "SEFramework/FITS/MmapFitsImageSource.h"
+
+namespace SourceXtractor {
+
+static Elements::Logging logger = Elements::Logging::getLogger("MmapFitsImageSource");
+
+namespace {
+
+int getBitpix(ImageTile::ImageType image_type) {
+  switch (image_type) {
+  case ImageTile::FloatImage:
+    return FLOAT_IMG;
+  case ImageTile::DoubleImage:
+    return DOUBLE_IMG;
+  case ImageTile::IntImage:
+    return LONG_IMG;
+  case ImageTile::LongLongImage:
+    return LONGLONG_IMG;
+  default:
+    // Unsigned types are stored with an offset, they can not be copied as they are
+    return 0;
+  }
+}
+
+/*
+ * FITS data is big endian
+ */
+void copyFromBigEndian(const char* src, char* dst, std::size_t count, std::size_t element_size) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  std::memcpy(dst, src, count * element_size);
+#else
+  if (element_size == 4) {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint32_t v;
+      std::memcpy(&v, src + i * 4, 4);
+      v = __builtin_bswap32(v);
+      std::memcpy(dst + i * 4, &v, 4);
+    }
+  }
+  else {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::uint64_t v;
+      std::memcpy(&v, src + i * 8, 8);
+      v = __builtin_bswap64(v);
+      std::memcpy(dst + i * 8, &v, 8);
+    }
+  }
+#endif
+}
+
+}
+
+MmapFitsImageSource::MmapFitsImageSource(const std::string& filename, int hdu_number,
+                                         ImageTile::ImageType image_type, std::shared_ptr<FileManager> manager)
+    : FitsImageSource(filename, hdu_number, image_type, std::move(manager)),
+      m_map(nullptr), m_map_size(0), m_data(nullptr), m_element_size(ImageTile::getTypeSize(getType())) {
+  tryMap();
+}
+
+MmapFitsImageSource::~MmapFitsImageSource() {
+  if (m_map) {
+    munmap(m_map, m_map_size);
+  }
+}
+
+void MmapFitsImageSource::tryMap() {
+  int status = 0, bitpix = 0, is_compressed = 0;
+  double bscale = 1., bzero = 0.;
+  LONGLONG head_start = 0, data_start = 0, data_end = 0;
+  char root_name[FLEN_FILENAME];
+
+  // Extended file name syntax (HDU selection, image sections, row filters, URL types...) means
+  // cfitsio may be serving something other than the bytes on disk. Leave those to cfitsio.
+  std::vector<char> url(m_filename.begin(), m_filename.end());
+  url.push_back('\0');
+  fits_parse_rootname(url.data(), root_name, &status);
+  if (status != 0 || m_filename != root_name) {
+    logger.debug() << "Can not map " << m_filename << ", extended file name syntax";
+    return;
+  }
+
+  {
+    auto acc = m_handler->getAccessor<FitsFile>();
+    auto fptr = acc->m_fd.getFitsFilePtr();
+    switchHdu(fptr, getHDU());
+
+    is_compressed = fits_is_compressed_image(fptr, &status);
+    fits_get_img_type(fptr, &bitpix, &status);
+    fits_get_hduaddrll(fptr, &head_start, &data_start, &data_end, &status);
+    if (status != 0) {
+      return;
+    }
+
+    // Missing keywords are fine
+    if (fits_read_key(fptr, TDOUBLE, "BSCALE", &bscale, nullptr, &status) == KEY_NO_EXIST) {
+      status = 0;
+    }
+    if (fits_read_key(fptr, TDOUBLE, "BZERO", &bzero, nullptr, &status) == KEY_NO_EXIST) {
+      status = 0;
+    }
+    if (status != 0) {
+      return;
+    }
+  }
+
+  if (is_compressed || bscale != 1. || bzero != 0. || bitpix != getBitpix(getType())) {
+    logger.debug() << "Can not map " << m_filename << ", pixels need conversion";
+    return;
+  }
+
+  std::size_t expected_size = static_cast<std::size_t>(getWidth()) * getHeight() * getDepth() * m_element_size;
+  if (static_cast<std::size_t>(data_end - data_start) < expected_size) {
+    return;
+  }
+
+  int fd = open(root_name, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  // If cfitsio uncompressed the file on the fly (i.e. .gz), the offsets do not correspond to what is on disk:
+  // the file must start with the primary header, and the HDU header must be where cfitsio says it is
+  struct stat file_stat;
+  char first_card[8], header_card[8];
+  bool is_plain = fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size >= data_end &&
+                  pread(fd, first_card, sizeof(first_card), 0) == sizeof(first_card) &&
+                  std::strncmp(first_card, "SIMPLE  ", 8) == 0 &&
+                  pread(fd, header_card, sizeof(header_card), head_start) == sizeof(header_card) &&
+                  (std::strncmp(header_card, "SIMPLE  ", 8) == 0 || std::strncmp(header_card, "XTENSION", 8) == 0);
+
+  if (is_plain) {
+    // The offset must be aligned to the page size
+    long page_size = sysconf(_SC_PAGESIZE);
+    off_t map_offset = data_start / page_size * page_size;
+    m_map_size = data_start - map_offset + expected_size;
+    m_map = mmap(nullptr, m_map_size, PROT_READ, MAP_SHARED, fd, map_offset);
+    if (m_map == MAP_FAILED) {
+      m_map = nullptr;
+    }
+    else {
+      m_data = static_cast<const char*>(m_map) + (data_start - map_offset);
+      logger.debug() << "Serving " << m_filename << "[" << getHDU() << "] from a memory map";
+    }
+  }
+
+  close(fd);
+}
+
+std::shared_ptr<ImageTile> MmapFitsImageSource::getImageTile(int x, int y, int width, int height) const {
+  if (!m_map) {
+    return FitsImageSource::getImageTile(x, y, width, height);
+  }
+
+  auto tile = ImageTile::create(getType(), x, y, width, height,
+                                std::const_pointer_cast<ImageSource>(shared_from_this()));
+
+  std::size_t layer_offset = static_cast<std::size_t>(getLayer()) * getWidth() * getHeight();
+  auto dst = static_cast<char*>(tile->getDataPtr());
+  for (int iy = 0; iy < height; ++iy) {
+    std::size_t src_offset = layer_offset + static_cast<std::size_t>(y + iy) * getWidth() + x;
+    copyFromBigEndian(m_data + src_offset * m_element_size, dst + iy * width * m_element_size,
+                      width, m_element_size);
+  }
+
+  return tile;
+}
+
+}
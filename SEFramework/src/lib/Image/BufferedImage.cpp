@@ -98,6 +98,12 @@ std::shared_ptr<ImageChunk<T>> BufferedImage<T>::getChunk(int x, int y, int widt
 }
 
 
+template<typename T>
+void BufferedImage<T>::prefetch(int x, int y, int width, int height) const {
+  m_tile_manager->prefetch(x, y, width, height, m_source);
+}
+
+
 template<typename T>
 void BufferedImage<T>::copyOverlappingPixels(const ImageTileWithType<T> &tile, std::vector<T>& output,
                                              int x, int y, int w, int h,
@@ -0,0 +1,163 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * TileEvictionPolicy.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include "SEFramework/Image/TileEvictionPolicy.h"
+
+namespace SourceXtractor {
+
+std::unique_ptr<TileEvictionPolicy> TileEvictionPolicy::create(Type type) {
+  switch (type) {
+  case Type::FIFO:
+    return std::unique_ptr<TileEvictionPolicy>(new FifoEvictionPolicy);
+  case Type::CLOCK:
+    return std::unique_ptr<TileEvictionPolicy>(new ClockEvictionPolicy);
+  case Type::TWO_Q:
+  default:
+    return std::unique_ptr<TileEvictionPolicy>(new TwoQueueEvictionPolicy);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+void FifoEvictionPolicy::insert(const TileKey& key) {
+  m_queue.push_front(key);
+}
+
+TileKey FifoEvictionPolicy::evict(const ReferencedFunction& referenced) {
+  assert(!m_queue.empty());
+  auto victim = m_queue.back();
+  // Clear the flag anyway, for consistency with the other policies
+  referenced(victim);
+  m_queue.pop_back();
+  return victim;
+}
+
+void FifoEvictionPolicy::clear() {
+  m_queue.clear();
+}
+
+bool FifoEvictionPolicy::empty() const {
+  return m_queue.empty();
+}
+
+//-----------------------------------------------------------------------------
+
+void ClockEvictionPolicy::insert(const TileKey& key) {
+  m_queue.push_front(key);
+}
+
+TileKey ClockEvictionPolicy::evict(const ReferencedFunction& referenced) {
+  assert(!m_queue.empty());
+  // Terminates: the flags are cleared as the hand goes by, so at worst this does a full turn
+  while (referenced(m_queue.back())) {
+    m_queue.splice(m_queue.begin(), m_queue, std::prev(m_queue.end()));
+  }
+  auto victim = m_queue.back();
+  m_queue.pop_back();
+  return victim;
+}
+
+void ClockEvictionPolicy::clear() {
+  m_queue.clear();
+}
+
+bool ClockEvictionPolicy::empty() const {
+  return m_queue.empty();
+}
+
+//-----------------------------------------------------------------------------
+
+std::size_t TwoQueueEvictionPolicy::GhostKeyHash::operator()(const GhostKey& key) const {
+  std::size_t local_hash = 0;
+  boost::hash_combine(local_hash, key.m_source);
+  boost::hash_combine(local_hash, key.m_tile_x);
+  boost::hash_combine(local_hash, key.m_tile_y);
+  return local_hash;
+}
+
+void TwoQueueEvictionPolicy::insert(const TileKey& key) {
+  auto ghost_i = m_a1out_map.find(GhostKey{key.m_source.get(), key.m_tile_x, key.m_tile_y});
+  if (ghost_i != m_a1out_map.end()) {
+    // Re-requested after eviction: it is hot, promote
+    m_a1out.erase(ghost_i->second);
+    m_a1out_map.erase(ghost_i);
+    m_am.push_front(key);
+  }
+  else {
+    m_a1in.push_front(key);
+  }
+}
+
+TileKey TwoQueueEvictionPolicy::evict(const ReferencedFunction& referenced) {
+  assert(!empty());
+  // The 2Q paper recommends 25% of the cache for A1in
+  std::size_t max_a1in = std::max<std::size_t>(1, (m_a1in.size() + m_am.size()) / 4);
+
+  if (m_am.empty() || m_a1in.size() > max_a1in) {
+    auto victim = m_a1in.back();
+    // Accesses during the first stay in A1in are considered correlated, and do not count
+    referenced(victim);
+    m_a1in.pop_back();
+    remember(victim);
+    return victim;
+  }
+
+  while (referenced(m_am.back())) {
+    m_am.splice(m_am.begin(), m_am, std::prev(m_am.end()));
+  }
+  auto victim = m_am.back();
+  m_am.pop_back();
+  return victim;
+}
+
+void TwoQueueEvictionPolicy::remember(const TileKey& key) {
+  // The 2Q paper recommends remembering as many entries as half the cache, but the ghosts
+  // are cheap, and a longer memory gives hot tiles a better chance of being promoted
+  std::size_t max_a1out = std::max<std::size_t>(1, m_a1in.size() + m_am.size());
+
+  GhostKey ghost{key.m_source.get(), key.m_tile_x, key.m_tile_y};
+  if (m_a1out_map.count(ghost) == 0) {
+    m_a1out.push_front(ghost);
+    m_a1out_map.emplace(ghost, m_a1out.begin());
+  }
+  while (m_a1out.size() > max_a1out) {
+    m_a1out_map.erase(m_a1out.back());
+    m_a1out.pop_back();
+  }
+}
+
+void TwoQueueEvictionPolicy::clear() {
+  m_a1in.clear();
+  m_am.clear();
+  m_a1out.clear();
+  m_a1out_map.clear();
+}
+
+bool TwoQueueEvictionPolicy::empty() const {
+  return m_a1in.empty() && m_am.empty();
+}
+
+}
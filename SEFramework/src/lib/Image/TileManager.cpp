@@ -27,6 +27,36 @@ namespace SourceXtractor {
 
 static std::shared_ptr<TileManager> s_instance;
 static Elements::Logging s_tile_logger = Elements::Logging::getLogger("TileManager");
+static std::atomic<unsigned long> s_instance_counter{0};
+
+// Hits are accumulated per thread, and published after this many
+static const std::uint64_t s_hit_batch = 1024;
+static const std::size_t s_thread_cache_size = 8;
+// Maximum number of tiles waiting to be read ahead
+static const std::size_t s_max_prefetch_queue = 256;
+
+/*
+ * Per-thread cache of the last tiles used. A hit is only valid while the shard the tile belongs to
+ * has not lost any tile since the entry was stored, so evicted (or flushed) tiles are never
+ * served from here.
+ */
+struct TileManager::ThreadCache {
+  struct Entry {
+    unsigned long m_manager_id = 0;
+    const ImageSource* m_source = nullptr;
+    int m_tile_x = 0, m_tile_y = 0;
+    const std::atomic<unsigned long>* m_shard_generation = nullptr;
+    unsigned long m_generation = 0;
+    std::shared_ptr<CachedTile> m_cached;
+  };
+
+  std::array<Entry, s_thread_cache_size> m_entries;
+  std::size_t m_next = 0;
+
+  // Hits not yet published to the manager identified by m_hits_manager_id
+  unsigned long m_hits_manager_id = 0;
+  std::uint64_t m_hits = 0;
+};
 
 bool TileKey::operator==(const TileKey& other) const {
   return m_source == other.m_source && m_tile_x == other.m_tile_x && m_tile_y == other.m_tile_y;
@@ -40,10 +70,17 @@ std::string TileKey::getRepr() const {
 
 
 TileManager::TileManager() : m_tile_width(256), m_tile_height(256),
-                             m_max_memory(100 * 1024L * 1024L), m_total_memory_used(0) {
+                             m_max_memory(100 * 1024L * 1024L), m_total_memory_used(0),
+                             m_hits(0), m_misses(0), m_evictions(0), m_prefetched(0),
+                             m_instance_id(++s_instance_counter),
+                             m_prefetch_busy(false), m_prefetch_stop(false) {
+  for (auto& shard : m_shards) {
+    shard.m_policy = TileEvictionPolicy::create(TileEvictionPolicy::Type::TWO_Q);
+  }
 }
 
 TileManager::~TileManager() {
+  stopPrefetching();
   try {
     saveAllTiles();
   } catch (const std::exception& e) {
@@ -51,39 +88,126 @@ TileManager::~TileManager() {
   }
 }
 
-void TileManager::setOptions(int tile_width, int tile_height, int max_memory) {
+void TileManager::setOptions(int tile_width, int tile_height, int max_memory,
+                             TileEvictionPolicy::Type eviction_policy) {
   flush();
 
-  boost::lock_guard<boost::shared_mutex> wr_lock(m_mutex);
   m_tile_width = tile_width;
   m_tile_height = tile_height;
   m_max_memory = max_memory * 1024L * 1024L;
+
+  for (auto& shard : m_shards) {
+    boost::lock_guard<boost::shared_mutex> wr_lock(shard.m_mutex);
+    shard.m_policy = TileEvictionPolicy::create(eviction_policy);
+  }
+
+  m_hits = 0;
+  m_misses = 0;
+  m_evictions = 0;
+  m_prefetched = 0;
 }
 
 void TileManager::flush() {
+  // drop pending read-ahead requests, and wait for the one in flight, if any
+  {
+    std::unique_lock<std::mutex> prefetch_lock(m_prefetch_mutex);
+    m_prefetch_queue.clear();
+    m_prefetch_idle_cv.wait(prefetch_lock, [this]() { return !m_prefetch_busy; });
+  }
+
   // empty anything still stored in cache
   saveAllTiles();
 
-  boost::lock_guard<boost::shared_mutex> wr_lock(m_mutex);
-  m_tile_list.clear();
-  m_tile_map.clear();
-  m_total_memory_used = 0;
+  for (auto& shard : m_shards) {
+    boost::lock_guard<boost::shared_mutex> wr_lock(shard.m_mutex);
+    shard.m_policy->clear();
+    shard.m_tile_map.clear();
+    m_total_memory_used -= shard.m_memory_used;
+    shard.m_memory_used = 0;
+    ++shard.m_generation;
+  }
+}
+
+TileManager::ThreadCache& TileManager::getThreadCache() {
+  static thread_local ThreadCache s_thread_cache;
+  return s_thread_cache;
+}
+
+std::shared_ptr<ImageTile> TileManager::tryTileFromThreadCache(const ImageSource* source, int x, int y) {
+  for (auto& entry : getThreadCache().m_entries) {
+    if (entry.m_manager_id == m_instance_id && entry.m_source == source &&
+        entry.m_tile_x == x && entry.m_tile_y == y) {
+      if (entry.m_shard_generation->load(std::memory_order_acquire) == entry.m_generation) {
+        // Avoid writing into a shared cache line when the flag is already set
+        if (!entry.m_cached->m_referenced.load(std::memory_order_relaxed)) {
+          entry.m_cached->m_referenced.store(true, std::memory_order_relaxed);
+        }
+        countHit();
+        return entry.m_cached->m_tile;
+      }
+      // Stale, release the tile now
+      entry = ThreadCache::Entry();
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+void TileManager::putTileInThreadCache(const ImageSource* source, int x, int y, const Shard& shard,
+                                       unsigned long generation, const std::shared_ptr<CachedTile>& cached) const {
+  auto& thread_cache = getThreadCache();
+  auto& entry = thread_cache.m_entries[thread_cache.m_next];
+  thread_cache.m_next = (thread_cache.m_next + 1) % s_thread_cache_size;
+
+  entry.m_manager_id = m_instance_id;
+  entry.m_source = source;
+  entry.m_tile_x = x;
+  entry.m_tile_y = y;
+  entry.m_shard_generation = &shard.m_generation;
+  entry.m_generation = generation;
+  entry.m_cached = cached;
+}
+
+void TileManager::countHit() {
+  auto& thread_cache = getThreadCache();
+  if (thread_cache.m_hits_manager_id != m_instance_id) {
+    // Pending hits from another manager can not be safely published from here, so they are lost
+    thread_cache.m_hits_manager_id = m_instance_id;
+    thread_cache.m_hits = 0;
+  }
+  if (++thread_cache.m_hits >= s_hit_batch) {
+    publishHits();
+  }
+}
+
+void TileManager::publishHits() {
+  auto& thread_cache = getThreadCache();
+  if (thread_cache.m_hits_manager_id == m_instance_id) {
+    m_hits += thread_cache.m_hits;
+    thread_cache.m_hits = 0;
+  }
 }
 
 /*
  * boost::upgrade_lock can only be acquired by a single thread, even if none of them
  * ends needing an exclusive lock. Cache lookup must be done with a shared_lock instead
  * so multiples can retrieve from the cache at the same time.
+ * The generation is read while holding the lock, so it is consistent with the returned tile.
  */
-std::shared_ptr<ImageTile> TileManager::tryTileFromCache(const TileKey& key) {
-  boost::shared_lock<boost::shared_mutex> shared_rd_lock(m_mutex);
+auto TileManager::tryTileFromCache(Shard& shard, const TileKey& key, unsigned long& generation)
+-> std::shared_ptr<CachedTile> {
+  boost::shared_lock<boost::shared_mutex> shared_rd_lock(shard.m_mutex);
 
-  auto it = m_tile_map.find(key);
-  if (it != m_tile_map.end()) {
+  auto it = shard.m_tile_map.find(key);
+  if (it != shard.m_tile_map.end()) {
 #ifndef NDEBUG
     s_tile_logger.debug() << "Cache hit " << key;
 #endif
-    return std::dynamic_pointer_cast<ImageTile>(it->second);
+    generation = shard.m_generation.load(std::memory_order_acquire);
+    if (!it->second->m_referenced.load(std::memory_order_relaxed)) {
+      it->second->m_referenced.store(true, std::memory_order_relaxed);
+    }
+    return it->second;
   }
   return nullptr;
 }
@@ -91,8 +215,8 @@ std::shared_ptr<ImageTile> TileManager::tryTileFromCache(const TileKey& key) {
 /*
  * If the mutex does not exist, we need an upgradable lock
  */
-std::shared_ptr<boost::mutex>& TileManager::getMutexForImageSource(const ImageSource *src_ptr) {
-  boost::upgrade_lock<boost::shared_mutex> upgrade_lock(m_mutex);
+std::shared_ptr<boost::mutex> TileManager::getMutexForImageSource(const ImageSource *src_ptr) {
+  boost::upgrade_lock<boost::shared_mutex> upgrade_lock(m_mutex_map_mutex);
   auto mit = m_mutex_map.find(src_ptr);
   if (mit == m_mutex_map.end()) {
     boost::upgrade_to_unique_lock<boost::shared_mutex> unique_lock(upgrade_lock);
@@ -105,36 +229,161 @@ std::shared_ptr<ImageTile> TileManager::getTileForPixel(int x, int y,
                                                         std::shared_ptr<const ImageSource> source) {
   x = x / m_tile_width * m_tile_width;
   y = y / m_tile_height * m_tile_height;
-  TileKey key{std::static_pointer_cast<const ImageSource>(source), x, y};
 
-  // Try from the cache, this can be done by multiple threads in parallel
-  auto tile = tryTileFromCache(key);
+  // Fast path, no shared structure involved
+  auto tile = tryTileFromThreadCache(source.get(), x, y);
   if (tile) {
     return tile;
   }
 
-  // Cache miss, we need to ask the underlying source.
-  // First, we need a mutex only for that source, and that needs writing to the tile manager.
+  TileKey key{std::static_pointer_cast<const ImageSource>(source), x, y};
+  std::size_t shard_index = std::hash<TileKey>()(key) % s_shard_count;
+  auto& shard = m_shards[shard_index];
+  unsigned long generation = 0;
+
+  // Try from the cache, this can be done by multiple threads in parallel
+  auto cached = tryTileFromCache(shard, key, generation);
+  if (cached) {
+    putTileInThreadCache(source.get(), x, y, shard, generation, cached);
+    countHit();
+    return cached->m_tile;
+  }
+
+  // We are in the slow path anyway
+  publishHits();
+
+  bool loaded = false;
+  cached = loadTile(key, shard_index, generation, loaded);
+  if (loaded) {
+    ++m_misses;
+  }
+  else {
+    countHit();
+  }
+  putTileInThreadCache(source.get(), x, y, shard, generation, cached);
+  return cached->m_tile;
+}
+
+/*
+ * Slow path: the tile needs to be read from the source, unless someone else has done it
+ * while we were waiting for the source lock.
+ */
+auto TileManager::loadTile(const TileKey& key, std::size_t shard_index, unsigned long& generation, bool& loaded)
+-> std::shared_ptr<CachedTile> {
+  auto& shard = m_shards[shard_index];
+  auto& source = key.m_source;
+
+  // First, we need a mutex only for that source
   auto img_mutex = getMutexForImageSource(source.get());
 
   // Here we block access only to this specific image source
   boost::lock_guard<boost::mutex> img_lock(*img_mutex);
 
   // Try again from the cache, maybe someone put it there while we waited for the image lock
-  tile = tryTileFromCache(key);
-  if (tile) {
-    return tile;
+  auto cached = tryTileFromCache(shard, key, generation);
+  if (cached) {
+    loaded = false;
+    return cached;
+  }
+
+  auto tile = source->getImageTile(key.m_tile_x, key.m_tile_y,
+                                   std::min(m_tile_width, source->getWidth() - key.m_tile_x),
+                                   std::min(m_tile_height, source->getHeight() - key.m_tile_y));
+  cached = std::make_shared<CachedTile>(tile);
+
+  {
+    // Here we need to acquire the shard mutex in write mode!
+    boost::lock_guard<boost::shared_mutex> wr_lock(shard.m_mutex);
+    addTile(shard, key, cached);
+    generation = shard.m_generation.load(std::memory_order_acquire);
+  }
+
+  removeExtraTiles(shard_index);
+  loaded = true;
+  return cached;
+}
+
+bool TileManager::isTileCached(Shard& shard, const TileKey& key) {
+  boost::shared_lock<boost::shared_mutex> shared_rd_lock(shard.m_mutex);
+  return shard.m_tile_map.count(key) > 0;
+}
+
+void TileManager::prefetch(int x, int y, int width, int height, std::shared_ptr<const ImageSource> source) {
+  int start_x = std::max(0, x) / m_tile_width * m_tile_width;
+  int start_y = std::max(0, y) / m_tile_height * m_tile_height;
+  int end_x = std::min(x + width, source->getWidth());
+  int end_y = std::min(y + height, source->getHeight());
+
+  std::vector<TileKey> missing;
+  for (int iy = start_y; iy < end_y; iy += m_tile_height) {
+    for (int ix = start_x; ix < end_x; ix += m_tile_width) {
+      TileKey key{source, ix, iy};
+      if (!isTileCached(m_shards[std::hash<TileKey>()(key) % s_shard_count], key)) {
+        missing.emplace_back(std::move(key));
+      }
+    }
+  }
+  if (missing.empty()) {
+    return;
   }
 
-  tile = source->getImageTile(x, y,
-                              std::min(m_tile_width, source->getWidth() - x),
-                              std::min(m_tile_height, source->getHeight() - y));
+  std::lock_guard<std::mutex> prefetch_lock(m_prefetch_mutex);
+  if (!m_prefetch_thread.joinable()) {
+    m_prefetch_thread = std::thread(&TileManager::prefetchLoop, this);
+  }
+  for (auto& key : missing) {
+    if (m_prefetch_queue.size() >= s_max_prefetch_queue) {
+      break;
+    }
+    m_prefetch_queue.emplace_back(std::move(key));
+  }
+  m_prefetch_cv.notify_one();
+}
+
+void TileManager::prefetchLoop() {
+  std::unique_lock<std::mutex> prefetch_lock(m_prefetch_mutex);
+  while (true) {
+    m_prefetch_cv.wait(prefetch_lock, [this]() { return m_prefetch_stop || !m_prefetch_queue.empty(); });
+    if (m_prefetch_stop) {
+      break;
+    }
+
+    auto key = std::move(m_prefetch_queue.front());
+    m_prefetch_queue.pop_front();
+    m_prefetch_busy = true;
+    prefetch_lock.unlock();
+
+    try {
+      std::size_t shard_index = std::hash<TileKey>()(key) % s_shard_count;
+      if (!isTileCached(m_shards[shard_index], key)) {
+        unsigned long generation;
+        bool loaded = false;
+        loadTile(key, shard_index, generation, loaded);
+        if (loaded) {
+          ++m_prefetched;
+        }
+      }
+    } catch (const std::exception& e) {
+      // Not fatal, the tile will be read (and the error reported) when it is actually needed
+      s_tile_logger.warn() << "Failed to read ahead " << key << ": " << e.what();
+    }
+
+    prefetch_lock.lock();
+    m_prefetch_busy = false;
+    m_prefetch_idle_cv.notify_all();
+  }
+}
 
-  // Here we need to acquire the mutex in write mode!
-  boost::lock_guard<boost::shared_mutex> wr_lock(m_mutex);
-  addTile(key, std::static_pointer_cast<ImageTile>(tile));
-  removeExtraTiles();
-  return tile;
+void TileManager::stopPrefetching() {
+  {
+    std::lock_guard<std::mutex> prefetch_lock(m_prefetch_mutex);
+    m_prefetch_stop = true;
+    m_prefetch_queue.clear();
+  }
+  m_prefetch_cv.notify_all();
+  if (m_prefetch_thread.joinable()) {
+    m_prefetch_thread.join();
+  }
 }
 
 std::shared_ptr<TileManager> TileManager::getInstance() {
@@ -145,10 +394,12 @@ std::shared_ptr<TileManager> TileManager::getInstance() {
 }
 
 void TileManager::saveAllTiles() {
-  boost::lock_guard<boost::shared_mutex> wr_lock(m_mutex);
+  for (auto& shard : m_shards) {
+    boost::lock_guard<boost::shared_mutex> wr_lock(shard.m_mutex);
 
-  for (auto tile_key : m_tile_list) {
-    m_tile_map.at(tile_key)->saveIfModified();
+    for (auto& entry : shard.m_tile_map) {
+      entry.second->m_tile->saveIfModified();
+    }
   }
 }
 
@@ -160,36 +411,59 @@ int TileManager::getTileHeight() const {
   return m_tile_height;
 }
 
-void TileManager::removeTile(TileKey tile_key) {
+auto TileManager::getStatistics() const -> Statistics {
+  return {m_hits, m_misses, m_evictions, m_prefetched, m_total_memory_used};
+}
+
+void TileManager::removeTile(Shard& shard, TileKey tile_key) {
 #ifndef NDEBUG
   s_tile_logger.debug() << "Cache eviction " << tile_key;
 #endif
 
-  auto& tile = m_tile_map.at(tile_key);
+  auto& tile = shard.m_tile_map.at(tile_key)->m_tile;
 
   tile->saveIfModified();
+  shard.m_memory_used -= tile->getTileMemorySize();
   m_total_memory_used -= tile->getTileMemorySize();
 
-  m_tile_map.erase(tile_key);
+  shard.m_tile_map.erase(tile_key);
+  shard.m_generation.fetch_add(1, std::memory_order_release);
+  ++m_evictions;
 }
 
-void TileManager::removeExtraTiles() {
-  while (m_total_memory_used > m_max_memory) {
-    assert(m_tile_list.size() > 0);
-    auto tile_to_remove = m_tile_list.back();
-    removeTile(tile_to_remove);
-    m_tile_list.pop_back();
+/*
+ * The first pass only trims the shards holding more than their fair share of the memory. Only if that is
+ * not enough the rest are trimmed too. The shard that just grew is visited last, so the tile just loaded
+ * is not dropped right away.
+ * Only one shard lock is held at any given time.
+ */
+void TileManager::removeExtraTiles(std::size_t shard_index) {
+  const long fair_share = m_max_memory / static_cast<long>(s_shard_count);
+
+  for (long keep : {fair_share, 0L}) {
+    for (std::size_t i = 0; i < s_shard_count && m_total_memory_used > m_max_memory; ++i) {
+      auto& shard = m_shards[(shard_index + 1 + i) % s_shard_count];
+      boost::lock_guard<boost::shared_mutex> wr_lock(shard.m_mutex);
+      auto referenced = [&shard](const TileKey& key) {
+        return shard.m_tile_map.at(key)->m_referenced.exchange(false, std::memory_order_relaxed);
+      };
+      while (m_total_memory_used > m_max_memory && shard.m_memory_used > keep) {
+        assert(!shard.m_policy->empty());
+        removeTile(shard, shard.m_policy->evict(referenced));
+      }
+    }
   }
 }
 
-void TileManager::addTile(TileKey key, std::shared_ptr<ImageTile> tile) {
+void TileManager::addTile(Shard& shard, TileKey key, std::shared_ptr<CachedTile> cached) {
 #ifndef NDEBUG
   s_tile_logger.debug() << "Cache miss " << key;
 #endif
 
-  m_tile_map[key] = tile;
-  m_tile_list.push_front(key);
-  m_total_memory_used += tile->getTileMemorySize();
+  shard.m_tile_map[key] = cached;
+  shard.m_policy->insert(key);
+  shard.m_memory_used += cached->m_tile->getTileMemorySize();
+  m_total_memory_used += cached->m_tile->getTileMemorySize();
 }
 
 }
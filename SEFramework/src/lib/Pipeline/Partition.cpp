@@ -29,6 +29,14 @@ Partition::Partition(std::vector<std::shared_ptr<PartitionStep>> steps)
 }
 
 void Partition::receiveSource(std::unique_ptr<SourceInterface> input_source) {
+  // Observers are then notified of the output of the last step
+  for (auto& source : applySteps(std::move(input_source))) {
+    sendSource(std::move(source));
+  }
+}
+
+std::vector<std::unique_ptr<SourceInterface>> Partition::applySteps(
+    std::unique_ptr<SourceInterface> input_source) const {
   // The input of the current step
   std::vector<std::unique_ptr<SourceInterface>> step_input_sources;
   step_input_sources.emplace_back(std::move(input_source));
@@ -49,11 +57,9 @@ void Partition::receiveSource(std::unique_ptr<SourceInterface> input_source) {
     step_input_sources = std::move(step_output_sources);
   }
 
-  // Observers are then notified of the output of the last step
-  for (auto& source : step_input_sources) {
-    sendSource(std::move(source));
-  }
+  return step_input_sources;
 }
+
 void Partition::receiveProcessSignal(const ProcessSourcesEvent& event) {
   sendProcessSignal(event);
 }
@@ -21,41 +21,98 @@
  */
 
 #include "SEFramework/Pipeline/SourceGrouping.h"
+#include <algorithm>
 #include <vector>
 
 
 namespace SourceXtractor {
 
+// Size in pixels of the cells of the spatial index
+static const int INDEX_CELL_SIZE = 64;
+
+static int cellIndex(int coord) {
+  return coord >= 0 ? coord / INDEX_CELL_SIZE : -((-coord - 1) / INDEX_CELL_SIZE) - 1;
+}
+
+static bool isEmpty(const PixelRectangle& rect) {
+  return rect.getWidth() <= 0 || rect.getHeight() <= 0;
+}
+
+static bool overlap(const PixelRectangle& a, const PixelRectangle& b) {
+  return !(a.getTopLeft().m_x > b.getBottomRight().m_x || a.getBottomRight().m_x < b.getTopLeft().m_x ||
+           a.getTopLeft().m_y > b.getBottomRight().m_y || a.getBottomRight().m_y < b.getTopLeft().m_y);
+}
+
+template <typename F>
+static void forEachCell(const PixelRectangle& rect, F func) {
+  for (int cy = cellIndex(rect.getTopLeft().m_y); cy <= cellIndex(rect.getBottomRight().m_y); ++cy) {
+    for (int cx = cellIndex(rect.getTopLeft().m_x); cx <= cellIndex(rect.getBottomRight().m_x); ++cx) {
+      func(std::make_pair(cx, cy));
+    }
+  }
+}
+
 SourceGrouping::SourceGrouping(std::shared_ptr<GroupingCriteria> grouping_criteria,
                                std::shared_ptr<SourceGroupFactory> group_factory,
                                unsigned int hard_limit)
-        : m_grouping_criteria(grouping_criteria), m_group_factory(group_factory), m_hard_limit(hard_limit) {
+        : m_grouping_criteria(grouping_criteria), m_group_factory(group_factory), m_hard_limit(hard_limit),
+          m_next_order(0) {
 }
 
 void SourceGrouping::receiveSource(std::unique_ptr<SourceInterface> source) {
+  SearchRegion region;
+  region.bounded = m_grouping_criteria->getSearchRegion(*source, region.rect);
+
+  // Groups with a source that could be grouped with this one, in creation order
+  std::vector<OpenGroup*> candidates;
+  if (!region.bounded) {
+    for (auto& open_group : m_source_groups) {
+      candidates.emplace_back(&open_group);
+    }
+  } else if (!isEmpty(region.rect)) {
+    forEachCell(region.rect, [this, &region, &candidates](const CellKey& key) {
+      auto cell = m_index.find(key);
+      if (cell != m_index.end()) {
+        for (auto& entry : cell->second) {
+          if (overlap(entry.region, region.rect)) {
+            candidates.emplace_back(entry.group);
+          }
+        }
+      }
+    });
+    candidates.insert(candidates.end(), m_unbounded_groups.begin(), m_unbounded_groups.end());
+    std::sort(candidates.begin(), candidates.end(), [](const OpenGroup* a, const OpenGroup* b) {
+      return a->order < b->order;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  }
+
   // Pointer which points to the group of the source
-  SourceGroupInterface* matched_group = nullptr;
+  OpenGroup* matched_group = nullptr;
 
   auto source_ptr = source.get();
-  std::vector<std::list<std::unique_ptr<SourceGroupInterface>>::iterator> groups_to_remove {};
 
-  for (auto group_it = m_source_groups.begin(); group_it != m_source_groups.end(); ++group_it) {
+  for (auto candidate : candidates) {
 
     if (m_hard_limit > 0) {
-      unsigned int current_group_size = (matched_group != nullptr) ? matched_group->size() : 1;
+      unsigned int current_group_size = (matched_group != nullptr) ? matched_group->group->size() : 1;
       if (current_group_size >= m_hard_limit) {
         break; // no need to try to find matching groups anymore, we have reached the limit
       }
 
-      if (current_group_size + (*group_it)->size() > m_hard_limit) {
+      if (current_group_size + candidate->group->size() > m_hard_limit) {
         continue; // we can't merge groups without hitting the limit, so skip it
       }
     }
 
-    // Search if the source meets the grouping criteria with any of the sources in the group
+    // Search if the source meets the grouping criteria with any of the nearby sources in the group
     bool in_group = false;
-    for (auto& s : **group_it) {
-      if (m_grouping_criteria->shouldGroup(*source_ptr, s)) {
+    auto other_region = candidate->regions.begin();
+    for (auto& s : *candidate->group) {
+      bool nearby = !region.bounded || !other_region->bounded ||
+                    (!isEmpty(other_region->rect) && overlap(region.rect, other_region->rect));
+      ++other_region;
+      if (nearby && m_grouping_criteria->shouldGroup(*source_ptr, s)) {
         in_group = true;
         break; // No need to check the rest of the group sources
       }
@@ -63,34 +120,121 @@ void SourceGrouping::receiveSource(std::unique_ptr<SourceInterface> source) {
 
     if (in_group) {
       if (matched_group == nullptr) {
-        matched_group = group_it->get();
-        matched_group->addSource(std::move(source));
+        matched_group = candidate;
+        addToGroup(*matched_group, std::move(source), region);
       } else {
-        matched_group->merge(std::move(**group_it));
-        groups_to_remove.emplace_back(group_it);
+        mergeGroups(*matched_group, *candidate);
       }
     }
   }
 
   // If there was no group the source should be grouped in, we create a new one
   if (matched_group == nullptr) {
-    auto new_group = m_group_factory->createSourceGroup();
-    new_group->addSource(std::move(source));
-    m_source_groups.emplace_back(std::move(new_group));
+    m_source_groups.emplace_back();
+    auto& new_group = m_source_groups.back();
+    new_group.group = m_group_factory->createSourceGroup();
+    new_group.self = std::prev(m_source_groups.end());
+    new_group.order = m_next_order++;
+    new_group.unbounded = 0;
+    new_group.empty = 0;
+    addToGroup(new_group, std::move(source), region);
   }
+}
+
+void SourceGrouping::addToGroup(OpenGroup& open_group, std::unique_ptr<SourceInterface> source,
+                                const SearchRegion& region) {
+  open_group.group->addSource(std::move(source));
+  open_group.regions.emplace_back(region);
+
+  if (!region.bounded) {
+    ++open_group.unbounded;
+    m_unbounded_groups.insert(&open_group);
+  } else if (isEmpty(region.rect)) {
+    ++open_group.empty;
+  } else {
+    forEachCell(region.rect, [this, &open_group, &region](const CellKey& key) {
+      m_index[key].emplace_back(IndexEntry{&open_group, region.rect});
+      open_group.cells.emplace_back(key);
+    });
 
-  for (auto& group_it : groups_to_remove) {
-    m_source_groups.erase(group_it);
+    if (isEmpty(open_group.bounds)) {
+      open_group.bounds = region.rect;
+    } else {
+      open_group.bounds = PixelRectangle(
+          {std::min(open_group.bounds.getTopLeft().m_x, region.rect.getTopLeft().m_x),
+           std::min(open_group.bounds.getTopLeft().m_y, region.rect.getTopLeft().m_y)},
+          {std::max(open_group.bounds.getBottomRight().m_x, region.rect.getBottomRight().m_x),
+           std::max(open_group.bounds.getBottomRight().m_y, region.rect.getBottomRight().m_y)});
+    }
   }
 }
 
+void SourceGrouping::mergeGroups(OpenGroup& target, OpenGroup& other) {
+  target.group->merge(std::move(*other.group));
+  target.regions.insert(target.regions.end(), other.regions.begin(), other.regions.end());
+
+  // The sources of the other group now belong to the target
+  for (auto& key : other.cells) {
+    for (auto& entry : m_index[key]) {
+      if (entry.group == &other) {
+        entry.group = &target;
+      }
+    }
+  }
+  target.cells.insert(target.cells.end(), other.cells.begin(), other.cells.end());
+
+  if (!isEmpty(other.bounds)) {
+    if (isEmpty(target.bounds)) {
+      target.bounds = other.bounds;
+    } else {
+      target.bounds = PixelRectangle(
+          {std::min(target.bounds.getTopLeft().m_x, other.bounds.getTopLeft().m_x),
+           std::min(target.bounds.getTopLeft().m_y, other.bounds.getTopLeft().m_y)},
+          {std::max(target.bounds.getBottomRight().m_x, other.bounds.getBottomRight().m_x),
+           std::max(target.bounds.getBottomRight().m_y, other.bounds.getBottomRight().m_y)});
+    }
+  }
+
+  target.empty += other.empty;
+  if (other.unbounded > 0) {
+    target.unbounded += other.unbounded;
+    m_unbounded_groups.insert(&target);
+    m_unbounded_groups.erase(&other);
+  }
+
+  m_source_groups.erase(other.self);
+}
+
+void SourceGrouping::removeFromIndex(OpenGroup& open_group) {
+  std::sort(open_group.cells.begin(), open_group.cells.end());
+  open_group.cells.erase(std::unique(open_group.cells.begin(), open_group.cells.end()), open_group.cells.end());
+
+  for (auto& key : open_group.cells) {
+    auto cell = m_index.find(key);
+    auto& entries = cell->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&open_group](const IndexEntry& entry) {
+      return entry.group == &open_group;
+    }), entries.end());
+    if (entries.empty()) {
+      m_index.erase(cell);
+    }
+  }
+  m_unbounded_groups.erase(&open_group);
+}
+
 void SourceGrouping::receiveProcessSignal(const ProcessSourcesEvent& process_event) {
-  std::vector<std::list<std::unique_ptr<SourceGroupInterface>>::iterator> groups_to_process;
+  std::vector<std::list<OpenGroup>::iterator> groups_to_process;
 
   // We iterate through all the SourceGroups we have
   for (auto group_it = m_source_groups.begin(); group_it != m_source_groups.end(); ++group_it) {
+    // Groups that are fully bounded can be discarded without looking at their sources
+    if (group_it->unbounded == 0 && group_it->empty == 0 &&
+        !process_event.m_selection_criteria->mayBeProcessed(group_it->bounds)) {
+      continue;
+    }
+
     // We look at its Sources and if we find at least one that needs to be processed we put it in groups_to_process
-    for (auto& source : **group_it) {
+    for (auto& source : *group_it->group) {
       if (process_event.m_selection_criteria->mustBeProcessed(source)) {
         groups_to_process.push_back(group_it);
         break;
@@ -101,7 +245,8 @@ void SourceGrouping::receiveProcessSignal(const ProcessSourcesEvent& process_eve
   // For each SourceGroup that we put in groups_to_process,
   for (auto& group : groups_to_process) {
     // we remove it from our list of stored SourceGroups and notify our observers
-    sendSource(std::move(*group));
+    removeFromIndex(*group);
+    sendSource(std::move(group->group));
     m_source_groups.erase(group);
   }
 }
@@ -111,6 +256,3 @@ std::set<PropertyId> SourceGrouping::requiredProperties() const {
 }
 
 } // SEFramework namespace
-
-
-
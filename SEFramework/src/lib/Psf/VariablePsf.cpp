@@ -23,6 +23,7 @@
 
 #include <ElementsKernel/Exception.h>
 #include <algorithm>
+#include <cmath>
 #include "SEFramework/Psf/VariablePsf.h"
 
 
@@ -63,26 +64,93 @@ const std::vector<std::string>& VariablePsf::getComponents() const {
 }
 
 std::shared_ptr<VectorImage<SeFloat>> VariablePsf::getPsf(const std::vector<double> &values) const
+{
+  if (m_cache_bin_size <= 0. || m_components.empty()) {
+    return computePsf(values);
+  }
+  if (values.size() != m_components.size()) {
+    throw Elements::Exception()
+        << "Expecting " << m_components.size() << " values, got " << values.size();
+  }
+
+  std::vector<long> bin(values.size());
+  std::vector<double> bin_center(values.size());
+  for (auto i = 0u; i < values.size(); ++i) {
+    bin[i] = std::lround(std::floor(values[i] / m_cache_bin_size));
+    bin_center[i] = (bin[i] + 0.5) * m_cache_bin_size;
+  }
+
+  std::shared_ptr<const VectorImage<SeFloat>> psf;
+  {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    auto i = m_cache_index.find(bin);
+    if (i != m_cache_index.end()) {
+      m_cache.splice(m_cache.begin(), m_cache, i->second);
+      psf = i->second->second;
+    }
+  }
+
+  if (!psf) {
+    // Computed without the lock, so other threads can still use the cache
+    psf = computePsf(bin_center);
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    if (m_cache_index.find(bin) == m_cache_index.end()) {
+      m_cache.emplace_front(bin, psf);
+      m_cache_index.emplace(bin, m_cache.begin());
+      while (m_cache.size() > m_cache_max_entries) {
+        m_cache_index.erase(m_cache.back().first);
+        m_cache.pop_back();
+      }
+    }
+  }
+
+  // The caller gets its own copy, as the cached one is shared
+  return VectorImage<SeFloat>::create(*psf);
+}
+
+void VariablePsf::setCache(double bin_size, std::size_t max_memory) {
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  m_cache_bin_size = bin_size;
+  m_cache_max_entries = std::max<std::size_t>(1, max_memory / (getWidth() * getHeight() * sizeof(SeFloat)));
+  m_cache.clear();
+  m_cache_index.clear();
+}
+
+std::shared_ptr<VectorImage<SeFloat>> VariablePsf::computePsf(const std::vector<double> &values) const
 {
   auto scaled_props = scaleProperties(values);
 
+  // Powers of each component, up to the highest exponent
+  int max_exponent = 0;
+  for (const auto& exp : m_exponents) {
+    for (auto e : exp) {
+      max_exponent = std::max(max_exponent, e);
+    }
+  }
+  std::vector<std::vector<double>> powers(scaled_props.size(), std::vector<double>(max_exponent + 1, 1.));
+  for (auto j = 0u; j < scaled_props.size(); ++j) {
+    for (int d = 1; d <= max_exponent; ++d) {
+      powers[j][d] = powers[j][d - 1] * scaled_props[j];
+    }
+  }
+
   // Initialize with the constant component
   auto result = VectorImage<SeFloat>::create(*m_coefficients[0]);
+  auto& result_data = result->getData();
 
   // Add the rest of the components
   for (auto i = 1u; i < m_coefficients.size(); ++i) {
     const auto& exp = m_exponents[i];
-    const auto& coef = m_coefficients[i];
+    const auto& coef_data = m_coefficients[i]->getData();
 
     double acc = 1.;
     for (auto j = 0u; j < scaled_props.size(); ++j) {
-      acc *= std::pow(scaled_props[j], exp[j]);
+      acc *= powers[j][exp[j]];
     }
 
-    for (auto x = 0; x < getWidth(); ++x) {
-      for (auto y = 0; y < getHeight(); ++y) {
-        result->at(x, y) += acc * coef->at(x, y);
-      }
+    for (auto p = 0u; p < result_data.size(); ++p) {
+      result_data[p] += acc * coef_data[p];
     }
   }
 
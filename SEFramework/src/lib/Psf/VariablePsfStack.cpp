@@ -21,6 +21,8 @@
  *      Author: Martin Kuemmel
  */
 #include <algorithm>
+#include <cmath>
+#include <AlexandriaKernel/memory_tools.h>
 #include <ElementsKernel/Logging.h>
 #include <ElementsKernel/Exception.h>
 #include "SEFramework/Psf/VariablePsfStack.h"
@@ -72,6 +74,9 @@ void VariablePsfStack::setup(std::shared_ptr<CCfits::FITS> pFits) {
 
     // read the nrows value
     m_nrows = position_data.rows();
+    if (m_nrows == 0) {
+      throw Elements::Exception() << "The stacked PSF file has no PSF positions! File: " << pFits->name();
+    }
 
     try {
       // read in all the EXT specific columns
@@ -115,50 +120,70 @@ void VariablePsfStack::selfTest() {
                                 << " NAXIS2: " << naxis1;
 }
 
-std::shared_ptr<VectorImage<SeFloat>> VariablePsfStack::getPsf(const std::vector<double>& values) const {
-  long   index_min_distance = 0;
-  double min_distance       = 1.0e+32;
+void VariablePsfStack::preload() {
+  try {
+    int naxis1;
+    auto& psf_data = m_pFits->extension(1);
+    psf_data.readKey("NAXIS1", naxis1);
+
+    std::valarray<SeFloat> stack_data;
+    psf_data.read(stack_data);
+
+    // NOTE: the grid positions are 1-based, and the +0.5 forces a correct cast/ceiling
+    m_stamps.reserve(m_nrows);
+    std::vector<SeFloat> stamp_data(m_psf_size * m_psf_size);
+    for (long index = 0; index < m_nrows; ++index) {
+      long first_x = long(m_gridx_values[index] + .5) - long(m_grid_offset) - 1;
+      long first_y = long(m_gridy_values[index] + .5) - long(m_grid_offset) - 1;
+      for (int y = 0; y < m_psf_size; ++y) {
+        auto row = std::begin(stack_data) + (first_y + y) * naxis1 + first_x;
+        std::copy(row, row + m_psf_size, stamp_data.begin() + y * m_psf_size);
+      }
+      m_stamps.emplace_back(VectorImage<SeFloat>::create(m_psf_size, m_psf_size, stamp_data));
+    }
+  } catch (CCfits::FitsException& e) {
+    throw Elements::Exception() << "Error loading stacked PSF file: " << e.message();
+  }
+
+  std::vector<VariablePsfStackPosition> positions(m_nrows);
+  for (long index = 0; index < m_nrows; ++index) {
+    positions[index] = {m_x_values[index], m_y_values[index], index};
+  }
+  m_positions = Euclid::make_unique<KdTree<VariablePsfStackPosition>>(positions);
+
+  stack_logger.debug() << "Loaded " << m_nrows << " PSF stamps from " << m_pFits->name();
+}
 
+long VariablePsfStack::findNearest(double x, double y) const {
+  auto nearest = m_positions->findNearest({{x, y}});
+  double min_distance = (x - nearest.x) * (x - nearest.x) + (y - nearest.y) * (y - nearest.y);
+
+  // If several PSFs are at the same distance, use the first one
+  long index_min_distance = nearest.index;
+  double radius = std::sqrt(min_distance) * (1. + 1e-9) + 1e-9;
+  for (auto& candidate : m_positions->findPointsWithinRadius({{x, y}}, radius)) {
+    double distance = (x - candidate.x) * (x - candidate.x) + (y - candidate.y) * (y - candidate.y);
+    if (distance == min_distance && candidate.index < index_min_distance) {
+      index_min_distance = candidate.index;
+    }
+  }
+  return index_min_distance;
+}
+
+std::shared_ptr<VectorImage<SeFloat>> VariablePsfStack::getPsf(const std::vector<double>& values) const {
   // make sure there are only two positions
   if (values.size() != 2)
     throw Elements::Exception() << "There can be only two positional value for the stacked PSF!";
 
-  // find the position of minimal distance
-  for (int act_index = 0; act_index < m_nrows; act_index++) {
-    double act_distance = (values[0] - m_x_values[act_index]) * (values[0] - m_x_values[act_index]) +
-                          (values[1] - m_y_values[act_index]) * (values[1] - m_y_values[act_index]);
-    if (act_distance < min_distance) {
-      index_min_distance = act_index;
-      min_distance       = act_distance;
-    }
-  }
+  long index_min_distance = findNearest(values[0], values[1]);
+
   // give some feedback
-  stack_logger.debug() << "Distance: " << sqrt(min_distance) << " (" << values[0] << "," << values[1] << ")<-->("
+  stack_logger.debug() << "Position (" << values[0] << "," << values[1] << ")<-->("
                        << m_x_values[index_min_distance] << "," << m_y_values[index_min_distance]
                        << ") index: " << index_min_distance;
 
-  // get the first and last pixels for the PSF to be extracted
-  // NOTE: CCfits has 1-based indices, also the last index is *included* in the reading
-  // NOTE: the +0.5 forces a correct cast/ceiling
-  std::vector<long> first_vertex{long(m_gridx_values[index_min_distance]+.5) - long(m_grid_offset),  long(m_gridy_values[index_min_distance]+.5) - long(m_grid_offset)};
-  stack_logger.debug() << "First vertex: ( " << first_vertex[0] << ", " << first_vertex[1] << ") First vertex alternative: " <<
-      m_gridx_values[index_min_distance]-m_grid_offset << " " << m_gridy_values[index_min_distance]-m_grid_offset <<
-      " grid offset:" << m_grid_offset;
-
-  std::vector<long> last_vertex{first_vertex[0] + long(m_psf_size) - 1, first_vertex[1] +long( m_psf_size) - 1};
-  std::vector<long> stride{1, 1};
-
-  // read out the image
-  std::valarray<SeFloat> stamp_data;
-  {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_pFits->extension(1).read(stamp_data, first_vertex, last_vertex, stride);
-  }
-
-  //stack_logger.info() << "DDD ( " << first_vertex[0] << ", " << first_vertex[1] << ") --> ( " << last_vertex[0] << ", " << last_vertex[1] << "): " << stamp_data.size();
-
-  // create and return the psf image
-  return VectorImage<SeFloat>::create(m_psf_size, m_psf_size, std::begin(stamp_data), std::end(stamp_data));
+  // The caller gets its own copy
+  return VectorImage<SeFloat>::create(*m_stamps[index_min_distance]);
 }
 
 } // end SExtractor
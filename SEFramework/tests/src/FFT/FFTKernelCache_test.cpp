@@ -0,0 +1,148 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FFTKernelCache_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include "SEFramework/FFT/FFTKernelCache.h"
+#include "SEFramework/Convolution/DFT.h"
+#include "SEFramework/Image/VectorImage.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace SourceXtractor;
+
+struct FFTKernelCache_Fixture {
+  FFTKernelCache<float>& cache = FFTKernelCache<float>::getInstance();
+  int computed = 0;
+
+  std::function<void(std::vector<float>&)> compute = [this](std::vector<float>& transform) {
+    ++computed;
+    transform.assign(100, float(computed));
+  };
+
+  FFTKernelCache_Fixture() {
+    cache.clear();
+    cache.setMaxMemory(1024 * 1024);
+  }
+
+  ~FFTKernelCache_Fixture() {
+    cache.clear();
+    cache.setMaxMemory(256 * 1024 * 1024);
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(FFTKernelCache_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Reuse_test, FFTKernelCache_Fixture) {
+  std::vector<float> kernel{0, 1, 0, 1, 4, 1, 0, 1, 0};
+  auto before = cache.getStatistics();
+
+  auto first = cache.get(3, 3, kernel, 10, 10, compute);
+  auto second = cache.get(3, 3, kernel, 10, 10, compute);
+
+  // Same values, different buffer
+  std::vector<float> copy(kernel);
+  auto third = cache.get(3, 3, copy, 10, 10, compute);
+
+  BOOST_CHECK_EQUAL(computed, 1);
+  BOOST_CHECK_EQUAL(first, second);
+  BOOST_CHECK_EQUAL(first, third);
+
+  auto after = cache.getStatistics();
+  BOOST_CHECK_EQUAL(after.m_misses - before.m_misses, 1);
+  BOOST_CHECK_EQUAL(after.m_hits - before.m_hits, 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Key_test, FFTKernelCache_Fixture) {
+  std::vector<float> kernel{0, 1, 0, 1, 4, 1, 0, 1, 0};
+  std::vector<float> other{0, 1, 0, 1, 5, 1, 0, 1, 0};
+
+  auto reference = cache.get(3, 3, kernel, 10, 10, compute);
+  BOOST_CHECK_NE(reference, cache.get(3, 3, other, 10, 10, compute));
+  BOOST_CHECK_NE(reference, cache.get(3, 3, kernel, 12, 10, compute));
+  BOOST_CHECK_NE(reference, cache.get(3, 3, kernel, 10, 12, compute));
+  BOOST_CHECK_NE(reference, cache.get(1, 9, kernel, 10, 10, compute));
+  BOOST_CHECK_EQUAL(computed, 5);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Eviction_test, FFTKernelCache_Fixture) {
+  std::vector<float> kernel(1, 0.);
+  // Each entry takes 101 floats, so only three fit
+  cache.setMaxMemory(3 * 101 * sizeof(float));
+
+  for (int i = 0; i < 4; ++i) {
+    kernel[0] = i;
+    cache.get(1, 1, kernel, 10, 10, compute);
+  }
+  BOOST_CHECK_EQUAL(computed, 4);
+  BOOST_CHECK_LE(cache.getStatistics().m_memory, 3 * 101 * sizeof(float));
+
+  // The last three are still there, the first one was dropped
+  for (int i = 3; i > 0; --i) {
+    kernel[0] = i;
+    cache.get(1, 1, kernel, 10, 10, compute);
+  }
+  BOOST_CHECK_EQUAL(computed, 4);
+  kernel[0] = 0;
+  cache.get(1, 1, kernel, 10, 10, compute);
+  BOOST_CHECK_EQUAL(computed, 5);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(Disabled_test, FFTKernelCache_Fixture) {
+  std::vector<float> kernel{1};
+  cache.setMaxMemory(0);
+
+  auto first = cache.get(1, 1, kernel, 10, 10, compute);
+  auto second = cache.get(1, 1, kernel, 10, 10, compute);
+  BOOST_CHECK_EQUAL(computed, 2);
+  BOOST_CHECK_EQUAL(first->front(), 1.);
+  BOOST_CHECK_EQUAL(second->front(), 2.);
+  BOOST_CHECK_EQUAL(cache.getStatistics().m_memory, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(SharedContext_test, FFTKernelCache_Fixture) {
+  auto kernel = VectorImage<float>::create(3, 3, std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+  auto kernel_copy = VectorImage<float>::create(*kernel);
+  auto image = VectorImage<float>::create(20, 20);
+
+  DFTConvolution<float, PaddedImage<float>> dft{kernel}, dft_copy{kernel_copy};
+  auto before = cache.getStatistics();
+  auto context = dft.prepare(image);
+  auto context_copy = dft_copy.prepare(image);
+  auto after = cache.getStatistics();
+
+  BOOST_CHECK_EQUAL(after.m_misses - before.m_misses, 1);
+  BOOST_CHECK_EQUAL(after.m_hits - before.m_hits, 1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
 #include "SEFramework/FFT/FFTHelper.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEUtils/TestUtils.h"
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <numeric>
 
@@ -87,4 +88,62 @@ BOOST_AUTO_TEST_CASE(FFT_float_symmetric_double_test) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE(FFT_plan_cache_test) {
+  std::vector<float> scratch;
+  auto fwd_plan = FFT<float>::createForwardPlan(6, 10, scratch);
+  auto inv_plan = FFT<float>::createInversePlan(6, 10, scratch);
+
+  BOOST_CHECK_EQUAL(fwd_plan, FFT<float>::createForwardPlan(6, 10, scratch));
+  BOOST_CHECK_EQUAL(inv_plan, FFT<float>::createInversePlan(6, 10, scratch));
+  BOOST_CHECK_NE(fwd_plan, FFT<float>::createForwardPlan(10, 6, scratch));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(FFT_wisdom_test) {
+  auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+  BOOST_CHECK(!fftImportWisdom(path.native()));
+
+  fftSetPlanningRigor(FFTPlanningRigor::MEASURE);
+  std::vector<float> float_scratch;
+  FFT<float>::createForwardPlan(12, 12, float_scratch);
+  std::vector<double> double_scratch;
+  FFT<double>::createForwardPlan(12, 12, double_scratch);
+  fftSetPlanningRigor(FFTPlanningRigor::ESTIMATE);
+
+  fftExportWisdom(path.native());
+  BOOST_CHECK(fftImportWisdom(path.native()));
+
+  boost::filesystem::remove(path);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(FFT_plan_cache_full_test) {
+  std::vector<float> scratch;
+  auto cached = FFT<float>::createForwardPlan(5, 7, scratch);
+  BOOST_CHECK_EQUAL(cached, FFT<float>::createForwardPlan(5, 7, scratch));
+
+  // More sizes than the cache can hold
+  for (int width = 1; width <= 1100; ++width) {
+    FFT<float>::createForwardPlan(width, 3, scratch);
+  }
+
+  // Plans cached before are still reused
+  BOOST_CHECK_EQUAL(cached, FFT<float>::createForwardPlan(5, 7, scratch));
+
+  // New sizes are planned each time, and the plans work
+  auto uncached = FFT<float>::createForwardPlan(1101, 3, scratch);
+  BOOST_CHECK_NE(uncached, FFT<float>::createForwardPlan(1101, 3, scratch));
+
+  // A constant image, the padding is ignored
+  std::fill(scratch.begin(), scratch.end(), 1.f);
+  FFT<float>::executeForward(uncached, scratch);
+  BOOST_CHECK_CLOSE(scratch[0], 3 * 1101, 1e-3);
+  BOOST_CHECK_SMALL(scratch[1], 1e-2f);
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MmapFitsImageSource_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "ElementsKernel/Temporary.h"
+
+#include "SEFramework/FITS/MmapFitsImageSource.h"
+
+using namespace SourceXtractor;
+
+namespace {
+const int WIDTH = 67, HEIGHT = 45;
+const int EXT_WIDTH = 31, EXT_HEIGHT = 52;
+}
+
+struct MmapFitsImageSourceFixture {
+  Elements::TempFile temp_file;
+  std::string path;
+
+  /*
+   * HDU 1: float image
+   * HDU 2: double image
+   * HDU 3: float image with BSCALE/BZERO
+   */
+  MmapFitsImageSourceFixture() : temp_file("MmapFitsImageSource_test_%%%%%%.fits") {
+    path = temp_file.path().native();
+
+    int status = 0;
+    fitsfile* fptr = nullptr;
+    fits_create_file(&fptr, ("!" + path).c_str(), &status);
+
+    long primary_naxes[2] = {WIDTH, HEIGHT};
+    std::vector<float> primary(WIDTH * HEIGHT);
+    for (std::size_t i = 0; i < primary.size(); ++i) {
+      primary[i] = i * 0.5f - 100.f;
+    }
+    fits_create_img(fptr, FLOAT_IMG, 2, primary_naxes, &status);
+    fits_write_img(fptr, TFLOAT, 1, primary.size(), primary.data(), &status);
+
+    long ext_naxes[2] = {EXT_WIDTH, EXT_HEIGHT};
+    std::vector<double> ext(EXT_WIDTH * EXT_HEIGHT);
+    for (std::size_t i = 0; i < ext.size(); ++i) {
+      ext[i] = 1e3 - i * 0.25;
+    }
+    fits_create_img(fptr, DOUBLE_IMG, 2, ext_naxes, &status);
+    fits_write_img(fptr, TDOUBLE, 1, ext.size(), ext.data(), &status);
+
+    // The keywords are written after the pixels, so these are stored unscaled
+    double bscale = 2., bzero = 10.;
+    fits_create_img(fptr, FLOAT_IMG, 2, primary_naxes, &status);
+    fits_write_img(fptr, TFLOAT, 1, primary.size(), primary.data(), &status);
+    fits_write_key(fptr, TDOUBLE, "BSCALE", &bscale, nullptr, &status);
+    fits_write_key(fptr, TDOUBLE, "BZERO", &bzero, nullptr, &status);
+
+    fits_close_file(fptr, &status);
+    BOOST_REQUIRE_EQUAL(status, 0);
+  }
+
+  // Compares tiles from both sources, covering borders and interior rows
+  template <typename T>
+  void checkSameTiles(const std::shared_ptr<ImageSource>& mapped, const std::shared_ptr<ImageSource>& reference) {
+    BOOST_REQUIRE_EQUAL(mapped->getWidth(), reference->getWidth());
+    BOOST_REQUIRE_EQUAL(mapped->getHeight(), reference->getHeight());
+
+    int width = mapped->getWidth(), height = mapped->getHeight();
+    std::vector<std::vector<int>> tiles{
+        {0, 0, width, height}, {0, 0, 7, 5}, {width - 9, height - 4, 9, 4}, {3, 11, width / 2, 13}};
+    for (auto& t : tiles) {
+      auto mapped_tile = mapped->getImageTile(t[0], t[1], t[2], t[3]);
+      auto reference_tile = reference->getImageTile(t[0], t[1], t[2], t[3]);
+      for (int y = t[1]; y < t[1] + t[3]; ++y) {
+        for (int x = t[0]; x < t[0] + t[2]; ++x) {
+          BOOST_CHECK_EQUAL(mapped_tile->getValue<T>(x, y), reference_tile->getValue<T>(x, y));
+        }
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(MmapFitsImageSource_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(primary_hdu_test, MmapFitsImageSourceFixture) {
+  auto mapped = std::make_shared<MmapFitsImageSource>(path, 1, ImageTile::FloatImage);
+  auto reference = std::make_shared<FitsImageSource>(path, 1, ImageTile::FloatImage);
+  BOOST_CHECK(mapped->isMapped());
+  checkSameTiles<float>(mapped, reference);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(extension_hdu_test, MmapFitsImageSourceFixture) {
+  auto mapped = std::make_shared<MmapFitsImageSource>(path, 2, ImageTile::DoubleImage);
+  auto reference = std::make_shared<FitsImageSource>(path, 2, ImageTile::DoubleImage);
+  BOOST_CHECK(mapped->isMapped());
+  BOOST_CHECK_EQUAL(mapped->getWidth(), EXT_WIDTH);
+  BOOST_CHECK_EQUAL(mapped->getHeight(), EXT_HEIGHT);
+  checkSameTiles<double>(mapped, reference);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(type_mismatch_test, MmapFitsImageSourceFixture) {
+  auto mapped = std::make_shared<MmapFitsImageSource>(path, 2, ImageTile::FloatImage);
+  auto reference = std::make_shared<FitsImageSource>(path, 2, ImageTile::FloatImage);
+  BOOST_CHECK(!mapped->isMapped());
+  checkSameTiles<float>(mapped, reference);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(scaled_hdu_test, MmapFitsImageSourceFixture) {
+  auto mapped = std::make_shared<MmapFitsImageSource>(path, 3, ImageTile::FloatImage);
+  auto reference = std::make_shared<FitsImageSource>(path, 3, ImageTile::FloatImage);
+  BOOST_CHECK(!mapped->isMapped());
+  checkSameTiles<float>(mapped, reference);
+  // BSCALE and BZERO are applied
+  BOOST_CHECK_EQUAL(mapped->getImageTile(0, 0, 1, 1)->getValue<float>(0, 0), 2 * -100.f + 10.f);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(extended_syntax_test, MmapFitsImageSourceFixture) {
+  auto mapped = std::make_shared<MmapFitsImageSource>(path + "[1]", 0, ImageTile::DoubleImage);
+  auto reference = std::make_shared<FitsImageSource>(path + "[1]", 0, ImageTile::DoubleImage);
+  BOOST_CHECK(!mapped->isMapped());
+  checkSameTiles<double>(mapped, reference);
+
+  mapped = std::make_shared<MmapFitsImageSource>(path + "[0][10:40,5:30]", 0, ImageTile::FloatImage);
+  reference = std::make_shared<FitsImageSource>(path + "[0][10:40,5:30]", 0, ImageTile::FloatImage);
+  BOOST_CHECK(!mapped->isMapped());
+  BOOST_CHECK_EQUAL(mapped->getWidth(), 31);
+  BOOST_CHECK_EQUAL(mapped->getHeight(), 26);
+  checkSameTiles<float>(mapped, reference);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//-----------------------------------------------------------------------------
@@ -123,5 +123,30 @@ BOOST_FIXTURE_TEST_CASE ( Wrap_test, PaddedImage_Fixture ) {
   BOOST_CHECK(compareImages(expected, padded));
 }
 
+// copyPadded must write the same pixels the padded image has, leaving the stride gap alone
+BOOST_FIXTURE_TEST_CASE ( CopyPadded_test, PaddedImage_Fixture ) {
+  const int stride = 9;
+  std::vector<SeFloat> buffer(stride * 7, -1);
+
+  PaddedImage<SeFloat, Reflect101Coordinates>::copyPadded(*img, 7, 7, buffer.data(), stride);
+  auto reflected = PaddedImage<SeFloat, Reflect101Coordinates>::create(img, 7, 7);
+  auto reflected_chunk = reflected->getChunk(0, 0, 7, 7);
+  for (int y = 0; y < 7; ++y) {
+    for (int x = 0; x < 7; ++x) {
+      BOOST_CHECK_EQUAL(buffer[x + y * stride], reflected_chunk->getValue(x, y));
+    }
+    BOOST_CHECK_EQUAL(buffer[7 + y * stride], -1);
+  }
+
+  PaddedImage<SeFloat>::copyPadded(*img, 5, 5, buffer.data(), stride, 42);
+  auto constant = PaddedImage<SeFloat>::create(img, 5, 5, SeFloat(42));
+  auto constant_chunk = constant->getChunk(0, 0, 5, 5);
+  for (int y = 0; y < 5; ++y) {
+    for (int x = 0; x < 5; ++x) {
+      BOOST_CHECK_EQUAL(buffer[x + y * stride], constant_chunk->getValue(x, y));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
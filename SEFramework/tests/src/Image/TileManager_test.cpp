@@ -0,0 +1,273 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * TileManager_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include "SEFramework/Image/TileManager.h"
+
+using namespace SourceXtractor;
+
+/**
+ * Each pixel value encodes its own coordinates, and counts how many tiles have been read
+ */
+class CountingImageSource : public ImageSource {
+public:
+  CountingImageSource(int width, int height) : m_width(width), m_height(height), m_reads(0) {}
+
+  virtual ~CountingImageSource() = default;
+
+  std::string getRepr() const override {
+    return "CountingImageSource";
+  }
+
+  void saveTile(ImageTile&) override {
+  }
+
+  int getWidth() const override {
+    return m_width;
+  }
+
+  int getHeight() const override {
+    return m_height;
+  }
+
+  std::shared_ptr<ImageTile> getImageTile(int x, int y, int width, int height) const override {
+    ++m_reads;
+    auto tile = ImageTile::create(ImageTile::IntImage, x, y, width, height);
+    for (int iy = y; iy < y + height; ++iy) {
+      for (int ix = x; ix < x + width; ++ix) {
+        tile->setValue(ix, iy, ix + iy * m_width);
+      }
+    }
+    return tile;
+  }
+
+  ImageTile::ImageType getType() const override {
+    return ImageTile::IntImage;
+  }
+
+  int getReads() const {
+    return m_reads;
+  }
+
+private:
+  int m_width, m_height;
+  mutable std::atomic<int> m_reads;
+};
+
+/**
+ * Replay a sequence of tile accesses on a cache with room for `capacity` tiles,
+ * and return the number of misses
+ */
+static int replay(TileEvictionPolicy& policy, std::shared_ptr<const ImageSource> source,
+                  const std::vector<int>& accesses, std::size_t capacity) {
+  std::set<int> resident, referenced;
+  int misses = 0;
+  auto referenced_func = [&referenced](const TileKey& key) {
+    return referenced.erase(key.m_tile_x) > 0;
+  };
+
+  for (auto x : accesses) {
+    if (resident.count(x)) {
+      referenced.insert(x);
+      continue;
+    }
+    ++misses;
+    if (resident.size() >= capacity) {
+      auto victim = policy.evict(referenced_func);
+      resident.erase(victim.m_tile_x);
+    }
+    policy.insert(TileKey{source, x, 0});
+    resident.insert(x);
+  }
+  return misses;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (TileManager_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (CacheHit_test) {
+  auto tile_manager = std::make_shared<TileManager>();
+  tile_manager->setOptions(64, 64, 16);
+  auto source = std::make_shared<CountingImageSource>(256, 256);
+
+  auto tile = tile_manager->getTileForPixel(10, 10, source);
+  BOOST_CHECK_EQUAL(tile->getPosX(), 0);
+  BOOST_CHECK_EQUAL(tile->getPosY(), 0);
+  BOOST_CHECK_EQUAL(tile->getValue<int>(10, 10), 10 + 10 * 256);
+  BOOST_CHECK_EQUAL(source->getReads(), 1);
+
+  // Same tile, from this thread and from another one
+  BOOST_CHECK_EQUAL(tile_manager->getTileForPixel(63, 63, source), tile);
+  std::thread other([&]() {
+    BOOST_CHECK_EQUAL(tile_manager->getTileForPixel(0, 0, source), tile);
+  });
+  other.join();
+  BOOST_CHECK_EQUAL(source->getReads(), 1);
+
+  // A flush must invalidate the per-thread cache too
+  tile_manager->flush();
+  BOOST_CHECK_NE(tile_manager->getTileForPixel(10, 10, source), tile);
+  BOOST_CHECK_EQUAL(source->getReads(), 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Eviction_test) {
+  auto tile_manager = std::make_shared<TileManager>();
+  // 256x256 int tiles use 256 KiB, so only four fit
+  tile_manager->setOptions(256, 256, 1);
+  auto source = std::make_shared<CountingImageSource>(2048, 256);
+
+  for (int x = 0; x < 2048; x += 256) {
+    tile_manager->getTileForPixel(x, 0, source);
+  }
+  BOOST_CHECK_EQUAL(source->getReads(), 8);
+
+  // Some must have been evicted, and be read again
+  for (int x = 0; x < 2048; x += 256) {
+    auto tile = tile_manager->getTileForPixel(x, 0, source);
+    BOOST_CHECK_EQUAL(tile->getValue<int>(x + 1, 1), x + 1 + 2048);
+  }
+  BOOST_CHECK_GT(source->getReads(), 8);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Concurrent_test) {
+  auto tile_manager = std::make_shared<TileManager>();
+  tile_manager->setOptions(32, 32, 1);
+  auto source = std::make_shared<CountingImageSource>(1024, 1024);
+
+  std::atomic<int> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 20000; ++i) {
+        int x = (i * 37 + t * 101) % 1024;
+        int y = (i * 53 + t * 29) % 1024;
+        auto tile = tile_manager->getTileForPixel(x, y, source);
+        if (!tile->isPixelInTile(x, y) || tile->getValue<int>(x, y) != x + y * 1024) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+/**
+ * A hot set of tiles reused all the time, while a scan goes over many tiles used only once.
+ * FIFO keeps losing the hot set, CLOCK and 2Q should not.
+ */
+BOOST_AUTO_TEST_CASE (ScanResistance_test) {
+  auto source = std::make_shared<CountingImageSource>(1, 1);
+
+  std::vector<int> accesses;
+  for (int x = 0; x < 200; ++x) {
+    accesses.push_back(1000 + x);
+    accesses.push_back(x % 4);
+  }
+
+  auto fifo = TileEvictionPolicy::create(TileEvictionPolicy::Type::FIFO);
+  auto clock = TileEvictionPolicy::create(TileEvictionPolicy::Type::CLOCK);
+  auto two_q = TileEvictionPolicy::create(TileEvictionPolicy::Type::TWO_Q);
+
+  int fifo_misses = replay(*fifo, source, accesses, 8);
+  int clock_misses = replay(*clock, source, accesses, 8);
+  int two_q_misses = replay(*two_q, source, accesses, 8);
+
+  // The scan always misses, the hot set should only miss a few times
+  BOOST_CHECK_GT(fifo_misses, 250);
+  BOOST_CHECK_LT(clock_misses, 210);
+  BOOST_CHECK_LT(two_q_misses, 210);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Statistics_test) {
+  auto tile_manager = std::make_shared<TileManager>();
+  tile_manager->setOptions(256, 256, 1, TileEvictionPolicy::Type::CLOCK);
+  auto source = std::make_shared<CountingImageSource>(2048, 256);
+
+  for (int x = 0; x < 2048; x += 256) {
+    tile_manager->getTileForPixel(x, 0, source);
+  }
+  // Force the publication of the pending hits
+  tile_manager->getTileForPixel(0, 0, source);
+  for (int i = 0; i < 2048; ++i) {
+    tile_manager->getTileForPixel(1792, 0, source);
+  }
+
+  auto stats = tile_manager->getStatistics();
+  BOOST_CHECK_GE(stats.m_misses, 8u);
+  BOOST_CHECK_EQUAL(stats.m_misses, static_cast<std::uint64_t>(source->getReads()));
+  BOOST_CHECK_EQUAL(stats.m_evictions, stats.m_misses - 4);
+  BOOST_CHECK_GE(stats.m_hits, 1024u);
+  BOOST_CHECK_LE(stats.m_memory_used, 1024L * 1024L);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (Prefetch_test) {
+  auto tile_manager = std::make_shared<TileManager>();
+  tile_manager->setOptions(64, 64, 16);
+  auto source = std::make_shared<CountingImageSource>(256, 256);
+
+  // Second row of tiles
+  tile_manager->prefetch(0, 64, 256, 64, source);
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (tile_manager->getStatistics().m_prefetched < 4 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(tile_manager->getStatistics().m_prefetched, 4u);
+  BOOST_CHECK_EQUAL(source->getReads(), 4);
+
+  // They must be there already
+  for (int x = 0; x < 256; x += 64) {
+    auto tile = tile_manager->getTileForPixel(x, 100, source);
+    BOOST_CHECK_EQUAL(tile->getValue<int>(x, 100), x + 100 * 256);
+  }
+  BOOST_CHECK_EQUAL(source->getReads(), 4);
+  BOOST_CHECK_EQUAL(tile_manager->getStatistics().m_misses, 0u);
+
+  // Cached tiles are not read again
+  tile_manager->prefetch(0, 64, 256, 64, source);
+  tile_manager->flush();
+  BOOST_CHECK_EQUAL(source->getReads(), 4);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -56,6 +56,30 @@ class TestGroupingCriteria : public GroupingCriteria {
   }
 };
 
+struct RectProperty : public Property {
+  PixelRectangle rect;
+  RectProperty(PixelRectangle rect) : rect(rect) { }
+};
+
+// Groups sources whose rectangles overlap, and counts how many pairs it was asked about
+class BoundedGroupingCriteria : public GroupingCriteria {
+public:
+  bool shouldGroup(const SourceInterface& first, const SourceInterface& second) const override {
+    ++m_comparisons;
+    auto& a = first.getProperty<RectProperty>().rect;
+    auto& b = second.getProperty<RectProperty>().rect;
+    return a.getTopLeft().m_x <= b.getBottomRight().m_x && b.getTopLeft().m_x <= a.getBottomRight().m_x &&
+           a.getTopLeft().m_y <= b.getBottomRight().m_y && b.getTopLeft().m_y <= a.getBottomRight().m_y;
+  }
+
+  bool getSearchRegion(const SourceInterface& source, PixelRectangle& region) const override {
+    region = source.getProperty<RectProperty>().rect;
+    return true;
+  }
+
+  mutable int m_comparisons = 0;
+};
+
 class SourceGroupObserver : public Observer<SourceGroupInterface> {
 public:
   virtual void handleMessage(const SourceGroupInterface& group) override {
@@ -194,6 +218,61 @@ BOOST_FIXTURE_TEST_CASE( grouping_limit, SourceGroupingFixture ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_FIXTURE_TEST_CASE( bounded_grouping_test, SourceGroupingFixture ) {
+  auto criteria = new BoundedGroupingCriteria;
+  auto bounded_grouping = std::make_shared<SourceGrouping>(
+    std::unique_ptr<GroupingCriteria>(criteria), group_factory, 0);
+  bounded_grouping->addObserver(source_group_observer);
+
+  source_a->setProperty<RectProperty>(PixelRectangle({0, 0}, {10, 10}));
+  source_b->setProperty<RectProperty>(PixelRectangle({500, 500}, {510, 510}));
+  source_c->setProperty<RectProperty>(PixelRectangle({8, 8}, {20, 20}));
+
+  bounded_grouping->receiveSource(std::move(source_a));
+  bounded_grouping->receiveSource(std::move(source_b));
+  bounded_grouping->receiveSource(std::move(source_c));
+
+  // Neither B nor C are compared with sources far away
+  BOOST_CHECK_EQUAL(criteria->m_comparisons, 1);
+
+  bounded_grouping->receiveProcessSignal(ProcessSourcesEvent { select_all_criteria } );
+
+  BOOST_REQUIRE_EQUAL(source_group_observer->m_list.size(), 2);
+  BOOST_CHECK((source_group_observer->m_list[0] == std::vector<std::string>{"A", "C"}));
+  BOOST_CHECK((source_group_observer->m_list[1] == std::vector<std::string>{"B"}));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( bounded_merge_test, SourceGroupingFixture ) {
+  auto criteria = new BoundedGroupingCriteria;
+  auto bounded_grouping = std::make_shared<SourceGrouping>(
+    std::unique_ptr<GroupingCriteria>(criteria), group_factory, 0);
+  bounded_grouping->addObserver(source_group_observer);
+
+  std::unique_ptr<SourceInterface> source_d {new SimpleSource};
+  source_d->setProperty<IdProperty>("D");
+
+  source_a->setProperty<RectProperty>(PixelRectangle({0, 0}, {10, 10}));
+  source_b->setProperty<RectProperty>(PixelRectangle({100, 0}, {110, 10}));
+  source_c->setProperty<RectProperty>(PixelRectangle({300, 300}, {310, 310}));
+  // Bridges A and B
+  source_d->setProperty<RectProperty>(PixelRectangle({5, 5}, {105, 5}));
+
+  bounded_grouping->receiveSource(std::move(source_a));
+  bounded_grouping->receiveSource(std::move(source_b));
+  bounded_grouping->receiveSource(std::move(source_c));
+  bounded_grouping->receiveSource(std::move(source_d));
+
+  bounded_grouping->receiveProcessSignal(ProcessSourcesEvent { select_all_criteria } );
+
+  BOOST_REQUIRE_EQUAL(source_group_observer->m_list.size(), 2);
+  BOOST_CHECK((source_group_observer->m_list[0] == std::vector<std::string>{"A", "D", "B"}));
+  BOOST_CHECK((source_group_observer->m_list[1] == std::vector<std::string>{"C"}));
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 
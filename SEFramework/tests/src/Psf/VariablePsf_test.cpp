@@ -230,4 +230,35 @@ BOOST_AUTO_TEST_CASE(x_y_cubic_fractional) {
   checkEqual(psf, cubic_expected);
 }
 
+/// With the cache, the PSF of every value within a bin is the one at the bin centre
+BOOST_AUTO_TEST_CASE(cached) {
+  VariablePsf reference{1, {{"x", 0, 50., 5.}, {"y", 1, 20., 3.}}, {2, 1}, {constant, x, x2, y, xy, x2y}};
+  VariablePsf varPsf{1, {{"x", 0, 50., 5.}, {"y", 1, 20., 3.}}, {2, 1}, {constant, x, x2, y, xy, x2y}};
+  varPsf.setCache(4., 1024 * 1024);
+
+  auto expected = reference.getPsf({102., 22.});
+  checkEqual(varPsf.getPsf({100.5, 21.}), expected);
+  checkEqual(varPsf.getPsf({103.9, 23.9}), expected);
+
+  // The caller can modify its copy
+  auto psf = varPsf.getPsf({101., 22.});
+  psf->at(0, 0) = -1;
+  checkEqual(varPsf.getPsf({101., 22.}), expected);
+
+  // Next bin
+  checkEqual(varPsf.getPsf({104., 22.}), reference.getPsf({106., 22.}));
+}
+
+/// The cache can not hold more PSFs than allowed by the memory limit
+BOOST_AUTO_TEST_CASE(cached_eviction) {
+  VariablePsf reference{1, {{"x", 0, 5., 2.}}, {1}, {constant, x}};
+  VariablePsf varPsf{1, {{"x", 0, 5., 2.}}, {1}, {constant, x}};
+  // Room for a single 3x3 PSF
+  varPsf.setCache(1., 9 * sizeof(SeFloat));
+
+  checkEqual(varPsf.getPsf({8.}), reference.getPsf({8.5}));
+  checkEqual(varPsf.getPsf({9.}), reference.getPsf({9.5}));
+  checkEqual(varPsf.getPsf({8.2}), reference.getPsf({8.5}));
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
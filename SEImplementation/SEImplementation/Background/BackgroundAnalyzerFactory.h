@@ -26,6 +26,8 @@
 
 #include "Configuration/Configuration.h"
 
+#include "AlexandriaKernel/ThreadPool.h"
+#include "SEImplementation/Background/SE/BackgroundCache.h"
 #include "SEImplementation/Configuration/SE2BackgroundConfig.h"
 #include "SEImplementation/Configuration/WeightImageConfig.h"
 
@@ -49,6 +51,8 @@ private:
   std::vector<int> m_cell_size;
   std::vector<int> m_smoothing_box;
   WeightImageConfig::WeightType m_weight_type;
+  std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
+  std::shared_ptr<BackgroundCache> m_cache;
 };
 
 }
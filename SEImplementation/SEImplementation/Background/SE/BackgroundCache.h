@@ -0,0 +1,102 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef SOURCEXTRACTORPLUSPLUS_BACKGROUNDCACHE_H
+#define SOURCEXTRACTORPLUSPLUS_BACKGROUNDCACHE_H
+
+#include <string>
+
+#include <boost/uuid/detail/sha1.hpp>
+
+#include "SEFramework/Image/Image.h"
+#include "SEFramework/Image/VectorImage.h"
+
+namespace SourceXtractor {
+
+/**
+ * Keeps the low resolution background meshes computed by SEBackgroundLevelAnalyzer on disk,
+ * so later runs over the same image can skip the estimation.
+ * @details
+ *  Each entry is a FITS file in the cache directory, named after its key. The first HDU contains the
+ *  mode mesh, the second the sigma mesh and, if the image had a weight map, the third contains the
+ *  mode of the variance (kept for inspection, only the scaling factor derived from it is needed).
+ *  The primary header records the full digest of the key and the number of meshes. The file name only
+ *  uses part of the digest, so the stored one is compared on load. Entries are written to a temporary
+ *  file that is renamed once complete, so a partially written entry is never visible.
+ *
+ *  Any problem reading an entry is reported as a cache miss, so a broken cache costs only the time
+ *  to recompute the model.
+ */
+class BackgroundCache {
+public:
+  struct Entry {
+    std::shared_ptr<VectorImage<DetectionImage::PixelType>> m_mode, m_sigma, m_variance_mode;
+    SeFloat m_scaling;
+  };
+
+  /**
+   * Identifies an entry by everything the meshes depend on, summarized as a SHA-1 digest
+   */
+  class Key {
+  public:
+    /**
+     * Constructor
+     * @param description
+     *    Parameters of the estimation and sizes of the images
+     */
+    explicit Key(const std::string& description);
+
+    /**
+     * Add the pixel values of an image to the digest, reading it in chunks of full rows
+     */
+    void addImage(const Image<SeFloat>& image);
+
+    /**
+     * @return The digest of the description and of the images, in hexadecimal
+     */
+    std::string getDigest() const;
+
+  private:
+    boost::uuids::detail::sha1 m_sha1;
+  };
+
+  /**
+   * Constructor
+   * @param directory
+   *    Where to store the entries. It is created if it does not exist.
+   */
+  explicit BackgroundCache(const std::string& directory);
+
+  /**
+   * @return true, and fills entry, if there is a valid entry for the key
+   */
+  bool load(const Key& key, Entry& entry) const;
+
+  /**
+   * Store the entry. Failures are logged, but not fatal.
+   */
+  void store(const Key& key, const Entry& entry) const;
+
+private:
+  std::string m_directory;
+
+  std::string getPath(const std::string& digest) const;
+};
+
+} // end of namespace SourceXtractor
+
+#endif // SOURCEXTRACTORPLUSPLUS_BACKGROUNDCACHE_H
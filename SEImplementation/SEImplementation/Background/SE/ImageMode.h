@@ -18,6 +18,7 @@
 #ifndef SOURCEXTRACTORPLUSPLUS_IMAGEMODE_H
 #define SOURCEXTRACTORPLUSPLUS_IMAGEMODE_H
 
+#include "AlexandriaKernel/ThreadPool.h"
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Image/VectorImage.h"
 
@@ -64,11 +65,14 @@ public:
    *    Relative tolerance used to test for convergence around the median
    * @param max_iter
    *    Maximum number of iterations
+   * @param thread_pool
+   *    If not null, the rows of cells are processed in parallel on this pool
    */
   ImageMode(const std::shared_ptr<Image<T>>& image, const std::shared_ptr<Image<T>>& variance,
             int cell_w, int cell_h,
             T invalid_value, T kappa1 = 2, T kappa2 = 5, T kappa3 = 3,
-            T rtol = 1e-4, size_t max_iter = 100);
+            T rtol = 1e-4, size_t max_iter = 100,
+            const std::shared_ptr<Euclid::ThreadPool>& thread_pool = nullptr);
 
   /**
    * Destructor
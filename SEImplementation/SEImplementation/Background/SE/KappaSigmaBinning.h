@@ -19,6 +19,8 @@
 #define SOURCEXTRACTORPLUSPLUS_KAPPASIGMABINNING_H
 
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include "Histogram/Histogram.h"
 
 namespace SourceXtractor {
@@ -67,13 +69,12 @@ public:
    */
   template<typename Iterator>
   void computeBins(Iterator begin, Iterator end) {
+    using category = typename std::iterator_traits<Iterator>::iterator_category;
+
     // Compute mean and standard deviation of the original data set
     double mean, sigma;
     size_t ndata;
-    Stats stats;
-    for (auto i = begin; i != end; ++i) {
-      stats(*i);
-    }
+    Stats stats = accumulate<false>(begin, end, 0, 0, category());
     std::tie(mean, sigma, ndata) = stats.get();
 
     if (sigma == 0) {
@@ -88,11 +89,7 @@ public:
     auto hcut = mean + sigma;
 
     // Re-compute mean and standard deviation of values within cut
-    stats.reset();
-    for (auto i = begin; i != end; ++i) {
-      if (*i >= lcut && *i <= hcut)
-        stats(*i);
-    }
+    stats = accumulate<true>(begin, end, lcut, hcut, category());
     std::tie(mean, sigma, ndata) = stats.get();
 
     assert(ndata > 0);
@@ -160,6 +157,53 @@ private:
       ndata = 0;
     }
   };
+
+  /**
+   * Accumulate the values within [lcut, hcut] if Clip is true. Otherwise, accumulate all of them, NaN included.
+   */
+  template<bool Clip, typename Iterator>
+  static Stats accumulate(Iterator begin, Iterator end, double lcut, double hcut, std::input_iterator_tag) {
+    Stats stats;
+    for (auto i = begin; i != end; ++i) {
+      if (!Clip || (*i >= lcut && *i <= hcut))
+        stats(*i);
+    }
+    return stats;
+  }
+
+  /**
+   * Same, but spread over independent lanes without branches, so the loop can be vectorized
+   * (a single accumulator can not, as floating point additions can not be reordered)
+   */
+  template<bool Clip, typename Iterator>
+  static Stats accumulate(Iterator begin, Iterator end, double lcut, double hcut, std::random_access_iterator_tag) {
+    constexpr size_t nlanes = 4;
+    double sum[nlanes] = {0}, sum2[nlanes] = {0}, count[nlanes] = {0};
+
+    size_t n = end - begin, i = 0;
+    for (; i + nlanes <= n; i += nlanes) {
+      for (size_t l = 0; l < nlanes; ++l) {
+        VarType v = begin[i + l];
+        bool in = !Clip || (v >= lcut && v <= hcut);
+        sum[l] += in ? v : 0.;
+        sum2[l] += in ? v * v : 0.;
+        count[l] += in;
+      }
+    }
+
+    Stats stats;
+    for (; i < n; ++i) {
+      VarType v = begin[i];
+      if (!Clip || (v >= lcut && v <= hcut))
+        stats(v);
+    }
+    for (size_t l = 0; l < nlanes; ++l) {
+      stats.mean += sum[l];
+      stats.sigma += sum2[l];
+      stats.ndata += static_cast<size_t>(count[l]);
+    }
+    return stats;
+  }
 };
 
 } // end of namespace SourceXtractor
@@ -20,7 +20,12 @@
 
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/WriteableImage.h"
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <set>
 
 namespace SourceXtractor {
 
@@ -76,15 +81,42 @@ public:
     auto out_img = VectorImage<T>::create(image.getWidth(), image.getHeight());
     auto out_var = VectorImage<T>::create(image.getWidth(), image.getHeight());
 
+    SlidingMedian img_box, var_box;
+
     for (int y = 0; y < image.getHeight(); ++y) {
+      int hh = clip(y, m_box_height, image.getHeight());
+      img_box.clear();
+      var_box.clear();
+
+      // Columns currently inside the box
+      int first = 0, last = -1;
+
       for (int x = 0; x < image.getWidth(); ++x) {
-        auto box = getBox(image, x, y);
-        auto median = getMedian(box);
+        int hw = clip(x, m_box_width, image.getWidth());
+        int new_first = x - hw, new_last = x + hw;
+
+        // Move the box along the row: only the columns leaving and entering it are updated.
+        // Near the edges the box grows or shrinks on both sides, so up to two columns per side change
+        for (int ix = first; ix <= std::min(last, new_first - 1); ++ix) {
+          updateColumn(image, variance, img_box, var_box, ix, y, hh, false);
+        }
+        for (int ix = std::max(first, new_last + 1); ix <= last; ++ix) {
+          updateColumn(image, variance, img_box, var_box, ix, y, hh, false);
+        }
+        for (int ix = new_first; ix <= std::min(new_last, first - 1); ++ix) {
+          updateColumn(image, variance, img_box, var_box, ix, y, hh, true);
+        }
+        for (int ix = std::max(new_first, last + 1); ix <= new_last; ++ix) {
+          updateColumn(image, variance, img_box, var_box, ix, y, hh, true);
+        }
+        first = new_first;
+        last = new_last;
+
+        auto median = img_box.getMedian();
         auto value = image.getValue(x, y);
         if (std::abs(median - value) >= threshold) {
           out_img->setValue(x, y, median);
-          auto var_box = getBox(variance, x, y);
-          out_var->setValue(x, y, getMedian(var_box));
+          out_var->setValue(x, y, var_box.getMedian());
         }
         else {
           out_img->setValue(x, y, value);
@@ -100,16 +132,79 @@ private:
   int m_box_width, m_box_height;
 
   /**
-   * Convenience method to compute the median of a vector
-   * @param data
-   *    The vector on which to compute the median. *It will be modified*.
+   * Median of a multiset of values that can be updated incrementally, in O(log n) per insertion or removal.
+   * The lower half is kept in m_low, and the upper half in m_high, with m_low holding one extra value
+   * when the count is odd.
+   * NaN values are ignored, they have no place in the ordering of the sets. If there are only NaN values,
+   * the median is NaN.
    */
-  static T getMedian(std::vector<T>& data) {
-    std::sort(data.begin(), data.end());
-    auto nitems = data.size();
-    if (nitems % 2 == 1)
-      return data[nitems / 2];
-    return (data[nitems / 2] + data[nitems / 2 - 1]) / 2;
+  class SlidingMedian {
+  public:
+    void insert(T value) {
+      if (std::isnan(value))
+        return;
+      if (m_low.empty() || value <= *m_low.rbegin())
+        m_low.insert(value);
+      else
+        m_high.insert(value);
+      rebalance();
+    }
+
+    void erase(T value) {
+      if (std::isnan(value))
+        return;
+      // Values equal to the maximum of the lower half may be on either side, any of them will do
+      if (value <= *m_low.rbegin())
+        m_low.erase(m_low.find(value));
+      else
+        m_high.erase(m_high.find(value));
+      rebalance();
+    }
+
+    void clear() {
+      m_low.clear();
+      m_high.clear();
+    }
+
+    T getMedian() const {
+      if (m_low.empty())
+        return std::numeric_limits<T>::quiet_NaN();
+      if (m_low.size() > m_high.size())
+        return *m_low.rbegin();
+      return (*m_high.begin() + *m_low.rbegin()) / 2;
+    }
+
+  private:
+    std::multiset<T> m_low, m_high;
+
+    void rebalance() {
+      if (m_low.size() > m_high.size() + 1) {
+        auto last = std::prev(m_low.end());
+        m_high.insert(*last);
+        m_low.erase(last);
+      }
+      else if (m_high.size() > m_low.size()) {
+        m_low.insert(*m_high.begin());
+        m_high.erase(m_high.begin());
+      }
+    }
+  };
+
+  /**
+   * Add (or remove) the pixels of the column ix, between y - hh and y + hh, to the boxes
+   */
+  static void updateColumn(const VectorImage<T>& image, const VectorImage<T>& variance,
+                           SlidingMedian& img_box, SlidingMedian& var_box, int ix, int y, int hh, bool add) {
+    for (int iy = y - hh; iy <= y + hh; ++iy) {
+      if (add) {
+        img_box.insert(image.getValue(ix, iy));
+        var_box.insert(variance.getValue(ix, iy));
+      }
+      else {
+        img_box.erase(image.getValue(ix, iy));
+        var_box.erase(variance.getValue(ix, iy));
+      }
+    }
   }
 
   /**
@@ -125,29 +220,7 @@ private:
    *    As many pixels as could be read safely from the image, up to box_size
    */
   static int clip(int position, int box_size, int image_size) {
-    box_size /= 2;
-    if (box_size > position)
-      return position;
-    if (box_size > image_size - position - 1)
-      return image_size - position - 1;
-    return box_size;
-  }
-
-  /**
-   * Get the pixel values contained within a box centered at x,y
-   */
-  std::vector<T> getBox(const VectorImage<T>& img, int x, int y) const {
-    int hw = clip(x, m_box_width, img.getWidth());
-    int hh = clip(y, m_box_height, img.getHeight());
-    std::vector<T> data;
-    auto inserter = std::back_inserter(data);
-    for (int iy = -hh; iy < hh + 1; ++iy) {
-      for (int ix = -hw; ix < hw + 1; ++ix) {
-        *inserter = img.getValue(x + ix, y + iy);
-        ++inserter;
-      }
-    }
-    return data;
+    return std::min({box_size / 2, position, image_size - position - 1});
   }
 };
 
@@ -18,9 +18,11 @@
 #ifndef SOURCEXTRACTORPLUSPLUS_SEBACKGROUNDLEVELANALYZER_H
 #define SOURCEXTRACTORPLUSPLUS_SEBACKGROUNDLEVELANALYZER_H
 
+#include "AlexandriaKernel/ThreadPool.h"
 #include "SEFramework/Frame/Frame.h"
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Background/BackgroundAnalyzer.h"
+#include "SEImplementation/Background/SE/BackgroundCache.h"
 #include "SEImplementation/Configuration/WeightImageConfig.h"
 
 namespace SourceXtractor {
@@ -28,7 +30,9 @@ namespace SourceXtractor {
 class SEBackgroundLevelAnalyzer : public BackgroundAnalyzer {
 public:
   SEBackgroundLevelAnalyzer(const std::vector<int>& cell_size, const std::vector<int>& smoothing_box,
-                            const WeightImageConfig::WeightType weight_type);
+                            const WeightImageConfig::WeightType weight_type,
+                            std::shared_ptr<Euclid::ThreadPool> thread_pool = nullptr,
+                            std::shared_ptr<BackgroundCache> cache = nullptr);
 
   virtual ~SEBackgroundLevelAnalyzer() = default;
 
@@ -41,6 +45,16 @@ private:
   std::array<int, 2> m_smoothing_box;
 
   WeightImageConfig::WeightType m_weight_type;
+  std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
+  std::shared_ptr<BackgroundCache> m_cache;
+
+  /// Estimate the low resolution meshes, and the weight scaling if there is a variance map
+  BackgroundCache::Entry computeMeshes(const std::shared_ptr<DetectionImage>& image,
+                                       const std::shared_ptr<WeightImage>& variance_map,
+                                       DetectionImage::PixelType mask_value) const;
+
+  BackgroundCache::Key computeCacheKey(const DetectionImage& image, const std::shared_ptr<WeightImage>& variance_map,
+                                       WeightImage::PixelType variance_threshold) const;
 };
 
 } // end of namespace SourceXtractor
@@ -0,0 +1,83 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ThreadPoolWait.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_COMMON_THREADPOOLWAIT_H_
+#define _SEIMPLEMENTATION_COMMON_THREADPOOLWAIT_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "ElementsKernel/Exception.h"
+#include "AlexandriaKernel/ThreadPool.h"
+#include "AlexandriaKernel/Semaphore.h"
+
+namespace SourceXtractor {
+
+/**
+ * Waits on work done by the thread pool return as soon as they are signalled. They also wake up with
+ * this period to check the pool is still running: if a task throws, the pool stops its workers, and
+ * the tasks still queued will never signal anything.
+ */
+static constexpr std::chrono::milliseconds THREAD_POOL_CHECK_PERIOD {100};
+
+/**
+ * @return
+ *    true if the pool can not run any more tasks
+ */
+inline bool isThreadPoolStopped(Euclid::ThreadPool& thread_pool) {
+  return thread_pool.checkForException(false) || thread_pool.activeThreads() == 0;
+}
+
+/**
+ * Rethrows the exception a task raised, or throws if the pool can not run any more tasks
+ */
+inline void checkThreadPool(Euclid::ThreadPool& thread_pool) {
+  thread_pool.checkForException(true);
+  if (thread_pool.activeThreads() == 0) {
+    throw Elements::Exception() << "No active threads and the queue is not empty! Please, report this as a bug";
+  }
+}
+
+/**
+ * Acquires the semaphore, throwing if the pool stops while waiting
+ */
+inline void acquireWhileRunning(Euclid::Semaphore& semaphore, Euclid::ThreadPool& thread_pool) {
+  while (!semaphore.try_acquire_for(THREAD_POOL_CHECK_PERIOD)) {
+    checkThreadPool(thread_pool);
+  }
+}
+
+/**
+ * Waits on the condition until predicate is true, throwing if the pool stops while waiting
+ */
+template <typename Predicate>
+void waitWhileRunning(std::condition_variable& condition, std::unique_lock<std::mutex>& lock,
+                      Euclid::ThreadPool& thread_pool, Predicate predicate) {
+  while (!condition.wait_for(lock, THREAD_POOL_CHECK_PERIOD, predicate)) {
+    checkThreadPool(thread_pool);
+  }
+}
+
+} // end of namespace SourceXtractor
+
+#endif // _SEIMPLEMENTATION_COMMON_THREADPOOLWAIT_H_
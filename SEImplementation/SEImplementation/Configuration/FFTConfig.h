@@ -0,0 +1,63 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FFTConfig.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_CONFIGURATION_FFTCONFIG_H_
+#define _SEIMPLEMENTATION_CONFIGURATION_FFTCONFIG_H_
+
+#include "Configuration/Configuration.h"
+#include "SEFramework/FFT/FFT.h"
+
+namespace SourceXtractor {
+
+class FFTConfig : public Euclid::Configuration::Configuration {
+public:
+  explicit FFTConfig(long manager_id);
+
+  virtual ~FFTConfig() = default;
+
+  std::map<std::string, OptionDescriptionList> getProgramOptions() override;
+
+  void initialize(const UserValues& args) override;
+
+  // file where FFTW wisdom is loaded from at startup, and saved to at the end. Empty if not used.
+  const std::string& getWisdomFile() const {
+    return m_wisdom_file;
+  }
+
+  FFTPlanningRigor getPlanningRigor() const {
+    return m_planning_rigor;
+  }
+
+  // maximum memory, in bytes, used to keep the transforms of the convolution kernels
+  std::size_t getKernelCacheSize() const {
+    return m_kernel_cache_size;
+  }
+
+private:
+  std::string m_wisdom_file;
+  FFTPlanningRigor m_planning_rigor;
+  std::size_t m_kernel_cache_size;
+};
+
+}
+
+#endif /* _SEIMPLEMENTATION_CONFIGURATION_FFTCONFIG_H_ */
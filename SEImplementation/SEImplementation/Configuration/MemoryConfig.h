@@ -25,6 +25,7 @@
 #define _SEIMPLEMENTATION_CONFIGURATION_MEMORYCONFIG_H_
 
 #include "Configuration/Configuration.h"
+#include "SEFramework/Image/TileEvictionPolicy.h"
 
 namespace SourceXtractor {
 
@@ -47,9 +48,14 @@ public:
     return m_tile_size;
   }
 
+  TileEvictionPolicy::Type getTileEvictionPolicy() const {
+    return m_eviction_policy;
+  }
+
 private:
   int m_max_memory;
   int m_tile_size;
+  TileEvictionPolicy::Type m_eviction_policy;
 };
 
 
@@ -26,6 +26,7 @@
 
 #include "Configuration/Configuration.h"
 #include "AlexandriaKernel/ThreadPool.h"
+#include "SEUtils/ParallelFor.h"
 
 namespace SourceXtractor {
 
@@ -47,6 +48,15 @@ public:
     return m_thread_pool;
   }
 
+  /// Submits the tasks to the thread pool, for use with parallelFor. Empty if multithreading is disabled.
+  TaskExecutor getTaskExecutor() const {
+    if (!m_thread_pool) {
+      return {};
+    }
+    auto thread_pool = m_thread_pool;
+    return [thread_pool](std::function<void()> task) { thread_pool->submit(std::move(task)); };
+  }
+
   unsigned getMaxQueueSize() const {
     return m_max_queue_size;
   }
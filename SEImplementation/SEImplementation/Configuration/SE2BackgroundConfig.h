@@ -47,9 +47,15 @@ public:
     return m_smoothing_box;
   }
 
+  /// Directory where the background meshes are cached between runs. Empty if disabled.
+  const std::string& getCacheDirectory() const {
+    return m_cache_directory;
+  }
+
 private:
   std::vector<int> m_cell_size;
   std::vector<int> m_smoothing_box;
+  std::string m_cache_directory;
 };
 
 } /* namespace SourceXtractor */
@@ -64,6 +64,10 @@ public:
     return m_lutz_window_size;
   }
 
+  bool isLutzParallel() const {
+    return m_lutz_parallel;
+  }
+
   int getBfsMaxDelta() const {
     return m_bfs_max_delta;
   }
@@ -95,6 +99,7 @@ private:
   std::shared_ptr<DetectionImageFrame::ImageFilter> m_filter;
 
   int m_lutz_window_size;
+  bool m_lutz_parallel;
   int m_bfs_max_delta;
   std::string m_onnx_model_path;
   double m_ml_threshold;
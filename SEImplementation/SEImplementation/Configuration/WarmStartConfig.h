@@ -0,0 +1,64 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * WarmStartConfig.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_CONFIGURATION_WARMSTARTCONFIG_H_
+#define _SEIMPLEMENTATION_CONFIGURATION_WARMSTARTCONFIG_H_
+
+#include "Configuration/Configuration.h"
+#include "Table/Table.h"
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingWarmStart.h"
+
+namespace SourceXtractor {
+
+/**
+ * Reads the catalog of a previous run, used to initialize the model fitting free parameters
+ */
+class WarmStartConfig : public Euclid::Configuration::Configuration {
+public:
+  explicit WarmStartConfig(long manager_id);
+
+  virtual ~WarmStartConfig() = default;
+
+  std::map<std::string, OptionDescriptionList> getProgramOptions() override;
+
+  void initialize(const UserValues& args) override;
+
+  /**
+   * @param parameter_columns
+   *    Name of the catalog column holding the value of each free parameter, by parameter id
+   * @return
+   *    The initial values found in the catalog, or nullptr if no catalog was given
+   */
+  std::shared_ptr<FlexibleModelFittingWarmStart> getWarmStart(
+      const std::map<int, std::string>& parameter_columns) const;
+
+private:
+  std::string m_filename;
+  std::shared_ptr<Euclid::Table::Table> m_table;
+  FlexibleModelFittingWarmStart::MatchType m_match_type;
+  double m_radius;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEIMPLEMENTATION_CONFIGURATION_WARMSTARTCONFIG_H_ */
@@ -37,6 +37,8 @@ public:
 
   bool mustBeProcessed(const SourceInterface& ) const override;
 
+  bool mayBeProcessed(const PixelRectangle& bounds) const override;
+
 private:
   int m_line_number;
 };
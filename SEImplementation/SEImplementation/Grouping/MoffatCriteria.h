@@ -46,6 +46,8 @@ public:
 
   std::set<PropertyId> requiredProperties() const override;
 
+  bool getSearchRegion(const SourceInterface& source, PixelRectangle& region) const override;
+
 private:
   bool doesImpact(const SourceInterface& impactor, const SourceInterface& impactee) const;
 
@@ -34,6 +34,11 @@ public:
   bool shouldGroup(const SourceInterface&, const SourceInterface&) const override {
     return false;
   }
+
+  bool getSearchRegion(const SourceInterface&, PixelRectangle& region) const override {
+    region = PixelRectangle();
+    return true;
+  }
 };
 
 
@@ -36,6 +36,8 @@ namespace SourceXtractor {
 class OverlappingBoundariesCriteria : public GroupingCriteria {
 public:
   bool shouldGroup(const SourceInterface& first, const SourceInterface& second) const override;
+
+  bool getSearchRegion(const SourceInterface& source, PixelRectangle& region) const override;
 };
 
 
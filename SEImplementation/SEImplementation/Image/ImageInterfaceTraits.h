@@ -36,6 +36,7 @@
 #include "ModelFitting/Image/ImageTraits.h"
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Image/VectorImage.h"
+#include "SEImplementation/Image/ImagePool.h"
 
 #ifdef __APPLE__
 #define sincosf __sincosf
@@ -57,7 +58,11 @@ struct ImageTraits<ImageInterfaceTypePtr> {
 
   using iterator = std::vector<ImageInterfaceType::PixelType>::iterator;
 
+  // Draws from the ImagePool active on this thread, if any
   static ImageInterfaceTypePtr factory(std::size_t width, std::size_t height) {
+    if (auto pool = SourceXtractor::ImagePool::current()) {
+      return pool->acquire(width, height);
+    }
     return SourceXtractor::VectorImage<ImageInterfaceType::PixelType>::create(width, height);
   }
 
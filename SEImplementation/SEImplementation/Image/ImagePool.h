@@ -0,0 +1,109 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ImagePool.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_IMAGE_IMAGEPOOL_H_
+#define _SEIMPLEMENTATION_IMAGE_IMAGEPOOL_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "SEUtils/Types.h"
+#include "SEUtils/ParallelFor.h"
+#include "SEFramework/Image/VectorImage.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class ImagePool
+ *
+ * @brief
+ * Recycles the images used while evaluating the models of a fit
+ *
+ * @details
+ * Every image the pool hands out stays referenced by the pool. Once all the other references are
+ * dropped, the next request for an image of the same size gets it back, so after the first
+ * iterations a fit keeps drawing the same buffers and stops allocating.
+ *
+ * The pool is made active on a thread with a Scope. While it is, ImageTraits<ImageInterfaceTypePtr>::factory
+ * draws from it, which covers the model rasters, the resampling buffers and the frame images.
+ * All the buffers are released when the pool is destroyed, typically at the end of the fit.
+ */
+class ImagePool {
+public:
+  using ImageType = VectorImage<SeFloat>;
+
+  /**
+   * Makes a pool the active one for the current thread, until destroyed
+   */
+  class Scope {
+  public:
+    explicit Scope(ImagePool& pool);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ImagePool* m_previous;
+  };
+
+  ImagePool() = default;
+
+  ImagePool(const ImagePool&) = delete;
+  ImagePool& operator=(const ImagePool&) = delete;
+
+  /**
+   * @return
+   *    A zero-filled image, reusing one the pool handed out before if it is not in use anymore
+   */
+  std::shared_ptr<ImageType> acquire(int width, int height);
+
+  /**
+   * @return
+   *    How many images the pool holds, in use or not
+   */
+  std::size_t size() const;
+
+  /**
+   * @return
+   *    The pool active on the current thread, or nullptr
+   */
+  static ImagePool* current();
+
+  /**
+   * Wraps an executor so the tasks it runs draw from the given pool too
+   * @return
+   *    An empty executor if executor is empty
+   */
+  static TaskExecutor bind(std::shared_ptr<ImagePool> pool, TaskExecutor executor);
+
+private:
+  mutable std::mutex m_mutex;
+  std::map<std::pair<int, int>, std::vector<std::shared_ptr<ImageType>>> m_images;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_IMAGE_IMAGEPOOL_H_ */
@@ -24,12 +24,15 @@
 #ifndef _SEIMPLEMENTATION_IMAGE_IMAGEPSF_H_
 #define _SEIMPLEMENTATION_IMAGE_IMAGEPSF_H_
 
+#include <algorithm>
+
 #include "ElementsKernel/Exception.h"
 #include "AlexandriaKernel/memory_tools.h"
 #include "ModelFitting/Image/PsfTraits.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/ProcessedImage.h"
 #include "SEFramework/Convolution/Convolution.h"
+#include "SEImplementation/Image/ImageInterfaceTraits.h"
 
 
 namespace SourceXtractor {
@@ -41,7 +44,7 @@ private:
 public:
 
   ImagePsf(double pixel_scale, std::shared_ptr<const VectorImage<SeFloat>> image)
-          : base_t{image}, m_pixel_scale{pixel_scale} {
+          : base_t{image}, m_pixel_scale{pixel_scale}, m_image{image} {
     if (image->getWidth() != image->getHeight()) {
       throw Elements::Exception() << "PSF kernel must be square but was "
                                   << image->getWidth() << " x " << image->getHeight();
@@ -63,11 +66,16 @@ public:
   }
 
   std::shared_ptr<VectorImage<SourceXtractor::SeFloat>> getScaledKernel(SeFloat scale) const {
-    return VectorImage<SeFloat>::create(*MultiplyImage<SourceXtractor::SeFloat>::create(getKernel(), scale));
+    // Drawn from the active ImagePool, if any
+    auto scaled = ModelFitting::ImageTraits<ImageInterfaceTypePtr>::factory(m_image->getWidth(), m_image->getHeight());
+    std::transform(m_image->getData().begin(), m_image->getData().end(), scaled->getData().begin(),
+                   [scale](SeFloat v) { return v * scale; });
+    return scaled;
   }
 
 private:
   double m_pixel_scale;
+  std::shared_ptr<const VectorImage<SeFloat>> m_image;
 
 };
 
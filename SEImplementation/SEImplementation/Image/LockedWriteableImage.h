@@ -46,6 +46,10 @@ public:
     return m_img->getChunk(x, y, width, height);
   }
 
+  void prefetch(int x, int y, int width, int height) const override {
+    m_img->prefetch(x, y, width, height);
+  }
+
 private:
   std::shared_ptr<WriteableImage<T>> m_img;
   std::lock_guard<std::mutex> m_lock;
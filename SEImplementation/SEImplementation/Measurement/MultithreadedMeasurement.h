@@ -31,6 +31,7 @@
 #include <atomic>
 #include "AlexandriaKernel/ThreadPool.h"
 #include "AlexandriaKernel/Semaphore.h"
+#include "SEUtils/BoundedQueue.h"
 #include "SEFramework/Pipeline/Measurement.h"
 
 namespace SourceXtractor {
@@ -43,8 +44,10 @@ public:
                            unsigned max_queue_size)
       : m_source_to_row(source_to_row),
         m_thread_pool(thread_pool),
-        m_group_counter(0),
-        m_input_done(false), m_abort_raised(false), m_semaphore(max_queue_size) {}
+        m_group_counter(0), m_output_counter(0),
+        m_input_done(false), m_abort_raised(false), m_failed(false),
+        m_new_output(std::make_shared<Euclid::Semaphore>(0)), m_output_queue(max_queue_size),
+        m_semaphore(max_queue_size) {}
 
   ~MultithreadedMeasurement() override;
 
@@ -63,12 +66,18 @@ private:
   std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
   std::unique_ptr<std::thread> m_output_thread;
 
-  int m_group_counter;
-  std::atomic_bool m_input_done, m_abort_raised;
+  std::atomic<int> m_group_counter;
+  int m_output_counter;
+  std::atomic_bool m_input_done, m_abort_raised, m_failed;
 
-  std::condition_variable m_new_output;
-  std::list<std::pair<int, std::unique_ptr<SourceGroupInterface>>> m_output_queue;
-  std::mutex m_output_queue_mutex;
+  // Released once for every measured group and stop request. Shared with the workers, which may
+  // still be releasing it once their output has been consumed.
+  std::shared_ptr<Euclid::Semaphore> m_new_output;
+  // Measured groups, null if the measurement failed
+  BoundedQueue<std::pair<int, std::unique_ptr<SourceGroupInterface>>> m_output_queue;
+  // Protects m_output_counter, and notifies when it changes
+  std::mutex m_output_counter_mutex;
+  std::condition_variable m_output_done;
   Euclid::Semaphore m_semaphore;
 };
 
@@ -28,7 +28,6 @@
 
 #include "SEImplementation/Property/PixelCoordinateList.h"
 #include "SEFramework/Image/Image.h"
-#include "SEFramework/Image/VectorImage.h"
 
 #include "SEFramework/Pipeline/Partition.h"
 #include "SEFramework/Source/SourceFactory.h"
@@ -58,9 +57,7 @@ private:
   std::vector<std::unique_ptr<SourceInterface>> reassignPixels(
       const std::vector<std::unique_ptr<SourceInterface>>& sources,
       const std::vector<PixelCoordinate>& pixel_coords,
-      std::shared_ptr<VectorImage<DetectionImage::PixelType>> image,
-      const std::vector<std::shared_ptr<MultiThresholdNode>>& source_nodes,
-      const PixelCoordinate& offset
+      const std::vector<std::shared_ptr<MultiThresholdNode>>& source_nodes
       ) const;
 
   std::shared_ptr<SourceFactory> m_source_factory;
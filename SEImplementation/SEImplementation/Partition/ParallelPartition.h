@@ -0,0 +1,145 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ParallelPartition.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PARTITION_PARALLELPARTITION_H_
+#define _SEIMPLEMENTATION_PARTITION_PARALLELPARTITION_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "AlexandriaKernel/ThreadPool.h"
+#include "AlexandriaKernel/Semaphore.h"
+#include "SEUtils/BoundedQueue.h"
+#include "SEFramework/Pipeline/Partition.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class ParallelPartition
+ * @brief Partition that runs the steps of each detected source on the thread pool
+ *
+ * @details
+ * Partitioning a large source (i.e. multi-thresholding) can take long. Done on the segmentation
+ * thread, it blocks the detection of the rest of the image, and the later stages run out of work.
+ *
+ * Here the steps are run asynchronously, and the results are passed along in the order the detections
+ * were received, so the output is the same as the one of Partition. ProcessSourcesEvent are
+ * synchronization points, and are forwarded only once all the sources received before have been.
+ *
+ * The ids the steps give to new sources depend on the order the workers ran. They are replaced, in
+ * reception order, by ids starting at SourceId::PARTITION_ID_BASE, so they are the same from run to run.
+ */
+class ParallelPartition : public Partition {
+public:
+
+  /**
+   * Constructor
+   * @param steps
+   *    Partition steps, applied in order. They must be safe to call concurrently.
+   * @param thread_pool
+   *    Alexandria thread pool
+   * @param max_queue_size
+   *    Maximum number of detections being partitioned or waiting to be passed along
+   */
+  ParallelPartition(std::vector<std::shared_ptr<PartitionStep>> steps,
+                    const std::shared_ptr<Euclid::ThreadPool>& thread_pool, unsigned max_queue_size);
+
+  virtual ~ParallelPartition();
+
+  void receiveSource(std::unique_ptr<SourceInterface> source) override;
+  void receiveProcessSignal(const ProcessSourcesEvent& event) override;
+
+  /**
+   * Wait until all the detections received so far have been passed along
+   */
+  void synchronize();
+
+  /**
+   * Pass along the pending detections and stop the output thread
+   */
+  void wait();
+
+private:
+  struct EventType {
+    enum Type {
+      SOURCE, PROCESS_SOURCE
+    } m_event_type;
+    unsigned long m_sequence;
+
+    explicit EventType(Type type, unsigned long sequence = 0)
+      : m_event_type(type), m_sequence(sequence) {}
+  };
+
+  /// Sources produced by a detection, with its reception order
+  struct FinishedDetection {
+    unsigned long m_sequence = 0;
+    /// Set if applying the steps failed
+    bool m_failed = false;
+    /// Set if the detection had a SourceId, which is then m_source_id
+    bool m_has_source_id = false;
+    unsigned int m_source_id = 0;
+    std::vector<std::unique_ptr<SourceInterface>> m_sources;
+  };
+
+  /// Pointer to the pool of worker threads
+  std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
+  /// Orchestration thread
+  std::unique_ptr<std::thread> m_output_thread;
+  /// Released once for every finished detection, received ProcessSourcesEvent, and stop request.
+  /// Workers keep their own reference, as they may release it after their detection was passed along.
+  std::shared_ptr<Euclid::Semaphore> m_new_output;
+  /// Handoff of the finished detections from the workers to the output thread
+  BoundedQueue<FinishedDetection> m_finished_queue;
+  /// Finished detections waiting for the ones received before. Only used by the output thread.
+  std::map<unsigned long, FinishedDetection> m_finished_sources;
+  /// Queue of received ProcessSourceEvent, order preserved
+  std::deque<ProcessSourcesEvent> m_event_queue;
+  /// Queue of type of received events. Used to pass downstream events respecting the received order
+  std::deque<EventType> m_received;
+  /// Sequence number of the next detection
+  unsigned long m_next_sequence;
+  /// Id given to the next source created by the steps. Only used by the output thread.
+  unsigned int m_next_source_id;
+
+  /// Protects the received queues, which are not touched by the workers
+  std::mutex m_queue_mutex;
+  /// Notifies the received queue is empty
+  std::condition_variable m_drained;
+
+  /// Termination condition for the output loop
+  std::atomic_bool m_stop;
+  /// Set if the partitioning of a detection failed
+  std::atomic_bool m_failed;
+
+  /// Keep the queue under control
+  Euclid::Semaphore m_semaphore;
+
+  void outputLoop();
+};
+
+} // end of namespace SourceXtractor
+
+#endif // _SEIMPLEMENTATION_PARTITION_PARALLELPARTITION_H_
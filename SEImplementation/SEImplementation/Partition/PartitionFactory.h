@@ -27,6 +27,7 @@
 #include "SEFramework/Source/SourceFactory.h"
 
 #include "SEImplementation/Configuration/PartitionStepConfig.h"
+#include "SEImplementation/Partition/ParallelPartition.h"
 
 namespace SourceXtractor {
 
@@ -50,6 +51,12 @@ public:
   std::shared_ptr<Partition> getPartition() const {
     return std::make_shared<Partition>(m_steps);
   }
+
+  /// The steps of each detection are run on the thread pool, instead of on the segmentation thread
+  std::shared_ptr<ParallelPartition> getParallelPartition(const std::shared_ptr<Euclid::ThreadPool>& thread_pool,
+                                                          unsigned max_queue_size) const {
+    return std::make_shared<ParallelPartition>(m_steps, thread_pool, max_queue_size);
+  }
   
 private:
   
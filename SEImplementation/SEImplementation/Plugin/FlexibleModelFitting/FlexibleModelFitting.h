@@ -47,7 +47,9 @@ public:
                        std::unordered_map<int, double> parameter_sigmas,
                        std::vector<SeFloat> chi_squared_per_meta,
                        std::vector<int> iterations_per_meta,
-                       int meta_iterations) :
+                       int meta_iterations,
+                       int skipped_meta_iterations = 0,
+                       int reused_renders = 0) :
     m_iterations(iterations),
     m_stop_reason(stop_reason),
     m_chi_squared(chi_squared),
@@ -57,7 +59,9 @@ public:
     m_parameter_sigmas(parameter_sigmas),
     m_chi_squared_per_meta(chi_squared_per_meta),
     m_iterations_per_meta(iterations_per_meta),
-    m_meta_iterations(meta_iterations)
+    m_meta_iterations(meta_iterations),
+    m_skipped_meta_iterations(skipped_meta_iterations),
+    m_reused_renders(reused_renders)
 {}
 
   unsigned int getIterations() const {
@@ -100,6 +104,16 @@ public:
     return m_meta_iterations;
   }
 
+  // meta-iterations in which the source was not fitted again, as it had converged
+  int getSkippedMetaIterations() const {
+    return m_skipped_meta_iterations;
+  }
+
+  // neighbour models whose rendering for the deblending of this source was reused from a previous meta-iteration
+  int getReusedRenders() const {
+    return m_reused_renders;
+  }
+
 private:
   unsigned int m_iterations, m_stop_reason;
   SeFloat m_chi_squared, m_duration;
@@ -110,6 +124,8 @@ private:
   std::vector<SeFloat> m_chi_squared_per_meta;
   std::vector<int> m_iterations_per_meta;
   int m_meta_iterations;
+  int m_skipped_meta_iterations;
+  int m_reused_renders;
 };
 
 }
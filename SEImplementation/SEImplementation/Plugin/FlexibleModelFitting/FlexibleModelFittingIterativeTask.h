@@ -18,11 +18,14 @@
 #ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGITERATIVETASK_H_
 #define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGITERATIVETASK_H_
 
+#include <map>
+
 #include "ModelFitting/Models/FrameModel.h"
 #include "ModelFitting/Engine/ResidualEstimator.h"
 #include "ModelFitting/Engine/LeastSquareEngineManager.h"
 
 #include "SEUtils/PixelRectangle.h"
+#include "SEUtils/ParallelFor.h"
 
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Task/GroupTask.h"
@@ -47,7 +50,8 @@ public:
       int meta_iterations=3,
       double deblend_factor=1.0,
       double meta_iteration_stop=0.0001,
-      size_t max_fit_size=100
+      size_t max_fit_size=100,
+      TaskExecutor executor={}
       );
 
   virtual ~FlexibleModelFittingIterativeTask();
@@ -66,10 +70,32 @@ private:
     unsigned int stop_reason;
     std::vector<SeFloat> chi_squared_per_meta;
     std::vector<int> iterations_per_meta;
+
+    // Convergence tracking across meta-iterations
+    bool converged = false;
+    unsigned int fitted_at = 0;
+    unsigned int version = 0;
+    int skipped_meta_iterations = 0;
+    int reused_renders = 0;
+  };
+
+  // Models of the neighbours of a source rendered over its fitting area, for one frame
+  struct DeblendCache {
+    std::shared_ptr<VectorImage<SeFloat>> image;
+    std::vector<unsigned int> versions;
+    // Kept if the memory budget allows it, so only the neighbours that changed need to be rendered again
+    std::vector<std::shared_ptr<VectorImage<SeFloat>>> stamps;
   };
 
   struct FittingState {
     std::vector<SourceState> source_states;
+
+    // Counts the calls to fitSource, and remembers the last one that changed the source noticeably
+    unsigned int fit_count = 0;
+    unsigned int last_moved = 0;
+
+    std::map<std::pair<int, int>, DeblendCache> deblend_cache;
+    std::size_t deblend_cache_pixels = 0;
   };
 
   std::shared_ptr<VectorImage<SeFloat>> createDeblendImage(
@@ -77,6 +103,8 @@ private:
       std::shared_ptr<FlexibleModelFittingFrame> frame, FittingState& state) const;
 
   void fitSource(SourceGroupInterface& group, SourceInterface& source, int index, FittingState& state) const;
+  bool hasConverged(const std::unordered_map<int, double>& previous_values, SeFloat previous_chi_squared,
+                    const SourceState& source_state) const;
   void updateCheckImages(SourceGroupInterface& group, double pixel_scale, FittingState& state) const;
   SeFloat computeChiSquared(SourceGroupInterface& group, SourceInterface& source, int index,
       double pixel_scale, FlexibleModelFittingParameterManager& manager, int& total_data_points, FittingState& state) const;
@@ -108,6 +136,10 @@ private:
   std::vector<std::shared_ptr<FlexibleModelFittingParameter>> m_parameters;
   std::vector<std::shared_ptr<FlexibleModelFittingFrame>> m_frames;
   std::vector<std::shared_ptr<FlexibleModelFittingPrior>> m_priors;
+
+  // Renders the frames and the neighbours of a source concurrently. The sources themselves are
+  // still fitted one after the other, as each fit uses the latest values of the previous ones.
+  TaskExecutor m_executor;
 };
 
 }
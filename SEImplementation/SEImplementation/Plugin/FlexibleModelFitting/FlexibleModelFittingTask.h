@@ -28,6 +28,8 @@
 
 #include "SEImplementation/Image/ImagePsf.h"
 
+#include "SEUtils/ParallelFor.h"
+
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Task/GroupTask.h"
 
@@ -46,7 +48,8 @@ public:
       std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters,
       std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames,
       std::vector<std::shared_ptr<FlexibleModelFittingPrior>> priors,
-      double scale_factor=1.0
+      double scale_factor=1.0,
+      TaskExecutor executor={}
       );
 
   virtual ~FlexibleModelFittingTask();
@@ -86,6 +89,9 @@ private:
   std::vector<std::shared_ptr<FlexibleModelFittingPrior>> m_priors;
 
   double m_scale_factor;
+
+  // Renders the frames of a group concurrently
+  TaskExecutor m_executor;
 };
 
 }
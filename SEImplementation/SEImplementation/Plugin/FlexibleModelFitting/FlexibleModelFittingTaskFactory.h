@@ -60,6 +60,8 @@ private:
 
   double m_scale_factor {1.0};
   double m_max_fit_size {100};
+
+  TaskExecutor m_executor;
 };
 
 }
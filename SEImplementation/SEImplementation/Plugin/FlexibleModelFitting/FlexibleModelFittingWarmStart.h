@@ -0,0 +1,107 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingWarmStart.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGWARMSTART_H_
+#define _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGWARMSTART_H_
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "SEUtils/KdTree.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameter.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class FlexibleModelFittingWarmStart
+ *
+ * @brief
+ * Initial values for the free parameters taken from the catalog of a previous run
+ *
+ * @details
+ * Sources are matched to the rows of the previous catalog either by their source id, or by the
+ * nearest detection centroid within a radius. Sources without a match, or parameters without a
+ * finite value on the matched row, keep using the initial value function from the configuration.
+ */
+class FlexibleModelFittingWarmStart : public std::enable_shared_from_this<FlexibleModelFittingWarmStart> {
+public:
+
+  enum class MatchType {
+    SOURCE_ID,
+    POSITION
+  };
+
+  /// A row of the previous catalog
+  struct Entry {
+    int source_id;
+    /// Centroid in the detection image, zero-based
+    double x, y;
+    size_t row;
+  };
+
+  /**
+   * @param match_type
+   *    How sources are matched to the catalog entries
+   * @param radius
+   *    Maximum distance, in pixels, for a match by position
+   * @param entries
+   *    The rows of the catalog
+   * @param values
+   *    For each free parameter id, the value on each row. NaN stands for missing.
+   */
+  FlexibleModelFittingWarmStart(MatchType match_type, double radius, std::vector<Entry> entries,
+                                std::map<int, std::vector<double>> values);
+
+  /// @return The catalog row matched to the source, or -1
+  int findRow(const SourceInterface& source) const;
+
+  /**
+   * Looks up the value the parameter had on the source in the previous run
+   * @return
+   *    true if there is one, and then it is stored in value
+   */
+  bool getValue(int parameter_id, const SourceInterface& source, double& value) const;
+
+  /// @return An initial value function that uses the previous value if there is one, and fallback otherwise
+  FlexibleModelFittingFreeParameter::InitialValueFunc wrap(
+      int parameter_id, FlexibleModelFittingFreeParameter::InitialValueFunc fallback) const;
+
+private:
+  MatchType m_match_type;
+  double m_radius;
+  std::map<int, std::vector<double>> m_values;
+  std::unordered_map<int, size_t> m_rows_by_id;
+  std::shared_ptr<KdTree<Entry>> m_rows_by_position;
+};
+
+template <>
+struct KdTreeTraits<FlexibleModelFittingWarmStart::Entry> {
+  static double getCoord(const FlexibleModelFittingWarmStart::Entry& entry, size_t index) {
+    return index == 0 ? entry.x : entry.y;
+  }
+};
+
+}
+
+#endif /* _SEIMPLEMENTATION_PLUGIN_FLEXIBLEMODELFITTING_FLEXIBLEMODELFITTINGWARMSTART_H_ */
@@ -108,9 +108,19 @@ public:
     return image;
   }
 
+  std::vector<std::shared_ptr<BasicParameter>> getShapeParameters() const override {
+    auto parameters = getTransformParameters();
+    parameters.emplace_back(m_flux);
+    for (auto const& it : m_params) {
+      parameters.emplace_back(it.second);
+    }
+    return parameters;
+  }
+
 private:
   using CompactModelBase<ImageType>::getMaxRadiusSqr;
   using CompactModelBase<ImageType>::getCombinedTransform;
+  using CompactModelBase<ImageType>::getTransformParameters;
   using CompactModelBase<ImageType>::m_jacobian;
   using CompactModelBase<ImageType>::samplePixel;
   using CompactModelBase<ImageType>::adaptiveSamplePixel;
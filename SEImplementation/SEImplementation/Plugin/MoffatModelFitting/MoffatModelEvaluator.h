@@ -24,6 +24,10 @@
 #ifndef _SEIMPLEMENTATION_PLUGIN_MOFFATMODELFITTING_MOFFATMODELEVALUATOR_H_
 #define _SEIMPLEMENTATION_PLUGIN_MOFFATMODELFITTING_MOFFATMODELEVALUATOR_H_
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include "ModelFitting/Models/ExtendedModel.h"
 #include "SEFramework/Source/SourceInterface.h"
 #include "SEFramework/Image/VectorImage.h"
@@ -40,6 +44,44 @@ public:
     return m_model->getValue(x, y);
   }
 
+  /**
+   * Adds the value of the model at each of the pixels to values. Same as calling getValue() for every
+   * pixel, but the profile is evaluated directly in a tight loop instead of through the model components.
+   */
+  template <typename PixelList>
+  void addValues(const PixelList& pixels, std::vector<double>& values) const {
+    auto value = values.begin();
+    for (auto& pixel : pixels) {
+      double dx = pixel.m_x - m_x, dy = pixel.m_y - m_y;
+      double u = (dx * m_cos - dy * m_sin) / m_x_scale;
+      double v = (dx * m_sin + dy * m_cos) / m_y_scale;
+      double z = std::pow(std::pow(std::fabs(u), m_minkowski_exponent) + std::pow(std::fabs(v), m_minkowski_exponent),
+                          1. / m_minkowski_exponent) - m_top_offset;
+      *value++ += z < 0 ? m_i0 : m_i0 * std::pow(1 + z * z, -m_index);
+    }
+  }
+
+  /**
+   * @return
+   *    An upper bound of the model anywhere at least distance away from its center
+   */
+  double getUpperBound(double distance) const;
+
+  /**
+   * @return
+   *    Distance from the center beyond which the model is below value. Infinity if there is no such distance,
+   *    or if it can not be bound.
+   */
+  double getRadius(double value) const;
+
+  double getX() const {
+    return m_x;
+  }
+
+  double getY() const {
+    return m_y;
+  }
+
   unsigned getIterations() const {
     return m_iterations;
   }
@@ -47,6 +89,10 @@ public:
 private:
   std::shared_ptr<ModelFitting::ExtendedModel<ImageInterfaceTypePtr>> m_model;
   unsigned m_iterations;
+
+  double m_x, m_y;
+  double m_i0, m_index, m_minkowski_exponent, m_top_offset;
+  double m_x_scale, m_y_scale, m_cos, m_sin;
 };
 
 //ModelFitting::ExtendedModel createMoffatModel();
@@ -42,11 +42,16 @@ public:
 
   const std::shared_ptr<Psf>& getPsf() const;
 
+  /// Enables on psf the caching of the reconstructed PSFs, as configured, if it supports it
+  void configureCache(const std::shared_ptr<Psf>& psf) const;
+
   static std::shared_ptr<Psf> readPsf(const std::string &filename, int hdu_number = 1);
   static std::shared_ptr<Psf> generateGaussianPsf(SeFloat fwhm, SeFloat pixel_sampling);
 
 private:
   std::shared_ptr<Psf> m_vpsf;
+  double m_cache_bin_size = 0.;
+  std::size_t m_cache_memory = 0;
 };
 
 } // end SourceXtractor
@@ -21,6 +21,7 @@
 #include <condition_variable>
 #include "AlexandriaKernel/ThreadPool.h"
 #include "AlexandriaKernel/Semaphore.h"
+#include "SEUtils/BoundedQueue.h"
 #include "SEFramework/Source/SourceInterface.h"
 #include "SEFramework/Pipeline/PipelineStage.h"
 
@@ -99,31 +100,44 @@ private:
     enum Type {
       SOURCE, PROCESS_SOURCE
     } m_event_type;
-    intptr_t m_source_addr;
+    unsigned long m_sequence;
 
-    explicit EventType(Type type, intptr_t source_addr = -1)
-      : m_event_type(type), m_source_addr(source_addr) {}
+    explicit EventType(Type type, unsigned long sequence = 0)
+      : m_event_type(type), m_sequence(sequence) {}
   };
 
+  /// Source done prefetching, with its reception order. Null if the prefetching failed.
+  using FinishedSource = std::pair<unsigned long, std::unique_ptr<SourceInterface>>;
+
   /// Pointer to the pool of worker threads
   std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
   /// Properties to prefetch
   std::set<PropertyId> m_prefetch_set;
   /// Orchestration thread
   std::unique_ptr<std::thread> m_output_thread;
-  /// Notifies there is a new source done processing
-  std::condition_variable m_new_output;
-  /// Finished sources
-  std::map<intptr_t, std::unique_ptr<SourceInterface>> m_finished_sources;
+  /// Released once for every finished source, received ProcessSourcesEvent, and stop request.
+  /// Shared with the workers, which may still be releasing it once their output has been consumed.
+  std::shared_ptr<Euclid::Semaphore> m_new_output;
+  /// Handoff of the finished sources from the workers to the output thread
+  BoundedQueue<FinishedSource> m_finished_queue;
+  /// Finished sources waiting for the ones received before. Only used by the output thread.
+  std::map<unsigned long, std::unique_ptr<SourceInterface>> m_finished_sources;
   /// Queue of received ProcessSourceEvent, order preserved
   std::deque<ProcessSourcesEvent> m_event_queue;
   /// Queue of type of received events. Used to pass downstream events respecting the received order
   std::deque<EventType> m_received;
+  /// Sequence number of the next source
+  unsigned long m_next_sequence;
 
+  /// Protects the received queues, which are not touched by the workers
   std::mutex m_queue_mutex;
+  /// Notifies the received queue is empty
+  std::condition_variable m_drained;
 
   /// Termination condition for the output loop
   std::atomic_bool m_stop;
+  /// Set if the prefetching of a source failed
+  std::atomic_bool m_failed;
 
   /// Keep the queue under control
   Euclid::Semaphore m_semaphore;
@@ -23,34 +23,36 @@
 #define _SEIMPLEMENTATION_PIXELCOORDINATELIST_H
 
 #include "SEUtils/PixelCoordinate.h"
+#include "SEUtils/PixelRunList.h"
 #include "SEFramework/Property/Property.h"
 
-#include <algorithm>
-#include <vector>
-
 namespace SourceXtractor {
 
+/**
+ * @class PixelCoordinateList
+ * @brief The pixels belonging to a source, stored as horizontal runs
+ */
 class PixelCoordinateList : public Property {
   
 public:
   
-  explicit PixelCoordinateList(std::vector<PixelCoordinate> coordinate_list)
+  explicit PixelCoordinateList(PixelRunList coordinate_list)
       : m_coordinate_list(std::move(coordinate_list)) {
   }
 
   virtual ~PixelCoordinateList() = default;
   
-  const std::vector<PixelCoordinate>& getCoordinateList() const {
+  const PixelRunList& getCoordinateList() const {
     return m_coordinate_list;
   }
 
   bool contains(const PixelCoordinate& coord) const {
-    return std::find(m_coordinate_list.begin(), m_coordinate_list.end(), coord) != m_coordinate_list.end();
+    return m_coordinate_list.contains(coord);
   }
   
 private:
 
-  std::vector<PixelCoordinate> m_coordinate_list;
+  PixelRunList m_coordinate_list;
   
 }; /* End of PixelCoordinateList class */
 
@@ -33,14 +33,30 @@ class SourceId : public Property {
 
 public:
 
+  /**
+   * The detections and the sources derived from them are numbered from separate counters, so the ids
+   * given to the detections do not depend on how far the later stages are, which run on other threads.
+   * ParallelPartition renumbers the sources it creates from PARTITION_ID_BASE, in reception order.
+   */
+  enum : unsigned int {
+    DERIVED_ID_BASE = 1u << 29,
+    PARTITION_ID_BASE = 1u << 30
+  };
+
+  /// Source derived from the detection detection_id
   explicit SourceId(unsigned int detection_id)
-      : m_source_id(getNewId()), m_detection_id(detection_id) {
+      : m_source_id(getNewDerivedId()), m_detection_id(detection_id) {
   }
 
+  /// New detection
   SourceId()
       : m_source_id(getNewId()), m_detection_id(m_source_id) {
   }
 
+  SourceId(unsigned int source_id, unsigned int detection_id)
+      : m_source_id(source_id), m_detection_id(detection_id) {
+  }
+
   virtual ~SourceId() = default;
 
   unsigned int getSourceId() const {
@@ -59,6 +75,11 @@ private:
     return s_id++;
   }
 
+  static unsigned int getNewDerivedId() {
+    static std::atomic<uint32_t> s_id(DERIVED_ID_BASE);
+    return s_id++;
+  }
+
 
 
 }; /* End of SourceId class */
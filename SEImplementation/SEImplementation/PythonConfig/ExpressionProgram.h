@@ -0,0 +1,113 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExpressionProgram.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PYTHONCONFIG_EXPRESSIONPROGRAM_H_
+#define _SEIMPLEMENTATION_PYTHONCONFIG_EXPRESSIONPROGRAM_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Pyston/Graph/Node.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class ExpressionProgram
+ *
+ * @brief
+ * Expression compiled by Pyston, lowered into a flat sequence of instructions for a stack machine
+ *
+ * @details
+ * Pyston evaluates its trees node by node, with a virtual call per node and the arguments packed as variants.
+ * A program is evaluated by a single loop over its instructions, on a stack of doubles, and never needs the GIL.
+ *
+ * Only expressions over doubles are supported, made of constants, arguments, the arithmetic operators,
+ * the usual math functions and the functions given by name to lower. For anything else lower returns nullptr,
+ * and the expression is left to Pyston.
+ */
+class ExpressionProgram {
+public:
+
+  /// Expression tree, made of the representation of each node
+  struct Node {
+    std::string m_repr;
+    /// True if the node evaluates to a double
+    bool m_is_double;
+    std::vector<Node> m_children;
+  };
+
+  /// Function of two values that needs the context, as image_to_world_alpha
+  typedef double (*ContextFunction)(const Pyston::Context&, double, double);
+
+  /// Deeper expressions are not lowered
+  static constexpr std::size_t MAX_STACK_SIZE = 32;
+
+  /**
+   * Copies the structure of a Pyston tree
+   */
+  static Node mirror(const Pyston::NodeBase& root);
+
+  /**
+   * @param tree
+   *    Expression to lower
+   * @param nargs
+   *    Number of arguments. They are the placeholders _0 to _<nargs - 1>
+   * @param functions
+   *    Functions that can be called from the expression, by name
+   * @return
+   *    The program, or nullptr if any node is not supported
+   */
+  static std::shared_ptr<ExpressionProgram> lower(const Node& tree, std::size_t nargs,
+                                                  const std::map<std::string, ContextFunction>& functions);
+
+  double operator()(const Pyston::Context& context, const std::vector<double>& args) const;
+
+  /// @return The number of instructions
+  std::size_t size() const {
+    return m_instructions.size();
+  }
+
+private:
+  enum class OpCode {
+    CONSTANT, ARGUMENT, ADD, SUB, MUL, DIV, NEG, UNARY, BINARY, CONTEXT_FUNCTION
+  };
+
+  struct Instruction {
+    OpCode m_opcode;
+    double m_value;
+    std::size_t m_index;
+    double (*m_unary)(double);
+    double (*m_binary)(double, double);
+    ContextFunction m_context_function;
+  };
+
+  std::vector<Instruction> m_instructions;
+  std::size_t m_nargs = 0;
+
+  bool emit(const Node& node, std::size_t depth, const std::map<std::string, ContextFunction>& functions);
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_PYTHONCONFIG_EXPRESSIONPROGRAM_H_ */
@@ -0,0 +1,118 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PythonCallStatistics.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEIMPLEMENTATION_PYTHONCONFIG_PYTHONCALLSTATISTICS_H_
+#define _SEIMPLEMENTATION_PYTHONCONFIG_PYTHONCALLSTATISTICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ElementsKernel/Logging.h"
+
+namespace SourceXtractor {
+
+/**
+ * @class PythonCallStatistics
+ *
+ * @brief
+ * Keeps track of the user functions that could not be compiled by Pyston
+ *
+ * @details
+ * Those functions are evaluated by calling back into Python, which requires the GIL and serializes
+ * the threads running the model fitting. The time spent in them, including the wait for the GIL,
+ * is accumulated here so it can be reported at the end of the run.
+ */
+class PythonCallStatistics {
+public:
+
+  struct Counter {
+    Counter(const std::string& name, const std::string& reason) : m_name(name), m_reason(reason) {}
+
+    const std::string m_name, m_reason;
+    std::atomic<std::uint64_t> m_calls {0};
+    std::atomic<std::uint64_t> m_nanoseconds {0};
+  };
+
+  /// Accumulates the time between its construction and destruction into a counter
+  class Timer {
+  public:
+    explicit Timer(Counter& counter) : m_counter(counter), m_start(std::chrono::steady_clock::now()) {}
+
+    ~Timer() {
+      auto elapsed = std::chrono::steady_clock::now() - m_start;
+      m_counter.m_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+      ++m_counter.m_calls;
+    }
+
+  private:
+    Counter& m_counter;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  static PythonCallStatistics& getInstance();
+
+  /**
+   * Registers a function that runs on the Python interpreter
+   * @param name
+   *    Human readable name of the function (i.e. "Dependent parameter 3")
+   * @param reason
+   *    Why it could not be compiled
+   * @return
+   *    The counter to update on each call
+   */
+  std::shared_ptr<Counter> registerFunction(const std::string& name, const std::string& reason);
+
+  /**
+   * Wraps a function so every call is accounted for in the given counter
+   */
+  template <typename R, typename... Args>
+  static std::function<R(Args...)> wrap(std::shared_ptr<Counter> counter, std::function<R(Args...)> func) {
+    return [counter, func](Args... args) -> R {
+      Timer timer(*counter);
+      return func(std::forward<Args>(args)...);
+    };
+  }
+
+  /// @return The registered counters, sorted by decreasing time spent
+  std::vector<std::shared_ptr<const Counter>> getCounters() const;
+
+  /// Logs one line per registered function, or nothing if all of them were compiled
+  void report(Elements::Logging& logger) const;
+
+  void clear();
+
+private:
+  PythonCallStatistics() = default;
+
+  mutable std::mutex m_mutex;
+  std::vector<std::shared_ptr<Counter>> m_counters;
+};
+
+} // end of namespace SourceXtractor
+
+#endif /* _SEIMPLEMENTATION_PYTHONCONFIG_PYTHONCALLSTATISTICS_H_ */
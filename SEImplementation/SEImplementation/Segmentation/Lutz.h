@@ -25,12 +25,14 @@
 #define _SEIMPLEMENTATION_SEGMENTATION_LUTZ_H_
 
 #include "ElementsKernel/Logging.h"
+#include "AlexandriaKernel/ThreadPool.h"
 
 #include "SEFramework/Source/SourceFactory.h"
 #include "SEFramework/Task/TaskProvider.h"
 #include "SEFramework/Source/SourceWithOnDemandProperties.h"
 #include "SEFramework/Pipeline/Segmentation.h"
 #include "SEFramework/Image/Image.h"
+#include "SEUtils/PixelRunList.h"
 
 namespace SourceXtractor {
 
@@ -41,12 +43,12 @@ public:
 
     int start;
     int end;
-    std::vector<PixelCoordinate> pixel_list;
+    PixelRunList pixel_list;
 
     PixelGroup() : start(-1), end(-1) {}
 
     void merge_pixel_list(PixelGroup& other) {
-      pixel_list.insert(pixel_list.end(), other.pixel_list.begin(), other.pixel_list.end());
+      pixel_list.append(other.pixel_list);
     }
   };
 
@@ -84,6 +86,38 @@ private:
 
 };
 
+/**
+ * @class ParallelLutz
+ * @brief
+ *    Runs Lutz on horizontal bands of the image concurrently, and stitches together the groups
+ *    that cross the band boundaries
+ * @details
+ *    Groups and progress notifications are sent to the listener in the same order as a single Lutz
+ *    pass over the whole image would, so source ids are assigned identically.
+ */
+class ParallelLutz {
+public:
+
+  /**
+   * @param thread_pool
+   *    Pool where the bands are labelled
+   * @param band_height
+   *    Height of each band. Ideally a multiple of the tile height.
+   * @param max_bands_in_flight
+   *    Bound the number of bands labelled but not yet published, and therefore the memory used
+   */
+  ParallelLutz(std::shared_ptr<Euclid::ThreadPool> thread_pool, int band_height, int max_bands_in_flight)
+      : m_thread_pool(thread_pool), m_band_height(band_height), m_max_bands_in_flight(max_bands_in_flight) {}
+
+  virtual ~ParallelLutz() = default;
+
+  void labelImage(Lutz::LutzListener& listener, std::shared_ptr<const DetectionImage> image);
+
+private:
+  std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
+  int m_band_height, m_max_bands_in_flight;
+};
+
 }
 
 
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <memory>
+#include "AlexandriaKernel/ThreadPool.h"
 #include "SEFramework/Frame/Frame.h"
 #include "SEFramework/Source/SourceFactory.h"
 #include "SEFramework/Pipeline/Segmentation.h"
@@ -44,9 +45,18 @@ public:
    */
   virtual ~LutzSegmentation() = default;
 
-  explicit LutzSegmentation(std::shared_ptr<SourceFactory> source_factory, int window_size = 0)
+  /**
+   * @param thread_pool
+   *    If not null, horizontal bands of the image are labelled in parallel using this pool
+   * @param max_bands_in_flight
+   *    Maximum number of bands being labelled or waiting to be published
+   */
+  explicit LutzSegmentation(std::shared_ptr<SourceFactory> source_factory, int window_size = 0,
+                            std::shared_ptr<Euclid::ThreadPool> thread_pool = nullptr, int max_bands_in_flight = 0)
       : m_source_factory(source_factory),
-        m_window_size(window_size) {
+        m_window_size(window_size),
+        m_thread_pool(thread_pool),
+        m_max_bands_in_flight(max_bands_in_flight) {
     assert(source_factory != nullptr);
   }
 
@@ -55,6 +65,8 @@ public:
 private:
   std::shared_ptr<SourceFactory> m_source_factory;
   int m_window_size;
+  std::shared_ptr<Euclid::ThreadPool> m_thread_pool;
+  int m_max_bands_in_flight;
 };
 
 } /* namespace SourceXtractor */
@@ -23,6 +23,7 @@
 #ifndef _SEIMPLEMENTATION_SEGMENTATIONFACTORY_H
 #define _SEIMPLEMENTATION_SEGMENTATIONFACTORY_H
 
+#include "AlexandriaKernel/ThreadPool.h"
 #include "SEImplementation/Configuration/SegmentationConfig.h"
 
 #include "SEFramework/Task/TaskProvider.h"
@@ -59,6 +60,8 @@ private:
   std::shared_ptr<TaskProvider> m_task_provider;
 
   int m_lutz_window_size;
+  std::shared_ptr<Euclid::ThreadPool> m_lutz_thread_pool;
+  int m_lutz_max_bands_in_flight;
   int m_bfs_max_delta;
 
   std::string m_model_path;
@@ -24,6 +24,7 @@
 
 #include "SEImplementation/Background/BackgroundAnalyzerFactory.h"
 
+#include "SEImplementation/Configuration/MultiThreadingConfig.h"
 #include "SEImplementation/Background/SimpleBackgroundAnalyzer.h"
 #include "SEImplementation/Background/SE/SEBackgroundLevelAnalyzer.h"
 
@@ -37,7 +38,8 @@ std::shared_ptr<BackgroundAnalyzer> BackgroundAnalyzerFactory::createBackgroundA
     WeightImageConfig::WeightType weight_type) const {
   // make a SE2 background if cell size and smoothing box are given
   if (m_cell_size.size() > 0 && m_smoothing_box.size() > 0) {
-      return std::make_shared<SEBackgroundLevelAnalyzer>(m_cell_size, m_smoothing_box, weight_type);
+      return std::make_shared<SEBackgroundLevelAnalyzer>(m_cell_size, m_smoothing_box, weight_type, m_thread_pool,
+                                                         m_cache);
   } else {
     // make a simple background
     return std::make_shared<SimpleBackgroundAnalyzer>();
@@ -48,6 +50,7 @@ BackgroundAnalyzerFactory::BackgroundAnalyzerFactory(long manager_id)
     : Configuration(manager_id), m_weight_type(WeightImageConfig::WeightType::WEIGHT_TYPE_NONE) {
   declareDependency<SE2BackgroundConfig>();
   declareDependency<WeightImageConfig>();
+  declareDependency<MultiThreadingConfig>();
 }
 
 void BackgroundAnalyzerFactory::initialize(const UserValues&) {
@@ -56,6 +59,10 @@ void BackgroundAnalyzerFactory::initialize(const UserValues&) {
   m_cell_size = se2background_config.getCellSize();
   m_smoothing_box = se2background_config.getSmoothingBox();
   m_weight_type = weight_image_config.getWeightType();
+  m_thread_pool = getDependency<MultiThreadingConfig>().getThreadPool();
+  if (!se2background_config.getCacheDirectory().empty()) {
+    m_cache = std::make_shared<BackgroundCache>(se2background_config.getCacheDirectory());
+  }
 }
 
 }
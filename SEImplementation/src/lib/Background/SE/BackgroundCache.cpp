@@ -0,0 +1,194 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "SEFramework/FITS/FitsImageSource.h"
+#include "SEFramework/Image/ImageChunk.h"
+#include "SEImplementation/Background/Utils.h"
+#include "SEImplementation/Background/SE/BackgroundCache.h"
+
+namespace SourceXtractor {
+
+// Rows hashed per chunk
+static constexpr int HASH_CHUNK_HEIGHT = 64;
+
+// Digits of the digest used in the file names
+static constexpr std::size_t FILE_NAME_DIGITS = 16;
+
+static const std::string KEY_KEYWORD = "BKGKEY";
+static const std::string SCALING_KEYWORD = "BKGSCALE";
+static const std::string MESH_COUNT_KEYWORD = "BKGNMESH";
+
+BackgroundCache::BackgroundCache(const std::string& directory) : m_directory(directory) {
+  boost::filesystem::create_directories(m_directory);
+}
+
+std::string BackgroundCache::getPath(const std::string& digest) const {
+  return (boost::filesystem::path(m_directory) /
+          ("background_" + digest.substr(0, FILE_NAME_DIGITS) + ".fits")).native();
+}
+
+static std::shared_ptr<VectorImage<DetectionImage::PixelType>> readMesh(const std::string& path, int hdu) {
+  auto source = std::make_shared<FitsImageSource>(path, hdu, ImageTile::FloatImage);
+  auto tile = source->getImageTile(0, 0, source->getWidth(), source->getHeight());
+  auto mesh = VectorImage<DetectionImage::PixelType>::create(source->getWidth(), source->getHeight());
+  for (int y = 0; y < mesh->getHeight(); ++y) {
+    for (int x = 0; x < mesh->getWidth(); ++x) {
+      mesh->setValue(x, y, tile->getValue<DetectionImage::PixelType>(x, y));
+    }
+  }
+  return mesh;
+}
+
+static std::shared_ptr<FitsImageSource> writeMesh(const std::string& path, const VectorImage<DetectionImage::PixelType>& mesh,
+                                                  bool append) {
+  auto source = std::make_shared<FitsImageSource>(path, mesh.getWidth(), mesh.getHeight(), ImageTile::FloatImage,
+                                                  nullptr, append);
+  auto tile = ImageTile::create(ImageTile::FloatImage, 0, 0, mesh.getWidth(), mesh.getHeight());
+  for (int y = 0; y < mesh.getHeight(); ++y) {
+    for (int x = 0; x < mesh.getWidth(); ++x) {
+      tile->setValue(x, y, mesh.getValue(x, y));
+    }
+  }
+  source->saveTile(*tile);
+  return source;
+}
+
+bool BackgroundCache::load(const Key& key, Entry& entry) const {
+  auto digest = key.getDigest();
+  auto path = getPath(digest);
+  if (!boost::filesystem::exists(path)) {
+    return false;
+  }
+
+  try {
+    auto primary = std::make_shared<FitsImageSource>(path, 1, ImageTile::FloatImage);
+    std::string stored_key;
+    double scaling;
+    int mesh_count;
+    if (!primary->readFitsKeyword(KEY_KEYWORD, stored_key) ||
+        !primary->readFitsKeyword(SCALING_KEYWORD, scaling) ||
+        !primary->readFitsKeyword(MESH_COUNT_KEYWORD, mesh_count) || mesh_count < 2 || mesh_count > 3) {
+      bck_model_logger.warn() << "Ignoring incomplete background cache entry " << path;
+      return false;
+    }
+    // Another key with the same file name
+    if (stored_key != digest) {
+      bck_model_logger.info() << "The background cache entry " << path << " belongs to a different image";
+      return false;
+    }
+
+    entry.m_mode = readMesh(path, 1);
+    entry.m_sigma = readMesh(path, 2);
+    // Only a third mesh recorded in the header is expected, any error reading it is an error
+    entry.m_variance_mode = mesh_count == 3 ? readMesh(path, 3) : nullptr;
+    entry.m_scaling = scaling;
+  }
+  catch (const std::exception& e) {
+    bck_model_logger.warn() << "Could not read the background cache entry " << path << ": " << e.what();
+    return false;
+  }
+
+  bck_model_logger.info() << "Background model read from cache " << path;
+  return true;
+}
+
+void BackgroundCache::store(const Key& key, const Entry& entry) const {
+  auto digest = key.getDigest();
+  auto path = getPath(digest);
+  // Written aside and renamed into place, so readers, even from other processes,
+  // see either the complete entry or none at all
+  auto temp_path = boost::filesystem::unique_path(
+    boost::filesystem::path(m_directory) /
+    ("background_" + digest.substr(0, FILE_NAME_DIGITS) + "_%%%%%%%%.tmp")).native();
+
+  try {
+    {
+      auto primary = writeMesh(temp_path, *entry.m_mode, false);
+
+      std::ostringstream scaling;
+      scaling << std::setprecision(std::numeric_limits<SeFloat>::max_digits10) << std::showpoint << entry.m_scaling;
+      primary->setMetadata(SCALING_KEYWORD, MetadataEntry{scaling.str(), {}});
+      primary->setMetadata(MESH_COUNT_KEYWORD, MetadataEntry{std::int64_t{entry.m_variance_mode ? 3 : 2}, {}});
+      primary->setMetadata(KEY_KEYWORD, MetadataEntry{"'" + digest + "'", {}});
+
+      writeMesh(temp_path, *entry.m_sigma, true);
+      if (entry.m_variance_mode) {
+        writeMesh(temp_path, *entry.m_variance_mode, true);
+      }
+    }
+    // The file is closed once no image source refers to it anymore
+    boost::filesystem::rename(temp_path, path);
+  }
+  catch (const std::exception& e) {
+    bck_model_logger.warn() << "Could not write the background cache entry " << path << ": " << e.what();
+    boost::system::error_code ignored;
+    boost::filesystem::remove(temp_path, ignored);
+    return;
+  }
+
+  bck_model_logger.info() << "Background model stored in cache " << path;
+}
+
+BackgroundCache::Key::Key(const std::string& description) {
+  m_sha1.process_bytes(description.data(), description.size());
+}
+
+void BackgroundCache::Key::addImage(const Image<SeFloat>& image) {
+  const int width = image.getWidth(), height = image.getHeight();
+  std::vector<SeFloat> row(width);
+
+  for (int y = 0; y < height; y += HASH_CHUNK_HEIGHT) {
+    int chunk_height = std::min(HASH_CHUNK_HEIGHT, height - y);
+    if (y + chunk_height < height) {
+      image.prefetch(0, y + chunk_height, width, std::min(HASH_CHUNK_HEIGHT, height - y - chunk_height));
+    }
+
+    auto chunk = image.getChunk(0, y, width, chunk_height);
+    for (int iy = 0; iy < chunk_height; ++iy) {
+      for (int ix = 0; ix < width; ++ix) {
+        row[ix] = chunk->getValue(ix, iy);
+      }
+      m_sha1.process_bytes(row.data(), row.size() * sizeof(SeFloat));
+    }
+  }
+}
+
+std::string BackgroundCache::Key::getDigest() const {
+  // Reading the digest finalizes the state, so work on a copy
+  auto sha1 = m_sha1;
+  boost::uuids::detail::sha1::digest_type digest;
+  sha1.get_digest(digest);
+
+  // The words of the digest are 32 bits wide, or bytes depending on the version of boost
+  std::ostringstream str;
+  str << std::hex << std::setfill('0');
+  for (auto word : digest) {
+    str << std::setw(sizeof(word) * 2) << static_cast<std::uint64_t>(word);
+  }
+  return str.str();
+}
+
+} // end of namespace SourceXtractor
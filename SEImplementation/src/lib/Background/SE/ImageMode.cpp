@@ -15,6 +15,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <functional>
+#include <future>
 #include <Histogram/Histogram.h> // From Alexandria
 
 #include "SEFramework/Image/ImageChunk.h"
@@ -30,7 +32,8 @@ template<typename T>
 ImageMode<T>::ImageMode(const std::shared_ptr<Image<T>>& image, const std::shared_ptr<Image<T>>& variance,
                         int cell_w, int cell_h,
                         T invalid_value, T kappa1, T kappa2, T kappa3,
-                        T rtol, size_t max_iter): m_image(image),
+                        T rtol, size_t max_iter,
+                        const std::shared_ptr<Euclid::ThreadPool>& thread_pool): m_image(image),
                                                             m_cell_w(cell_w), m_cell_h(cell_h),
                                                             m_invalid(invalid_value),
                                                             m_kappa1(kappa1), m_kappa2(kappa2), m_kappa3(kappa3),
@@ -48,19 +51,37 @@ ImageMode<T>::ImageMode(const std::shared_ptr<Image<T>>& image, const std::share
   if (variance) {
     m_var_mode = VectorImage<T>::create(hist_width.quot, hist_height.quot);
     m_var_sigma = VectorImage<T>::create(hist_width.quot, hist_height.quot);
+  }
 
-    for (int y = 0; y < m_mode->getHeight(); ++y) {
-      for (int x = 0; x < m_mode->getWidth(); ++x) {
-        processCell(*image, x, y, *m_mode, *m_sigma);
+  // Each row writes to its own pixels of the output images, so rows can run concurrently
+  auto process_row = [this, &image, &variance](int y) {
+    for (int x = 0; x < m_mode->getWidth(); ++x) {
+      processCell(*image, x, y, *m_mode, *m_sigma);
+      if (variance) {
         processCell(*variance, x, y, *m_var_mode, *m_var_sigma);
       }
     }
+  };
+
+  if (thread_pool) {
+    std::vector<std::future<void>> rows;
+    rows.reserve(m_mode->getHeight());
+    for (int y = 0; y < m_mode->getHeight(); ++y) {
+      auto task = std::make_shared<std::packaged_task<void()>>(std::bind(process_row, y));
+      rows.emplace_back(task->get_future());
+      thread_pool->submit([task]() { (*task)(); });
+    }
+    // All rows must be done before anything is rethrown, as they reference this object
+    for (auto& row : rows) {
+      row.wait();
+    }
+    for (auto& row : rows) {
+      row.get();
+    }
   }
   else {
     for (int y = 0; y < m_mode->getHeight(); ++y) {
-      for (int x = 0; x < m_mode->getWidth(); ++x) {
-        processCell(*image, x, y, *m_mode, *m_sigma);
-      }
+      process_row(y);
     }
   }
 }
@@ -131,7 +152,19 @@ void ImageMode<T>::processCell(const Image<T>& img, int x, int y,
   auto img_chunk_ptr = img.getChunk(off_x, off_y, w, h);
   auto& img_chunk = *img_chunk_ptr;
 
-  std::vector<T> filtered;
+  // Cells are visited in row-major order, so read the next one while this one is being processed
+  int next_x = off_x + m_cell_w, next_y = off_y;
+  if (next_x >= img.getWidth()) {
+    next_x = 0;
+    next_y += m_cell_h;
+  }
+  if (next_y < img.getHeight()) {
+    img.prefetch(next_x, next_y, m_cell_w, m_cell_h);
+  }
+
+  // Scratch buffer reused by all the cells processed by this thread
+  static thread_local std::vector<T> filtered;
+  filtered.clear();
   filtered.reserve(w * h);
 
   for (int y = 0; y < h; ++y) {
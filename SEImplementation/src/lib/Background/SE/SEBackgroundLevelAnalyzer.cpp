@@ -27,12 +27,18 @@
 #include "SEImplementation/Background/SE/MedianFilter.h"
 #include "SEImplementation/Background/SE/ReplaceUndefImage.h"
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 namespace SourceXtractor {
 
 SEBackgroundLevelAnalyzer::SEBackgroundLevelAnalyzer(const std::vector<int>& cell_size,
                                                      const std::vector<int>& smoothing_box,
-                                                     const WeightImageConfig::WeightType weight_type)
-  : m_weight_type(weight_type) {
+                                                     const WeightImageConfig::WeightType weight_type,
+                                                     std::shared_ptr<Euclid::ThreadPool> thread_pool,
+                                                     std::shared_ptr<BackgroundCache> cache)
+  : m_weight_type(weight_type), m_thread_pool(thread_pool), m_cache(cache) {
   assert(cell_size.size() > 0 && cell_size.size() < 3);
   assert(smoothing_box.size() > 0 && smoothing_box.size() < 3);
   m_cell_size[0] = cell_size.front();
@@ -76,6 +82,67 @@ static float getMedian(const VectorImage<DetectionImage::PixelType>& img) {
   return (v[nitems / 2] + v[nitems / 2 - 1]) / 2;
 }
 
+BackgroundCache::Entry SEBackgroundLevelAnalyzer::computeMeshes(const std::shared_ptr<DetectionImage>& image,
+                                                                const std::shared_ptr<WeightImage>& variance_map,
+                                                                DetectionImage::PixelType mask_value) const {
+  BackgroundCache::Entry meshes;
+
+  // Create histogram model for the image
+  ImageMode<DetectionImage::PixelType> histo(image, variance_map, m_cell_size[0], m_cell_size[1], mask_value, 2, 5, 3,
+                                             1e-4, 100, m_thread_pool);
+  auto mode = histo.getModeImage();
+  auto var = histo.getSigmaImage();
+
+  // Interpolate missing values
+  // The result is "materialized" into a VectorImage to avoid redundant computations on the next steps
+  mode = ReplaceUndef<DetectionImage::PixelType>(*mode, mask_value);
+  var = ReplaceUndef<WeightImage::PixelType>(*var, mask_value);
+
+  // Smooth with the smooth_box (median filtering)
+  std::tie(meshes.m_mode, meshes.m_sigma) = MedianFilter<DetectionImage::PixelType>(m_smoothing_box)(*mode, *var);
+
+  meshes.m_scaling = 99999;
+
+  if (variance_map) {
+    // Create histogram model for the variance image
+    auto weight = histo.getVarianceModeImage();
+    auto weight_var = histo.getVarianceSigmaImage();
+    // Interpolate missing values
+    weight = ReplaceUndef<DetectionImage::PixelType>(*weight, mask_value);
+    // Smooth with the smooth_box (median filtering)
+    std::tie(weight, weight_var) = MedianFilter<WeightImage::PixelType>(m_smoothing_box)(*weight, *weight_var);
+    // Compute scaling
+    meshes.m_scaling = computeScaling(meshes.m_sigma, weight);
+    meshes.m_variance_mode = weight;
+  }
+
+  return meshes;
+}
+
+BackgroundCache::Key SEBackgroundLevelAnalyzer::computeCacheKey(const DetectionImage& image,
+                                                         const std::shared_ptr<WeightImage>& variance_map,
+                                                         WeightImage::PixelType variance_threshold) const {
+  // Everything that changes the meshes: the estimation parameters, and the pixel values as seen here,
+  // which already have the mask and the variance threshold applied.
+  // Bump the version if the estimation itself changes.
+  std::ostringstream description;
+  description << std::setprecision(std::numeric_limits<WeightImage::PixelType>::max_digits10)
+              << "v1 " << image.getRepr() << " " << image.getWidth() << "x" << image.getHeight()
+              << " cell " << m_cell_size[0] << "x" << m_cell_size[1]
+              << " box " << m_smoothing_box[0] << "x" << m_smoothing_box[1]
+              << " threshold " << variance_threshold;
+  if (variance_map) {
+    description << " variance " << variance_map->getRepr();
+  }
+
+  BackgroundCache::Key key(description.str());
+  key.addImage(image);
+  if (variance_map) {
+    key.addImage(*variance_map);
+  }
+  return key;
+}
+
 BackgroundModel SEBackgroundLevelAnalyzer::analyzeBackground(
   std::shared_ptr<DetectionImage> image, std::shared_ptr<WeightImage> variance_map,
   std::shared_ptr<Image<unsigned char>> mask, WeightImage::PixelType variance_threshold) const {
@@ -113,37 +180,28 @@ BackgroundModel SEBackgroundLevelAnalyzer::analyzeBackground(
       variance_map, variance_map, mask_value, variance_threshold);
   }
 
-  // Create histogram model for the image
-  ImageMode<DetectionImage::PixelType> histo(image, variance_map, m_cell_size[0], m_cell_size[1], mask_value, 2, 5, 3);
-  auto mode = histo.getModeImage();
-  auto var = histo.getSigmaImage();
-
-  // Interpolate missing values
-  // The result is "materialized" into a VectorImage to avoid redundant computations on the next steps
-  mode = ReplaceUndef<DetectionImage::PixelType>(*mode, mask_value);
-  var = ReplaceUndef<WeightImage::PixelType>(*var, mask_value);
+  BackgroundCache::Entry meshes;
+  if (m_cache) {
+    auto cache_key = computeCacheKey(*image, variance_map, variance_threshold);
+    if (!m_cache->load(cache_key, meshes)) {
+      meshes = computeMeshes(image, variance_map, mask_value);
+      m_cache->store(cache_key, meshes);
+    }
+  }
+  else {
+    meshes = computeMeshes(image, variance_map, mask_value);
+  }
 
-  // Smooth with the smooth_box (median filtering)
-  std::tie(mode, var) = MedianFilter<DetectionImage::PixelType>(m_smoothing_box)(*mode, *var);
-  auto median = getMedian(*mode);
-  auto median_sigma = getMedian(*var);
+  auto median = getMedian(*meshes.m_mode);
+  auto median_sigma = getMedian(*meshes.m_sigma);
 
-  SeFloat scaling = 99999;
+  SeFloat scaling = meshes.m_scaling;
 
   std::shared_ptr<Image<DetectionImage::PixelType>> final_bg, final_var;
 
   if (variance_map) {
-    // Create histogram model for the variance image
-    auto weight = histo.getVarianceModeImage();
-    auto weight_var = histo.getVarianceSigmaImage();
-    // Interpolate missing values
-    weight = ReplaceUndef<DetectionImage::PixelType>(*weight, mask_value);
-    // Smooth with the smooth_box (median filtering)
-    std::tie(weight, weight_var) = MedianFilter<WeightImage::PixelType>(m_smoothing_box)(*weight, *weight_var);
-    // Compute scaling
-    scaling = computeScaling(var, weight);
     // Transform RMS to variance
-    final_var = MultiplyImage<DetectionImage::PixelType>::create(var, var);
+    final_var = MultiplyImage<DetectionImage::PixelType>::create(meshes.m_sigma, meshes.m_sigma);
     final_var = BufferedImage<DetectionImage::PixelType>::create(
       std::make_shared<ScaledImageSource<DetectionImage::PixelType>>(
         final_var, image->getWidth(), image->getHeight(),
@@ -161,7 +219,7 @@ BackgroundModel SEBackgroundLevelAnalyzer::analyzeBackground(
 
   final_bg = BufferedImage<DetectionImage::PixelType>::create(
     std::make_shared<ScaledImageSource<DetectionImage::PixelType>>(
-      mode, image->getWidth(), image->getHeight(),
+      meshes.m_mode, image->getWidth(), image->getHeight(),
       ScaledImageSource<DetectionImage::PixelType>::InterpolationType::BICUBIC
     )
   );
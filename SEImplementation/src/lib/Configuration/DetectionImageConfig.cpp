@@ -29,6 +29,7 @@ using boost::smatch;
 #include <SEFramework/Image/ProcessedImage.h>
 #include <SEFramework/Image/BufferedImage.h>
 #include "SEFramework/FITS/FitsImageSource.h"
+#include "SEFramework/FITS/MmapFitsImageSource.h"
 
 #include "SEFramework/CoordinateSystem/WCS.h"
 
@@ -84,13 +85,13 @@ void DetectionImageConfig::initialize(const UserValues& args) {
     std::shared_ptr<FitsImageSource> fits_image_source;
     if (boost::regex_match(m_detection_image_path, hdu_regex)) {
       if (i==0) {
-        fits_image_source = std::make_shared<FitsImageSource>(m_detection_image_path, 0, ImageTile::FloatImage);
+        fits_image_source = std::make_shared<MmapFitsImageSource>(m_detection_image_path, 0, ImageTile::FloatImage);
       } else {
         break;
       }
     } else {
       try {
-        fits_image_source = std::make_shared<FitsImageSource>(m_detection_image_path, i+1, ImageTile::FloatImage);
+        fits_image_source = std::make_shared<MmapFitsImageSource>(m_detection_image_path, i+1, ImageTile::FloatImage);
       } catch (...) {
         if (i==0) {
           // Skip past primary HDU if it doesn't have an image
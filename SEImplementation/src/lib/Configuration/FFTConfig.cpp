@@ -0,0 +1,72 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FFTConfig.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/algorithm/string.hpp>
+
+#include "SEImplementation/Configuration/FFTConfig.h"
+
+using namespace Euclid::Configuration;
+namespace po = boost::program_options;
+
+namespace SourceXtractor {
+
+static const std::string FFTW_WISDOM {"fftw-wisdom"};
+static const std::string FFTW_PLANNING {"fftw-planning"};
+static const std::string FFT_KERNEL_CACHE {"fft-kernel-cache"};
+
+FFTConfig::FFTConfig(long manager_id) : Configuration(manager_id), m_planning_rigor(FFTPlanningRigor::ESTIMATE),
+                                                 m_kernel_cache_size(0) {
+}
+
+auto FFTConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
+  return { {"FFT", {
+      {FFTW_WISDOM.c_str(), po::value<std::string>()->default_value(""),
+          "File where FFTW plans are loaded from, and saved to at the end of the run"},
+      {FFTW_PLANNING.c_str(), po::value<std::string>()->default_value("ESTIMATE"),
+          "FFTW planning rigor (ESTIMATE, MEASURE or PATIENT)"},
+      {FFT_KERNEL_CACHE.c_str(), po::value<int>()->default_value(256),
+          "Maximum memory used to keep the transforms of the convolution kernels (i.e. the PSF) in megabytes"},
+  }}};
+}
+
+void FFTConfig::initialize(const UserValues& args) {
+  m_wisdom_file = args.at(FFTW_WISDOM).as<std::string>();
+
+  auto rigor_name = boost::to_upper_copy(args.at(FFTW_PLANNING).as<std::string>());
+  if (rigor_name == "ESTIMATE") {
+    m_planning_rigor = FFTPlanningRigor::ESTIMATE;
+  } else if (rigor_name == "MEASURE") {
+    m_planning_rigor = FFTPlanningRigor::MEASURE;
+  } else if (rigor_name == "PATIENT") {
+    m_planning_rigor = FFTPlanningRigor::PATIENT;
+  } else {
+    throw Elements::Exception() << "Invalid " << FFTW_PLANNING << " value: " << rigor_name;
+  }
+
+  auto kernel_cache_mb = args.at(FFT_KERNEL_CACHE).as<int>();
+  if (kernel_cache_mb < 0) {
+    throw Elements::Exception() << "Invalid " << FFT_KERNEL_CACHE << " value: " << kernel_cache_mb;
+  }
+  m_kernel_cache_size = std::size_t(kernel_cache_mb) * 1024 * 1024;
+}
+
+} /* namespace SourceXtractor */
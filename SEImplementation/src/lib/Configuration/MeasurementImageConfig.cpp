@@ -34,6 +34,7 @@
 #include <SEFramework/Image/BufferedImage.h>
 #include <SEFramework/Image/ProcessedImage.h>
 #include <SEFramework/FITS/FitsImageSource.h>
+#include <SEFramework/FITS/MmapFitsImageSource.h>
 
 #include <SEFramework/CoordinateSystem/WCS.h>
 #include <SEImplementation/Configuration/WeightImageConfig.h>
@@ -118,7 +119,7 @@ std::shared_ptr<WeightImage> createWeightMap(const PyMeasurementImage& py_image)
   }
 
   auto weight_image_source =
-      std::make_shared<FitsImageSource>(py_image.weight_file, py_image.weight_hdu+1, ImageTile::FloatImage);
+      std::make_shared<MmapFitsImageSource>(py_image.weight_file, py_image.weight_hdu+1, ImageTile::FloatImage);
   std::shared_ptr<WeightImage> weight_map = BufferedImage<WeightImage::PixelType>::create(weight_image_source);
   if (py_image.is_data_cube) {
     weight_image_source->setLayer(py_image.weight_layer);
@@ -186,7 +187,7 @@ void MeasurementImageConfig::initialize(const UserValues&) {
       info.m_weight_layer = py_image.weight_layer;
 
       auto fits_image_source =
-          std::make_shared<FitsImageSource>(py_image.file, py_image.image_hdu+1, ImageTile::FloatImage);
+          std::make_shared<MmapFitsImageSource>(py_image.file, py_image.image_hdu+1, ImageTile::FloatImage);
 
       if (py_image.is_data_cube) {
         fits_image_source->setLayer(py_image.image_layer);
@@ -21,6 +21,8 @@
  *      Author: mschefer
  */
 
+#include <boost/algorithm/string.hpp>
+
 #include "SEImplementation/Configuration/MemoryConfig.h"
 
 using namespace Euclid::Configuration;
@@ -30,14 +32,18 @@ namespace SourceXtractor {
 
 static const std::string MAX_TILE_MEMORY {"tile-memory-limit"};
 static const std::string TILE_SIZE {"tile-size"};
+static const std::string TILE_EVICTION_POLICY {"tile-eviction-policy"};
 
-MemoryConfig::MemoryConfig(long manager_id) : Configuration(manager_id), m_max_memory(512), m_tile_size(256) {
+MemoryConfig::MemoryConfig(long manager_id) : Configuration(manager_id), m_max_memory(512), m_tile_size(256),
+                                              m_eviction_policy(TileEvictionPolicy::Type::TWO_Q) {
 }
 
 auto MemoryConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
   return { {"Memory usage", {
       {MAX_TILE_MEMORY.c_str(), po::value<int>()->default_value(512), "Maximum memory used for image tiles cache in megabytes"},
       {TILE_SIZE.c_str(), po::value<int>()->default_value(256), "Image tiles size in pixels"},
+      {TILE_EVICTION_POLICY.c_str(), po::value<std::string>()->default_value("2Q"),
+          "Image tiles cache eviction policy (FIFO, CLOCK or 2Q)"},
   }}};
 }
 
@@ -50,6 +56,17 @@ void MemoryConfig::initialize(const UserValues& args) {
   if (m_tile_size <= 0) {
     throw Elements::Exception() << "Invalid " << TILE_SIZE << " value: " << m_tile_size;
   }
+
+  auto policy_name = boost::to_upper_copy(args.at(TILE_EVICTION_POLICY).as<std::string>());
+  if (policy_name == "FIFO") {
+    m_eviction_policy = TileEvictionPolicy::Type::FIFO;
+  } else if (policy_name == "CLOCK") {
+    m_eviction_policy = TileEvictionPolicy::Type::CLOCK;
+  } else if (policy_name == "2Q") {
+    m_eviction_policy = TileEvictionPolicy::Type::TWO_Q;
+  } else {
+    throw Elements::Exception() << "Invalid " << TILE_EVICTION_POLICY << " value: " << policy_name;
+  }
 }
 
 } /* namespace SourceXtractor */
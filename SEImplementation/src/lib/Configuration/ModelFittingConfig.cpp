@@ -20,6 +20,8 @@
  * @author Nikolaos Apostolakos <nikoapos@gmail.com>
  */
 
+#include <cmath>
+#include <map>
 #include <string>
 #include <boost/python/extract.hpp>
 #include <boost/python/object.hpp>
@@ -27,14 +29,20 @@
 #include <boost/python/dict.hpp>
 
 #include "ElementsKernel/Logging.h"
+#include "ElementsKernel/Exception.h"
 
 #include "ModelFitting/Engine/LeastSquareEngineManager.h"
 
+#include "SEFramework/CoordinateSystem/CoordinateSystem.h"
+
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingParameter.h"
 #include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingConverterFactory.h"
+#include "SEImplementation/PythonConfig/ExpressionProgram.h"
 #include "SEImplementation/PythonConfig/ObjectInfo.h"
+#include "SEImplementation/PythonConfig/PythonCallStatistics.h"
 #include "SEImplementation/Configuration/PythonConfig.h"
 #include "SEImplementation/Configuration/ModelFittingConfig.h"
+#include "SEImplementation/Configuration/WarmStartConfig.h"
 #include "Pyston/GIL.h"
 #include "Pyston/Exceptions.h"
 #include "Pyston/ExpressionTreeBuilder.h"
@@ -59,6 +67,101 @@ static Elements::Logging logger = Elements::Logging::getLogger("Config");
 
 namespace SourceXtractor {
 
+/**
+ * Logs whether the expression could be compiled. If it could not, it is registered into PythonCallStatistics
+ * and the returned counter must be updated on each call, since each one goes through the interpreter.
+ */
+template<typename ExpressionTree>
+static std::shared_ptr<PythonCallStatistics::Counter> checkCompiled(const std::string& readable,
+                                                                   const ExpressionTree& wrapped) {
+  if (!wrapped.isCompiled()) {
+    logger.warn() << "Could not compile " << readable << ": " << wrapped.reason()->what();
+    wrapped.reason()->log(log4cpp::Priority::DEBUG, logger);
+    return PythonCallStatistics::getInstance().registerFunction(readable, wrapped.reason()->what());
+  }
+
+  logger.info() << readable << " compiled";
+  Pyston::GraphvizGenerator gv(readable);
+  wrapped.getTree()->visit(gv);
+  logger.debug() << gv.str();
+  return nullptr;
+}
+
+static double image_to_world_alpha(const Pyston::Context& context, double x, double y) {
+  auto coord_system = boost::any_cast<std::shared_ptr<CoordinateSystem>>(context.at("coordinate_system"));
+  return coord_system->imageToWorld({x, y}).m_alpha;
+}
+
+static double image_to_world_delta(const Pyston::Context& context, double x, double y) {
+  auto coord_system = boost::any_cast<std::shared_ptr<CoordinateSystem>>(context.at("coordinate_system"));
+  return coord_system->imageToWorld({x, y}).m_delta;
+}
+
+// Functions that can be called from the expressions
+static const std::map<std::string, ExpressionProgram::ContextFunction> context_functions {
+  {"image_to_world_alpha", image_to_world_alpha},
+  {"image_to_world_delta", image_to_world_delta}
+};
+
+namespace {
+
+/// Arbitrary, but not trivial, transformation used to check the programs that convert coordinates
+class ProbeCoordinateSystem : public CoordinateSystem {
+public:
+  WorldCoordinate imageToWorld(ImageCoordinate image_coordinate) const override {
+    return {150. + 1e-4 * image_coordinate.m_x - 2e-5 * image_coordinate.m_y,
+            -30. + 3e-5 * image_coordinate.m_x + 1e-4 * image_coordinate.m_y};
+  }
+
+  ImageCoordinate worldToImage(WorldCoordinate) const override {
+    throw Elements::Exception() << "Not implemented";
+  }
+};
+
+}
+
+/**
+ * Lowers a compiled expression into an ExpressionProgram. The program is checked against the Pyston tree
+ * on a few points, so a node that is not understood as Pyston does leaves the expression to Pyston.
+ * @return
+ *    nullptr if the expression could not be lowered
+ */
+template<typename ExpressionTree>
+static std::shared_ptr<ExpressionProgram> lowerCompiled(const std::string& readable, const ExpressionTree& wrapped,
+                                                        size_t nparams) {
+  auto program = ExpressionProgram::lower(ExpressionProgram::mirror(*wrapped.getTree()), nparams, context_functions);
+  if (!program) {
+    logger.debug() << readable << " has nodes that can not be lowered, it is evaluated by Pyston";
+    return nullptr;
+  }
+
+  Pyston::Context context;
+  context["coordinate_system"] = std::shared_ptr<CoordinateSystem>(std::make_shared<ProbeCoordinateSystem>());
+  for (int probe = 0; probe < 3; ++probe) {
+    std::vector<double> params(nparams);
+    for (size_t i = 0; i < nparams; ++i) {
+      params[i] = (probe == 2 ? -1. : 1.) * (0.75 + 0.5 * i) + 0.3 * probe;
+    }
+    try {
+      double expected = wrapped(context, params);
+      double value = (*program)(context, params);
+      bool same = (std::isnan(expected) && std::isnan(value)) || expected == value ||
+                  std::abs(expected - value) <= 1e-12 * std::abs(expected);
+      if (!same) {
+        logger.debug() << readable << " lowered gives " << value << " instead of " << expected
+                       << ", it is evaluated by Pyston";
+        return nullptr;
+      }
+    } catch (const std::exception& e) {
+      logger.debug() << readable << " could not be checked (" << e.what() << "), it is evaluated by Pyston";
+      return nullptr;
+    }
+  }
+
+  logger.info() << readable << " lowered into " << program->size() << " instructions";
+  return program;
+}
+
 template<typename Signature>
 struct FunctionFromPython {
 };
@@ -66,25 +169,17 @@ struct FunctionFromPython {
 template<>
 struct FunctionFromPython<double(const SourceInterface&)> {
   static
-  std::function<double(const SourceInterface&)> get(const char *readable,
+  std::function<double(const SourceInterface&)> get(const std::string& readable,
                                                  Pyston::ExpressionTreeBuilder& builder,
                                                  py::object py_func) {
     auto wrapped = builder.build<double(const AttributeSet&)>(py_func, ObjectInfo{});
 
-    if (!wrapped.isCompiled()) {
-      logger.warn() << "Could not compile " << readable << ": " << wrapped.reason()->what();
-      wrapped.reason()->log(log4cpp::Priority::DEBUG, logger);
-    }
-    else {
-      logger.info() << readable << " compiled";
-      Pyston::GraphvizGenerator gv(readable);
-      wrapped.getTree()->visit(gv);
-      logger.debug() << gv.str();
-    }
+    auto counter = checkCompiled(readable, wrapped);
 
-    return [wrapped](const SourceInterface& o) -> double {
+    std::function<double(const SourceInterface&)> func = [wrapped](const SourceInterface& o) -> double {
       return wrapped(ObjectInfo{o});
     };
+    return counter ? PythonCallStatistics::wrap(counter, func) : func;
   }
 };
 
@@ -92,51 +187,46 @@ template<>
 struct FunctionFromPython<double(const Pyston::Context&, const std::vector<double>&)> {
   static
   std::function<double(const Pyston::Context&, const std::vector<double>&)>
-    get(const char *readable, Pyston::ExpressionTreeBuilder& builder, py::object py_func,
+    get(const std::string& readable, Pyston::ExpressionTreeBuilder& builder, py::object py_func,
         size_t nparams) {
     auto wrapped = builder.build<double(const std::vector<double>&)>(py_func, nparams);
-    if (!wrapped.isCompiled()) {
-      logger.warn() << "Could not compile " << readable << ": " << wrapped.reason()->what();
-      wrapped.reason()->log(log4cpp::Priority::DEBUG, logger);
-    }
-    else {
-      logger.info() << readable << " compiled";
-      Pyston::GraphvizGenerator gv(readable);
-      wrapped.getTree()->visit(gv);
-      logger.debug() << gv.str();
+    auto counter = checkCompiled(readable, wrapped);
+
+    std::function<double(const Pyston::Context&, const std::vector<double>&)> func = wrapped;
+    if (counter) {
+      return PythonCallStatistics::wrap(counter, func);
     }
 
-    return wrapped;
+    // Evaluated on each iteration of the fit, so worth flattening
+    if (auto program = lowerCompiled(readable, wrapped, nparams)) {
+      return [program](const Pyston::Context& context, const std::vector<double>& params) {
+        return (*program)(context, params);
+      };
+    }
+    return func;
   }
 };
 
 template<>
 struct FunctionFromPython<double(double, const SourceInterface&)> {
   static
-  std::function<double(double, const SourceInterface&)> get(const char *readable,
+  std::function<double(double, const SourceInterface&)> get(const std::string& readable,
                                                             Pyston::ExpressionTreeBuilder& builder,
                                                             py::object py_func) {
     auto wrapped = builder.build<double(double, const AttributeSet&)>(py_func, ObjectInfo{});
 
-    if (!wrapped.isCompiled()) {
-      logger.warn() << "Could not compile " << readable << ": " << wrapped.reason()->what();
-      wrapped.reason()->log(log4cpp::Priority::DEBUG, logger);
-    }
-    else {
-      logger.info() << readable << " compiled";
-      Pyston::GraphvizGenerator gv(readable);
-      wrapped.getTree()->visit(gv);
-      logger.debug() << gv.str();
-    }
+    auto counter = checkCompiled(readable, wrapped);
 
-    return [wrapped](double a, const SourceInterface& o) -> double {
+    std::function<double(double, const SourceInterface&)> func = [wrapped](double a, const SourceInterface& o) -> double {
       return wrapped(a, ObjectInfo{o});
     };
+    return counter ? PythonCallStatistics::wrap(counter, func) : func;
   }
 };
 
 ModelFittingConfig::ModelFittingConfig(long manager_id) : Configuration(manager_id) {
   declareDependency<PythonConfig>();
+  declareDependency<WarmStartConfig>();
 }
 
 ModelFittingConfig::~ModelFittingConfig() {
@@ -159,29 +249,16 @@ void ModelFittingConfig::initialize(const UserValues&) {
   }
 }
 
-static double image_to_world_alpha(const Pyston::Context& context, double x, double y) {
-  auto coord_system = boost::any_cast<std::shared_ptr<CoordinateSystem>>(context.at("coordinate_system"));
-  return coord_system->imageToWorld({x, y}).m_alpha;
-}
-
-static double image_to_world_delta(const Pyston::Context& context, double x, double y) {
-  auto coord_system = boost::any_cast<std::shared_ptr<CoordinateSystem>>(context.at("coordinate_system"));
-  return coord_system->imageToWorld({x, y}).m_delta;
-}
-
 void ModelFittingConfig::initializeInner() {
   Pyston::ExpressionTreeBuilder expr_builder;
-  expr_builder.registerFunction<double(const Pyston::Context&, double, double)>(
-    "image_to_world_alpha", image_to_world_alpha
-  );
-  expr_builder.registerFunction<double(const Pyston::Context&, double, double)>(
-    "image_to_world_delta", image_to_world_delta
-  );
+  for (auto& f : context_functions) {
+    expr_builder.registerFunction<double(const Pyston::Context&, double, double)>(f.first, f.second);
+  }
 
   /* Constant parameters */
   for (auto& p : getDependency<PythonConfig>().getInterpreter().getConstantParameters()) {
     auto value_func = FunctionFromPython<double(const SourceInterface&)>::get(
-      "Constant parameter", expr_builder, p.second.attr("get_value")
+      "Constant parameter " + std::to_string(p.first), expr_builder, p.second.attr("get_value")
     );
 
     m_parameters[p.first] = std::make_shared<FlexibleModelFittingConstantParameter>(
@@ -189,10 +266,24 @@ void ModelFittingConfig::initializeInner() {
   }
 
   /* Free parameters */
-  for (auto& p : getDependency<PythonConfig>().getInterpreter().getFreeParameters()) {
+  auto free_parameters = getDependency<PythonConfig>().getInterpreter().getFreeParameters();
+
+  // Free parameters written as an output column can be initialized from the catalog of a previous run
+  std::map<int, std::string> free_parameter_columns;
+  for (auto& column : getDependency<PythonConfig>().getInterpreter().getModelFittingOutputColumns()) {
+    if (column.second.size() == 1 && free_parameters.count(column.second.front())) {
+      free_parameter_columns.emplace(column.second.front(), column.first);
+    }
+  }
+  auto warm_start = getDependency<WarmStartConfig>().getWarmStart(free_parameter_columns);
+
+  for (auto& p : free_parameters) {
     auto init_value_func = FunctionFromPython<double(const SourceInterface&)>::get(
-      "Free parameter", expr_builder, p.second.attr("get_init_value")
+      "Free parameter " + std::to_string(p.first), expr_builder, p.second.attr("get_init_value")
     );
+    if (warm_start) {
+      init_value_func = warm_start->wrap(p.first, init_value_func);
+    }
 
     auto py_range_obj = p.second.attr("get_range")();
 
@@ -201,15 +292,15 @@ void ModelFittingConfig::initializeInner() {
 
     if (type_string == "Unbounded") {
       auto factor_func = FunctionFromPython<double(double, const SourceInterface&)>::get(
-        "Unbounded", expr_builder, py_range_obj.attr("get_normalization_factor")
+        "Unbounded " + std::to_string(p.first), expr_builder, py_range_obj.attr("get_normalization_factor")
       );
       converter = std::make_shared<FlexibleModelFittingUnboundedConverterFactory>(factor_func);
     } else if (type_string == "Range") {
       auto min_func = FunctionFromPython<double(double, const SourceInterface&)>::get(
-        "Range min", expr_builder, py_range_obj.attr("get_min")
+        "Range min " + std::to_string(p.first), expr_builder, py_range_obj.attr("get_min")
       );
       auto max_func = FunctionFromPython<double(double, const SourceInterface&)>::get(
-        "Range max", expr_builder, py_range_obj.attr("get_max")
+        "Range max " + std::to_string(p.first), expr_builder, py_range_obj.attr("get_max")
       );
 
       auto range_func = [min_func, max_func] (double init, const SourceInterface& o) -> std::pair<double, double> {
@@ -241,7 +332,7 @@ void ModelFittingConfig::initializeInner() {
     }
 
     auto dependent = FunctionFromPython<double(const Pyston::Context&, const std::vector<double>&)>
-      ::get("Dependent parameter", expr_builder, py_func, params.size());
+      ::get("Dependent parameter " + std::to_string(p.first), expr_builder, py_func, params.size());
 
     auto dependent_func = [dependent](const std::shared_ptr<CoordinateSystem> &cs, const std::vector<double> &params) -> double {
       Pyston::Context context;
@@ -360,10 +451,10 @@ void ModelFittingConfig::initializeInner() {
     auto param = m_parameters.at(param_id);
 
     auto value_func = FunctionFromPython<double(const SourceInterface&)>::get(
-      "Prior mean", expr_builder, prior.attr("value")
+      "Prior mean " + std::to_string(p.first), expr_builder, prior.attr("value")
     );
     auto sigma_func = FunctionFromPython<double(const SourceInterface&)>::get(
-      "Prior sigma", expr_builder, prior.attr("sigma")
+      "Prior sigma " + std::to_string(p.first), expr_builder, prior.attr("sigma")
     );
 
     m_priors[p.first] = std::make_shared<FlexibleModelFittingPrior>(param, value_func, sigma_func);
@@ -34,6 +34,7 @@ static Elements::Logging logger = Elements::Logging::getLogger("BackgroundConfig
 
 static const std::string CELLSIZE_VALUE {"background-cell-size" };
 static const std::string SMOOTHINGBOX_VALUE {"smoothing-box-size" };
+static const std::string CACHE_DIRECTORY {"background-cache-dir" };
 
 SE2BackgroundConfig::SE2BackgroundConfig(long manager_id) :
   Configuration(manager_id), m_cell_size(), m_smoothing_box() {
@@ -44,7 +45,9 @@ std::map<std::string, Configuration::OptionDescriptionList> SE2BackgroundConfig:
       {CELLSIZE_VALUE.c_str(), po::value<std::string>()->default_value(std::string("64")),
           "Background mesh cell size to determine a value."},
       {SMOOTHINGBOX_VALUE.c_str(), po::value<std::string>()->default_value(std::string("3")),
-          "Background median filter size"}
+          "Background median filter size"},
+      {CACHE_DIRECTORY.c_str(), po::value<std::string>()->default_value(""),
+          "Directory where background models are stored and reused on later runs (disabled if empty)"}
   }}};
 }
 
@@ -59,6 +62,8 @@ void SE2BackgroundConfig::initialize(const UserValues& args) {
     m_smoothing_box = Euclid::stringToVector<int>(smoothing_box_str);
   }
 
+  m_cache_directory = args.find(CACHE_DIRECTORY)->second.as<std::string>();
+
   auto less_eq_0 = [](int v) { return v <= 0; };
   auto less_0 = [](int v) { return v < 0; };
 
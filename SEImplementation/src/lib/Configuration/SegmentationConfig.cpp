@@ -48,12 +48,14 @@ static const std::string SEGMENTATION_ALGORITHM {"segmentation-algorithm" };
 static const std::string SEGMENTATION_USE_FILTERING {"segmentation-use-filtering" };
 static const std::string SEGMENTATION_FILTER {"segmentation-filter" };
 static const std::string SEGMENTATION_LUTZ_WINDOW_SIZE {"segmentation-lutz-window-size" };
+static const std::string SEGMENTATION_LUTZ_PARALLEL {"segmentation-lutz-parallel" };
 static const std::string SEGMENTATION_BFS_MAX_DELTA {"segmentation-bfs-max-delta" };
 static const std::string SEGMENTATION_ML_MODEL {"segmentation-ml-model" };
 static const std::string SEGMENTATION_ML_THRESHOLD {"segmentation-ml-threshold" };
 
 SegmentationConfig::SegmentationConfig(long manager_id) : Configuration(manager_id), m_selected_algorithm(Algorithm::UNKNOWN)
     , m_lutz_window_size(0)
+    , m_lutz_parallel(false)
     , m_bfs_max_delta(1000)
     , m_ml_threshold(0.9) {}
 
@@ -67,6 +69,8 @@ std::map<std::string, Configuration::OptionDescriptionList> SegmentationConfig::
           "Loads a filter"},
       {SEGMENTATION_LUTZ_WINDOW_SIZE.c_str(), po::value<int>()->default_value(0),
           "Lutz sliding window size (0=disable)"},
+      {SEGMENTATION_LUTZ_PARALLEL.c_str(), po::value<bool>()->default_value(false),
+          "Label horizontal bands of the image in parallel with Lutz (requires multithreading)"},
       {SEGMENTATION_BFS_MAX_DELTA.c_str(), po::value<int>()->default_value(1000),
           "BFS algorithm max source x/y size (default=1000)"},
       {SEGMENTATION_ML_MODEL.c_str(), po::value<std::string>()->default_value(""),
@@ -106,6 +110,7 @@ void SegmentationConfig::preInitialize(const UserValues& args) {
   }
 
   m_lutz_window_size = args.at(SEGMENTATION_LUTZ_WINDOW_SIZE).as<int>();
+  m_lutz_parallel = args.at(SEGMENTATION_LUTZ_PARALLEL).as<bool>();
   m_bfs_max_delta = args.at(SEGMENTATION_BFS_MAX_DELTA).as<int>();
   m_onnx_model_path = args.at(SEGMENTATION_ML_MODEL).as<std::string>();
   m_ml_threshold = args.at(SEGMENTATION_ML_THRESHOLD).as<double>();
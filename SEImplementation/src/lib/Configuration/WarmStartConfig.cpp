@@ -0,0 +1,167 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * WarmStartConfig.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <limits>
+#include <boost/algorithm/string.hpp>
+
+#include "ElementsKernel/Exception.h"
+#include "ElementsKernel/Logging.h"
+
+#include "Table/AsciiReader.h"
+#include "Table/FitsReader.h"
+#include "Table/CastVisitor.h"
+
+#include "SEImplementation/Configuration/WarmStartConfig.h"
+
+using namespace Euclid::Configuration;
+namespace po = boost::program_options;
+
+namespace SourceXtractor {
+
+static Elements::Logging logger = Elements::Logging::getLogger("WarmStartConfig");
+
+static const std::string WARM_START_CATALOG {"model-fitting-warm-start"};
+static const std::string WARM_START_MATCH {"model-fitting-warm-start-match"};
+static const std::string WARM_START_RADIUS {"model-fitting-warm-start-radius"};
+
+// Column names used by the SourceIDs and PixelCentroid plugins
+static const std::string SOURCE_ID_COLUMN {"source_id"};
+static const std::string CENTROID_X_COLUMN {"pixel_centroid_x"};
+static const std::string CENTROID_Y_COLUMN {"pixel_centroid_y"};
+
+WarmStartConfig::WarmStartConfig(long manager_id) : Configuration(manager_id),
+    m_match_type(FlexibleModelFittingWarmStart::MatchType::POSITION), m_radius(1.) {}
+
+auto WarmStartConfig::getProgramOptions() -> std::map<std::string, OptionDescriptionList> {
+  return {{"Model Fitting warm start", {
+      {WARM_START_CATALOG.c_str(), po::value<std::string>(),
+       "Catalog of a previous run used to initialize the model fitting parameters"},
+      {WARM_START_MATCH.c_str(), po::value<std::string>()->default_value("POSITION"),
+       "How sources are matched to the warm start catalog (POSITION or SOURCE_ID)"},
+      {WARM_START_RADIUS.c_str(), po::value<double>()->default_value(1.),
+       "Maximum distance in pixels for a match by position"}
+  }}};
+}
+
+void WarmStartConfig::initialize(const UserValues& args) {
+  auto match = boost::to_upper_copy(args.at(WARM_START_MATCH).as<std::string>());
+  if (match == "POSITION") {
+    m_match_type = FlexibleModelFittingWarmStart::MatchType::POSITION;
+  } else if (match == "SOURCE_ID") {
+    m_match_type = FlexibleModelFittingWarmStart::MatchType::SOURCE_ID;
+  } else {
+    throw Elements::Exception() << "Invalid warm start match type: " << match;
+  }
+
+  m_radius = args.at(WARM_START_RADIUS).as<double>();
+  if (m_radius < 0) {
+    throw Elements::Exception() << "Invalid " << WARM_START_RADIUS << " value: " << m_radius;
+  }
+
+  if (args.find(WARM_START_CATALOG) == args.end()) {
+    return;
+  }
+
+  m_filename = args.at(WARM_START_CATALOG).as<std::string>();
+  try {
+    std::shared_ptr<Euclid::Table::TableReader> reader;
+    try {
+      reader = std::make_shared<Euclid::Table::FitsReader>(m_filename);
+    } catch (...) {
+      // If FITS not successful try reading as ascii
+      reader = std::make_shared<Euclid::Table::AsciiReader>(m_filename);
+    }
+    m_table = std::make_shared<Euclid::Table::Table>(reader->read());
+  } catch (const std::exception& e) {
+    throw Elements::Exception() << "Can't either open or read warm start catalog: " << m_filename
+                                << " (" << e.what() << ")";
+  }
+}
+
+std::shared_ptr<FlexibleModelFittingWarmStart> WarmStartConfig::getWarmStart(
+    const std::map<int, std::string>& parameter_columns) const {
+  using Euclid::Table::CastVisitor;
+
+  if (!m_table) {
+    return nullptr;
+  }
+
+  auto column_info = m_table->getColumnInfo();
+  auto getColumnIndex = [&column_info, this](const std::string& name) -> std::size_t {
+    auto index = column_info->find(name);
+    if (!index) {
+      throw Elements::Exception() << "Column " << name << " not found in warm start catalog " << m_filename;
+    }
+    return *index;
+  };
+
+  std::size_t id_column = 0, x_column = 0, y_column = 0;
+  if (m_match_type == FlexibleModelFittingWarmStart::MatchType::SOURCE_ID) {
+    id_column = getColumnIndex(SOURCE_ID_COLUMN);
+  } else {
+    x_column = getColumnIndex(CENTROID_X_COLUMN);
+    y_column = getColumnIndex(CENTROID_Y_COLUMN);
+  }
+
+  std::map<int, std::size_t> value_columns;
+  for (auto& p : parameter_columns) {
+    auto index = column_info->find(p.second);
+    if (index) {
+      value_columns[p.first] = *index;
+    } else {
+      logger.warn() << "Column " << p.second << " not found in warm start catalog, it will use its initial value";
+    }
+  }
+
+  std::vector<FlexibleModelFittingWarmStart::Entry> entries;
+  std::map<int, std::vector<double>> values;
+  entries.reserve(m_table->size());
+  for (auto& row : *m_table) {
+    FlexibleModelFittingWarmStart::Entry entry {-1, 0., 0., entries.size()};
+    if (m_match_type == FlexibleModelFittingWarmStart::MatchType::SOURCE_ID) {
+      entry.source_id = static_cast<int>(boost::apply_visitor(CastVisitor<double>{}, row[id_column]));
+    } else {
+      // The catalog uses FITS coordinates, ours are zero-based
+      entry.x = boost::apply_visitor(CastVisitor<double>{}, row[x_column]) - 1.;
+      entry.y = boost::apply_visitor(CastVisitor<double>{}, row[y_column]) - 1.;
+    }
+    entries.emplace_back(entry);
+
+    for (auto& c : value_columns) {
+      double value = std::numeric_limits<double>::quiet_NaN();
+      try {
+        value = boost::apply_visitor(CastVisitor<double>{}, row[c.second]);
+      } catch (...) {
+        // Not a scalar numeric column, leave the parameter to its initial value
+      }
+      values[c.first].emplace_back(value);
+    }
+  }
+
+  logger.info() << "Warm start from " << m_filename << ": " << entries.size() << " sources, "
+                << value_columns.size() << " of " << parameter_columns.size() << " free parameters";
+
+  return std::make_shared<FlexibleModelFittingWarmStart>(m_match_type, m_radius, std::move(entries),
+                                                         std::move(values));
+}
+
+} /* namespace SourceXtractor */
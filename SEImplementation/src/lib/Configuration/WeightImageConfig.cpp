@@ -35,6 +35,7 @@ using boost::smatch;
 #include "SEFramework/Image/ProcessedImage.h"
 #include "SEFramework/FITS/FitsReader.h"
 #include "SEFramework/FITS/FitsImageSource.h"
+#include "SEFramework/FITS/MmapFitsImageSource.h"
 
 #include "SEImplementation/Configuration/DetectionImageConfig.h"
 
@@ -143,13 +144,13 @@ void WeightImageConfig::initialize(const UserValues& args) {
       std::shared_ptr<FitsImageSource> fits_image_source;
       if (boost::regex_match(weight_image_filename, hdu_regex)) {
         if (i==0) {
-          fits_image_source = std::make_shared<FitsImageSource>(weight_image_filename, 0, ImageTile::FloatImage);
+          fits_image_source = std::make_shared<MmapFitsImageSource>(weight_image_filename, 0, ImageTile::FloatImage);
         } else {
           break;
         }
       } else {
         try {
-          fits_image_source = std::make_shared<FitsImageSource>(weight_image_filename, i+1, ImageTile::FloatImage);
+          fits_image_source = std::make_shared<MmapFitsImageSource>(weight_image_filename, i+1, ImageTile::FloatImage);
         } catch (...) {
           if (i==0) {
             // Skip past primary HDU if it doesn't have an image
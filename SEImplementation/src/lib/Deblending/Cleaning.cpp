@@ -21,6 +21,8 @@
  *      Author: mschefer
  */
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <set>
 #include <tuple>
@@ -33,6 +35,7 @@
 #include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelEvaluator.h"
 
 #include "SEImplementation/Plugin/DetectionFramePixelValues/DetectionFramePixelValues.h"
+#include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
 
 #include "SEImplementation/Deblending/Cleaning.h"
 
@@ -86,11 +89,33 @@ void Cleaning::deblend(SourceGroupInterface& group) const {
   }
 }
 
+namespace {
+
+// Neighbours whose profile is below this fraction of the faintest pixel of the source, everywhere over it,
+// are only evaluated where they could change the outcome
+const double CULLING_FRACTION = 0.01;
+
+double distanceToBoundaries(const PixelBoundaries& boundaries, double x, double y) {
+  double dx = std::max({boundaries.getMin().m_x - x, 0., x - boundaries.getMax().m_x});
+  double dy = std::max({boundaries.getMin().m_y - y, 0., y - boundaries.getMax().m_y});
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+}
+
 bool Cleaning::shouldClean(SourceInterface& source, SourceGroupInterface& group) const {
   const auto& pixel_list = source.getProperty<PixelCoordinateList>().getCoordinateList();
+  const auto& boundaries = source.getProperty<PixelBoundaries>();
+  const auto& pixel_values = source.getProperty<DetectionFramePixelValues>().getFilteredValues();
+
+  double culling_level = *std::min_element(pixel_values.begin(), pixel_values.end()) * CULLING_FRACTION;
 
   std::vector<double> group_influence(pixel_list.size());
 
+  // Neighbours too far away to matter, and the sum of their maximum values over the source
+  std::vector<const MoffatModelEvaluator*> far_models;
+  double far_influence = 0;
+
   // iterate through all other sources in the group
   for (auto it = group.begin(); it != group.end(); ++it) {
     if (&(*it) == &source) { // skip self
@@ -98,19 +123,40 @@ bool Cleaning::shouldClean(SourceInterface& source, SourceGroupInterface& group)
     }
 
     auto &model = it->getProperty<MoffatModelEvaluator>();
-    int i = 0;
-    for (auto pixel : pixel_list) {
-      auto pixel_value = model.getValue(pixel.m_x, pixel.m_y);
-      group_influence[i++] += pixel_value;
+    double distance = distanceToBoundaries(boundaries, model.getX(), model.getY());
+    if (distance > model.getRadius(culling_level)) {
+      far_models.push_back(&model);
+      far_influence += model.getUpperBound(distance);
+    } else {
+      model.addValues(pixel_list, group_influence);
     }
   }
 
+  // The far neighbours are non-negative, so they only matter for the pixels that are above the influence
+  // of the near ones, but not by more than their maximum
   unsigned int still_valid_pixels = 0;
-  const auto& pixel_values = source.getProperty<DetectionFramePixelValues>().getFilteredValues();
-  int i = 0;
-  for (auto value : pixel_values) {
-    if (value > group_influence[i++]) {
+  std::vector<PixelCoordinate> undecided_pixels;
+  std::vector<std::size_t> undecided_indexes;
+  auto pixel = pixel_list.begin();
+  for (std::size_t i = 0; i < pixel_values.size(); ++i, ++pixel) {
+    if (pixel_values[i] > group_influence[i] + far_influence) {
       still_valid_pixels++;
+    } else if (pixel_values[i] > group_influence[i]) {
+      undecided_pixels.push_back(*pixel);
+      undecided_indexes.push_back(i);
+    }
+  }
+
+  if (!undecided_pixels.empty()) {
+    std::vector<double> far_group_influence(undecided_pixels.size());
+    for (auto model : far_models) {
+      model->addValues(undecided_pixels, far_group_influence);
+    }
+    for (std::size_t j = 0; j < undecided_indexes.size(); ++j) {
+      auto i = undecided_indexes[j];
+      if (pixel_values[i] > group_influence[i] + far_group_influence[j]) {
+        still_valid_pixels++;
+      }
     }
   }
 
@@ -121,16 +167,36 @@ SourceGroupInterface::iterator Cleaning::findMostInfluentialSource(
     SourceInterface& source, const std::vector<SourceGroupInterface::iterator>& candidates) const {
 
   const auto& pixel_list = source.getProperty<PixelCoordinateList>().getCoordinateList();
+  const auto& boundaries = source.getProperty<PixelBoundaries>();
 
-  std::vector<double> total_influence_of_sources(candidates.size());
-
-  // iterate through all other sources in the group
+  // Bound the influence of every candidate, and evaluate the most promising ones first, so the ones that
+  // can not beat the best so far are skipped
+  std::vector<double> max_influence(candidates.size());
+  std::vector<size_t> order(candidates.size());
   for (size_t i = 0; i < candidates.size(); i++) {
     auto &model = candidates[i]->getProperty<MoffatModelEvaluator>();
-    for (auto pixel : pixel_list) {
-      auto pixel_value = model.getValue(pixel.m_x, pixel.m_y);
+    double distance = distanceToBoundaries(boundaries, model.getX(), model.getY());
+    max_influence[i] = model.getUpperBound(distance) * pixel_list.size();
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&max_influence](size_t a, size_t b) {
+    return max_influence[a] > max_influence[b];
+  });
+
+  std::vector<double> total_influence_of_sources(candidates.size());
+  double best_influence = 0;
+  std::vector<double> influence(pixel_list.size());
+  for (auto i : order) {
+    if (max_influence[i] < best_influence) {
+      break;
+    }
+    auto &model = candidates[i]->getProperty<MoffatModelEvaluator>();
+    std::fill(influence.begin(), influence.end(), 0.);
+    model.addValues(pixel_list, influence);
+    for (auto pixel_value : influence) {
       total_influence_of_sources[i] += pixel_value;
     }
+    best_influence = std::max(best_influence, total_influence_of_sources[i]);
   }
 
   SourceGroupInterface::iterator most_influential_source(candidates[0]);
@@ -153,12 +219,12 @@ std::unique_ptr<SourceInterface> Cleaning::mergeSources(SourceInterface& parent,
   // Merge the pixel lists of all the child sources
   for (const auto& child : children) {
     const auto& pixel_list_to_merge = child->getProperty<PixelCoordinateList>().getCoordinateList();
-    pixel_list.insert(pixel_list.end(), pixel_list_to_merge.begin(), pixel_list_to_merge.end());
+    pixel_list.append(pixel_list_to_merge);
   }
 
   // Create a new source with the minimum necessary properties
   auto new_source = m_source_factory->createSource();
-  new_source->setProperty<PixelCoordinateList>(pixel_list);
+  new_source->setProperty<PixelCoordinateList>(std::move(pixel_list));
   new_source->setProperty<DetectionFrame>(parent.getProperty<DetectionFrame>().getEncapsulatedFrame());
   new_source->setProperty<SourceId>(parent.getProperty<SourceId>().getSourceId());
 
@@ -168,6 +234,7 @@ std::unique_ptr<SourceInterface> Cleaning::mergeSources(SourceInterface& parent,
 std::set<PropertyId> Cleaning::requiredProperties() const {
   return {
     PropertyId::create<PixelCoordinateList>(),
+    PropertyId::create<PixelBoundaries>(),
     PropertyId::create<MoffatModelEvaluator>()
   };
 }
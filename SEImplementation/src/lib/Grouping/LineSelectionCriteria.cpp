@@ -35,4 +35,9 @@ bool LineSelectionCriteria::mustBeProcessed(const SourceInterface& source) const
   return centroid.getCentroidY() < m_line_number;
 }
 
+bool LineSelectionCriteria::mayBeProcessed(const PixelRectangle& bounds) const {
+  // The centroids are within the bounds
+  return bounds.getTopLeft().m_y < m_line_number;
+}
+
 } // SourceXtractor namespace
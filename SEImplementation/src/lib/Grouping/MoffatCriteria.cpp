@@ -21,11 +21,15 @@
  *      Author: mschefer
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "SEImplementation/Grouping/MoffatCriteria.h"
 #include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelFitting.h"
 #include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelEvaluator.h"
 
 #include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
 #include "SEImplementation/Plugin/PeakValue/PeakValue.h"
 
 namespace SourceXtractor {
@@ -63,9 +67,25 @@ std::set<PropertyId> MoffatCriteria::requiredProperties() const {
     PropertyId::create<PixelCentroid>(),
     PropertyId::create<PeakValue>(),
     PropertyId::create<MoffatModelEvaluator>(),
+    PropertyId::create<PixelBoundaries>(),
   };
 }
 
+bool MoffatCriteria::getSearchRegion(const SourceInterface& source, PixelRectangle& region) const {
+  // Sources further apart than the maximum distance do not impact each other, so half of it around each
+  // centroid is enough for their regions to overlap
+  auto& centroid = source.getProperty<PixelCentroid>();
+  auto& boundaries = source.getProperty<PixelBoundaries>();
+  double reach = m_max_distance / 2.;
+  region = PixelRectangle(
+    {std::min(boundaries.getMin().m_x, static_cast<int>(std::floor(centroid.getCentroidX() - reach))),
+     std::min(boundaries.getMin().m_y, static_cast<int>(std::floor(centroid.getCentroidY() - reach)))},
+    {std::max(boundaries.getMax().m_x, static_cast<int>(std::ceil(centroid.getCentroidX() + reach))),
+     std::max(boundaries.getMax().m_y, static_cast<int>(std::ceil(centroid.getCentroidY() + reach)))}
+  );
+  return true;
+}
+
 } // SourceXtractor namespace
 
 
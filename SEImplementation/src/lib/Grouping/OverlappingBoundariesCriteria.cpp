@@ -34,6 +34,12 @@ bool OverlappingBoundariesCriteria::shouldGroup(const SourceInterface& first, co
           first_boundaries.getMax().m_y < second_boundaries.getMin().m_y);
 }
 
+bool OverlappingBoundariesCriteria::getSearchRegion(const SourceInterface& source, PixelRectangle& region) const {
+  auto& boundaries = source.getProperty<PixelBoundaries>();
+  region = PixelRectangle(boundaries.getMin(), boundaries.getMax());
+  return true;
+}
+
 
 } // SourceXtractor namespace
 
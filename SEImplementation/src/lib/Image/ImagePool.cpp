@@ -0,0 +1,83 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ImagePool.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <atomic>
+
+#include "SEImplementation/Image/ImagePool.h"
+
+namespace SourceXtractor {
+
+namespace {
+
+thread_local ImagePool* s_current_pool = nullptr;
+
+}
+
+ImagePool::Scope::Scope(ImagePool& pool) : m_previous(s_current_pool) {
+  s_current_pool = &pool;
+}
+
+ImagePool::Scope::~Scope() {
+  s_current_pool = m_previous;
+}
+
+std::shared_ptr<ImagePool::ImageType> ImagePool::acquire(int width, int height) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& images = m_images[std::make_pair(width, height)];
+  for (auto& image : images) {
+    if (image.use_count() == 1 && !image->isDataShared()) {
+      // The last reference may have been dropped by another thread: make its writes visible before reusing
+      std::atomic_thread_fence(std::memory_order_acquire);
+      image->fillValue(0);
+      return image;
+    }
+  }
+  images.emplace_back(ImageType::create(width, height));
+  return images.back();
+}
+
+std::size_t ImagePool::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::size_t n = 0;
+  for (auto& images : m_images) {
+    n += images.second.size();
+  }
+  return n;
+}
+
+ImagePool* ImagePool::current() {
+  return s_current_pool;
+}
+
+TaskExecutor ImagePool::bind(std::shared_ptr<ImagePool> pool, TaskExecutor executor) {
+  if (!executor) {
+    return {};
+  }
+  return [pool, executor](std::function<void()> task) {
+    executor([pool, task]() {
+      Scope scope(*pool);
+      task();
+    });
+  };
+}
+
+} // end of namespace SourceXtractor
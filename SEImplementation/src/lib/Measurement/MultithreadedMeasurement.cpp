@@ -21,11 +21,12 @@
  *      Author: mschefer
  */
 
-#include <chrono>
+#include <exception>
 #include <ElementsKernel/Logging.h>
 #include <csignal>
 
 #include "SEImplementation/Plugin/SourceIDs/SourceID.h"
+#include "SEImplementation/Common/ThreadPoolWait.h"
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 
 using namespace SourceXtractor;
@@ -45,31 +46,26 @@ void MultithreadedMeasurement::startThreads() {
 
 void MultithreadedMeasurement::stopThreads() {
   m_input_done = true;
-  m_thread_pool->block();
+  m_new_output->release();
   m_output_thread->join();
   logger.debug() << "All worker threads done!";
+  if (m_failed) {
+    m_thread_pool->checkForException(true);
+    throw Elements::Exception() << "Failed to measure some sources";
+  }
 }
 
 void MultithreadedMeasurement::synchronizeThreads() {
-  // Wait until all worker threads are done
-  m_thread_pool->block();
-
-  // Wait until the output queue is empty
-  while (true) {
-    {
-      std::unique_lock<std::mutex> output_lock(m_output_queue_mutex);
-      if (m_output_queue.empty()) {
-        break;
-      }
-      else if (m_thread_pool->checkForException(false)) {
-        logger.fatal() << "An exception was thrown from a worker thread";
-        m_thread_pool->checkForException(true);
-      }
-      else if (m_thread_pool->activeThreads() == 0) {
-        throw Elements::Exception() << "No active threads and the queue is not empty! Please, report this as a bug";
-      }
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // Wait until all the groups received so far have been measured and passed along
+  {
+    std::unique_lock<std::mutex> output_lock(m_output_counter_mutex);
+    waitWhileRunning(m_output_done, output_lock, *m_thread_pool,
+                     [this]() { return m_output_counter == m_group_counter || m_failed; });
+  }
+  if (m_failed) {
+    logger.fatal() << "An exception was thrown from a worker thread";
+    m_thread_pool->checkForException(true);
+    throw Elements::Exception() << "Failed to measure some sources";
   }
 }
 
@@ -79,25 +75,38 @@ void MultithreadedMeasurement::receiveSource(std::unique_ptr<SourceGroupInterfac
     source.getProperty<SourceID>();
   }
 
+  acquireWhileRunning(m_semaphore, *m_thread_pool);
+
   // Put the new SourceGroup into the input queue
-  auto order_number = m_group_counter;
-  auto lambda = [this, order_number, source_group = std::move(source_group)]() mutable {
+  auto order_number = m_group_counter.load();
+  auto lambda = [this, order_number, new_output = m_new_output,
+                 source_group = std::move(source_group)]() mutable {
+    std::exception_ptr error;
     // Trigger measurements
-    for (auto& source : *source_group) {
-      m_source_to_row(source);
+    try {
+      for (auto& source : *source_group) {
+        m_source_to_row(source);
+      }
     }
-    // Pass to the output thread
-    {
-      std::unique_lock<std::mutex> output_lock(m_output_queue_mutex);
-      m_output_queue.emplace_back(order_number, std::move(source_group));
+    catch (...) {
+      // The output thread still needs to know this group is done
+      error = std::current_exception();
+      source_group.reset();
+    }
+    // Pass to the output thread. The semaphore keeps the groups in flight under the capacity.
+    if (!m_output_queue.tryPush(std::make_pair(order_number, std::move(source_group)))) {
+      throw Elements::Exception() << "Measurement output queue full! Please, report this as a bug";
+    }
+    new_output->release();
+    if (error) {
+      std::rethrow_exception(error);
     }
-    m_new_output.notify_one();
   };
   auto lambda_copyable = [lambda = std::make_shared<decltype(lambda)>(std::move(lambda))](){
     (*lambda)();
   };
-  m_thread_pool->submit(lambda_copyable);
   ++m_group_counter;
+  m_thread_pool->submit(lambda_copyable);
 }
 
 void MultithreadedMeasurement::outputThreadStatic(MultithreadedMeasurement *measurement) {
@@ -117,23 +126,46 @@ void MultithreadedMeasurement::outputThreadStatic(MultithreadedMeasurement *meas
 }
 
 void MultithreadedMeasurement::outputThreadLoop() {
-  while (m_thread_pool->activeThreads() > 0) {
-    std::unique_lock<std::mutex> output_lock(m_output_queue_mutex);
-
-    // Wait for something in the output queue
-    if (m_output_queue.empty()) {
-      m_new_output.wait_for(output_lock, std::chrono::milliseconds(100));
+  while (true) {
+    // Wait for something in the output queue, as long as the pool can still deliver it
+    if (!m_new_output->try_acquire_for(THREAD_POOL_CHECK_PERIOD) && isThreadPoolStopped(*m_thread_pool)) {
+      logger.fatal() << "The thread pool stopped, the pending groups will not be measured";
+      {
+        std::lock_guard<std::mutex> output_lock(m_output_counter_mutex);
+        m_failed = true;
+      }
+      m_output_done.notify_all();
+      break;
     }
 
     // Process the output queue
-    while (!m_output_queue.empty()) {
-      sendSource(std::move(m_output_queue.front().second));
-      m_output_queue.pop_front();
+    int output_count = 0;
+    std::pair<int, std::unique_ptr<SourceGroupInterface>> output;
+    while (m_output_queue.tryPop(output)) {
+      if (output.second) {
+        sendSource(std::move(output.second));
+      }
+      else {
+        logger.fatal() << "Group " << output.first << " failed to be measured";
+        m_failed = true;
+      }
+      m_semaphore.release();
+      ++output_count;
     }
 
-    if (m_input_done && m_thread_pool->running() + m_thread_pool->queued() == 0 &&
-        m_output_queue.empty()) {
-      break;
+    if (output_count > 0) {
+      {
+        std::lock_guard<std::mutex> output_lock(m_output_counter_mutex);
+        m_output_counter += output_count;
+      }
+      m_output_done.notify_all();
+    }
+
+    if (m_input_done) {
+      std::lock_guard<std::mutex> output_lock(m_output_counter_mutex);
+      if (m_output_counter == m_group_counter) {
+        break;
+      }
     }
   }
 }
@@ -21,13 +21,13 @@
  *      Author: mschefer
  */
 
+#include <algorithm>
 #include <boost/random.hpp>
 
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 #include "SEImplementation/Partition/MultiThresholdPartitionStep.h"
 
-#include "SEFramework/Image/VectorImage.h"
-#include "SEFramework/Image/ProcessedImage.h"
+#include "SEFramework/Property/DetectionFrame.h"
 
 #include "SEImplementation/Plugin/DetectionFramePixelValues/DetectionFramePixelValues.h"
 #include "SEImplementation/Plugin/PixelBoundaries/PixelBoundaries.h"
@@ -38,19 +38,29 @@
 
 #include "SEImplementation/Property/SourceId.h"
 
-#include "SEImplementation/Segmentation/Lutz.h"
-
 namespace SourceXtractor {
 
 namespace {
-  boost::random::mt19937 rng { ((unsigned int) time(NULL)) };
+  // Sources are partitioned concurrently
+  thread_local boost::random::mt19937 rng { ((unsigned int) time(NULL)) };
 }
 
+/**
+ * Pixels of the source being partitioned, stored once for the whole tree. They are ordered so that
+ * the pixels of every node are contiguous, and a node is just a range of indexes.
+ */
+struct MultiThresholdPixels {
+  std::vector<PixelCoordinate> coordinates;
+  std::vector<DetectionImage::PixelType> values;
+  /// cumulated_values[i] is the sum of the values of the first i pixels
+  std::vector<double> cumulated_values;
+};
+
 class MultiThresholdNode : public std::enable_shared_from_this<MultiThresholdNode> {
 public:
 
-  MultiThresholdNode(const std::vector<PixelCoordinate>& pixel_list, SeFloat threshold)
-    : m_pixel_list(pixel_list), m_is_split(false), m_threshold(threshold) {
+  MultiThresholdNode(const MultiThresholdPixels& pixels, std::size_t begin, std::size_t end, SeFloat threshold)
+    : m_pixels(pixels), m_begin(begin), m_end(end), m_is_split(false), m_threshold(threshold) {
   }
 
   void addChild(std::shared_ptr<MultiThresholdNode> child) {
@@ -58,13 +68,9 @@ public:
     child->m_parent = shared_from_this();
   }
 
-  bool contains(const Lutz::PixelGroup& pixel_group) const {
-    for (auto pixel : m_pixel_list) {
-      if (pixel_group.pixel_list[0] == pixel) {
-        return true;
-      }
-    }
-    return false;
+  /// Nodes are either nested or disjoint, so this is enough to tell if other is inside
+  bool contains(std::size_t begin, std::size_t end) const {
+    return m_begin <= begin && end <= m_end;
   }
 
   const std::vector<std::shared_ptr<MultiThresholdNode>>& getChildren() const {
@@ -75,13 +81,8 @@ public:
     return m_parent.lock();
   }
 
-  double getTotalIntensity(VectorImage<DetectionImage::PixelType>& image, const PixelCoordinate& offset) const {
-    DetectionImage::PixelType total_intensity = 0;
-    for (const auto& pixel_coord : m_pixel_list) {
-      total_intensity += (image.getValue(pixel_coord - offset) - m_threshold);
-    }
-
-    return total_intensity;
+  double getTotalIntensity() const {
+    return m_pixels.cumulated_values[m_end] - m_pixels.cumulated_values[m_begin] - m_threshold * double(m_end - m_begin);
   }
 
   bool isSplit() const {
@@ -96,12 +97,26 @@ public:
     }
   }
 
-  const std::vector<PixelCoordinate>& getPixels() const {
-    return m_pixel_list;
+  std::size_t getBegin() const {
+    return m_begin;
+  }
+
+  std::size_t getEnd() const {
+    return m_end;
+  }
+
+  /// Pixels of the node plus the ones added to it, in raster order
+  PixelRunList getPixels() const {
+    std::vector<PixelCoordinate> pixels(m_pixels.coordinates.begin() + m_begin, m_pixels.coordinates.begin() + m_end);
+    pixels.insert(pixels.end(), m_added_pixels.begin(), m_added_pixels.end());
+    std::sort(pixels.begin(), pixels.end(), [](const PixelCoordinate& a, const PixelCoordinate& b) {
+      return a.m_y < b.m_y || (a.m_y == b.m_y && a.m_x < b.m_x);
+    });
+    return PixelRunList(pixels);
   }
 
   void debugPrint() const {
-    std::cout << "(" << m_pixel_list.size();
+    std::cout << "(" << (m_end - m_begin);
 
     for (auto& child : m_children) {
       std::cout << ", ";
@@ -112,7 +127,7 @@ public:
   }
 
   void addPixel(PixelCoordinate pixel) {
-    m_pixel_list.emplace_back(pixel);
+    m_added_pixels.push_back(pixel);
   }
 
   SeFloat getThreshold() const {
@@ -120,7 +135,9 @@ public:
   }
 
 private:
-  std::vector<PixelCoordinate> m_pixel_list;
+  const MultiThresholdPixels& m_pixels;
+  std::size_t m_begin, m_end;
+  std::vector<PixelCoordinate> m_added_pixels;
 
   std::weak_ptr<MultiThresholdNode> m_parent;
   std::vector<std::shared_ptr<MultiThresholdNode>> m_children;
@@ -130,6 +147,138 @@ private:
   SeFloat m_threshold;
 };
 
+namespace {
+
+/// Range of indexes of MultiThresholdPixels covered by a connected component
+struct ComponentRange {
+  std::size_t begin, end;
+};
+
+/**
+ * Finds the 8-connected components of the pixels above each threshold, in a single sweep as for a
+ * component tree: the pixels are added from the brightest down, merging the components they touch
+ * with a union-find. Each component keeps its pixels as a linked list, and merging concatenates the
+ * lists, so the components of all levels end up as contiguous ranges of the final order.
+ *
+ * @return
+ *    For each threshold, the components of at least min_area pixels. pixels is filled with the pixels
+ *    in the final order.
+ */
+std::vector<std::vector<ComponentRange>> buildComponents(
+    const std::vector<PixelCoordinate>& coordinates, const std::vector<DetectionImage::PixelType>& values,
+    const PixelCoordinate& offset, int width, int height,
+    const std::vector<DetectionImage::PixelType>& thresholds, unsigned int min_area,
+    MultiThresholdPixels& pixels) {
+  const int nb_pixels = coordinates.size();
+
+  std::vector<int> index_image(width * height, -1);
+  for (int i = 0; i < nb_pixels; ++i) {
+    auto local = coordinates[i] - offset;
+    index_image[local.m_x + local.m_y * width] = i;
+  }
+
+  std::vector<int> order(nb_pixels);
+  for (int i = 0; i < nb_pixels; ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&values](int a, int b) { return values[a] > values[b]; });
+
+  std::vector<int> parent(nb_pixels, -1), next(nb_pixels, -1), head(nb_pixels), tail(nb_pixels), count(nb_pixels);
+  std::vector<int> roots;
+
+  auto find = [&parent](int i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  auto merge = [&](int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+      return;
+    }
+    if (count[a] < count[b]) {
+      std::swap(a, b);
+    }
+    parent[b] = a;
+    next[tail[a]] = head[b];
+    tail[a] = tail[b];
+    count[a] += count[b];
+  };
+
+  auto add = [&](int i) {
+    parent[i] = head[i] = tail[i] = i;
+    count[i] = 1;
+    roots.push_back(i);
+    auto local = coordinates[i] - offset;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        int x = local.m_x + dx, y = local.m_y + dy;
+        if ((dx != 0 || dy != 0) && x >= 0 && y >= 0 && x < width && y < height) {
+          int neighbour = index_image[x + y * width];
+          if (neighbour >= 0 && parent[neighbour] >= 0) {
+            merge(i, neighbour);
+          }
+        }
+      }
+    }
+  };
+
+  auto compactRoots = [&]() {
+    roots.erase(std::remove_if(roots.begin(), roots.end(), [&parent](int i) { return parent[i] != i; }),
+                roots.end());
+  };
+
+  // Components by threshold, as (head, tail) pixels, valid once all the pixels are in
+  std::vector<std::vector<std::pair<int, int>>> components(thresholds.size());
+  int added = 0;
+  for (int level = thresholds.size() - 1; level > 0; --level) {
+    for (; added < nb_pixels && values[order[added]] - thresholds[level] > 0; ++added) {
+      add(order[added]);
+    }
+    compactRoots();
+    for (int root : roots) {
+      if (count[root] >= int(min_area)) {
+        components[level].emplace_back(head[root], tail[root]);
+      }
+    }
+  }
+  for (; added < nb_pixels; ++added) {
+    add(order[added]);
+  }
+  compactRoots();
+
+  // Final order
+  std::vector<std::size_t> position(nb_pixels);
+  pixels.coordinates.clear();
+  pixels.coordinates.reserve(nb_pixels);
+  pixels.values.clear();
+  pixels.values.reserve(nb_pixels);
+  pixels.cumulated_values.assign(1, 0.);
+  pixels.cumulated_values.reserve(nb_pixels + 1);
+  for (int root : roots) {
+    for (int i = head[root]; i >= 0; i = next[i]) {
+      position[i] = pixels.coordinates.size();
+      pixels.coordinates.push_back(coordinates[i]);
+      pixels.values.push_back(values[i]);
+      pixels.cumulated_values.push_back(pixels.cumulated_values.back() + values[i]);
+    }
+  }
+
+  std::vector<std::vector<ComponentRange>> ranges(thresholds.size());
+  for (std::size_t level = 1; level < thresholds.size(); ++level) {
+    for (auto& component : components[level]) {
+      ranges[level].push_back({position[component.first], position[component.second] + 1});
+    }
+  }
+  return ranges;
+}
+
+}
+
 std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::partition(
     std::unique_ptr<SourceInterface> original_source) const {
 
@@ -138,44 +287,48 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
   auto& detection_frame = original_source->getProperty<DetectionFrame>();
 
   auto& detection_frame_images = original_source->getProperty<DetectionFrameImages>();
-  const auto labelling_image = detection_frame_images.getLockedImage(LayerFilteredImage);
 
   auto& pixel_boundaries = original_source->getProperty<PixelBoundaries>();
 
   auto& pixel_coords = original_source->getProperty<PixelCoordinateList>().getCoordinateList();
 
   auto offset = pixel_boundaries.getMin();
-  auto thumbnail_image = VectorImage<DetectionImage::PixelType>::create(
-      pixel_boundaries.getWidth(), pixel_boundaries.getHeight());
-  thumbnail_image->fillValue(0);
+  auto chunk = detection_frame_images.getImageChunk(LayerFilteredImage, offset.m_x, offset.m_y,
+                                                    pixel_boundaries.getWidth(), pixel_boundaries.getHeight());
 
   auto min_value = original_source->getProperty<PeakValue>().getMinValue() * .8;
   auto peak_value = original_source->getProperty<PeakValue>().getMaxValue();
 
-  for (auto pixel_coord : pixel_coords) {
-    auto value = labelling_image->getValue(pixel_coord);
-    thumbnail_image->setValue(pixel_coord - offset, value);
+  std::vector<PixelCoordinate> coordinates(pixel_coords.begin(), pixel_coords.end());
+  std::vector<DetectionImage::PixelType> values;
+  values.reserve(coordinates.size());
+  for (auto& pixel_coord : coordinates) {
+    auto local = pixel_coord - offset;
+    values.push_back(chunk->getValue(local.m_x, local.m_y));
   }
 
-  auto root = std::make_shared<MultiThresholdNode>(pixel_coords, 0);
+  std::vector<DetectionImage::PixelType> thresholds(m_thresholds_nb, 0);
+  for (unsigned int i = 1; i < m_thresholds_nb; i++) {
+    thresholds[i] = min_value * pow(peak_value / min_value, (double) i / m_thresholds_nb);
+  }
+
+  MultiThresholdPixels pixels;
+  auto components = buildComponents(coordinates, values, offset,
+                                    pixel_boundaries.getWidth(), pixel_boundaries.getHeight(),
+                                    thresholds, m_min_deblend_area, pixels);
+
+  auto root = std::make_shared<MultiThresholdNode>(pixels, 0, pixels.coordinates.size(), 0);
 
   std::list<std::shared_ptr<MultiThresholdNode>> active_nodes { root };
   std::list<std::shared_ptr<MultiThresholdNode>> junction_nodes;
 
   // Build the tree
   for (unsigned int i = 1; i < m_thresholds_nb; i++) {
-
-    auto threshold = min_value * pow(peak_value / min_value, (double) i / m_thresholds_nb);
-    auto subtracted_image = SubtractImage<DetectionImage::PixelType>::create(thumbnail_image, threshold);
-
-    LutzList lutz;
-    lutz.labelImage(*subtracted_image, offset);
-
     std::list<std::shared_ptr<MultiThresholdNode>> active_nodes_copy(active_nodes);
     for (auto& node : active_nodes_copy) {
       int nb_of_groups_inside = 0;
-      for (auto& pixel_group : lutz.getGroups()) {
-        if (pixel_group.pixel_list.size() >= m_min_deblend_area && node->contains(pixel_group)) {
+      for (auto& component : components[i]) {
+        if (node->contains(component.begin, component.end)) {
           nb_of_groups_inside++;
         }
       }
@@ -187,9 +340,9 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
       if (nb_of_groups_inside > 1) {
         active_nodes.remove(node);
         junction_nodes.push_back(node);
-        for (auto& pixel_group : lutz.getGroups()) {
-          if (pixel_group.pixel_list.size() >= m_min_deblend_area && node->contains(pixel_group)) {
-            auto new_node = std::make_shared<MultiThresholdNode>(pixel_group.pixel_list, threshold);
+        for (auto& component : components[i]) {
+          if (node->contains(component.begin, component.end)) {
+            auto new_node = std::make_shared<MultiThresholdNode>(pixels, component.begin, component.end, thresholds[i]);
             node->addChild(new_node);
             active_nodes.push_back(new_node);
           }
@@ -199,7 +352,7 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
   }
 
   // Identify the sources
-  double intensity_threshold = root->getTotalIntensity(*thumbnail_image, offset) * m_contrast;
+  double intensity_threshold = root->getTotalIntensity() * m_contrast;
 
   std::vector<std::shared_ptr<MultiThresholdNode>> source_nodes;
   while (!junction_nodes.empty()) {
@@ -209,7 +362,7 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
     int nb_of_children_above_threshold = 0;
 
     for (auto child : node->getChildren()) {
-      if (child->getTotalIntensity(*thumbnail_image, offset) > intensity_threshold) {
+      if (child->getTotalIntensity() > intensity_threshold) {
         nb_of_children_above_threshold++;
       }
     }
@@ -217,7 +370,7 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
     if (nb_of_children_above_threshold >= 2) {
       node->flagAsSplit();
       for (auto child : node->getChildren()) {
-        if (child->getTotalIntensity(*thumbnail_image, offset) > intensity_threshold && !child->isSplit()) {
+        if (child->getTotalIntensity() > intensity_threshold && !child->isSplit()) {
           source_nodes.push_back(child);
         }
       }
@@ -230,11 +383,10 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
     return sources;
   }
 
+  // The pixels not in any of the new sources are re-assigned
+  std::vector<bool> assigned(pixels.coordinates.size(), false);
   for (auto source_node : source_nodes) {
-    // remove pixels in the new sources from the image
-    for (auto& pixel : source_node->getPixels()) {
-      thumbnail_image->setValue(pixel - offset, 0);
-    }
+    std::fill(assigned.begin() + source_node->getBegin(), assigned.begin() + source_node->getEnd(), true);
 
     auto new_source = m_source_factory->createSource();
 
@@ -244,7 +396,14 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
     sources.push_back(std::move(new_source));
   }
 
-  auto new_sources = reassignPixels(sources, pixel_coords, thumbnail_image, source_nodes, offset);
+  std::vector<PixelCoordinate> unassigned_pixels;
+  for (std::size_t i = 0; i < pixels.coordinates.size(); ++i) {
+    if (!assigned[i] && pixels.values[i] > 0) {
+      unassigned_pixels.push_back(pixels.coordinates[i]);
+    }
+  }
+
+  auto new_sources = reassignPixels(sources, unassigned_pixels, source_nodes);
 
   for (auto& new_source : new_sources) {
     new_source->setProperty<DetectionFrame>(detection_frame.getEncapsulatedFrame());
@@ -257,9 +416,7 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::parti
 std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::reassignPixels(
     const std::vector<std::unique_ptr<SourceInterface>>& sources,
     const std::vector<PixelCoordinate>& pixel_coords,
-    std::shared_ptr<VectorImage<DetectionImage::PixelType>> image,
-    const std::vector<std::shared_ptr<MultiThresholdNode>>& source_nodes,
-    const PixelCoordinate& offset
+    const std::vector<std::shared_ptr<MultiThresholdNode>>& source_nodes
     ) const {
 
   std::vector<SeFloat> amplitudes;
@@ -282,51 +439,49 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::reass
   }
 
   for (auto pixel : pixel_coords) {
-    if (image->getValue(pixel - offset) > 0) {
-      SeFloat cumulated_probability = 0;
-      std::vector<SeFloat> probabilities;
-
-      SeFloat min_dist = std::numeric_limits<SeFloat>::max();
-      std::shared_ptr<MultiThresholdNode> closest_source_node;
+    SeFloat cumulated_probability = 0;
+    std::vector<SeFloat> probabilities;
 
-      int i = 0;
-      for (auto& source : sources) {
-        auto& shape_parameters = source->getProperty<ShapeParameters>();
-        auto& pixel_centroid = source->getProperty<PixelCentroid>();
+    SeFloat min_dist = std::numeric_limits<SeFloat>::max();
+    std::shared_ptr<MultiThresholdNode> closest_source_node;
 
-        auto dx = pixel.m_x - pixel_centroid.getCentroidX();
-        auto dy = pixel.m_y - pixel_centroid.getCentroidY();
+    int i = 0;
+    for (auto& source : sources) {
+      auto& shape_parameters = source->getProperty<ShapeParameters>();
+      auto& pixel_centroid = source->getProperty<PixelCentroid>();
 
-        auto dist = 0.5 * (shape_parameters.getEllipseCxx()*dx*dx +
-            shape_parameters.getEllipseCyy()*dy*dy + shape_parameters.getEllipseCxy()*dx*dy) /
-            shape_parameters.getAbcor();
+      auto dx = pixel.m_x - pixel_centroid.getCentroidX();
+      auto dy = pixel.m_y - pixel_centroid.getCentroidY();
 
-        if (dist < min_dist) {
-          min_dist = dist;
-          closest_source_node = source_nodes[i];
-        }
-
-        cumulated_probability += dist < 70.0 ? amplitudes[i] * expf(-dist) : 0.0;
+      auto dist = 0.5 * (shape_parameters.getEllipseCxx()*dx*dx +
+          shape_parameters.getEllipseCyy()*dy*dy + shape_parameters.getEllipseCxy()*dx*dy) /
+          shape_parameters.getAbcor();
 
-        probabilities.push_back(cumulated_probability);
-        i++;
+      if (dist < min_dist) {
+        min_dist = dist;
+        closest_source_node = source_nodes[i];
       }
 
-      if (probabilities.back() > 1.0e-31) {
-        auto drand = double(probabilities.back()) * boost::random::uniform_01<double>()(rng);
+      cumulated_probability += dist < 70.0 ? amplitudes[i] * expf(-dist) : 0.0;
 
-        unsigned int i=0;
-        for (; i<probabilities.size() && drand >= probabilities[i]; i++);
-        if (i < source_nodes.size()) {
-          source_nodes[i]->addPixel(pixel);
-        } else {
-          std::cout << i << " oops " << drand << " " << probabilities.back() << std::endl;
-        }
+      probabilities.push_back(cumulated_probability);
+      i++;
+    }
 
+    if (probabilities.back() > 1.0e-31) {
+      auto drand = double(probabilities.back()) * boost::random::uniform_01<double>()(rng);
+
+      unsigned int i=0;
+      for (; i<probabilities.size() && drand >= probabilities[i]; i++);
+      if (i < source_nodes.size()) {
+        source_nodes[i]->addPixel(pixel);
       } else {
-        // select closest source
-        closest_source_node->addPixel(pixel);
+        std::cout << i << " oops " << drand << " " << probabilities.back() << std::endl;
       }
+
+    } else {
+      // select closest source
+      closest_source_node->addPixel(pixel);
     }
   }
 
@@ -334,11 +489,6 @@ std::vector<std::unique_ptr<SourceInterface>> MultiThresholdPartitionStep::reass
 
   std::vector<std::unique_ptr<SourceInterface>> new_sources;
   for (auto source_node : source_nodes) {
-    // remove pixels in the new sources from the image
-    for (auto& pixel : source_node->getPixels()) {
-      image->setValue(pixel - offset, 0);
-    }
-
     auto new_source = m_source_factory->createSource();
 
     auto pixels = source_node->getPixels();
@@ -0,0 +1,197 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ParallelPartition.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <exception>
+#include <ElementsKernel/Logging.h>
+#include "AlexandriaKernel/memory_tools.h"
+#include "SEFramework/Property/PropertyNotFoundException.h"
+#include "SEImplementation/Property/SourceId.h"
+#include "SEImplementation/Common/ThreadPoolWait.h"
+#include "SEImplementation/Partition/ParallelPartition.h"
+
+static Elements::Logging logger = Elements::Logging::getLogger("ParallelPartition");
+
+namespace SourceXtractor {
+
+namespace {
+
+const SourceId* findSourceId(SourceInterface& source) {
+  try {
+    return &source.getProperty<SourceId>();
+  }
+  catch (const PropertyNotFoundException&) {
+    return nullptr;
+  }
+}
+
+}
+
+ParallelPartition::ParallelPartition(std::vector<std::shared_ptr<PartitionStep>> steps,
+                                     const std::shared_ptr<Euclid::ThreadPool>& thread_pool,
+                                     unsigned max_queue_size)
+  : Partition(std::move(steps)), m_thread_pool(thread_pool), m_new_output(std::make_shared<Euclid::Semaphore>(0)),
+    m_finished_queue(max_queue_size), m_next_sequence(0), m_next_source_id(SourceId::PARTITION_ID_BASE),
+    m_stop(false), m_failed(false), m_semaphore(max_queue_size) {
+  m_output_thread = Euclid::make_unique<std::thread>(&ParallelPartition::outputLoop, this);
+}
+
+ParallelPartition::~ParallelPartition() {
+  if (m_output_thread->joinable())
+    wait();
+}
+
+void ParallelPartition::receiveSource(std::unique_ptr<SourceInterface> source) {
+  acquireWhileRunning(m_semaphore, *m_thread_pool);
+
+  unsigned long sequence;
+  {
+    std::lock_guard<std::mutex> queue_lock(m_queue_mutex);
+    sequence = m_next_sequence++;
+    m_received.emplace_back(EventType::SOURCE, sequence);
+  }
+
+  auto lambda = [this, sequence, new_output = m_new_output, source = std::move(source)]() mutable {
+    FinishedDetection finished;
+    finished.m_sequence = sequence;
+    std::exception_ptr error;
+    try {
+      if (auto source_id = findSourceId(*source)) {
+        finished.m_has_source_id = true;
+        finished.m_source_id = source_id->getSourceId();
+      }
+      finished.m_sources = applySteps(std::move(source));
+    }
+    catch (...) {
+      // The output thread still needs to know this detection is done
+      error = std::current_exception();
+      finished.m_failed = true;
+    }
+    // The semaphore keeps the detections in flight under the capacity, so this can not fail
+    if (!m_finished_queue.tryPush(std::move(finished))) {
+      throw Elements::Exception() << "Partition output queue full! Please, report this as a bug";
+    }
+    new_output->release();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  };
+  auto lambda_copyable = [lambda = std::make_shared<decltype(lambda)>(std::move(lambda))](){
+    (*lambda)();
+  };
+  m_thread_pool->submit(lambda_copyable);
+}
+
+void ParallelPartition::receiveProcessSignal(const ProcessSourcesEvent& event) {
+  {
+    std::lock_guard<std::mutex> queue_lock(m_queue_mutex);
+    m_received.emplace_back(EventType::PROCESS_SOURCE);
+    m_event_queue.emplace_back(event);
+  }
+  m_new_output->release();
+}
+
+void ParallelPartition::outputLoop() {
+  logger.debug() << "Starting partition output loop";
+
+  while (true) {
+    // Wait for something new, as long as the pool can still deliver it
+    if (!m_new_output->try_acquire_for(THREAD_POOL_CHECK_PERIOD) && isThreadPoolStopped(*m_thread_pool)) {
+      logger.fatal() << "The thread pool stopped, the pending detections will not be partitioned";
+      std::lock_guard<std::mutex> output_lock(m_queue_mutex);
+      m_failed = true;
+      m_drained.notify_all();
+      break;
+    }
+
+    FinishedDetection finished;
+    while (m_finished_queue.tryPop(finished)) {
+      auto sequence = finished.m_sequence;
+      m_finished_sources.emplace(sequence, std::move(finished));
+    }
+
+    // Release everything at the front of the queue that is ready, in the received order
+    std::unique_lock<std::mutex> output_lock(m_queue_mutex);
+    while (!m_received.empty()) {
+      auto next = m_received.front();
+      if (next.m_event_type == EventType::PROCESS_SOURCE) {
+        auto event = m_event_queue.front();
+        m_event_queue.pop_front();
+        output_lock.unlock();
+        sendProcessSignal(event);
+        output_lock.lock();
+        m_received.pop_front();
+        continue;
+      }
+
+      auto processed = m_finished_sources.find(next.m_sequence);
+      if (processed == m_finished_sources.end()) {
+        break;
+      }
+      auto detection = std::move(processed->second);
+      m_finished_sources.erase(processed);
+      if (detection.m_failed) {
+        logger.fatal() << "Detection " << next.m_sequence << " failed to be partitioned";
+        m_failed = true;
+      }
+      output_lock.unlock();
+      for (auto& source : detection.m_sources) {
+        auto source_id = detection.m_has_source_id ? findSourceId(*source) : nullptr;
+        if (source_id && source_id->getSourceId() != detection.m_source_id) {
+          auto detection_id = source_id->getDetectionId();
+          source->setProperty<SourceId>(m_next_source_id++, detection_id);
+        }
+        sendSource(std::move(source));
+      }
+      output_lock.lock();
+      m_received.pop_front();
+      m_semaphore.release();
+    }
+
+    if (m_received.empty() || m_failed) {
+      m_drained.notify_all();
+    }
+    if (m_stop && m_received.empty()) {
+      break;
+    }
+  }
+  logger.debug() << "Stopping partition output loop";
+}
+
+void ParallelPartition::synchronize() {
+  {
+    std::unique_lock<std::mutex> output_lock(m_queue_mutex);
+    waitWhileRunning(m_drained, output_lock, *m_thread_pool, [this]() { return m_received.empty() || m_failed; });
+  }
+  if (m_failed) {
+    logger.fatal() << "An exception was thrown from a worker thread";
+    m_thread_pool->checkForException(true);
+    throw Elements::Exception() << "Failed to partition some detections";
+  }
+}
+
+void ParallelPartition::wait() {
+  m_stop = true;
+  m_new_output->release();
+  m_output_thread->join();
+}
+
+} // end of namespace SourceXtractor
@@ -15,6 +15,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "ModelFitting/Engine/ResidualEstimator.h"
 #include "ModelFitting/Engine/AsinhChiSquareComparator.h"
 #include "ModelFitting/Engine/DataVsModelResiduals.h"
@@ -22,6 +25,7 @@
 
 #include "SEImplementation/Image/ImagePsf.h"
 #include "SEImplementation/Image/DownSampledImagePsf.h"
+#include "SEImplementation/Image/ImagePool.h"
 #include "SEImplementation/Image/VectorImageDataVsModelInputTraits.h"
 
 #include "SEImplementation/CheckImages/CheckImages.h"
@@ -44,6 +48,12 @@ using namespace ModelFitting;
 
 static auto logger = Elements::Logging::getLogger("FlexibleModelFitting");
 
+// A parameter has converged when it moves less than this fraction of its uncertainty between meta-iterations
+static const double CONVERGENCE_SIGMA_FRACTION = 0.01;
+
+// Maximum number of pixels of neighbour models kept per group to update the deblend images incrementally
+static const std::size_t DEBLEND_CACHE_MAX_PIXELS = 16 * 1024 * 1024;
+
 FlexibleModelFittingIterativeTask::FlexibleModelFittingIterativeTask(const std::string &least_squares_engine,
     unsigned int max_iterations, double modified_chi_squared_scale,
     std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters,
@@ -53,11 +63,13 @@ FlexibleModelFittingIterativeTask::FlexibleModelFittingIterativeTask(const std::
     int meta_iterations,
     double deblend_factor,
     double meta_iteration_stop,
-    size_t max_fit_size)
+    size_t max_fit_size,
+    TaskExecutor executor)
     : m_least_squares_engine(least_squares_engine), m_max_iterations(max_iterations),
       m_modified_chi_squared_scale(modified_chi_squared_scale), m_scale_factor(scale_factor),
       m_meta_iterations(meta_iterations), m_deblend_factor(deblend_factor), m_meta_iteration_stop(meta_iteration_stop),
-      m_max_fit_size(max_fit_size * max_fit_size), m_parameters(parameters), m_frames(frames), m_priors(priors) {
+      m_max_fit_size(max_fit_size * max_fit_size), m_parameters(parameters), m_frames(frames), m_priors(priors),
+      m_executor(std::move(executor)) {
 }
 
 FlexibleModelFittingIterativeTask::~FlexibleModelFittingIterativeTask() {
@@ -208,12 +220,28 @@ void FlexibleModelFittingIterativeTask::computeProperties(SourceGroupInterface&
 
   double prev_chi_squared = 999999.9;
   for (int iteration = 0; iteration < m_meta_iterations; iteration++) {
+    auto last_moved = fitting_state.last_moved;
     int index = 0;
     for (auto& source : group) {
-      fitSource(group, source, index, fitting_state);
+      auto& source_state = fitting_state.source_states[index];
+      if (source_state.converged && fitting_state.last_moved < source_state.fitted_at) {
+        // Neither the source nor its neighbours changed since its last fit, which would give the same solution
+        ++source_state.skipped_meta_iterations;
+        if (!source_state.chi_squared_per_meta.empty()) {
+          source_state.chi_squared_per_meta.emplace_back(source_state.reduced_chi_squared);
+          source_state.iterations_per_meta.emplace_back(0);
+        }
+      } else {
+        fitSource(group, source, index, fitting_state);
+      }
       index++;
     }
 
+    // Every source has converged, another meta-iteration would skip all of them
+    if (fitting_state.last_moved == last_moved) {
+      break;
+    }
+
     // evaluate reduced chi squared to bail out of meta iterations if no longer improving the fit
 
     double chi_squared = 0.0;
@@ -258,7 +286,7 @@ void FlexibleModelFittingIterativeTask::computeProperties(SourceGroupInterface&
         source_state.reduced_chi_squared, source_state.duration, source_state.flags,
         source_state.parameters_values, source_state.parameters_sigmas,
         source_state.chi_squared_per_meta, source_state.iterations_per_meta,
-        meta_iterations);
+        meta_iterations, source_state.skipped_meta_iterations, source_state.reused_renders);
 
     index++;
   }
@@ -272,21 +300,38 @@ std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingIterativeTask::createD
     std::shared_ptr<FlexibleModelFittingFrame> frame, FittingState& state) const {
   int frame_index = frame->getFrameNb();
   auto rect = getFittingRect(source, frame_index);
+  int group_size = state.source_states.size();
+  auto& source_state = state.source_states[source_index];
+  auto& cache = state.deblend_cache[std::make_pair(source_index, frame_index)];
+
+  // Only the neighbours that changed since they were rendered for this source need to be rendered again,
+  // unless their models were not kept
+  std::vector<int> to_render;
+  for (int index = 0; index < group_size; ++index) {
+    if (index != source_index && (cache.stamps.empty() || cache.versions[index] != state.source_states[index].version)) {
+      to_render.push_back(index);
+    }
+  }
+
+  if (cache.image && std::all_of(to_render.begin(), to_render.end(), [&cache, &state](int index) {
+    return cache.versions[index] == state.source_states[index].version;
+  })) {
+    source_state.reused_renders += group_size - 1;
+    return cache.image;
+  }
 
   double pixel_scale = 1.0;
   FlexibleModelFittingParameterManager parameter_manager;
   ModelFitting::EngineParameterManager engine_parameter_manager {};
-  int n_free_parameters = 0;
 
+  auto next = to_render.begin();
   int index = 0;
   for (auto& src : group) {
-    if (index != source_index) {
-     for (auto parameter : m_parameters) {
+    if (next != to_render.end() && *next == index) {
+      for (auto parameter : m_parameters) {
         auto free_parameter = std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter);
 
         if (free_parameter != nullptr) {
-          ++n_free_parameters;
-
           // Initial with the values from the current iteration run
           parameter_manager.addParameter(src, parameter,
               free_parameter->create(parameter_manager, engine_parameter_manager, src,
@@ -297,26 +342,62 @@ std::shared_ptr<VectorImage<SeFloat>> FlexibleModelFittingIterativeTask::createD
               parameter->create(parameter_manager, engine_parameter_manager, src));
         }
       }
+      ++next;
     }
     index++;
   }
 
-  auto deblend_image = VectorImage<SeFloat>::create(rect.getWidth(), rect.getHeight());
+  // The models are created serially, as that accesses the parameter manager, but rendered concurrently
+  using SourceFrameModel = FrameModel<DownSampledImagePsf, std::shared_ptr<VectorImage<SourceXtractor::SeFloat>>>;
+  std::vector<SourceFrameModel> frame_models;
+  frame_models.reserve(to_render.size());
+  next = to_render.begin();
   index = 0;
   for (auto& src : group) {
-    if (index != source_index) {
-        auto frame_model = createFrameModel(src, pixel_scale, parameter_manager, frame, rect);
-        auto final_stamp = frame_model.getImage();
-
-        for (int y = 0; y < final_stamp->getHeight(); ++y) {
-          for (int x = 0; x < final_stamp->getWidth(); ++x) {
-            deblend_image->at(x, y) += final_stamp->at(x, y);
-          }
-        }
+    if (next != to_render.end() && *next == index) {
+      frame_models.emplace_back(createFrameModel(src, pixel_scale, parameter_manager, frame, rect));
+      ++next;
     }
     index++;
   }
 
+  std::vector<std::shared_ptr<VectorImage<SeFloat>>> stamps(frame_models.size());
+  parallelFor(m_executor, frame_models.size(), [&frame_models, &stamps](std::size_t i) {
+    stamps[i] = frame_models[i].getImage();
+  });
+
+  if (cache.stamps.empty()) {
+    std::size_t pixels = static_cast<std::size_t>(group_size - 1) * rect.getWidth() * rect.getHeight();
+    if (state.deblend_cache_pixels + pixels <= DEBLEND_CACHE_MAX_PIXELS) {
+      state.deblend_cache_pixels += pixels;
+      cache.stamps.resize(group_size);
+    }
+  }
+  if (!cache.stamps.empty()) {
+    for (std::size_t i = 0; i < to_render.size(); ++i) {
+      cache.stamps[to_render[i]] = stamps[i];
+    }
+  }
+
+  auto deblend_image = VectorImage<SeFloat>::create(rect.getWidth(), rect.getHeight());
+  for (auto& final_stamp : cache.stamps.empty() ? stamps : cache.stamps) {
+    if (!final_stamp) {
+      continue;
+    }
+    for (int y = 0; y < final_stamp->getHeight(); ++y) {
+      for (int x = 0; x < final_stamp->getWidth(); ++x) {
+        deblend_image->at(x, y) += final_stamp->at(x, y);
+      }
+    }
+  }
+
+  cache.image = deblend_image;
+  cache.versions.resize(group_size);
+  for (index = 0; index < group_size; ++index) {
+    cache.versions[index] = state.source_states[index].version;
+  }
+  source_state.reused_renders += group_size - 1 - to_render.size();
+
   return deblend_image;
 }
 
@@ -462,7 +543,34 @@ void FlexibleModelFittingIterativeTask::fitSourceUpdateState(
   state.source_states[index].flags = flags;
 }
 
+bool FlexibleModelFittingIterativeTask::hasConverged(const std::unordered_map<int, double>& previous_values,
+                                                     SeFloat previous_chi_squared,
+                                                     const SourceState& source_state) const {
+  if (!(std::abs(source_state.reduced_chi_squared - previous_chi_squared) <=
+        m_meta_iteration_stop * source_state.reduced_chi_squared)) {
+    return false;
+  }
+
+  for (auto parameter : m_parameters) {
+    int id = parameter->getId();
+    if (!std::dynamic_pointer_cast<FlexibleModelFittingFreeParameter>(parameter) ||
+        !source_state.parameters_fitted.at(id)) {
+      continue;
+    }
+    double previous = previous_values.at(id);
+    double sigma = source_state.parameters_sigmas.at(id);
+    double tolerance = (std::isfinite(sigma) && sigma > 0) ?
+                       CONVERGENCE_SIGMA_FRACTION * sigma : m_meta_iteration_stop * std::abs(previous);
+    if (!(std::abs(source_state.parameters_values.at(id) - previous) <= tolerance)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void FlexibleModelFittingIterativeTask::fitSource(SourceGroupInterface& group, SourceInterface& source, int index, FittingState& state) const {
+  auto& source_state = state.source_states[index];
+  source_state.fitted_at = ++state.fit_count;
 
   //////////////////////////////////////////////
   // Determine size of fitted area and if needed downsize factor
@@ -495,8 +603,11 @@ void FlexibleModelFittingIterativeTask::fitSource(SourceGroupInterface& group, S
       parameter_manager, engine_parameter_manager, source, index, state);
 
   ///////////////////////////////////////////////////////////////////////////////////
-  // Add models for all frames
+  // Add models for all frames, recycling the images rendered while fitting until the fit is done
+  auto image_pool = std::make_shared<ImagePool>();
+  ImagePool::Scope image_pool_scope(*image_pool);
   ResidualEstimator res_estimator {};
+  res_estimator.setTaskExecutor(ImagePool::bind(image_pool, m_executor));
   int n_good_pixels = 0;
   int valid_frames = fitSourcePrepareModels(
       parameter_manager, res_estimator, n_good_pixels, group, source, index, state, down_scaling);
@@ -513,8 +624,9 @@ void FlexibleModelFittingIterativeTask::fitSource(SourceGroupInterface& group, S
     flags = Flags::INSUFFICIENT_DATA;
   }
 
-  // Do not run the model fitting for the flags above
+  // Do not run the model fitting for the flags above. They will not change on the next meta-iterations.
   if (flags != Flags::NONE) {
+    source_state.converged = true;
     return;
   }
 
@@ -549,8 +661,21 @@ void FlexibleModelFittingIterativeTask::fitSource(SourceGroupInterface& group, S
 
   ////////////////////////////////////////////////////////////////////////////////////
   // update state with results
+  auto previous_values = source_state.parameters_values;
+  SeFloat previous_chi_squared = source_state.chi_squared_per_meta.empty() ?
+                                 std::numeric_limits<SeFloat>::quiet_NaN() : source_state.reduced_chi_squared;
+
   fitSourceUpdateState(parameter_manager, source, avg_reduced_chi_squared, duration, iterations, stop_reason, flags, solution,
                        index, state);
+
+  ////////////////////////////////////////////////////////////////////////////////////
+  // track convergence, the neighbours need to be fitted again if the source moved, and its renders
+  // kept by the neighbours are out of date. Otherwise, the change is within the convergence tolerance.
+  source_state.converged = hasConverged(previous_values, previous_chi_squared, source_state);
+  if (!source_state.converged) {
+    state.last_moved = state.fit_count;
+    ++source_state.version;
+  }
 }
 
 void FlexibleModelFittingIterativeTask::updateCheckImages(SourceGroupInterface& group,
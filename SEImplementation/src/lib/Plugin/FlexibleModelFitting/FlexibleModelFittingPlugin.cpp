@@ -109,6 +109,24 @@ void FlexibleModelFittingPlugin::registerPlugin(PluginAPI& plugin_api) {
             "Meta-iterations"
     );
 
+  plugin_api.getOutputRegistry().registerColumnConverter<FlexibleModelFitting, int>(
+            "fmf_skipped_meta_iterations",
+            [](const FlexibleModelFitting& prop) {
+              return prop.getSkippedMetaIterations();
+            },
+            "",
+            "Meta-iterations skipped because the source had converged"
+    );
+
+  plugin_api.getOutputRegistry().registerColumnConverter<FlexibleModelFitting, int>(
+            "fmf_reused_renders",
+            [](const FlexibleModelFitting& prop) {
+              return prop.getReusedRenders();
+            },
+            "",
+            "Neighbour models reused instead of rendered again for deblending"
+    );
+
   plugin_api.getOutputRegistry().enableOutput<FlexibleModelFitting>("FlexibleModelFitting");
 }
 
@@ -40,6 +40,7 @@
 
 #include "SEImplementation/Image/VectorImageDataVsModelInputTraits.h"
 #include "SEImplementation/Image/ImagePsf.h"
+#include "SEImplementation/Image/ImagePool.h"
 
 #include "SEImplementation/Plugin/MeasurementFrameImages/MeasurementFrameImages.h"
 #include "SEImplementation/Plugin/MeasurementFrameInfo/MeasurementFrameInfo.h"
@@ -69,10 +70,11 @@ FlexibleModelFittingTask::FlexibleModelFittingTask(const std::string &least_squa
     std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters,
     std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames,
     std::vector<std::shared_ptr<FlexibleModelFittingPrior>> priors,
-    double scale_factor)
+    double scale_factor, TaskExecutor executor)
   : m_least_squares_engine(least_squares_engine),
     m_max_iterations(max_iterations), m_modified_chi_squared_scale(modified_chi_squared_scale),
-    m_parameters(parameters), m_frames(frames), m_priors(priors), m_scale_factor(scale_factor) {}
+    m_parameters(parameters), m_frames(frames), m_priors(priors), m_scale_factor(scale_factor),
+    m_executor(std::move(executor)) {}
 
 bool FlexibleModelFittingTask::isFrameValid(SourceGroupInterface& group, int frame_index) const {
   auto stamp_rect = group.getProperty<MeasurementFrameGroupRectangle>(frame_index);
@@ -190,8 +192,13 @@ void FlexibleModelFittingTask::computeProperties(SourceGroupInterface& group) co
     // Reset access checks, as a dependent parameter could have triggered it
     parameter_manager.clearAccessCheck();
 
+    // The images rendered while fitting are recycled until the fit is done
+    auto image_pool = std::make_shared<ImagePool>();
+    ImagePool::Scope image_pool_scope(*image_pool);
+
     // Add models for all frames
     ResidualEstimator res_estimator{};
+    res_estimator.setTaskExecutor(ImagePool::bind(image_pool, m_executor));
 
     int valid_frames = 0;
     int n_good_pixels = 0;
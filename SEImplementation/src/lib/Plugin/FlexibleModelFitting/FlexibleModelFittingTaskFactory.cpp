@@ -29,6 +29,7 @@
 
 #include "SEImplementation/Configuration/ModelFittingConfig.h"
 #include "SEImplementation/Configuration/SamplingConfig.h"
+#include "SEImplementation/Configuration/MultiThreadingConfig.h"
 
 namespace SourceXtractor {
 
@@ -39,10 +40,10 @@ std::shared_ptr<Task> FlexibleModelFittingTaskFactory::createTask(const Property
     if (m_use_iterative_fitting) {
       return std::make_shared<FlexibleModelFittingIterativeTask>(m_least_squares_engine, m_max_iterations,
           m_modified_chi_squared_scale, m_parameters, m_frames, m_priors, m_scale_factor,
-          m_meta_iterations, m_deblend_factor, m_meta_iteration_stop, m_max_fit_size);
+          m_meta_iterations, m_deblend_factor, m_meta_iteration_stop, m_max_fit_size, m_executor);
     } else {
       return std::make_shared<FlexibleModelFittingTask>(m_least_squares_engine, m_max_iterations,
-          m_modified_chi_squared_scale, m_parameters, m_frames, m_priors, m_scale_factor);
+          m_modified_chi_squared_scale, m_parameters, m_frames, m_priors, m_scale_factor, m_executor);
     }
   } else {
     return nullptr;
@@ -51,6 +52,7 @@ std::shared_ptr<Task> FlexibleModelFittingTaskFactory::createTask(const Property
 
 void FlexibleModelFittingTaskFactory::reportConfigDependencies(Euclid::Configuration::ConfigManager& manager) const {
   manager.registerConfiguration<ModelFittingConfig>();
+  manager.registerConfiguration<MultiThreadingConfig>();
 }
 
 void FlexibleModelFittingTaskFactory::configure(Euclid::Configuration::ConfigManager& manager) {
@@ -90,6 +92,8 @@ void FlexibleModelFittingTaskFactory::configure(Euclid::Configuration::ConfigMan
 
   m_scale_factor = sampling_config.getScaleFactor();
   m_max_fit_size = sampling_config.getMaxFitSize();
+
+  m_executor = manager.getConfiguration<MultiThreadingConfig>().getTaskExecutor();
 }
 
 void FlexibleModelFittingTaskFactory::registerPropertyInstances(OutputRegistry& registry) {
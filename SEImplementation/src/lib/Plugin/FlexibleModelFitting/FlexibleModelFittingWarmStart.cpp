@@ -0,0 +1,93 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingWarmStart.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cmath>
+
+#include "SEFramework/Source/SourceInterface.h"
+#include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/SourceIDs/SourceID.h"
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingWarmStart.h"
+
+namespace SourceXtractor {
+
+FlexibleModelFittingWarmStart::FlexibleModelFittingWarmStart(MatchType match_type, double radius,
+                                                             std::vector<Entry> entries,
+                                                             std::map<int, std::vector<double>> values)
+    : m_match_type(match_type), m_radius(radius), m_values(std::move(values)) {
+  if (m_match_type == MatchType::SOURCE_ID) {
+    for (auto& entry : entries) {
+      m_rows_by_id.emplace(entry.source_id, entry.row);
+    }
+  } else if (!entries.empty()) {
+    m_rows_by_position = std::make_shared<KdTree<Entry>>(entries);
+  }
+}
+
+int FlexibleModelFittingWarmStart::findRow(const SourceInterface& source) const {
+  if (m_match_type == MatchType::SOURCE_ID) {
+    auto i = m_rows_by_id.find(source.getProperty<SourceID>().getId());
+    return i != m_rows_by_id.end() ? static_cast<int>(i->second) : -1;
+  }
+
+  if (!m_rows_by_position) {
+    return -1;
+  }
+  auto& centroid = source.getProperty<PixelCentroid>();
+  auto nearest = m_rows_by_position->findNearest({{centroid.getCentroidX(), centroid.getCentroidY()}});
+  double dx = nearest.x - centroid.getCentroidX();
+  double dy = nearest.y - centroid.getCentroidY();
+  if (dx * dx + dy * dy > m_radius * m_radius) {
+    return -1;
+  }
+  return static_cast<int>(nearest.row);
+}
+
+bool FlexibleModelFittingWarmStart::getValue(int parameter_id, const SourceInterface& source, double& value) const {
+  auto values = m_values.find(parameter_id);
+  if (values == m_values.end()) {
+    return false;
+  }
+  int row = findRow(source);
+  if (row < 0 || !std::isfinite(values->second[row])) {
+    return false;
+  }
+  value = values->second[row];
+  return true;
+}
+
+FlexibleModelFittingFreeParameter::InitialValueFunc FlexibleModelFittingWarmStart::wrap(
+    int parameter_id, FlexibleModelFittingFreeParameter::InitialValueFunc fallback) const {
+  if (m_values.find(parameter_id) == m_values.end()) {
+    return fallback;
+  }
+  auto self = shared_from_this();
+  return [self, parameter_id, fallback](const SourceInterface& source) {
+    double value;
+    if (self->getValue(parameter_id, source, value)) {
+      return value;
+    }
+    return fallback(source);
+  };
+}
+
+}
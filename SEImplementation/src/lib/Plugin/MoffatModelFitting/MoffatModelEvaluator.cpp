@@ -22,6 +22,8 @@
  */
 
 
+#include <algorithm>
+
 #include "AlexandriaKernel/memory_tools.h"
 #include "ModelFitting/Parameters/ManualParameter.h"
 #include "ModelFitting/Models/ExtendedModel.h"
@@ -37,7 +39,12 @@ namespace SourceXtractor {
 using namespace ModelFitting;
 using Euclid::make_unique;
 
-MoffatModelEvaluator::MoffatModelEvaluator(const MoffatModelFitting& model) {
+MoffatModelEvaluator::MoffatModelEvaluator(const MoffatModelFitting& model)
+  : m_x(model.getX()), m_y(model.getY()),
+    m_i0(model.getMoffatI0()), m_index(model.getMoffatIndex()),
+    m_minkowski_exponent(model.getMinkowksiExponent()), m_top_offset(model.getTopOffset()),
+    m_x_scale(model.getXScale()), m_y_scale(model.getYScale()),
+    m_cos(std::cos(double(model.getMoffatRotation()))), m_sin(std::sin(double(model.getMoffatRotation()))) {
   m_iterations = model.getIterations();
 
   auto x = std::make_shared<ManualParameter>(model.getX());
@@ -61,5 +68,29 @@ MoffatModelEvaluator::MoffatModelEvaluator(const MoffatModelFitting& model) {
       std::move(component_list), x_scale, y_scale, moffat_rotation, size, size, x, y);
 }
 
+// The Minkowski distance is never smaller than the largest coordinate, which is at least the euclidean
+// distance divided by sqrt(2). So at a distance d from the center, z >= d / (sqrt(2) * max scale) - offset.
+
+double MoffatModelEvaluator::getUpperBound(double distance) const {
+  if (m_i0 <= 0 || m_index < 0) {
+    return m_i0 <= 0 ? 0 : std::numeric_limits<double>::infinity();
+  }
+  double max_scale = std::max(std::fabs(m_x_scale), std::fabs(m_y_scale));
+  double z = distance / (M_SQRT2 * max_scale) - m_top_offset;
+  return z <= 0 ? m_i0 : m_i0 * std::pow(1 + z * z, -m_index);
+}
+
+double MoffatModelEvaluator::getRadius(double value) const {
+  if (value <= 0 || m_i0 < 0 || m_index <= 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  if (value >= m_i0) {
+    return 0;
+  }
+  double max_scale = std::max(std::fabs(m_x_scale), std::fabs(m_y_scale));
+  double z = std::sqrt(std::pow(m_i0 / value, 1. / m_index) - 1);
+  return M_SQRT2 * max_scale * (z + m_top_offset);
+}
+
 
 }
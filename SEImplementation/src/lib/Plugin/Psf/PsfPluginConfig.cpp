@@ -42,6 +42,8 @@ namespace SourceXtractor {
 static const std::string PSF_FILE{"psf-filename"};
 static const std::string PSF_FWHM {"psf-fwhm" };
 static const std::string PSF_PIXEL_SAMPLING {"psf-pixel-sampling" };
+static const std::string PSF_CACHE_BIN {"psf-cache-bin" };
+static const std::string PSF_CACHE_MEMORY {"psf-cache-memory" };
 
 /*
  * Reading in a stacked PSF as it is being developed for co-added images in Euclid
@@ -231,7 +233,11 @@ std::map<std::string, Configuration::OptionDescriptionList> PsfPluginConfig::get
     {PSF_FWHM.c_str(), po::value<double>(),
        "Generate a gaussian PSF with the given full-width half-maximum (in pixels)"},
     {PSF_PIXEL_SAMPLING.c_str(), po::value<double>(),
-        "Generate a gaussian PSF with the given pixel sampling step size"}
+        "Generate a gaussian PSF with the given pixel sampling step size"},
+    {PSF_CACHE_BIN.c_str(), po::value<double>()->default_value(0.),
+        "Sources within bins of this size (in pixels) share the same variable PSF (0, the default, disables it)"},
+    {PSF_CACHE_MEMORY.c_str(), po::value<int>()->default_value(64),
+        "Maximum memory used to keep the variable PSFs computed for each bin in megabytes"}
   }}};
 }
 
@@ -244,6 +250,16 @@ void PsfPluginConfig::preInitialize(const Euclid::Configuration::Configuration::
 }
 
 void PsfPluginConfig::initialize(const UserValues &args) {
+  m_cache_bin_size = args.at(PSF_CACHE_BIN).as<double>();
+  if (m_cache_bin_size < 0) {
+    throw Elements::Exception() << "Invalid " << PSF_CACHE_BIN << " value: " << m_cache_bin_size;
+  }
+  auto cache_memory_mb = args.at(PSF_CACHE_MEMORY).as<int>();
+  if (cache_memory_mb < 0) {
+    throw Elements::Exception() << "Invalid " << PSF_CACHE_MEMORY << " value: " << cache_memory_mb;
+  }
+  m_cache_memory = std::size_t(cache_memory_mb) * 1024 * 1024;
+
   if (args.find(PSF_FILE) != args.end()) {
     auto psf_file = args.find(PSF_FILE)->second.as<std::string>();
     logger.debug() << "Provided by user: " << psf_file;
@@ -256,10 +272,19 @@ void PsfPluginConfig::initialize(const UserValues &args) {
     m_vpsf = generateGaussianPsf(args.find(PSF_FWHM)->second.as<double>(),
                                 args.find(PSF_PIXEL_SAMPLING)->second.as<double>());
   }
+  configureCache(m_vpsf);
 }
 
 const std::shared_ptr<Psf>& PsfPluginConfig::getPsf() const {
   return m_vpsf;
 }
 
+void PsfPluginConfig::configureCache(const std::shared_ptr<Psf>& psf) const {
+  // A stacked PSF has no need for it, as all its PSFs are kept in memory already
+  auto variable_psf = std::dynamic_pointer_cast<VariablePsf>(psf);
+  if (variable_psf) {
+    variable_psf->setCache(m_cache_bin_size, m_cache_memory);
+  }
+}
+
 } // end SourceXtractor
@@ -40,7 +40,9 @@ void PsfTaskFactory::configure(Euclid::Configuration::ConfigManager& manager) {
 
   for (unsigned int i = 0; i < image_infos.size(); i++) {
     if (!image_infos[i].m_psf_path.empty()) {
-      m_vpsf[image_infos[i].m_id] = PsfPluginConfig::readPsf(image_infos[i].m_psf_path, image_infos[i].m_psf_hdu);
+      auto psf = PsfPluginConfig::readPsf(image_infos[i].m_psf_path, image_infos[i].m_psf_hdu);
+      psf_config.configureCache(psf);
+      m_vpsf[image_infos[i].m_id] = psf;
     }
     else if (default_psf) {
       m_vpsf[image_infos[i].m_id] = default_psf;
@@ -15,8 +15,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <exception>
 #include <ElementsKernel/Logging.h>
 #include "AlexandriaKernel/memory_tools.h"
+#include "SEImplementation/Common/ThreadPoolWait.h"
 #include "SEImplementation/Prefetcher/Prefetcher.h"
 
 static Elements::Logging logger = Elements::Logging::getLogger("Prefetcher");
@@ -42,7 +44,9 @@ private:
 };
 
 Prefetcher::Prefetcher(const std::shared_ptr<Euclid::ThreadPool>& thread_pool, unsigned max_queue_size)
-  : m_thread_pool(thread_pool), m_stop(false), m_semaphore(max_queue_size) {
+  : m_thread_pool(thread_pool), m_new_output(std::make_shared<Euclid::Semaphore>(0)),
+    m_finished_queue(max_queue_size), m_next_sequence(0), m_stop(false), m_failed(false),
+    m_semaphore(max_queue_size) {
   m_output_thread = Euclid::make_unique<std::thread>(&Prefetcher::outputLoop, this);
 }
 
@@ -52,24 +56,36 @@ Prefetcher::~Prefetcher() {
 }
 
 void Prefetcher::receiveSource(std::unique_ptr<SourceInterface> message) {
-  m_semaphore.acquire();
+  acquireWhileRunning(m_semaphore, *m_thread_pool);
 
-  intptr_t source_addr = reinterpret_cast<intptr_t>(message.get());
+  unsigned long sequence;
   {
     std::lock_guard<std::mutex> queue_lock(m_queue_mutex);
-    m_received.emplace_back(EventType::SOURCE, source_addr);
+    sequence = m_next_sequence++;
+    m_received.emplace_back(EventType::SOURCE, sequence);
   }
 
   // Pre-fetch in separate threads
-  auto lambda = [this, source_addr, message = std::move(message)]() mutable {
-    for (auto& prop : m_prefetch_set) {
-      message->getProperty(prop);
+  auto lambda = [this, sequence, new_output = m_new_output, message = std::move(message)]() mutable {
+    std::exception_ptr error;
+    try {
+      for (auto& prop : m_prefetch_set) {
+        message->getProperty(prop);
+      }
+    }
+    catch (...) {
+      // The output thread still needs to know this source is done
+      error = std::current_exception();
+      message.reset();
+    }
+    // The semaphore keeps the sources in flight under the capacity, so this can not fail
+    if (!m_finished_queue.tryPush(FinishedSource(sequence, std::move(message)))) {
+      throw Elements::Exception() << "Prefetcher output queue full! Please, report this as a bug";
     }
-    {
-      std::lock_guard<std::mutex> lock(m_queue_mutex);
-      m_finished_sources.emplace(source_addr, std::move(message));
+    new_output->release();
+    if (error) {
+      std::rethrow_exception(error);
     }
-    m_new_output.notify_one();
   };
   auto lambda_copyable = [lambda = std::make_shared<decltype(lambda)>(std::move(lambda))](){
     (*lambda)();
@@ -85,11 +101,22 @@ void Prefetcher::requestProperty(const PropertyId& property_id) {
 void Prefetcher::outputLoop() {
   logger.debug() << "Starting prefetcher output loop";
 
-  while (m_thread_pool->activeThreads() > 0) {
-    std::unique_lock<std::mutex> output_lock(m_queue_mutex);
+  while (true) {
+    // Wait for something new, as long as the pool can still deliver it
+    if (!m_new_output->try_acquire_for(THREAD_POOL_CHECK_PERIOD) && isThreadPoolStopped(*m_thread_pool)) {
+      logger.fatal() << "The thread pool stopped, the pending sources will not be sent";
+      std::lock_guard<std::mutex> output_lock(m_queue_mutex);
+      m_failed = true;
+      m_drained.notify_all();
+      break;
+    }
+
+    FinishedSource finished;
+    while (m_finished_queue.tryPop(finished)) {
+      m_finished_sources.emplace(finished.first, std::move(finished.second));
+    }
 
-    // Wait for something new
-    m_new_output.wait_for(output_lock, std::chrono::milliseconds(1000));
+    std::unique_lock<std::mutex> output_lock(m_queue_mutex);
 
     // Process the output queue
     // This is, release sources when the front of the received has been processed
@@ -109,23 +136,31 @@ void Prefetcher::outputLoop() {
         continue;
       }
       // Find if the matching source is done
-      auto processed = m_finished_sources.find(next.m_source_addr);
+      auto processed = m_finished_sources.find(next.m_sequence);
       // If not, we can't keep going, so exit here
       if (processed == m_finished_sources.end()) {
-        logger.debug() << "Next source " << next.m_source_addr << " not done yet";
+        logger.debug() << "Next source " << next.m_sequence << " not done yet";
         break;
       }
+      auto source = std::move(processed->second);
+      m_finished_sources.erase(processed);
       // If it is, send it downstream
-      logger.debug() << "Source " << next.m_source_addr << " sent downstream";
-      {
+      if (source) {
+        logger.debug() << "Source " << next.m_sequence << " sent downstream";
         ReverseLock<decltype(output_lock)> release_lock(output_lock);
-        sendSource(std::move(processed->second));
+        sendSource(std::move(source));
+      }
+      else {
+        logger.fatal() << "Source " << next.m_sequence << " failed to prefetch";
+        m_failed = true;
       }
-      m_finished_sources.erase(processed);
       m_received.pop_front();
       m_semaphore.release();
     }
 
+    if (m_received.empty() || m_failed) {
+      m_drained.notify_all();
+    }
     if (m_stop && m_received.empty()) {
       break;
     }
@@ -139,32 +174,26 @@ void Prefetcher::receiveProcessSignal(const ProcessSourcesEvent& message) {
     m_received.emplace_back(EventType::PROCESS_SOURCE);
     m_event_queue.emplace_back(message);
   }
-  m_new_output.notify_one();
+  m_new_output->release();
   logger.debug() << "ProcessSourceEvent received";
 }
 
 void Prefetcher::wait() {
   m_stop = true;
+  m_new_output->release();
   m_output_thread->join();
 }
 
 void Prefetcher::synchronize() {
   // Wait until the output queue is empty
-  while (true) {
-    {
-      std::unique_lock<std::mutex> output_lock(m_queue_mutex);
-      if (m_received.empty()) {
-        break;
-      }
-      else if (m_thread_pool->checkForException(false)) {
-        logger.fatal() << "An exception was thrown from a worker thread";
-        m_thread_pool->checkForException(true);
-      }
-      else if (m_thread_pool->activeThreads() == 0) {
-        throw Elements::Exception() << "No active threads and the queue is not empty! Please, report this as a bug";
-      }
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  {
+    std::unique_lock<std::mutex> output_lock(m_queue_mutex);
+    waitWhileRunning(m_drained, output_lock, *m_thread_pool, [this]() { return m_received.empty() || m_failed; });
+  }
+  if (m_failed) {
+    logger.fatal() << "An exception was thrown from a worker thread";
+    m_thread_pool->checkForException(true);
+    throw Elements::Exception() << "Failed to prefetch some sources";
   }
 }
 
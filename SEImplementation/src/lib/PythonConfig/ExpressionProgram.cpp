@@ -0,0 +1,258 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExpressionProgram.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <array>
+#include <cmath>
+#include <locale>
+#include <sstream>
+
+#include "ElementsKernel/Exception.h"
+#include "Pyston/Util/GraphvizGenerator.h"
+
+#include "SEImplementation/PythonConfig/ExpressionProgram.h"
+
+namespace SourceXtractor {
+
+constexpr std::size_t ExpressionProgram::MAX_STACK_SIZE;
+
+namespace {
+
+/// Names given by Pyston to the math functions, and their usual C names
+const std::map<std::string, double (*)(double)> UNARY_FUNCTIONS {
+  {"abs", [](double x) { return std::abs(x); }},
+  {"fabs", [](double x) { return std::abs(x); }},
+  {"exp", [](double x) { return std::exp(x); }},
+  {"exp2", [](double x) { return std::exp2(x); }},
+  {"log", [](double x) { return std::log(x); }},
+  {"log2", [](double x) { return std::log2(x); }},
+  {"log10", [](double x) { return std::log10(x); }},
+  {"sqrt", [](double x) { return std::sqrt(x); }},
+  {"sin", [](double x) { return std::sin(x); }},
+  {"cos", [](double x) { return std::cos(x); }},
+  {"tan", [](double x) { return std::tan(x); }},
+  {"arcsin", [](double x) { return std::asin(x); }},
+  {"asin", [](double x) { return std::asin(x); }},
+  {"arccos", [](double x) { return std::acos(x); }},
+  {"acos", [](double x) { return std::acos(x); }},
+  {"arctan", [](double x) { return std::atan(x); }},
+  {"atan", [](double x) { return std::atan(x); }},
+  {"sinh", [](double x) { return std::sinh(x); }},
+  {"cosh", [](double x) { return std::cosh(x); }},
+  {"tanh", [](double x) { return std::tanh(x); }},
+  {"arcsinh", [](double x) { return std::asinh(x); }},
+  {"arccosh", [](double x) { return std::acosh(x); }},
+  {"arctanh", [](double x) { return std::atanh(x); }},
+};
+
+const std::map<std::string, double (*)(double, double)> BINARY_FUNCTIONS {
+  {"**", [](double x, double y) { return std::pow(x, y); }},
+  {"^", [](double x, double y) { return std::pow(x, y); }},
+  {"pow", [](double x, double y) { return std::pow(x, y); }},
+  {"arctan2", [](double y, double x) { return std::atan2(y, x); }},
+  {"atan2", [](double y, double x) { return std::atan2(y, x); }},
+};
+
+/// Rebuilds the tree from the order in which the nodes are entered and exited
+class TreeMirror : public Pyston::Visitor {
+public:
+  void enter(const Pyston::NodeBase* node) override {
+    m_stack.push_back({node->repr(), dynamic_cast<const Pyston::Node<double>*>(node) != nullptr, {}});
+  }
+
+  void exit(const Pyston::NodeBase*) override {
+    auto node = std::move(m_stack.back());
+    m_stack.pop_back();
+    if (m_stack.empty()) {
+      m_root = std::move(node);
+    }
+    else {
+      m_stack.back().m_children.emplace_back(std::move(node));
+    }
+  }
+
+  ExpressionProgram::Node m_root;
+
+private:
+  std::vector<ExpressionProgram::Node> m_stack;
+};
+
+bool parseDouble(const std::string& repr, double& value) {
+  std::istringstream stream(repr);
+  stream.imbue(std::locale::classic());
+  stream >> value;
+  return !stream.fail() && stream.eof();
+}
+
+bool parsePlaceholder(const std::string& repr, std::size_t nargs, std::size_t& index) {
+  if (repr.size() < 2 || repr[0] != '_' || repr.find_first_not_of("0123456789", 1) != std::string::npos) {
+    return false;
+  }
+  index = std::stoul(repr.substr(1));
+  return index < nargs;
+}
+
+} // end of anonymous namespace
+
+ExpressionProgram::Node ExpressionProgram::mirror(const Pyston::NodeBase& root) {
+  TreeMirror mirror;
+  root.visit(mirror);
+  return std::move(mirror.m_root);
+}
+
+std::shared_ptr<ExpressionProgram> ExpressionProgram::lower(const Node& tree, std::size_t nargs,
+                                                            const std::map<std::string, ContextFunction>& functions) {
+  std::shared_ptr<ExpressionProgram> program(new ExpressionProgram);
+  program->m_nargs = nargs;
+  if (!program->emit(tree, 0, functions)) {
+    return nullptr;
+  }
+  return program;
+}
+
+bool ExpressionProgram::emit(const Node& node, std::size_t depth,
+                             const std::map<std::string, ContextFunction>& functions) {
+  if (!node.m_is_double || depth >= MAX_STACK_SIZE) {
+    return false;
+  }
+
+  // The operands are pushed in order, above the values already on the stack
+  for (std::size_t i = 0; i < node.m_children.size(); ++i) {
+    if (!emit(node.m_children[i], depth + i, functions)) {
+      return false;
+    }
+  }
+
+  Instruction instruction {};
+  switch (node.m_children.size()) {
+    case 0:
+      if (parsePlaceholder(node.m_repr, m_nargs, instruction.m_index)) {
+        instruction.m_opcode = OpCode::ARGUMENT;
+      }
+      else if (parseDouble(node.m_repr, instruction.m_value)) {
+        instruction.m_opcode = OpCode::CONSTANT;
+      }
+      else {
+        return false;
+      }
+      break;
+    case 1:
+      if (node.m_repr == "+") {
+        return true;
+      }
+      if (node.m_repr == "-") {
+        instruction.m_opcode = OpCode::NEG;
+      }
+      else if (UNARY_FUNCTIONS.count(node.m_repr)) {
+        instruction.m_opcode = OpCode::UNARY;
+        instruction.m_unary = UNARY_FUNCTIONS.at(node.m_repr);
+      }
+      else {
+        return false;
+      }
+      break;
+    case 2:
+      if (node.m_repr == "+") {
+        instruction.m_opcode = OpCode::ADD;
+      }
+      else if (node.m_repr == "-") {
+        instruction.m_opcode = OpCode::SUB;
+      }
+      else if (node.m_repr == "*") {
+        instruction.m_opcode = OpCode::MUL;
+      }
+      else if (node.m_repr == "/") {
+        instruction.m_opcode = OpCode::DIV;
+      }
+      else if (BINARY_FUNCTIONS.count(node.m_repr)) {
+        instruction.m_opcode = OpCode::BINARY;
+        instruction.m_binary = BINARY_FUNCTIONS.at(node.m_repr);
+      }
+      else if (functions.count(node.m_repr)) {
+        instruction.m_opcode = OpCode::CONTEXT_FUNCTION;
+        instruction.m_context_function = functions.at(node.m_repr);
+      }
+      else {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+
+  m_instructions.emplace_back(instruction);
+  return true;
+}
+
+double ExpressionProgram::operator()(const Pyston::Context& context, const std::vector<double>& args) const {
+  if (args.size() < m_nargs) {
+    throw Elements::Exception() << "Expression expects " << m_nargs << " arguments, got " << args.size();
+  }
+
+  std::array<double, MAX_STACK_SIZE> stack;
+  // Number of values on the stack
+  std::size_t top = 0;
+
+  for (auto& instruction : m_instructions) {
+    switch (instruction.m_opcode) {
+      case OpCode::CONSTANT:
+        stack[top++] = instruction.m_value;
+        break;
+      case OpCode::ARGUMENT:
+        stack[top++] = args[instruction.m_index];
+        break;
+      case OpCode::ADD:
+        --top;
+        stack[top - 1] += stack[top];
+        break;
+      case OpCode::SUB:
+        --top;
+        stack[top - 1] -= stack[top];
+        break;
+      case OpCode::MUL:
+        --top;
+        stack[top - 1] *= stack[top];
+        break;
+      case OpCode::DIV:
+        --top;
+        stack[top - 1] /= stack[top];
+        break;
+      case OpCode::NEG:
+        stack[top - 1] = -stack[top - 1];
+        break;
+      case OpCode::UNARY:
+        stack[top - 1] = instruction.m_unary(stack[top - 1]);
+        break;
+      case OpCode::BINARY:
+        --top;
+        stack[top - 1] = instruction.m_binary(stack[top - 1], stack[top]);
+        break;
+      case OpCode::CONTEXT_FUNCTION:
+        --top;
+        stack[top - 1] = instruction.m_context_function(context, stack[top - 1], stack[top]);
+        break;
+    }
+  }
+
+  return stack[0];
+}
+
+} // end of namespace SourceXtractor
@@ -0,0 +1,74 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PythonCallStatistics.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <algorithm>
+
+#include "SEImplementation/PythonConfig/PythonCallStatistics.h"
+
+namespace SourceXtractor {
+
+PythonCallStatistics& PythonCallStatistics::getInstance() {
+  static PythonCallStatistics instance;
+  return instance;
+}
+
+std::shared_ptr<PythonCallStatistics::Counter> PythonCallStatistics::registerFunction(const std::string& name,
+                                                                                      const std::string& reason) {
+  auto counter = std::make_shared<Counter>(name, reason);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_counters.emplace_back(counter);
+  return counter;
+}
+
+std::vector<std::shared_ptr<const PythonCallStatistics::Counter>> PythonCallStatistics::getCounters() const {
+  std::vector<std::shared_ptr<const Counter>> counters;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    counters.assign(m_counters.begin(), m_counters.end());
+  }
+  std::stable_sort(counters.begin(), counters.end(),
+                   [](const std::shared_ptr<const Counter>& a, const std::shared_ptr<const Counter>& b) {
+                     return a->m_nanoseconds > b->m_nanoseconds;
+                   });
+  return counters;
+}
+
+void PythonCallStatistics::report(Elements::Logging& logger) const {
+  auto counters = getCounters();
+  if (counters.empty()) {
+    return;
+  }
+
+  logger.info() << counters.size() << " user function(s) were evaluated by the Python interpreter";
+  for (auto& counter : counters) {
+    double seconds = counter->m_nanoseconds / 1e9;
+    logger.info() << "  " << counter->m_name << ": " << counter->m_calls << " calls, " << seconds << " s ("
+                  << counter->m_reason << ")";
+  }
+}
+
+void PythonCallStatistics::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_counters.clear();
+}
+
+} // end of namespace SourceXtractor
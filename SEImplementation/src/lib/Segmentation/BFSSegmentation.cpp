@@ -18,6 +18,7 @@
 #include <memory>
 #include <vector>
 #include <list>
+#include <iterator>
 #include <iostream>
 
 #include "SEUtils/PixelCoordinate.h"
@@ -43,8 +44,16 @@ void BFSSegmentation::labelImage(Segmentation::LabellingListener& listener,
 
   VisitedMap visited(detection_image->getWidth(), detection_image->getHeight());
 
-  for (auto& tile : tiles) {
+  for (auto tile_i = tiles.begin(); tile_i != tiles.end(); ++tile_i) {
+    auto& tile = *tile_i;
     auto chunk = detection_image->getChunk(tile.offset.m_x, tile.offset.m_y, tile.width, tile.height);
+
+    // Read the next tile along the Hilbert curve while this one is being labelled
+    auto next_i = std::next(tile_i);
+    if (next_i != tiles.end()) {
+      detection_image->prefetch(next_i->offset.m_x, next_i->offset.m_y, next_i->width, next_i->height);
+    }
+
     for (int y=0; y<tile.height; y++) {
       for (int x=0; x<tile.width; x++) {
         PixelCoordinate pixel =  tile.offset + PixelCoordinate(x,y);
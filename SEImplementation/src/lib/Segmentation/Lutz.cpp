@@ -22,11 +22,20 @@
  */
 
 
+#include <algorithm>
+#include <future>
+#include <map>
+#include <unordered_set>
+
+#include "AlexandriaKernel/memory_tools.h"
+
 #include "SEFramework/Image/Image.h"
+#include "SEFramework/Image/SubImage.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/TileManager.h"
 #include "SEFramework/Source/SourceWithOnDemandProperties.h"
 
+#include "SEImplementation/Common/ThreadPoolWait.h"
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
 #include "SEImplementation/Property/PixelCoordinateList.h"
 #include "SEImplementation/Segmentation/Lutz.h"
@@ -78,6 +87,10 @@ void Lutz::labelImage(LutzListener& listener, const DetectionImage& image, Pixel
 
     if (y % chunk_height == 0) {
       chunk = image.getChunk(0, y, image.getWidth(), std::min(chunk_height, lines - y));
+      // Read the next strip while this one is being labelled
+      if (y + chunk_height < lines) {
+        image.prefetch(0, y + chunk_height, image.getWidth(), std::min(chunk_height, lines - y - chunk_height));
+      }
     }
 
     int dy = y % chunk_height;
@@ -134,7 +147,7 @@ void Lutz::labelImage(LutzListener& listener, const DetectionImage& image, Pixel
             group_stack.back().start = -1;
           } else {
             // Add group to current group
-            auto prev_group = inc_group_map.at(x);
+            auto prev_group = std::move(inc_group_map.at(x));
             inc_group_map.erase(x);
 
             group_stack.back().merge_pixel_list(prev_group);
@@ -180,7 +193,7 @@ void Lutz::labelImage(LutzListener& listener, const DetectionImage& image, Pixel
               listener.publishGroup(old_group);
             } else {
               marker[old_group.end] = LutzMarker::F;
-              inc_group_map[old_group.start] = old_group;
+              inc_group_map[old_group.start] = std::move(old_group);
             }
             ps = ps_stack.back();
             ps_stack.pop_back();
@@ -210,10 +223,10 @@ void Lutz::labelImage(LutzListener& listener, const DetectionImage& image, Pixel
 
             marker[x] = LutzMarker::F;
 
-            auto old_group = group_stack.back();
+            auto old_group = std::move(group_stack.back());
             group_stack.pop_back();
 
-            inc_group_map[old_group.start] = old_group;
+            inc_group_map[old_group.start] = std::move(old_group);
           }
         }
       }
@@ -222,9 +235,16 @@ void Lutz::labelImage(LutzListener& listener, const DetectionImage& image, Pixel
   }
 
   //FitsWriter::writeFile<unsigned int>(*check_image, "segCheck.fits");
-  // Process the pixel groups left in the inc_group_map
+  // Process the pixel groups left in the inc_group_map, from left to right so the order does not
+  // depend on the hash map
+  std::vector<int> remaining;
+  remaining.reserve(inc_group_map.size());
   for (auto& group : inc_group_map) {
-    listener.publishGroup(group.second);
+    remaining.push_back(group.first);
+  }
+  std::sort(remaining.begin(), remaining.end());
+  for (auto start : remaining) {
+    listener.publishGroup(inc_group_map.at(start));
   }
 }
 
@@ -233,4 +253,226 @@ void LutzList::publishGroup(PixelGroup& pixel_group) {
 }
 
 
+//
+// class ParallelLutz
+//
+
+namespace {
+
+/**
+ * Result of labelling one band
+ */
+struct LutzBand {
+  LutzBand(int top, int height, int width)
+      : m_top(top), m_height(height), m_first_line(width, -1), m_last_line(width, -1) {}
+
+  int m_top, m_height;
+  std::vector<Lutz::PixelGroup> m_groups;
+  // Index of the group each pixel on the first and last lines belongs to, or -1
+  std::vector<int> m_first_line, m_last_line;
+};
+
+class LutzBandListener : public Lutz::LutzListener {
+public:
+  explicit LutzBandListener(LutzBand& band) : m_band(band) {}
+
+  void publishGroup(Lutz::PixelGroup& pixel_group) override {
+    int index = m_band.m_groups.size();
+    int last_y = m_band.m_top + m_band.m_height - 1;
+    for (auto& run : pixel_group.pixel_list.getRuns()) {
+      if (run.m_y == m_band.m_top) {
+        std::fill(m_band.m_first_line.begin() + run.m_x_start, m_band.m_first_line.begin() + run.m_x_end + 1, index);
+      }
+      if (run.m_y == last_y) {
+        std::fill(m_band.m_last_line.begin() + run.m_x_start, m_band.m_last_line.begin() + run.m_x_end + 1, index);
+      }
+    }
+    m_band.m_groups.emplace_back(std::move(pixel_group));
+  }
+
+private:
+  LutzBand& m_band;
+};
+
+int findRoot(std::vector<int>& parent, int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+void unite(std::vector<int>& parent, int a, int b) {
+  a = findRoot(parent, a);
+  b = findRoot(parent, b);
+  // Keep the lowest index as root, so the merge order does not depend on the seam scan
+  if (a < b) {
+    parent[b] = a;
+  } else {
+    parent[a] = b;
+  }
+}
+
+/**
+ * Position of the scan at which a single Lutz pass would publish the group: on the line below the
+ * last one of the group, when reaching the pixel after its rightmost pixel. The groups still open at the
+ * end of the image are published afterwards, from left to right.
+ */
+std::pair<int, int> getPublicationKey(const Lutz::PixelGroup& group, int lines) {
+  int max_y = -1, min_x = 0, max_x = 0;
+  for (auto& run : group.pixel_list.getRuns()) {
+    if (run.m_y > max_y) {
+      max_y = run.m_y;
+      min_x = run.m_x_start;
+      max_x = run.m_x_end;
+    } else if (run.m_y == max_y) {
+      min_x = std::min(min_x, run.m_x_start);
+      max_x = std::max(max_x, run.m_x_end);
+    }
+  }
+  if (max_y == lines - 1) {
+    return {lines, min_x};
+  }
+  return {max_y + 1, max_x + 1};
+}
+
 }
+
+void ParallelLutz::labelImage(Lutz::LutzListener& listener, std::shared_ptr<const DetectionImage> image) {
+  int width = image->getWidth();
+  int lines = image->getHeight();
+  int band_count = (lines + m_band_height - 1) / m_band_height;
+
+  std::vector<std::future<std::unique_ptr<LutzBand>>> futures(band_count);
+  int submitted = 0;
+  auto submit_next = [&]() {
+    int top = submitted * m_band_height;
+    int height = std::min(m_band_height, lines - top);
+    auto task = std::make_shared<std::packaged_task<std::unique_ptr<LutzBand>()>>([image, top, height, width]() {
+      auto band = Euclid::make_unique<LutzBand>(top, height, width);
+      LutzBandListener band_listener(*band);
+      auto band_image = SubImage<DetectionImage::PixelType>::create(image, 0, top, width, height);
+      Lutz().labelImage(band_listener, *band_image, PixelCoordinate(0, top));
+      return band;
+    });
+    futures[submitted] = task->get_future();
+    m_thread_pool->submit([task]() { (*task)(); });
+    ++submitted;
+  };
+  while (submitted < std::min(band_count, std::max(1, m_max_bands_in_flight))) {
+    submit_next();
+  }
+
+  // Groups are identified by a global index, assigned in band order
+  std::vector<std::unique_ptr<LutzBand>> bands(band_count);
+  std::vector<int> parent;
+  std::vector<std::pair<int, int>> location;
+  std::vector<int> pending;
+  int previous_base = 0, progress = 0;
+
+  for (int band_index = 0; band_index < band_count; ++band_index) {
+    // If another task on the shared pool throws, the workers stop and this band may never be processed
+    while (futures[band_index].wait_for(THREAD_POOL_CHECK_PERIOD) != std::future_status::ready) {
+      checkThreadPool(*m_thread_pool);
+    }
+    bands[band_index] = futures[band_index].get();
+    if (submitted < band_count) {
+      submit_next();
+    }
+    auto& current = bands[band_index];
+
+    int base = parent.size();
+    for (size_t i = 0; i < current->m_groups.size(); ++i) {
+      parent.push_back(base + i);
+      location.emplace_back(band_index, i);
+      pending.push_back(base + i);
+    }
+
+    // Stitch the groups touching the seam, using the same 8-way connectivity
+    if (band_index > 0) {
+      auto& previous = bands[band_index - 1];
+      for (int x = 0; x < width; ++x) {
+        int above = previous->m_last_line[x];
+        if (above < 0) {
+          continue;
+        }
+        for (int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); ++nx) {
+          int below = current->m_first_line[nx];
+          if (below >= 0) {
+            unite(parent, previous_base + above, base + below);
+          }
+        }
+      }
+    }
+    previous_base = base;
+
+    // Groups reaching the last line of the band may continue in the next one
+    bool is_last = band_index == band_count - 1;
+    std::unordered_set<int> open;
+    if (!is_last) {
+      for (int x = 0; x < width; ++x) {
+        if (current->m_last_line[x] >= 0) {
+          open.insert(findRoot(parent, base + current->m_last_line[x]));
+        }
+      }
+    }
+
+    std::map<int, std::vector<int>> closed;
+    std::vector<int> still_pending;
+    for (auto index : pending) {
+      int root = findRoot(parent, index);
+      if (open.count(root)) {
+        still_pending.push_back(index);
+      } else {
+        closed[root].push_back(index);
+      }
+    }
+    pending.swap(still_pending);
+
+    auto band_group = [&](int index) -> Lutz::PixelGroup& {
+      auto& loc = location[index];
+      return bands[loc.first]->m_groups[loc.second];
+    };
+
+    std::vector<std::pair<std::pair<int, int>, Lutz::PixelGroup>> ready;
+    ready.reserve(closed.size());
+    for (auto& members : closed) {
+      Lutz::PixelGroup merged = std::move(band_group(members.second.front()));
+      for (size_t i = 1; i < members.second.size(); ++i) {
+        merged.merge_pixel_list(band_group(members.second[i]));
+        band_group(members.second[i]).pixel_list.clear();
+      }
+      auto key = getPublicationKey(merged, lines);
+      ready.emplace_back(key, std::move(merged));
+    }
+    std::sort(ready.begin(), ready.end(),
+              [](const std::pair<std::pair<int, int>, Lutz::PixelGroup>& a,
+                 const std::pair<std::pair<int, int>, Lutz::PixelGroup>& b) {
+      return a.first < b.first;
+    });
+
+    // Replay the publications and progress notifications as a single pass would do them
+    for (auto& group : ready) {
+      while (progress < std::min(group.first.first, lines)) {
+        listener.notifyProgress(++progress, lines);
+      }
+      listener.publishGroup(group.second);
+    }
+    int done = is_last ? lines : current->m_top + current->m_height;
+    while (progress < done) {
+      listener.notifyProgress(++progress, lines);
+    }
+
+    // Release the bands no longer referenced. The current one is still needed for the next seam.
+    int first_needed = band_index;
+    for (auto index : pending) {
+      first_needed = std::min(first_needed, location[index].first);
+    }
+    for (int i = 0; i < first_needed; ++i) {
+      bands[i].reset();
+    }
+  }
+}
+
+}
+
@@ -23,6 +23,7 @@
 
 #include "SEFramework/Image/Image.h"
 #include "SEFramework/Image/ProcessedImage.h"
+#include "SEFramework/Image/TileManager.h"
 #include "SEFramework/Source/SourceWithOnDemandProperties.h"
 
 #include "SEImplementation/Measurement/MultithreadedMeasurement.h"
@@ -49,7 +50,7 @@ public:
 
   void publishGroup(Lutz::PixelGroup& pixel_group) override {
     auto source = m_source_factory->createSource();
-    source->setProperty<PixelCoordinateList>(pixel_group.pixel_list);
+    source->setProperty<PixelCoordinateList>(std::move(pixel_group.pixel_list));
     source->setProperty<SourceId>();
     m_listener.publishSource(std::move(source));
   }
@@ -77,9 +78,15 @@ private:
 //
 
 void LutzSegmentation::labelImage(Segmentation::LabellingListener& listener, std::shared_ptr<const DetectionImageFrame> frame) {
-  Lutz lutz;
   LutzLabellingListener lutz_listener(listener, m_source_factory, m_window_size);
-  lutz.labelImage(lutz_listener, *frame->getThresholdedImage());
+  if (m_thread_pool) {
+    // Bands aligned with the tiles, so each tile is read by only one band
+    ParallelLutz lutz(m_thread_pool, TileManager::getInstance()->getTileHeight(), m_max_bands_in_flight);
+    lutz.labelImage(lutz_listener, frame->getThresholdedImage());
+  } else {
+    Lutz lutz;
+    lutz.labelImage(lutz_listener, *frame->getThresholdedImage());
+  }
 }
 
 } // Segmentation namespace
@@ -66,7 +66,7 @@ public:
 
   void publishGroup(Lutz::PixelGroup& pixel_group) override {
     auto source = m_source_factory->createSource();
-    source->setProperty<PixelCoordinateList>(pixel_group.pixel_list);
+    source->setProperty<PixelCoordinateList>(std::move(pixel_group.pixel_list));
     source->setProperty<SourceId>();
     m_listener.publishSource(std::move(source));
   }
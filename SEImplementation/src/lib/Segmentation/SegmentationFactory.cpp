@@ -28,6 +28,7 @@
 #include "SEFramework/Source/SourceWithOnDemandPropertiesFactory.h"
 #include "SEFramework/Image/ImageProcessingList.h"
 
+#include "SEImplementation/Configuration/MultiThreadingConfig.h"
 #include "SEImplementation/Segmentation/BackgroundConvolution.h"
 #include "SEImplementation/Segmentation/LutzSegmentation.h"
 #include "SEImplementation/Segmentation/BFSSegmentation.h"
@@ -44,11 +45,13 @@ namespace SourceXtractor {
 
 SegmentationFactory::SegmentationFactory(std::shared_ptr<TaskProvider> task_provider)
     : m_algorithm(SegmentationConfig::Algorithm::UNKNOWN),
-      m_task_provider(task_provider), m_lutz_window_size(0), m_bfs_max_delta(0), m_ml_threshold(0.) {
+      m_task_provider(task_provider), m_lutz_window_size(0), m_lutz_max_bands_in_flight(0),
+      m_bfs_max_delta(0), m_ml_threshold(0.) {
 }
 
 void SegmentationFactory::reportConfigDependencies(Euclid::Configuration::ConfigManager& manager) const {
   manager.registerConfiguration<SegmentationConfig>();
+  manager.registerConfiguration<MultiThreadingConfig>();
 }
 
 void SegmentationFactory::configure(Euclid::Configuration::ConfigManager& manager) {
@@ -56,6 +59,11 @@ void SegmentationFactory::configure(Euclid::Configuration::ConfigManager& manage
   m_algorithm = segmentation_config.getAlgorithmOption();
   m_filter = segmentation_config.getFilter();
   m_lutz_window_size = segmentation_config.getLutzWindowSize();
+  if (segmentation_config.isLutzParallel()) {
+    auto& multithreading_config = manager.getConfiguration<MultiThreadingConfig>();
+    m_lutz_thread_pool = multithreading_config.getThreadPool();
+    m_lutz_max_bands_in_flight = 2 * multithreading_config.getThreadsNb();
+  }
   m_bfs_max_delta = segmentation_config.getBfsMaxDelta();
   m_model_path = segmentation_config.getOnnxModelPath();
   m_ml_threshold = segmentation_config.getMLThreashold();
@@ -68,7 +76,8 @@ std::shared_ptr<Segmentation> SegmentationFactory::createSegmentation() const {
     case SegmentationConfig::Algorithm::LUTZ:
       //FIXME Use a factory from parameter
       segmentation->setLabelling<LutzSegmentation>(
-          std::make_shared<SourceWithOnDemandPropertiesFactory>(m_task_provider), m_lutz_window_size);
+          std::make_shared<SourceWithOnDemandPropertiesFactory>(m_task_provider), m_lutz_window_size,
+          m_lutz_thread_pool, m_lutz_max_bands_in_flight);
       break;
     case SegmentationConfig::Algorithm::BFS:
       segmentation->setLabelling<BFSSegmentation>(
@@ -0,0 +1,167 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "ElementsKernel/Temporary.h"
+
+#include "SEImplementation/Background/SE/BackgroundCache.h"
+#include "SEFramework/Image/VectorImage.h"
+
+using namespace SourceXtractor;
+
+static std::shared_ptr<VectorImage<DetectionImage::PixelType>> createMesh(int width, int height, float offset) {
+  auto mesh = VectorImage<DetectionImage::PixelType>::create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      mesh->setValue(x, y, offset + x * 0.25 - y);
+    }
+  }
+  return mesh;
+}
+
+static void checkSameMesh(const VectorImage<DetectionImage::PixelType>& a,
+                          const VectorImage<DetectionImage::PixelType>& b) {
+  BOOST_REQUIRE_EQUAL(a.getWidth(), b.getWidth());
+  BOOST_REQUIRE_EQUAL(a.getHeight(), b.getHeight());
+  BOOST_CHECK(a.getData() == b.getData());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(BackgroundCache_test)
+
+//-----------------------------------------------------------------------------
+// The key digest must be stable, and change with any pixel
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(keyDigest) {
+  // Taller than a hashing chunk, so several chunks are combined
+  auto image = VectorImage<SeFloat>::create(17, 150);
+  for (int y = 0; y < image->getHeight(); ++y) {
+    for (int x = 0; x < image->getWidth(); ++x) {
+      image->setValue(x, y, x * 0.5 + y);
+    }
+  }
+  auto copy = VectorImage<SeFloat>::create(17, 150, image->getData());
+
+  BackgroundCache::Key key("a"), same_key("a"), other_description("b");
+  key.addImage(*image);
+  same_key.addImage(*copy);
+  other_description.addImage(*image);
+  BOOST_CHECK_EQUAL(key.getDigest().size(), 40u);
+  BOOST_CHECK_EQUAL(key.getDigest(), key.getDigest());
+  BOOST_CHECK_EQUAL(key.getDigest(), same_key.getDigest());
+  BOOST_CHECK_NE(key.getDigest(), other_description.getDigest());
+
+  copy->setValue(16, 149, copy->getValue(16, 149) + 1e-3);
+  BackgroundCache::Key other_pixels("a");
+  other_pixels.addImage(*copy);
+  BOOST_CHECK_NE(key.getDigest(), other_pixels.getDigest());
+}
+
+//-----------------------------------------------------------------------------
+// What is stored must be loaded back as it was, and no temporary file is left behind
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(roundTrip) {
+  Elements::TempDir directory;
+  BackgroundCache cache(directory.path().native());
+
+  BackgroundCache::Entry with_weight{createMesh(7, 5, 100), createMesh(7, 5, 3), createMesh(7, 5, 9), 1.125};
+  BackgroundCache::Entry without_weight{createMesh(4, 6, 50), createMesh(4, 6, 1), nullptr, 1.};
+  BackgroundCache::Key key1("1"), key2("2"), key3("3");
+  cache.store(key1, with_weight);
+  cache.store(key2, without_weight);
+
+  BackgroundCache::Entry loaded;
+  BOOST_REQUIRE(cache.load(key1, loaded));
+  checkSameMesh(*loaded.m_mode, *with_weight.m_mode);
+  checkSameMesh(*loaded.m_sigma, *with_weight.m_sigma);
+  BOOST_REQUIRE(loaded.m_variance_mode);
+  checkSameMesh(*loaded.m_variance_mode, *with_weight.m_variance_mode);
+  BOOST_CHECK_EQUAL(loaded.m_scaling, with_weight.m_scaling);
+
+  BOOST_REQUIRE(cache.load(key2, loaded));
+  checkSameMesh(*loaded.m_mode, *without_weight.m_mode);
+  checkSameMesh(*loaded.m_sigma, *without_weight.m_sigma);
+  BOOST_CHECK(!loaded.m_variance_mode);
+  BOOST_CHECK_EQUAL(loaded.m_scaling, without_weight.m_scaling);
+
+  BOOST_CHECK(!cache.load(key3, loaded));
+
+  for (auto& file : boost::filesystem::directory_iterator(directory.path())) {
+    BOOST_CHECK_EQUAL(file.path().extension(), ".fits");
+  }
+}
+
+//-----------------------------------------------------------------------------
+// A truncated or corrupt entry is a cache miss
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(corruptEntry) {
+  Elements::TempDir directory;
+  BackgroundCache cache(directory.path().native());
+
+  BackgroundCache::Entry entry{createMesh(64, 64, 100), createMesh(64, 64, 3), createMesh(64, 64, 9), 2.};
+  BackgroundCache::Key key1("1"), key2("2");
+  cache.store(key1, entry);
+  cache.store(key2, entry);
+
+  std::vector<boost::filesystem::path> paths;
+  for (auto& file : boost::filesystem::directory_iterator(directory.path())) {
+    paths.push_back(file.path());
+  }
+  BOOST_REQUIRE_EQUAL(paths.size(), 2u);
+
+  // Truncated in the middle of the last mesh
+  boost::filesystem::resize_file(paths[0], boost::filesystem::file_size(paths[0]) - 2880 * 2);
+  // Not even FITS
+  boost::filesystem::ofstream(paths[1]) << "SIMPLE  = garbage";
+
+  BackgroundCache::Entry loaded;
+  BOOST_CHECK(!cache.load(key1, loaded));
+  BOOST_CHECK(!cache.load(key2, loaded));
+}
+
+//-----------------------------------------------------------------------------
+// An entry stored for another key under the same file name is a cache miss
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fileNameCollision) {
+  Elements::TempDir directory;
+  BackgroundCache cache(directory.path().native());
+
+  BackgroundCache::Entry entry{createMesh(7, 5, 100), createMesh(7, 5, 3), nullptr, 1.};
+  BackgroundCache::Key stored("stored"), other("other");
+  cache.store(stored, entry);
+
+  // Move the entry where the other key would be looked up, as if both keys had the same file name
+  auto file_name = [](const BackgroundCache::Key& key) {
+    return "background_" + key.getDigest().substr(0, 16) + ".fits";
+  };
+  boost::filesystem::rename(directory.path() / file_name(stored), directory.path() / file_name(other));
+
+  BackgroundCache::Entry loaded;
+  BOOST_CHECK(!cache.load(other, loaded));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END()
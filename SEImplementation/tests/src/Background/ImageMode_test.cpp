@@ -0,0 +1,102 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ImageMode_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "SEImplementation/Background/SE/ImageMode.h"
+#include "SEFramework/Image/VectorImage.h"
+#include "SEUtils/TestUtils.h"
+
+using namespace SourceXtractor;
+
+struct ImageModeFixture {
+  const SeFloat invalid = -1e30;
+  // The cells do not divide the image evenly, so the last row and column of cells are smaller
+  const int cell_w = 16, cell_h = 12;
+  std::shared_ptr<VectorImage<SeFloat>> image = VectorImage<SeFloat>::create(150, 100);
+  std::shared_ptr<VectorImage<SeFloat>> variance = VectorImage<SeFloat>::create(150, 100);
+
+  ImageModeFixture() {
+    std::mt19937 generator(7);
+    std::normal_distribution<SeFloat> noise(0, 2);
+    std::uniform_real_distribution<SeFloat> uniform(0, 1);
+    for (int y = 0; y < image->getHeight(); ++y) {
+      for (int x = 0; x < image->getWidth(); ++x) {
+        // A background gradient, some bright pixels and some invalid ones
+        SeFloat value = 100 + 0.2 * x - 0.1 * y + noise(generator);
+        SeFloat draw = uniform(generator);
+        if (draw < 0.05) {
+          value += 500;
+        }
+        else if (draw < 0.08) {
+          value = invalid;
+        }
+        image->setValue(x, y, value);
+        variance->setValue(x, y, value == invalid ? invalid : 4 + 0.01 * x + std::abs(noise(generator)));
+      }
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ImageMode_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (threaded_matches_serial, ImageModeFixture) {
+  ImageMode<SeFloat> serial(image, variance, cell_w, cell_h, invalid);
+
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  ImageMode<SeFloat> threaded(image, variance, cell_w, cell_h, invalid, 2, 5, 3, 1e-4, 100, thread_pool);
+
+  // Each cell is computed the same way whichever thread processes it
+  BOOST_CHECK(compareImages(serial.getModeImage(), threaded.getModeImage(), 0, 0));
+  BOOST_CHECK(compareImages(serial.getSigmaImage(), threaded.getSigmaImage(), 0, 0));
+  BOOST_CHECK(compareImages(serial.getVarianceModeImage(), threaded.getVarianceModeImage(), 0, 0));
+  BOOST_CHECK(compareImages(serial.getVarianceSigmaImage(), threaded.getVarianceSigmaImage(), 0, 0));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (background_estimate, ImageModeFixture) {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  ImageMode<SeFloat> threaded(image, nullptr, cell_w, cell_h, invalid, 2, 5, 3, 1e-4, 100, thread_pool);
+
+  auto mode = threaded.getModeImage();
+  BOOST_CHECK(!threaded.getVarianceModeImage());
+  BOOST_CHECK_EQUAL(mode->getWidth(), 10);
+  BOOST_CHECK_EQUAL(mode->getHeight(), 9);
+
+  // The bright pixels are clipped, so the mode follows the gradient
+  for (int y = 0; y < mode->getHeight(); ++y) {
+    for (int x = 0; x < mode->getWidth(); ++x) {
+      double center_x = (x * cell_w + std::min(cell_w, image->getWidth() - x * cell_w) / 2.) - 0.5;
+      double center_y = (y * cell_h + std::min(cell_h, image->getHeight() - y * cell_h) / 2.) - 0.5;
+      BOOST_CHECK_SMALL(mode->getValue(x, y) - (100 + 0.2 * center_x - 0.1 * center_y), 3.);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
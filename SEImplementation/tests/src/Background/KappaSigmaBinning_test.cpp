@@ -15,6 +15,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <list>
 #include <boost/test/unit_test.hpp>
 #include "Histogram/Histogram.h"
 #include "SEImplementation/Background/SE/KappaSigmaBinning.h"
@@ -216,6 +217,28 @@ BOOST_AUTO_TEST_CASE(compat4Test) {
   BOOST_CHECK_CLOSE(0.623711, median, 1e-2);
 }
 
+//-----------------------------------------------------------------------------
+// Random access data is accumulated over several lanes, the rest serially: both must agree
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE(laneSplitTest, KappaSigmaBinningFixture) {
+  // Outliers to be clipped, and a size that is not a multiple of the number of lanes
+  std::vector<float> values(data);
+  values.insert(values.end(), {35.f, -12.f, 60.f});
+  std::list<float> serial_values(values.begin(), values.end());
+
+  KappaSigmaBinning<double> lanes, serial;
+  lanes.computeBins(values.begin(), values.end());
+  serial.computeBins(serial_values.begin(), serial_values.end());
+
+  auto lanes_edges = lanes.getEdges();
+  auto serial_edges = serial.getEdges();
+  BOOST_REQUIRE_EQUAL(lanes_edges.size(), serial_edges.size());
+  for (size_t i = 0; i < lanes_edges.size(); ++i) {
+    BOOST_CHECK_CLOSE(lanes_edges[i], serial_edges[i], 1e-8);
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,10 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
 #include "SEImplementation/Background/SE/MedianFilter.h"
 #include "SEFramework/Image/VectorImage.h"
 #include "SEUtils/TestUtils.h"
@@ -134,6 +138,104 @@ BOOST_FIXTURE_TEST_CASE(median1x3, MedianFilterImageFixture) {
   BOOST_CHECK(compareImages(expected_var, filtered.second));
 }
 
+//-----------------------------------------------------------------------------
+// The sliding window must give the same result as sorting each clipped box
+//-----------------------------------------------------------------------------
+
+static SeFloat referenceMedian(const VectorImage<SeFloat>& img, int x, int y, int box_w, int box_h) {
+  int hw = std::min({box_w / 2, x, img.getWidth() - x - 1});
+  int hh = std::min({box_h / 2, y, img.getHeight() - y - 1});
+  std::vector<SeFloat> data;
+  for (int iy = y - hh; iy <= y + hh; ++iy) {
+    for (int ix = x - hw; ix <= x + hw; ++ix) {
+      if (!std::isnan(img.getValue(ix, iy))) {
+        data.push_back(img.getValue(ix, iy));
+      }
+    }
+  }
+  if (data.empty()) {
+    return std::numeric_limits<SeFloat>::quiet_NaN();
+  }
+  std::sort(data.begin(), data.end());
+  if (data.size() % 2 == 1) {
+    return data[data.size() / 2];
+  }
+  return (data[data.size() / 2] + data[data.size() / 2 - 1]) / 2;
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window) {
+  std::mt19937 generator(7);
+  // Few distinct values, so there are plenty of ties
+  std::uniform_int_distribution<int> distribution(0, 20);
+  auto image = VectorImage<SeFloat>::create(23, 17);
+  auto variance = VectorImage<SeFloat>::create(23, 17);
+  for (int y = 0; y < image->getHeight(); ++y) {
+    for (int x = 0; x < image->getWidth(); ++x) {
+      image->setValue(x, y, distribution(generator));
+      variance->setValue(x, y, distribution(generator) / 10.);
+    }
+  }
+
+  SeFloat threshold = 2;
+  for (auto box : std::vector<std::array<int, 2>>{{3, 3}, {5, 5}, {7, 3}, {4, 6}, {1, 9}, {31, 31}}) {
+    auto filtered = MedianFilter<SeFloat>(box)(*image, *variance, threshold);
+    for (int y = 0; y < image->getHeight(); ++y) {
+      for (int x = 0; x < image->getWidth(); ++x) {
+        auto median = referenceMedian(*image, x, y, box[0], box[1]);
+        if (std::abs(median - image->getValue(x, y)) >= threshold) {
+          BOOST_CHECK_EQUAL(filtered.first->getValue(x, y), median);
+          BOOST_CHECK_EQUAL(filtered.second->getValue(x, y), referenceMedian(*variance, x, y, box[0], box[1]));
+        }
+        else {
+          BOOST_CHECK_EQUAL(filtered.first->getValue(x, y), image->getValue(x, y));
+          BOOST_CHECK_EQUAL(filtered.second->getValue(x, y), variance->getValue(x, y));
+        }
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// NaN pixels are left out of the boxes
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(nan_values) {
+  const SeFloat nan = std::numeric_limits<SeFloat>::quiet_NaN();
+  std::mt19937 generator(11);
+  std::uniform_int_distribution<int> distribution(0, 20);
+  std::uniform_real_distribution<SeFloat> draw(0, 1);
+  auto image = VectorImage<SeFloat>::create(19, 13);
+  auto variance = VectorImage<SeFloat>::create(19, 13);
+  for (int y = 0; y < image->getHeight(); ++y) {
+    for (int x = 0; x < image->getWidth(); ++x) {
+      // A whole block of NaN, so some boxes have nothing else
+      bool masked = draw(generator) < 0.2 || (x < 4 && y < 4);
+      image->setValue(x, y, masked ? nan : distribution(generator));
+      variance->setValue(x, y, masked ? nan : distribution(generator) / 10.);
+    }
+  }
+
+  for (auto box : std::vector<std::array<int, 2>>{{3, 3}, {5, 3}, {1, 1}}) {
+    auto filtered = MedianFilter<SeFloat>(box)(*image, *variance);
+    for (int y = 0; y < image->getHeight(); ++y) {
+      for (int x = 0; x < image->getWidth(); ++x) {
+        auto median = referenceMedian(*image, x, y, box[0], box[1]);
+        if (std::isnan(median)) {
+          BOOST_CHECK(std::isnan(filtered.first->getValue(x, y)));
+        }
+        else if (!std::isnan(image->getValue(x, y))) {
+          BOOST_CHECK_EQUAL(filtered.first->getValue(x, y), median);
+          BOOST_CHECK_EQUAL(filtered.second->getValue(x, y), referenceMedian(*variance, x, y, box[0], box[1]));
+        }
+        else {
+          // The pixel itself is NaN, it is kept
+          BOOST_CHECK(std::isnan(filtered.first->getValue(x, y)));
+        }
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 
 BOOST_AUTO_TEST_SUITE_END()
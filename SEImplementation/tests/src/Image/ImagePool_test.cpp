@@ -0,0 +1,128 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ImagePool_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <future>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEImplementation/Image/ImageInterfaceTraits.h"
+#include "SEImplementation/Image/ImagePool.h"
+
+using namespace SourceXtractor;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ImagePool_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (reuse) {
+  ImagePool pool;
+
+  auto image = pool.acquire(5, 3);
+  auto address = image.get();
+  image->fillValue(4.);
+  image.reset();
+
+  // Released, so the same image comes back cleared
+  auto again = pool.acquire(5, 3);
+  BOOST_CHECK_EQUAL(again.get(), address);
+  for (auto pixel : again->getData()) {
+    BOOST_CHECK_EQUAL(pixel, 0.);
+  }
+
+  // In use, or of a different size, so new ones are created
+  auto other = pool.acquire(5, 3);
+  auto different = pool.acquire(3, 5);
+  BOOST_CHECK_NE(other.get(), address);
+  BOOST_CHECK_NE(different.get(), address);
+  BOOST_CHECK_EQUAL(pool.size(), 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (shared_data) {
+  ImagePool pool;
+
+  auto image = pool.acquire(4, 4);
+  auto address = image.get();
+  auto chunk = image->getChunk(0, 0, 2, 2);
+  image.reset();
+
+  // A chunk still refers to the pixels, so they can not be reused yet
+  BOOST_CHECK_NE(pool.acquire(4, 4).get(), address);
+  chunk.reset();
+  BOOST_CHECK_EQUAL(pool.acquire(4, 4).get(), address);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (scope) {
+  using Traits = ModelFitting::ImageTraits<ImageInterfaceTypePtr>;
+  ImagePool pool;
+
+  BOOST_CHECK(ImagePool::current() == nullptr);
+  {
+    ImagePool::Scope scope(pool);
+    BOOST_CHECK_EQUAL(ImagePool::current(), &pool);
+    Traits::factory(7, 7);
+    Traits::factory(7, 7);
+    // The first one was released before asking for the second
+    BOOST_CHECK_EQUAL(pool.size(), 1);
+
+    ImagePool inner;
+    {
+      ImagePool::Scope inner_scope(inner);
+      Traits::factory(7, 7);
+      BOOST_CHECK_EQUAL(inner.size(), 1);
+    }
+    BOOST_CHECK_EQUAL(ImagePool::current(), &pool);
+  }
+  BOOST_CHECK(ImagePool::current() == nullptr);
+  Traits::factory(7, 7);
+  BOOST_CHECK_EQUAL(pool.size(), 1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (bind) {
+  auto pool = std::make_shared<ImagePool>();
+  BOOST_CHECK(!ImagePool::bind(pool, {}));
+
+  TaskExecutor detached = [](std::function<void()> task) {
+    std::thread(task).detach();
+  };
+
+  // The task runs on another thread, where the pool becomes the active one
+  std::promise<ImagePool*> seen;
+  auto future = seen.get_future();
+  ImagePool::bind(pool, detached)([&seen]() {
+    seen.set_value(ImagePool::current());
+  });
+  BOOST_CHECK_EQUAL(future.get(), pool.get());
+  BOOST_CHECK(ImagePool::current() == nullptr);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
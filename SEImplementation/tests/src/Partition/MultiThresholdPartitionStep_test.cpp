@@ -22,6 +22,10 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <set>
 
 #include "SEFramework/Source/SourceWithOnDemandProperties.h"
 #include "SEFramework/Source/SourceWithOnDemandPropertiesFactory.h"
@@ -67,6 +71,156 @@ public:
   }
 };
 
+class PixelListObserver : public Observer<SourceInterface> {
+public:
+  virtual void handleMessage(const SourceInterface& source) override {
+    auto& pixels = source.getProperty<PixelCoordinateList>().getCoordinateList();
+    m_list.emplace_back(pixels.begin(), pixels.end());
+  }
+
+  std::vector<std::vector<PixelCoordinate>> m_list;
+};
+
+/**
+ * Straightforward version of the partitioning, as the step did it before building all the levels in a
+ * single sweep: the pixels above each threshold are labelled on their own, and every node of the tree
+ * keeps its own set of pixels. Pixels are identified by x + y * width.
+ */
+struct ReferencePartition {
+  struct Node {
+    std::set<int> pixels;
+    double threshold;
+    Node* parent;
+    std::vector<Node*> children;
+    bool is_split;
+  };
+
+  /// Pixels of the nodes selected as sources, before the reassignment
+  std::vector<std::set<int>> sources;
+  /// Pixels left to be reassigned
+  std::set<int> unassigned;
+  /// Number of junctions whose children became sources
+  int split_junctions = 0;
+
+  ReferencePartition(const VectorImage<SeFloat>& image, const std::vector<PixelCoordinate>& coordinates,
+                     unsigned int thresholds_nb, unsigned int min_area, double contrast) {
+    const int width = image.getWidth(), height = image.getHeight();
+
+    std::set<int> all_pixels;
+    SeFloat min_pixel = std::numeric_limits<SeFloat>::max(), max_pixel = std::numeric_limits<SeFloat>::lowest();
+    for (auto& coord : coordinates) {
+      all_pixels.insert(coord.m_x + coord.m_y * width);
+      min_pixel = std::min(min_pixel, image.getValue(coord));
+      max_pixel = std::max(max_pixel, image.getValue(coord));
+    }
+
+    auto intensity = [&image, width](const Node& node) {
+      double total = 0;
+      for (int i : node.pixels) {
+        total += image.getValue(i % width, i / width) - node.threshold;
+      }
+      return total;
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    nodes.emplace_back(new Node{all_pixels, 0, nullptr, {}, false});
+    Node* root = nodes.front().get();
+
+    std::vector<Node*> active_nodes{root}, junction_nodes;
+    auto min_value = min_pixel * .8;
+    for (unsigned int level = 1; level < thresholds_nb; ++level) {
+      DetectionImage::PixelType threshold = min_value * pow(max_pixel / min_value, (double) level / thresholds_nb);
+
+      // 8-connected components above the threshold
+      std::set<int> above;
+      for (int i : all_pixels) {
+        DetectionImage::PixelType subtracted = image.getValue(i % width, i / width) - threshold;
+        if (subtracted > 0) {
+          above.insert(i);
+        }
+      }
+      std::vector<std::set<int>> groups;
+      while (!above.empty()) {
+        std::set<int> group;
+        std::vector<int> stack{*above.begin()};
+        above.erase(above.begin());
+        while (!stack.empty()) {
+          int i = stack.back();
+          stack.pop_back();
+          group.insert(i);
+          for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+              int x = i % width + dx, y = i / width + dy;
+              if (x >= 0 && y >= 0 && x < width && y < height && above.erase(x + y * width)) {
+                stack.push_back(x + y * width);
+              }
+            }
+          }
+        }
+        if (group.size() >= min_area) {
+          groups.push_back(std::move(group));
+        }
+      }
+
+      std::vector<Node*> next_active_nodes;
+      for (auto node : active_nodes) {
+        std::vector<const std::set<int>*> inside;
+        for (auto& group : groups) {
+          if (node->pixels.count(*group.begin())) {
+            inside.push_back(&group);
+          }
+        }
+        if (inside.size() == 1) {
+          next_active_nodes.push_back(node);
+        }
+        else if (inside.size() > 1) {
+          junction_nodes.push_back(node);
+          for (auto group : inside) {
+            nodes.emplace_back(new Node{*group, threshold, node, {}, false});
+            node->children.push_back(nodes.back().get());
+            next_active_nodes.push_back(nodes.back().get());
+          }
+        }
+      }
+      active_nodes = next_active_nodes;
+    }
+
+    double intensity_threshold = intensity(*root) * contrast;
+    std::vector<Node*> source_nodes;
+    while (!junction_nodes.empty()) {
+      auto node = junction_nodes.back();
+      junction_nodes.pop_back();
+
+      int above_threshold = 0;
+      for (auto child : node->children) {
+        above_threshold += intensity(*child) > intensity_threshold;
+      }
+      if (above_threshold >= 2) {
+        ++split_junctions;
+        for (auto parent = node; parent; parent = parent->parent) {
+          parent->is_split = true;
+        }
+        for (auto child : node->children) {
+          if (intensity(*child) > intensity_threshold && !child->is_split) {
+            source_nodes.push_back(child);
+          }
+        }
+      }
+    }
+
+    std::set<int> assigned;
+    for (auto node : source_nodes) {
+      sources.push_back(node->pixels);
+      assigned.insert(node->pixels.begin(), node->pixels.end());
+    }
+    for (int i : all_pixels) {
+      if (!assigned.count(i) && image.getValue(i % width, i / width) > 0) {
+        unassigned.insert(i);
+      }
+    }
+  }
+};
+
 struct MultiThresholdPartitionFixture {
   std::shared_ptr<TaskFactoryRegistry> task_factory_registry {new TaskFactoryRegistry};
   std::shared_ptr<TaskProvider> task_provider {new TaskProvider(task_factory_registry)};
@@ -84,8 +238,119 @@ struct MultiThresholdPartitionFixture {
     task_factory_registry->registerTaskFactory<DetectionFrameImagesTaskFactory, DetectionFrameImages>();
     task_factory_registry->registerTaskFactory<DetectionFrameSourceStampTaskFactory, DetectionFrameSourceStamp>();
   }
+
+  std::shared_ptr<MultiThresholdPartitionStep> createStep(unsigned int min_area) {
+    return std::make_shared<MultiThresholdPartitionStep>(
+      std::make_shared<SourceWithOnDemandPropertiesFactory>(task_provider), 0.005, 32, min_area);
+  }
+
+  /// Runs the step over all the pixels of the image above 1, the others are set to 0
+  std::vector<std::vector<PixelCoordinate>> partition(std::shared_ptr<MultiThresholdPartitionStep> step,
+                                                      std::shared_ptr<VectorImage<SeFloat>> image,
+                                                      std::vector<PixelCoordinate>& pixels) {
+    pixels.clear();
+    SeFloat min_value = std::numeric_limits<SeFloat>::max(), max_value = std::numeric_limits<SeFloat>::lowest();
+    PixelCoordinate peak, min_coord(image->getWidth(), image->getHeight()), max_coord(0, 0);
+    for (int y = 0; y < image->getHeight(); ++y) {
+      for (int x = 0; x < image->getWidth(); ++x) {
+        auto value = image->getValue(x, y);
+        if (value <= 1) {
+          image->setValue(x, y, 0);
+          continue;
+        }
+        pixels.emplace_back(x, y);
+        min_value = std::min(min_value, value);
+        if (value > max_value) {
+          max_value = value;
+          peak = PixelCoordinate(x, y);
+        }
+        min_coord = PixelCoordinate(std::min(min_coord.m_x, x), std::min(min_coord.m_y, y));
+        max_coord = PixelCoordinate(std::max(max_coord.m_x, x), std::max(max_coord.m_y, y));
+      }
+    }
+
+    std::unique_ptr<SourceWithOnDemandProperties> blob {new SourceWithOnDemandProperties(task_provider)};
+    blob->setProperty<SourceId>();
+    blob->setProperty<DetectionFrame>(std::make_shared<DetectionImageFrame>(
+        image, std::make_shared<DummyCoordinateSystem>()));
+    blob->setProperty<PeakValue>(min_value, max_value, peak.m_x, peak.m_y);
+    blob->setProperty<PixelCoordinateList>(pixels);
+    blob->setProperty<PixelBoundaries>(min_coord.m_x, min_coord.m_y, max_coord.m_x, max_coord.m_y);
+
+    Partition partition({step});
+    auto observer = std::make_shared<PixelListObserver>();
+    partition.addObserver(observer);
+    partition.receiveSource(std::move(blob));
+    return observer->m_list;
+  }
 };
 
+struct Peak {
+  double x, y, amplitude, sigma;
+};
+
+static std::shared_ptr<VectorImage<SeFloat>> createImage(int width, int height, const std::vector<Peak>& peaks) {
+  auto image = VectorImage<SeFloat>::create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      double value = 0;
+      for (auto& peak : peaks) {
+        double dx = x - peak.x, dy = y - peak.y;
+        value += peak.amplitude * std::exp(-(dx * dx + dy * dy) / (2 * peak.sigma * peak.sigma));
+      }
+      image->setValue(x, y, value);
+    }
+  }
+  return image;
+}
+
+/**
+ * Each source must contain the pixels of exactly one of the reference sources, and only pixels left to be
+ * reassigned on top of them. Each pixel ends up in a single source.
+ */
+static void checkSameAsReference(const std::vector<std::vector<PixelCoordinate>>& sources,
+                                 const ReferencePartition& reference, const std::vector<PixelCoordinate>& pixels,
+                                 int width) {
+  if (reference.sources.empty()) {
+    BOOST_REQUIRE_EQUAL(sources.size(), 1u);
+    BOOST_CHECK_EQUAL(sources.front().size(), pixels.size());
+    return;
+  }
+
+  BOOST_REQUIRE_EQUAL(sources.size(), reference.sources.size());
+
+  std::vector<bool> matched(reference.sources.size(), false);
+  std::set<int> seen;
+  for (auto& source : sources) {
+    std::set<int> source_pixels;
+    for (auto& coord : source) {
+      int i = coord.m_x + coord.m_y * width;
+      BOOST_CHECK(seen.insert(i).second);
+      source_pixels.insert(i);
+    }
+
+    int nb_matches = 0;
+    for (std::size_t r = 0; r < reference.sources.size(); ++r) {
+      auto& expected = reference.sources[r];
+      if (std::includes(source_pixels.begin(), source_pixels.end(), expected.begin(), expected.end())) {
+        BOOST_CHECK(!matched[r]);
+        matched[r] = true;
+        ++nb_matches;
+        for (int i : source_pixels) {
+          BOOST_CHECK(expected.count(i) || reference.unassigned.count(i));
+        }
+      }
+    }
+    BOOST_CHECK_EQUAL(nb_matches, 1);
+  }
+
+  std::size_t expected_total = reference.unassigned.size();
+  for (auto& expected : reference.sources) {
+    expected_total += expected.size();
+  }
+  BOOST_CHECK_EQUAL(seen.size(), expected_total);
+}
+
 class SourceObserver : public Observer<SourceInterface> {
 public:
   virtual void handleMessage(const SourceInterface& source) override {
@@ -182,4 +447,88 @@ BOOST_FIXTURE_TEST_CASE( multithreshold_test_3, MultiThresholdPartitionFixture )
 }
 //-----------------------------------------------------------------------------
 
+BOOST_FIXTURE_TEST_CASE( nested_peaks_test, MultiThresholdPartitionFixture ) {
+  // Two peaks far apart, plus a close pair that only separates at a higher threshold
+  std::vector<Peak> peaks{
+    {40, 40, 40, 14}, {26, 40, 400, 2.5}, {54, 40, 400, 2.5}, {36, 58, 300, 2}, {44, 58, 250, 2}
+  };
+  auto image = createImage(80, 80, peaks);
+  std::vector<PixelCoordinate> pixels;
+  auto sources = partition(multithreshold_step, image, pixels);
+
+  ReferencePartition reference(*image, pixels, 32, 1, 0.005);
+  BOOST_CHECK_EQUAL(reference.sources.size(), 4u);
+  BOOST_CHECK_GE(reference.split_junctions, 2);
+  checkSameAsReference(sources, reference, pixels, image->getWidth());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( random_peaks_test, MultiThresholdPartitionFixture ) {
+  std::mt19937 generator(1234);
+  for (int trial = 0; trial < 20; ++trial) {
+    int width = 60 + trial * 3, height = 50 + trial * 2;
+    std::uniform_real_distribution<double> x_dist(10, width - 10), y_dist(10, height - 10);
+    std::uniform_real_distribution<double> amplitude_dist(5, 100), sigma_dist(1.5, 8);
+
+    std::vector<Peak> peaks;
+    for (int i = 0; i < 1 + trial % 6; ++i) {
+      peaks.push_back({x_dist(generator), y_dist(generator), amplitude_dist(generator), sigma_dist(generator)});
+    }
+    auto image = createImage(width, height, peaks);
+    std::vector<PixelCoordinate> pixels;
+    auto sources = partition(multithreshold_step, image, pixels);
+
+    ReferencePartition reference(*image, pixels, 32, 1, 0.005);
+    checkSameAsReference(sources, reference, pixels, width);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( min_area_test, MultiThresholdPartitionFixture ) {
+  // The narrow spikes only have a handful of pixels above the thresholds where they separate
+  std::vector<Peak> peaks{{30, 30, 30, 10}, {22, 30, 200, 3}, {38, 30, 200, 3}, {30, 22, 150, .6}, {30, 38, 150, .6}};
+
+  std::size_t nb_sources[2];
+  unsigned int min_areas[2] = {1, 15};
+  for (int i = 0; i < 2; ++i) {
+    auto image = createImage(60, 60, peaks);
+    std::vector<PixelCoordinate> pixels;
+    auto sources = partition(createStep(min_areas[i]), image, pixels);
+
+    ReferencePartition reference(*image, pixels, 32, min_areas[i], 0.005);
+    checkSameAsReference(sources, reference, pixels, image->getWidth());
+    nb_sources[i] = sources.size();
+  }
+
+  // The spikes are pruned
+  BOOST_CHECK_GT(nb_sources[0], nb_sources[1]);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( exact_threshold_test, MultiThresholdPartitionFixture ) {
+  const unsigned int thresholds_nb = 32, bridge_level = 20;
+  const SeFloat min_pixel = 10, max_pixel = 100;
+
+  // Same computation as the step
+  auto min_value = min_pixel * .8;
+  DetectionImage::PixelType bridge = min_value * pow(max_pixel / min_value, (double) bridge_level / thresholds_nb);
+
+  // Two plateaus joined by a pixel exactly at a threshold: it is not above it, so they separate at that level
+  auto image = VectorImage<SeFloat>::create(9, 1, std::vector<SeFloat>{
+    min_pixel, max_pixel, max_pixel, max_pixel, bridge, max_pixel, max_pixel, max_pixel, min_pixel
+  });
+  std::vector<PixelCoordinate> pixels;
+  auto sources = partition(multithreshold_step, image, pixels);
+
+  ReferencePartition reference(*image, pixels, thresholds_nb, 1, 0.005);
+  BOOST_CHECK_EQUAL(reference.sources.size(), 2u);
+  BOOST_CHECK(reference.unassigned.count(4));
+  checkSameAsReference(sources, reference, pixels, image->getWidth());
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
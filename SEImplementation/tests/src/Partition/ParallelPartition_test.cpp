@@ -0,0 +1,223 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ParallelPartition_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEFramework/Pipeline/SourceGrouping.h"
+
+#include "SEImplementation/Partition/ParallelPartition.h"
+#include "SEImplementation/Property/SourceId.h"
+
+using namespace SourceXtractor;
+
+struct IdProperty : public Property {
+  int m_id;
+  explicit IdProperty(int id) : m_id(id) {}
+};
+
+// Splits a source with id n into n sources with ids n*100+i, taking longer for lower ids
+class SplitPartitionStep : public PartitionStep {
+public:
+  std::vector<std::unique_ptr<SourceInterface>> partition(std::unique_ptr<SourceInterface> source) const override {
+    int id = source->getProperty<IdProperty>().m_id;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10 * (10 - id)));
+    std::vector<std::unique_ptr<SourceInterface>> sources;
+    for (int i = 0; i < id; ++i) {
+      std::unique_ptr<SourceInterface> new_source {new SimpleSource};
+      new_source->setProperty<IdProperty>(id * 100 + i);
+      sources.emplace_back(std::move(new_source));
+    }
+    return sources;
+  }
+};
+
+// Records the sources and the process signals in the order they are received
+class RecordingReceiver : public PipelineReceiver<SourceInterface> {
+public:
+  void receiveSource(std::unique_ptr<SourceInterface> source) override {
+    m_received.push_back(source->getProperty<IdProperty>().m_id);
+  }
+
+  void receiveProcessSignal(const ProcessSourcesEvent&) override {
+    m_received.push_back(-1);
+  }
+
+  std::vector<int> m_received;
+};
+
+// Splits a source in three derived sources, after a random delay, as multi-thresholding does
+class DerivedPartitionStep : public PartitionStep {
+public:
+  std::vector<std::unique_ptr<SourceInterface>> partition(std::unique_ptr<SourceInterface> source) const override {
+    thread_local std::mt19937 generator {std::random_device{}()};
+    std::this_thread::sleep_for(std::chrono::microseconds(std::uniform_int_distribution<int>(0, 500)(generator)));
+    auto parent_id = source->getProperty<SourceId>().getSourceId();
+    std::vector<std::unique_ptr<SourceInterface>> sources;
+    sources.emplace_back(std::move(source));
+    for (int i = 0; i < 3; ++i) {
+      std::unique_ptr<SourceInterface> new_source {new SimpleSource};
+      new_source->setProperty<SourceId>(parent_id);
+      sources.emplace_back(std::move(new_source));
+    }
+    return sources;
+  }
+};
+
+class SourceIdReceiver : public PipelineReceiver<SourceInterface> {
+public:
+  void receiveSource(std::unique_ptr<SourceInterface> source) override {
+    auto& source_id = source->getProperty<SourceId>();
+    m_received.emplace_back(source_id.getSourceId(), source_id.getDetectionId());
+  }
+
+  void receiveProcessSignal(const ProcessSourcesEvent&) override {}
+
+  std::vector<std::pair<unsigned int, unsigned int>> m_received;
+};
+
+// Runs the segmentation and a parallel partition, returning the ids relative to the first detection
+std::vector<std::pair<unsigned int, unsigned int>> runDerivedPartition() {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  auto partition = std::make_shared<ParallelPartition>(
+    std::vector<std::shared_ptr<PartitionStep>>{std::make_shared<DerivedPartitionStep>()}, thread_pool, 8);
+  auto receiver = std::make_shared<SourceIdReceiver>();
+  partition->setNextStage(receiver);
+
+  // The detections get their ids while the workers are creating derived sources
+  unsigned int first_detection = 0;
+  for (int i = 0; i < 200; ++i) {
+    std::unique_ptr<SourceInterface> source {new SimpleSource};
+    source->setProperty<SourceId>();
+    if (i == 0) {
+      first_detection = source->getProperty<SourceId>().getSourceId();
+    }
+    partition->receiveSource(std::move(source));
+  }
+  partition->synchronize();
+  partition->wait();
+
+  auto relative = [first_detection](unsigned int id) {
+    return id < SourceId::DERIVED_ID_BASE ? id - first_detection : id;
+  };
+  for (auto& ids : receiver->m_received) {
+    ids = std::make_pair(relative(ids.first), relative(ids.second));
+  }
+  return receiver->m_received;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ParallelPartition_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( preserves_order_test ) {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  auto partition = std::make_shared<ParallelPartition>(
+    std::vector<std::shared_ptr<PartitionStep>>{std::make_shared<SplitPartitionStep>()}, thread_pool, 3);
+  auto receiver = std::make_shared<RecordingReceiver>();
+  partition->setNextStage(receiver);
+
+  for (int id = 1; id <= 4; ++id) {
+    std::unique_ptr<SourceInterface> source {new SimpleSource};
+    source->setProperty<IdProperty>(id);
+    partition->receiveSource(std::move(source));
+    if (id == 2) {
+      partition->receiveProcessSignal(ProcessSourcesEvent(std::make_shared<SelectAllCriteria>()));
+    }
+  }
+  partition->synchronize();
+
+  std::vector<int> expected {100, 200, 201, -1, 300, 301, 302, 400, 401, 402, 403};
+  BOOST_CHECK_EQUAL_COLLECTIONS(receiver->m_received.begin(), receiver->m_received.end(),
+                                expected.begin(), expected.end());
+
+  partition->wait();
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( deterministic_ids_test ) {
+  auto first = runDerivedPartition();
+  auto second = runDerivedPartition();
+
+  BOOST_REQUIRE_EQUAL(first.size(), 800);
+  for (std::size_t i = 0; i < first.size(); ++i) {
+    BOOST_CHECK_EQUAL(first[i].first, second[i].first);
+    BOOST_CHECK_EQUAL(first[i].second, second[i].second);
+    // Detections are numbered in order, and the derived sources point to them
+    BOOST_CHECK_EQUAL(first[i].second, i / 4);
+    if (i % 4 == 0) {
+      BOOST_CHECK_EQUAL(first[i].first, i / 4);
+    }
+    else {
+      BOOST_CHECK_EQUAL(first[i].first, SourceId::PARTITION_ID_BASE + i - i / 4 - 1);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( failure_test ) {
+  // A failing step stops the pool, so the detections still queued are never partitioned
+  class FailingPartitionStep : public PartitionStep {
+  public:
+    std::vector<std::unique_ptr<SourceInterface>> partition(std::unique_ptr<SourceInterface> source) const override {
+      if (source->getProperty<IdProperty>().m_id == 2) {
+        throw Elements::Exception() << "Partition failure";
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      std::vector<std::unique_ptr<SourceInterface>> sources;
+      sources.emplace_back(std::move(source));
+      return sources;
+    }
+  };
+
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(2);
+  auto partition = std::make_shared<ParallelPartition>(
+    std::vector<std::shared_ptr<PartitionStep>>{std::make_shared<FailingPartitionStep>()}, thread_pool, 4);
+  auto receiver = std::make_shared<RecordingReceiver>();
+  partition->setNextStage(receiver);
+
+  // Either receiving or synchronizing must report the failure instead of waiting forever
+  BOOST_CHECK_THROW({
+    for (int id = 1; id <= 10; ++id) {
+      std::unique_ptr<SourceInterface> source {new SimpleSource};
+      source->setProperty<IdProperty>(id);
+      partition->receiveSource(std::move(source));
+    }
+    partition->synchronize();
+  }, Elements::Exception);
+
+  partition->wait();
+  BOOST_CHECK_LT(receiver->m_received.size(), 10);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
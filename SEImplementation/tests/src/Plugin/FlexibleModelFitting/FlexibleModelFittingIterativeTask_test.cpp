@@ -0,0 +1,393 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingIterativeTask_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <cmath>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include "ModelFitting/Engine/LeastSquareEngine.h"
+#include "ModelFitting/Engine/LeastSquareEngineManager.h"
+
+#include "SEFramework/Image/VectorImage.h"
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEFramework/Source/SimpleSourceGroup.h"
+
+#include "SEImplementation/Plugin/DetectionFrameCoordinates/DetectionFrameCoordinates.h"
+#include "SEImplementation/Plugin/Jacobian/Jacobian.h"
+#include "SEImplementation/Plugin/MeasurementFrameCoordinates/MeasurementFrameCoordinates.h"
+#include "SEImplementation/Plugin/MeasurementFrameGroupRectangle/MeasurementFrameGroupRectangle.h"
+#include "SEImplementation/Plugin/MeasurementFrameImages/MeasurementFrameImages.h"
+#include "SEImplementation/Plugin/MeasurementFrameInfo/MeasurementFrameInfo.h"
+#include "SEImplementation/Plugin/MeasurementFrameRectangle/MeasurementFrameRectangle.h"
+#include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/Psf/PsfProperty.h"
+#include "SEImplementation/Plugin/SourcePsf/SourcePsfProperty.h"
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFitting.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingConverterFactory.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingIterativeTask.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingModel.h"
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingTask.h"
+
+using namespace SourceXtractor;
+
+namespace {
+
+const int WIDTH = 80, HEIGHT = 80;
+const double PSF_SIGMA = 1.2;
+const int PARAM_X = 0, PARAM_Y = 1, PARAM_FLUX = 2;
+
+/*
+ * Levenberg-Marquardt with numerical derivatives, deterministic so the meta-iterations of the
+ * iterative task are reproducible. Started at a minimum, it stays there.
+ */
+class TestEngine : public ModelFitting::LeastSquareEngine {
+public:
+  explicit TestEngine(unsigned max_iterations) : m_max_iterations(max_iterations) {}
+
+  ModelFitting::LeastSquareSummary solveProblem(ModelFitting::EngineParameterManager& parameter_manager,
+                                                ModelFitting::ResidualEstimator& residual_estimator) override {
+    std::size_t n = parameter_manager.numberOfParameters();
+    std::size_t m = residual_estimator.numberOfResiduals();
+
+    std::vector<double> values(n), trial(n), residuals(m), trial_residuals(m), jacobian(m * n);
+    parameter_manager.getEngineValues(values.begin());
+
+    auto cost = [&parameter_manager, &residual_estimator](const std::vector<double>& v, std::vector<double>& r) {
+      parameter_manager.updateEngineValues(v.begin());
+      residual_estimator.populateResiduals(r.begin());
+      double sum = 0;
+      for (auto residual : r) {
+        sum += residual * residual;
+      }
+      return sum;
+    };
+
+    ModelFitting::LeastSquareSummary summary;
+    double current = cost(values, residuals);
+    double lambda = 1e-3;
+    while (summary.iteration_no < m_max_iterations) {
+      ++summary.iteration_no;
+      residual_estimator.populateJacobian(parameter_manager, values.data(), jacobian.data());
+
+      std::vector<double> jtj, jtr;
+      normalEquations(jacobian, residuals, n, jtj, jtr);
+
+      bool improved = false;
+      double previous = current;
+      while (!improved && lambda < 1e10) {
+        auto a = jtj;
+        std::vector<double> delta(n);
+        for (std::size_t i = 0; i < n; ++i) {
+          a[i * n + i] *= 1 + lambda;
+          delta[i] = -jtr[i];
+        }
+        if (solve(a, delta, n)) {
+          for (std::size_t i = 0; i < n; ++i) {
+            trial[i] = values[i] + delta[i];
+          }
+          double trial_cost = cost(trial, trial_residuals);
+          if (trial_cost < current) {
+            values.swap(trial);
+            residuals.swap(trial_residuals);
+            current = trial_cost;
+            lambda /= 10;
+            improved = true;
+            continue;
+          }
+        }
+        lambda *= 10;
+      }
+      if (!improved || previous - current <= 1e-10 * previous) {
+        break;
+      }
+    }
+
+    // Covariance scaled by the residual variance, as the GSL engine does
+    residual_estimator.populateJacobian(parameter_manager, values.data(), jacobian.data());
+    std::vector<double> jtj, jtr;
+    normalEquations(jacobian, residuals, n, jtj, jtr);
+    std::vector<double> covariance(n * n);
+    for (std::size_t j = 0; j < n; ++j) {
+      auto a = jtj;
+      std::vector<double> column(n);
+      column[j] = 1.;
+      solve(a, column, n);
+      for (std::size_t i = 0; i < n; ++i) {
+        covariance[i * n + j] = column[i] * current / std::max<double>(1, m - n);
+      }
+    }
+    auto world_covariance = parameter_manager.convertCovarianceMatrixToWorldSpace(covariance);
+    for (std::size_t i = 0; i < n; ++i) {
+      summary.parameter_sigmas.push_back(std::sqrt(world_covariance[i * n + i]));
+    }
+
+    parameter_manager.updateEngineValues(values.begin());
+    summary.duration = 0;
+    return summary;
+  }
+
+private:
+  unsigned m_max_iterations;
+
+  static void normalEquations(const std::vector<double>& jacobian, const std::vector<double>& residuals,
+                              std::size_t n, std::vector<double>& jtj, std::vector<double>& jtr) {
+    jtj.assign(n * n, 0.);
+    jtr.assign(n, 0.);
+    for (std::size_t k = 0; k < residuals.size(); ++k) {
+      for (std::size_t i = 0; i < n; ++i) {
+        jtr[i] += jacobian[k * n + i] * residuals[k];
+        for (std::size_t j = 0; j < n; ++j) {
+          jtj[i * n + j] += jacobian[k * n + i] * jacobian[k * n + j];
+        }
+      }
+    }
+  }
+
+  // Gaussian elimination with partial pivoting, the solution is left on b
+  static bool solve(std::vector<double>& a, std::vector<double>& b, std::size_t n) {
+    for (std::size_t col = 0; col < n; ++col) {
+      std::size_t pivot = col;
+      for (std::size_t row = col + 1; row < n; ++row) {
+        if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col])) {
+          pivot = row;
+        }
+      }
+      if (a[pivot * n + col] == 0) {
+        return false;
+      }
+      for (std::size_t k = 0; k < n; ++k) {
+        std::swap(a[col * n + k], a[pivot * n + k]);
+      }
+      std::swap(b[col], b[pivot]);
+      for (std::size_t row = col + 1; row < n; ++row) {
+        double factor = a[row * n + col] / a[col * n + col];
+        for (std::size_t k = col; k < n; ++k) {
+          a[row * n + k] -= factor * a[col * n + k];
+        }
+        b[row] -= factor * b[col];
+      }
+    }
+    for (std::size_t col = n; col-- > 0;) {
+      for (std::size_t k = col + 1; k < n; ++k) {
+        b[col] -= a[col * n + k] * b[k];
+      }
+      b[col] /= a[col * n + col];
+    }
+    return true;
+  }
+};
+
+ModelFitting::LeastSquareEngineManager::StaticEngine test_engine{
+  "iterative_test", [](unsigned max_iterations) { return std::make_shared<TestEngine>(max_iterations); }};
+
+class IdentityCoordinateSystem : public CoordinateSystem {
+public:
+  WorldCoordinate imageToWorld(ImageCoordinate image_coordinate) const override {
+    return WorldCoordinate(image_coordinate.m_x, image_coordinate.m_y);
+  }
+
+  ImageCoordinate worldToImage(WorldCoordinate world_coordinate) const override {
+    return ImageCoordinate(world_coordinate.m_alpha, world_coordinate.m_delta);
+  }
+};
+
+struct Star {
+  double x, y, flux, initial_flux;
+};
+
+}
+
+struct IterativeTaskFixture {
+  // The first two overlap, the third is isolated and comes last, so it is skipped once the other two converge
+  std::vector<Star> stars {{20., 20., 1000., 500.}, {26., 21., 800., 700.}, {60., 60., 900., 800.}};
+
+  std::shared_ptr<CoordinateSystem> coordinates = std::make_shared<IdentityCoordinateSystem>();
+  std::shared_ptr<VectorImage<SeFloat>> psf;
+  std::shared_ptr<MeasurementImageFrame> frame;
+  std::vector<std::shared_ptr<FlexibleModelFittingParameter>> parameters;
+  std::vector<std::shared_ptr<FlexibleModelFittingFrame>> frames;
+
+  IterativeTaskFixture() {
+    psf = VectorImage<SeFloat>::create(15, 15);
+    double psf_total = 0;
+    for (int y = 0; y < psf->getHeight(); ++y) {
+      for (int x = 0; x < psf->getWidth(); ++x) {
+        double r2 = (x - 7) * (x - 7) + (y - 7) * (y - 7);
+        psf->at(x, y) = std::exp(-r2 / (2 * PSF_SIGMA * PSF_SIGMA));
+        psf_total += psf->at(x, y);
+      }
+    }
+    for (int y = 0; y < psf->getHeight(); ++y) {
+      for (int x = 0; x < psf->getWidth(); ++x) {
+        psf->at(x, y) /= psf_total;
+      }
+    }
+
+    // Gaussian stars plus a reproducible noise with unit variance
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0., 1.);
+    auto image = VectorImage<SeFloat>::create(WIDTH, HEIGHT);
+    for (int y = 0; y < HEIGHT; ++y) {
+      for (int x = 0; x < WIDTH; ++x) {
+        double value = noise(generator);
+        for (auto& star : stars) {
+          double r2 = (x - star.x) * (x - star.x) + (y - star.y) * (y - star.y);
+          value += star.flux * std::exp(-r2 / (2 * PSF_SIGMA * PSF_SIGMA)) / (2 * M_PI * PSF_SIGMA * PSF_SIGMA);
+        }
+        image->at(x, y) = value;
+      }
+    }
+    auto variance_map = VectorImage<WeightImage::PixelType>::create(WIDTH, HEIGHT);
+    variance_map->fillValue(1.);
+    frame = std::make_shared<MeasurementImageFrame>(image, coordinates, variance_map);
+
+    // The positions are 1-based
+    auto range = [](double initial, const SourceInterface&) { return std::make_pair(initial - 2., initial + 2.); };
+    auto flux_range = [](double initial, const SourceInterface&) {
+      return std::make_pair(initial * 1e-2, initial * 1e2);
+    };
+    auto x = std::make_shared<FlexibleModelFittingFreeParameter>(
+      PARAM_X, [](const SourceInterface& source) { return source.getProperty<PixelCentroid>().getCentroidX() + 1.3; },
+      std::make_shared<FlexibleModelFittingLinearRangeConverterFactory>(range));
+    auto y = std::make_shared<FlexibleModelFittingFreeParameter>(
+      PARAM_Y, [](const SourceInterface& source) { return source.getProperty<PixelCentroid>().getCentroidY() + 0.7; },
+      std::make_shared<FlexibleModelFittingLinearRangeConverterFactory>(range));
+    auto flux = std::make_shared<FlexibleModelFittingFreeParameter>(
+      PARAM_FLUX, [this](const SourceInterface& source) {
+        auto x = source.getProperty<PixelCentroid>().getCentroidX();
+        for (auto& star : stars) {
+          if (star.x == x) {
+            return star.initial_flux;
+          }
+        }
+        return 1.;
+      },
+      std::make_shared<FlexibleModelFittingExponentialRangeConverterFactory>(flux_range));
+    parameters = {x, y, flux};
+
+    std::vector<std::shared_ptr<FlexibleModelFittingModel>> models {
+      std::make_shared<FlexibleModelFittingPointModel>(x, y, flux)};
+    frames = {std::make_shared<FlexibleModelFittingFrame>(0, models)};
+  }
+
+  std::unique_ptr<SourceGroupInterface> createGroup(const std::vector<Star>& group_stars) const {
+    std::unique_ptr<SourceGroupInterface> group(new SimpleSourceGroup);
+    for (auto& star : group_stars) {
+      std::unique_ptr<SourceInterface> source(new SimpleSource);
+      PixelCoordinate center(std::lround(star.x), std::lround(star.y));
+      source->setProperty<PixelCentroid>(star.x, star.y);
+      source->setProperty<MeasurementFrameRectangle>(center - PixelCoordinate(2, 2), center + PixelCoordinate(2, 2));
+      source->setProperty<MeasurementFrameInfo>(WIDTH, HEIGHT, 0., 0., 1e6, 1.);
+      source->setProperty<MeasurementFrameImages>(frame, WIDTH, HEIGHT);
+      source->setProperty<MeasurementFrameCoordinates>(coordinates);
+      source->setProperty<DetectionFrameCoordinates>(coordinates);
+      source->setProperty<SourcePsfProperty>(1., psf);
+      source->setProperty<JacobianSource>();
+      group->addSource(std::move(source));
+    }
+    group->setProperty<MeasurementFrameGroupRectangle>(PixelCoordinate(10, 10), PixelCoordinate(69, 69));
+    group->setProperty<PsfProperty>(1., psf);
+    group->setProperty<JacobianGroup>();
+    return group;
+  }
+
+  std::unique_ptr<SourceGroupInterface> fitIterative(const std::vector<Star>& group_stars) const {
+    auto group = createGroup(group_stars);
+    FlexibleModelFittingIterativeTask task("iterative_test", 100, 10., parameters, frames, {}, 1., 10, 1., 1e-4, 10000);
+    task.computeProperties(*group);
+    return group;
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingIterativeTask_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (converged_source_skipped, IterativeTaskFixture) {
+  auto group = fitIterative(stars);
+
+  std::vector<FlexibleModelFitting> results;
+  for (auto& source : *group) {
+    results.emplace_back(source.getProperty<FlexibleModelFitting>());
+  }
+
+  // The isolated source converges on its second fit, and is skipped once its neighbours stop moving
+  BOOST_CHECK_EQUAL(results[2].getFlags(), Flags::NONE);
+  BOOST_CHECK_GT(results[2].getSkippedMetaIterations(), 0);
+  BOOST_CHECK_LT(results[2].getMetaIterations(), 10);
+  for (auto& result : results) {
+    BOOST_CHECK_EQUAL(result.getFlags(), Flags::NONE);
+    BOOST_CHECK_EQUAL(result.getMetaIterations(), results[0].getMetaIterations());
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (converged_render_reused, IterativeTaskFixture) {
+  // Two isolated sources: both converge on their second fit, after which nothing moved
+  auto group = fitIterative({stars[0], stars[2]});
+
+  std::vector<FlexibleModelFitting> results;
+  for (auto& source : *group) {
+    results.emplace_back(source.getProperty<FlexibleModelFitting>());
+  }
+
+  // Every fit reuses the render of its neighbour to compute the chi squared. Besides, the first source has
+  // converged when the second one is fitted again, so the second source keeps its render of the first pass.
+  BOOST_CHECK_EQUAL(results[0].getMetaIterations(), 2);
+  BOOST_CHECK_EQUAL(results[0].getReusedRenders(), 2);
+  BOOST_CHECK_EQUAL(results[1].getReusedRenders(), 3);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (match_non_iterative, IterativeTaskFixture) {
+  auto iterative = fitIterative(stars);
+
+  auto joint = createGroup(stars);
+  FlexibleModelFittingTask task("iterative_test", 100, 10., parameters, frames, {});
+  task.computeProperties(*joint);
+
+  auto iterative_source = iterative->begin();
+  auto joint_source = joint->begin();
+  for (auto& star : stars) {
+    auto& iterative_result = iterative_source->getProperty<FlexibleModelFitting>();
+    auto& joint_result = joint_source->getProperty<FlexibleModelFitting>();
+
+    BOOST_CHECK_CLOSE(iterative_result.getParameterValue(PARAM_FLUX), star.flux, 5.);
+    for (int id : {PARAM_X, PARAM_Y, PARAM_FLUX}) {
+      BOOST_CHECK_SMALL(iterative_result.getParameterValue(id) - joint_result.getParameterValue(id),
+                        2 * joint_result.getParameterSigma(id));
+    }
+
+    ++iterative_source;
+    ++joint_source;
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,117 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * FlexibleModelFittingWarmStart_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <limits>
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEImplementation/Plugin/PixelCentroid/PixelCentroid.h"
+#include "SEImplementation/Plugin/SourceIDs/SourceID.h"
+
+#include "SEImplementation/Plugin/FlexibleModelFitting/FlexibleModelFittingWarmStart.h"
+
+using namespace SourceXtractor;
+
+using MatchType = FlexibleModelFittingWarmStart::MatchType;
+
+struct WarmStartFixture {
+  // Two catalog rows, parameter 1 is missing on the second one, parameter 3 is not in the catalog
+  std::vector<FlexibleModelFittingWarmStart::Entry> entries {{7, 10., 10., 0}, {3, 50., 20., 1}};
+  std::map<int, std::vector<double>> values {
+    {1, {1.5, std::numeric_limits<double>::quiet_NaN()}},
+    {2, {2.5, 4.5}}
+  };
+
+  std::unique_ptr<SimpleSource> source(int id, double x, double y) {
+    std::unique_ptr<SimpleSource> source(new SimpleSource);
+    source->setProperty<SourceID>(id, id);
+    source->setProperty<PixelCentroid>(x, y);
+    return source;
+  }
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (FlexibleModelFittingWarmStart_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (match_position, WarmStartFixture) {
+  FlexibleModelFittingWarmStart warm_start(MatchType::POSITION, 1., entries, values);
+
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(3, 10.5, 9.5)), 0);
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(7, 50., 20.2)), 1);
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(7, 12., 10.)), -1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (match_id, WarmStartFixture) {
+  FlexibleModelFittingWarmStart warm_start(MatchType::SOURCE_ID, 1., entries, values);
+
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(3, 10., 10.)), 1);
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(7, 0., 0.)), 0);
+  BOOST_CHECK_EQUAL(warm_start.findRow(*source(5, 50., 20.)), -1);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE (fallback, WarmStartFixture) {
+  auto warm_start = std::make_shared<FlexibleModelFittingWarmStart>(MatchType::POSITION, 1., entries, values);
+  auto heuristic = [](const SourceInterface&) { return -1.; };
+
+  auto param1 = warm_start->wrap(1, heuristic);
+  auto param2 = warm_start->wrap(2, heuristic);
+  auto param3 = warm_start->wrap(3, heuristic);
+
+  auto first = source(1, 10., 10.);
+  auto second = source(2, 50., 20.);
+  auto unmatched = source(3, 30., 30.);
+
+  BOOST_CHECK_EQUAL(param1(*first), 1.5);
+  BOOST_CHECK_EQUAL(param2(*first), 2.5);
+  BOOST_CHECK_EQUAL(param3(*first), -1.);
+
+  BOOST_CHECK_EQUAL(param1(*second), -1.);
+  BOOST_CHECK_EQUAL(param2(*second), 4.5);
+
+  BOOST_CHECK_EQUAL(param1(*unmatched), -1.);
+  BOOST_CHECK_EQUAL(param2(*unmatched), -1.);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (empty) {
+  auto warm_start = std::make_shared<FlexibleModelFittingWarmStart>(
+    MatchType::POSITION, 1., std::vector<FlexibleModelFittingWarmStart::Entry>{},
+    std::map<int, std::vector<double>>{{1, {}}});
+
+  SimpleSource source;
+  source.setProperty<PixelCentroid>(1., 1.);
+  BOOST_CHECK_EQUAL(warm_start->findRow(source), -1);
+  BOOST_CHECK_EQUAL(warm_start->wrap(1, [](const SourceInterface&) { return 2.; })(source), 2.);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,83 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * MoffatModelEvaluator_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEImplementation/Plugin/MoffatModelFitting/MoffatModelEvaluator.h"
+
+using namespace SourceXtractor;
+
+struct MoffatModelEvaluatorFixture {
+  // Elongated, rotated, with a flat top and a non-euclidean distance
+  MoffatModelFitting moffat {20.5, 30.5, 100., 1.5, 1.3, 0.8, 41, 2.5, 1.2, 0.7, 10};
+  MoffatModelEvaluator evaluator {moffat};
+};
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (MoffatModelEvaluator_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( add_values_test, MoffatModelEvaluatorFixture ) {
+  std::vector<PixelCoordinate> pixels;
+  for (int y = 0; y < 60; y += 3) {
+    for (int x = 0; x < 40; x += 2) {
+      pixels.emplace_back(x, y);
+    }
+  }
+
+  std::vector<double> values(pixels.size(), 1.);
+  evaluator.addValues(pixels, values);
+
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    BOOST_CHECK_CLOSE(values[i], 1. + evaluator.getValue(pixels[i].m_x, pixels[i].m_y), 1e-8);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_FIXTURE_TEST_CASE( bounds_test, MoffatModelEvaluatorFixture ) {
+  for (double level : {50., 1., 0.01}) {
+    double radius = evaluator.getRadius(level);
+    BOOST_CHECK_LT(evaluator.getUpperBound(radius), level * (1 + 1e-9));
+
+    for (int angle = 0; angle < 360; angle += 5) {
+      for (double distance : {0., radius / 2, radius, radius * 1.5}) {
+        double x = evaluator.getX() + distance * std::cos(angle * M_PI / 180);
+        double y = evaluator.getY() + distance * std::sin(angle * M_PI / 180);
+        double value = evaluator.getValue(x, y);
+        BOOST_CHECK_LE(value, evaluator.getUpperBound(distance) * (1 + 1e-9));
+        if (distance > radius) {
+          BOOST_CHECK_LT(value, level);
+        }
+      }
+    }
+  }
+
+  BOOST_CHECK(std::isinf(evaluator.getRadius(0)));
+  BOOST_CHECK_EQUAL(evaluator.getRadius(200), 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
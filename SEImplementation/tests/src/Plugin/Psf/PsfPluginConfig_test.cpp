@@ -0,0 +1,87 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PsfPluginConfig_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEFramework/Psf/VariablePsf.h"
+#include "SEImplementation/Plugin/Psf/PsfPluginConfig.h"
+
+using namespace SourceXtractor;
+namespace po = boost::program_options;
+
+auto constant = VectorImage<SeFloat>::create(3, 3, std::vector<SeFloat>{
+    0. , 1., 0.,
+    0.5, 1., 0.5,
+    0. , 1., 0.
+});
+auto x = VectorImage<SeFloat>::create(3, 3, std::vector<SeFloat>{
+    0., 0., 0.,
+    0., 2., 0.,
+    0., 0., 0.
+});
+auto y = VectorImage<SeFloat>::create(3, 3, std::vector<SeFloat>{
+    1., 0., 0.,
+    0., 0., 0.,
+    0., 0., 0.2
+});
+
+std::shared_ptr<VariablePsf> createVariablePsf() {
+  return std::make_shared<VariablePsf>(
+    1., std::vector<VariablePsf::Component>{{"X_IMAGE", 0, 5., 2.}, {"Y_IMAGE", 0, 20., 30.}},
+    std::vector<int>{1}, std::vector<std::shared_ptr<VectorImage<SeFloat>>>{constant, x, y});
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (PsfPluginConfig_test)
+
+//-----------------------------------------------------------------------------
+
+/// With the default options, every source gets the PSF evaluated at its own position
+BOOST_AUTO_TEST_CASE( default_cache_is_exact_test ) {
+  PsfPluginConfig config {0};
+  Euclid::Configuration::Configuration::UserValues args;
+  auto options = config.getProgramOptions();
+  for (auto& option : options.at("Variable PSF")) {
+    boost::any value;
+    if (option.semantic()->apply_default(value)) {
+      args[option.long_name()] = po::variable_value(value, true);
+    }
+  }
+  config.preInitialize(args);
+  config.initialize(args);
+
+  auto reference = createVariablePsf();
+  auto psf = createVariablePsf();
+  config.configureCache(psf);
+
+  for (auto& values : std::vector<std::vector<double>>{{10.3, 21.7}, {10.6, 21.2}, {10.3, 21.7}, {-4.1, 80.5}}) {
+    auto expected = reference->getPsf(values);
+    auto result = psf->getPsf(values);
+    BOOST_CHECK_EQUAL_COLLECTIONS(result->getData().begin(), result->getData().end(),
+                                  expected->getData().begin(), expected->getData().end());
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,119 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * Prefetcher_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "SEFramework/Source/SimpleSource.h"
+#include "SEFramework/Pipeline/SourceGrouping.h"
+
+#include "SEImplementation/Prefetcher/Prefetcher.h"
+
+using namespace SourceXtractor;
+
+struct IdProperty : public Property {
+  int m_id;
+  explicit IdProperty(int id) : m_id(id) {}
+};
+
+struct FetchedProperty : public Property {
+};
+
+// Records the sources and the process signals in the order they are received
+class RecordingReceiver : public PipelineReceiver<SourceInterface> {
+public:
+  void receiveSource(std::unique_ptr<SourceInterface> source) override {
+    m_received.push_back(source->getProperty<IdProperty>().m_id);
+  }
+
+  void receiveProcessSignal(const ProcessSourcesEvent&) override {
+    m_received.push_back(-1);
+  }
+
+  std::vector<int> m_received;
+};
+
+// Source with an id, and the prefetched property unless missing is set
+std::unique_ptr<SourceInterface> createSource(int id, bool missing = false) {
+  std::unique_ptr<SourceInterface> source {new SimpleSource};
+  source->setProperty<IdProperty>(id);
+  if (!missing) {
+    source->setProperty<FetchedProperty>();
+  }
+  return source;
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (Prefetcher_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( preserves_order_test ) {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  auto prefetcher = std::make_shared<Prefetcher>(thread_pool, 5);
+  prefetcher->requestProperties(std::vector<PropertyId>{PropertyId::create<FetchedProperty>()});
+  auto receiver = std::make_shared<RecordingReceiver>();
+  prefetcher->setNextStage(receiver);
+
+  std::vector<int> expected;
+  for (int id = 0; id < 500; ++id) {
+    prefetcher->receiveSource(createSource(id));
+    expected.push_back(id);
+    if (id % 50 == 0) {
+      prefetcher->receiveProcessSignal(ProcessSourcesEvent(std::make_shared<SelectAllCriteria>()));
+      expected.push_back(-1);
+    }
+  }
+  prefetcher->synchronize();
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(receiver->m_received.begin(), receiver->m_received.end(),
+                                expected.begin(), expected.end());
+  prefetcher->wait();
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( failure_test ) {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(2);
+  auto prefetcher = std::make_shared<Prefetcher>(thread_pool, 4);
+  prefetcher->requestProperties(std::vector<PropertyId>{PropertyId::create<FetchedProperty>()});
+  auto receiver = std::make_shared<RecordingReceiver>();
+  prefetcher->setNextStage(receiver);
+
+  // The prefetching of the third source throws, which stops the pool. Either receiving or
+  // synchronizing must report it instead of waiting forever for the sources left behind.
+  BOOST_CHECK_THROW({
+    for (int id = 0; id < 100; ++id) {
+      prefetcher->receiveSource(createSource(id, id == 2));
+    }
+    prefetcher->synchronize();
+  }, Elements::Exception);
+
+  prefetcher->wait();
+  BOOST_CHECK_LT(receiver->m_received.size(), 100);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
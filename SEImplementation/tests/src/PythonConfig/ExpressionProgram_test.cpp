@@ -0,0 +1,139 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * ExpressionProgram_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+#include "ElementsKernel/Exception.h"
+
+#include "SEImplementation/PythonConfig/ExpressionProgram.h"
+
+using namespace SourceXtractor;
+
+namespace {
+
+typedef ExpressionProgram::Node Node;
+
+Node leaf(const std::string& repr) {
+  return {repr, true, {}};
+}
+
+Node op(const std::string& repr, std::vector<Node> children) {
+  return {repr, true, std::move(children)};
+}
+
+double scaledSum(const Pyston::Context& context, double x, double y) {
+  return boost::any_cast<double>(context.at("scale")) * (x + y);
+}
+
+const std::map<std::string, ExpressionProgram::ContextFunction> functions {{"scaled_sum", scaledSum}};
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ExpressionProgram_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (arithmetic) {
+  // (_0 * 2.5 - _1) / -_2
+  auto tree = op("/", {op("-", {op("*", {leaf("_0"), leaf("2.5")}), leaf("_1")}), op("-", {leaf("_2")})});
+  auto program = ExpressionProgram::lower(tree, 3, functions);
+  BOOST_REQUIRE(program);
+  BOOST_CHECK_EQUAL(program->size(), 8);
+
+  Pyston::Context context;
+  for (double x : {-3., 0.5, 7.25}) {
+    std::vector<double> args {x, x * x, x + 1};
+    BOOST_CHECK_EQUAL((*program)(context, args), (x * 2.5 - x * x) / -(x + 1));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (functions_test) {
+  // sqrt(_0) ** 3 + arctan2(_1, exp(_0))
+  auto tree = op("+", {
+    op("**", {op("sqrt", {leaf("_0")}), leaf("3")}),
+    op("arctan2", {leaf("_1"), op("exp", {leaf("_0")})})
+  });
+  auto program = ExpressionProgram::lower(tree, 2, functions);
+  BOOST_REQUIRE(program);
+
+  Pyston::Context context;
+  std::vector<double> args {2., -0.5};
+  BOOST_CHECK_EQUAL((*program)(context, args), std::pow(std::sqrt(2.), 3) + std::atan2(-0.5, std::exp(2.)));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (context_function) {
+  auto tree = op("scaled_sum", {leaf("_0"), op("*", {leaf("_1"), leaf("2")})});
+  auto program = ExpressionProgram::lower(tree, 2, functions);
+  BOOST_REQUIRE(program);
+
+  Pyston::Context context;
+  context["scale"] = 3.;
+  BOOST_CHECK_EQUAL((*program)(context, {1., 4.}), 27.);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (unsupported) {
+  // Unknown function
+  BOOST_CHECK(!ExpressionProgram::lower(op("where", {leaf("_0"), leaf("1"), leaf("2")}), 1, functions));
+  BOOST_CHECK(!ExpressionProgram::lower(op("floor", {leaf("_0")}), 1, functions));
+  // Unknown leaf, or argument out of range
+  BOOST_CHECK(!ExpressionProgram::lower(op("+", {leaf("centroid_x"), leaf("1")}), 1, functions));
+  BOOST_CHECK(!ExpressionProgram::lower(op("+", {leaf("_0"), leaf("_1")}), 1, functions));
+  // Not a double, as a comparison
+  BOOST_CHECK(!ExpressionProgram::lower(op("*", {leaf("_0"), {"<", false, {leaf("_0"), leaf("1")}}}), 1, functions));
+
+  // Too deep for the stack: _0 + (_0 + (_0 + ...))
+  Node deep = leaf("_0");
+  for (std::size_t i = 0; i < ExpressionProgram::MAX_STACK_SIZE; ++i) {
+    deep = op("+", {leaf("_0"), deep});
+  }
+  BOOST_CHECK(!ExpressionProgram::lower(deep, 1, functions));
+
+  // The same depth, built the other way, only needs two slots
+  Node shallow = leaf("_0");
+  for (std::size_t i = 0; i < ExpressionProgram::MAX_STACK_SIZE; ++i) {
+    shallow = op("+", {shallow, leaf("_0")});
+  }
+  auto program = ExpressionProgram::lower(shallow, 1, functions);
+  BOOST_REQUIRE(program);
+  BOOST_CHECK_EQUAL((*program)(Pyston::Context{}, {0.5}), 0.5 * (ExpressionProgram::MAX_STACK_SIZE + 1));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (missing_arguments) {
+  auto program = ExpressionProgram::lower(op("+", {leaf("_0"), leaf("_1")}), 2, functions);
+  BOOST_REQUIRE(program);
+  BOOST_CHECK_THROW((*program)(Pyston::Context{}, {1.}), Elements::Exception);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
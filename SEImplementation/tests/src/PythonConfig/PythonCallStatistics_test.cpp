@@ -0,0 +1,70 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PythonCallStatistics_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEImplementation/PythonConfig/PythonCallStatistics.h"
+
+using namespace SourceXtractor;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (PythonCallStatistics_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (wrap) {
+  auto& stats = PythonCallStatistics::getInstance();
+  stats.clear();
+
+  auto counter = stats.registerFunction("Dependent parameter 1", "Unsupported operation");
+  std::function<double(double, double)> add = [](double a, double b) { return a + b; };
+  auto wrapped = PythonCallStatistics::wrap(counter, add);
+
+  BOOST_CHECK_EQUAL(wrapped(1., 2.), 3.);
+  BOOST_CHECK_EQUAL(wrapped(3., 4.), 7.);
+  BOOST_CHECK_EQUAL(counter->m_calls, 2);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (sorted) {
+  auto& stats = PythonCallStatistics::getInstance();
+  stats.clear();
+
+  auto fast = stats.registerFunction("fast", "");
+  auto slow = stats.registerFunction("slow", "");
+  fast->m_nanoseconds = 10;
+  slow->m_nanoseconds = 1000;
+
+  auto counters = stats.getCounters();
+  BOOST_REQUIRE_EQUAL(counters.size(), 2);
+  BOOST_CHECK_EQUAL(counters[0]->m_name, "slow");
+  BOOST_CHECK_EQUAL(counters[1]->m_name, "fast");
+
+  stats.clear();
+  BOOST_CHECK(stats.getCounters().empty());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
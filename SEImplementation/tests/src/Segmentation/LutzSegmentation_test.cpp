@@ -22,8 +22,12 @@
 
 
 #include "SEImplementation/Segmentation/LutzSegmentation.h"
+#include "SEImplementation/Segmentation/Lutz.h"
 
+#include <algorithm>
+#include <random>
 #include <boost/test/unit_test.hpp>
+#include "ElementsKernel/Exception.h"
 
 #include "SEFramework/Image/VectorImage.h"
 #include "SEFramework/Image/ConstantImage.h"
@@ -42,6 +46,25 @@ public:
 };
 
 
+/// Records the groups, sorted, and the line reached by the progress when they are published
+class RecordingLutzListener : public Lutz::LutzListener {
+public:
+  void publishGroup(Lutz::PixelGroup& pixel_group) override {
+    std::vector<PixelCoordinate> pixels(pixel_group.pixel_list.begin(), pixel_group.pixel_list.end());
+    std::sort(pixels.begin(), pixels.end(), [](const PixelCoordinate& a, const PixelCoordinate& b) {
+      return a.m_y < b.m_y || (a.m_y == b.m_y && a.m_x < b.m_x);
+    });
+    m_groups.emplace_back(m_progress.empty() ? 0 : m_progress.back(), pixels);
+  }
+
+  void notifyProgress(int line, int) override {
+    m_progress.push_back(line);
+  }
+
+  std::vector<std::pair<int, std::vector<PixelCoordinate>>> m_groups;
+  std::vector<int> m_progress;
+};
+
 struct LutzFixture {
   std::shared_ptr<SourceObserver> source_observer {new SourceObserver};
 };
@@ -183,5 +206,52 @@ BOOST_FIXTURE_TEST_CASE( lutz_test, LutzFixture ) {
 
 //-----------------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE( parallel_lutz_test ) {
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(4);
+  std::mt19937 generator(42);
+
+  for (double density : {0.1, 0.4, 0.6}) {
+    std::bernoulli_distribution is_object(density);
+    std::vector<DetectionImage::PixelType> data(53 * 61);
+    for (auto& pixel : data) {
+      pixel = is_object(generator) ? 1. : 0.;
+    }
+    auto image = VectorImage<DetectionImage::PixelType>::create(53, 61, data);
+
+    RecordingLutzListener expected;
+    Lutz().labelImage(expected, *image);
+
+    for (int band_height : {1, 3, 8, 61}) {
+      RecordingLutzListener result;
+      ParallelLutz(thread_pool, band_height, 4).labelImage(result, image);
+
+      // Same groups, published in the same order and at the same point of the progress
+      BOOST_CHECK(result.m_progress == expected.m_progress);
+      BOOST_REQUIRE_EQUAL(result.m_groups.size(), expected.m_groups.size());
+      for (size_t i = 0; i < expected.m_groups.size(); ++i) {
+        BOOST_CHECK_EQUAL(result.m_groups[i].first, expected.m_groups[i].first);
+        BOOST_CHECK(result.m_groups[i].second == expected.m_groups[i].second);
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( parallel_lutz_failure_test ) {
+  // A task from another stage throws before the bands are labeled, and stops the only worker
+  auto thread_pool = std::make_shared<Euclid::ThreadPool>(1);
+  thread_pool->submit([]() {
+    throw Elements::Exception() << "Measurement failure";
+  });
+
+  auto image = VectorImage<DetectionImage::PixelType>::create(20, 20, std::vector<DetectionImage::PixelType>(400, 1.));
+  RecordingLutzListener result;
+  BOOST_CHECK_THROW(ParallelLutz(thread_pool, 5, 2).labelImage(result, image), Elements::Exception);
+  BOOST_CHECK(result.m_groups.empty());
+}
+
+//-----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_SUITE_END ()
 
@@ -43,6 +43,7 @@
 #include "SEFramework/Task/TaskProvider.h"
 #include "SEFramework/Image/ProcessedImage.h"
 #include "SEFramework/Image/BufferedImage.h"
+#include "SEFramework/FFT/FFTKernelCache.h"
 #include "SEFramework/Pipeline/SourceGrouping.h"
 #include "SEFramework/Pipeline/Deblending.h"
 #include "SEFramework/Pipeline/Partition.h"
@@ -72,10 +73,12 @@
 #include "SEImplementation/Configuration/SE2BackgroundConfig.h"
 #include "SEImplementation/Configuration/WeightImageConfig.h"
 #include "SEImplementation/Configuration/MemoryConfig.h"
+#include "SEImplementation/Configuration/FFTConfig.h"
 #include "SEImplementation/Configuration/OutputConfig.h"
 #include "SEImplementation/Configuration/SamplingConfig.h"
 #include "SEImplementation/CheckImages/CheckImages.h"
 #include "SEImplementation/Prefetcher/Prefetcher.h"
+#include "SEImplementation/PythonConfig/PythonCallStatistics.h"
 
 #include "SEMain/ProgressReporterFactory.h"
 #include "SEMain/PluginConfig.h"
@@ -188,6 +191,7 @@ public:
       config_manager.registerConfiguration<BackgroundConfig>();
       config_manager.registerConfiguration<SE2BackgroundConfig>();
       config_manager.registerConfiguration<MemoryConfig>();
+      config_manager.registerConfiguration<FFTConfig>();
       config_manager.registerConfiguration<BackgroundAnalyzerFactory>();
       config_manager.registerConfiguration<SamplingConfig>();
       config_manager.registerConfiguration<DetectionFrameConfig>();
@@ -331,7 +335,15 @@ public:
     // Configure TileManager
     auto memory_config = config_manager.getConfiguration<MemoryConfig>();
     TileManager::getInstance()->setOptions(memory_config.getTileSize(),
-        memory_config.getTileSize(), memory_config.getTileMaxMemory());
+        memory_config.getTileSize(), memory_config.getTileMaxMemory(), memory_config.getTileEvictionPolicy());
+
+    // Configure FFTW planning
+    const auto& fft_config = config_manager.getConfiguration<FFTConfig>();
+    fftSetPlanningRigor(fft_config.getPlanningRigor());
+    fftSetKernelCacheSize(fft_config.getKernelCacheSize());
+    if (!fft_config.getWisdomFile().empty() && !fftImportWisdom(fft_config.getWisdomFile())) {
+      logger.info() << "No FFTW wisdom loaded from " << fft_config.getWisdomFile();
+    }
 
     CheckImages::getInstance().configure(config_manager);
 
@@ -357,7 +369,15 @@ public:
     auto thread_pool = multithreading_config.getThreadPool();
 
     // Rest of the stages
-    auto partition = partition_factory.getPartition();
+    std::shared_ptr<Partition> partition;
+    std::shared_ptr<ParallelPartition> parallel_partition;
+    if (thread_pool) {
+      parallel_partition = partition_factory.getParallelPartition(thread_pool, multithreading_config.getMaxQueueSize());
+      partition = parallel_partition;
+    }
+    else {
+      partition = partition_factory.getPartition();
+    }
     auto source_grouping = grouping_factory.createGrouping();
 
     std::shared_ptr<Deblending> deblending = deblending_factory.createDeblending();
@@ -439,6 +459,9 @@ public:
         return Elements::ExitCode::NOT_OK;
       }
 
+      if (parallel_partition) {
+        parallel_partition->synchronize();
+      }
       if (prefetcher) {
         prefetcher->synchronize();
       }
@@ -452,13 +475,38 @@ public:
       prev_writen_rows = nb_writen_rows;
     }
 
+    if (parallel_partition) {
+      parallel_partition->wait();
+    }
     if (prefetcher) {
       prefetcher->wait();
     }
     measurement->stopThreads();
 
     CheckImages::getInstance().saveImages();
+
+    auto tile_stats = TileManager::getInstance()->getStatistics();
+    logger.info() << "Tile cache: " << tile_stats.m_hits << " hits, " << tile_stats.m_misses << " misses, "
+                  << tile_stats.m_evictions << " evictions, " << tile_stats.m_prefetched << " read ahead";
+
+    auto kernel_stats = FFTKernelCache<SeFloat>::getInstance().getStatistics();
+    logger.info() << "Kernel transform cache: " << kernel_stats.m_hits << " hits, " << kernel_stats.m_misses
+                  << " misses, " << kernel_stats.m_evictions << " evictions";
+
+    PythonCallStatistics::getInstance().report(logger);
+
     TileManager::getInstance()->flush();
+
+    // The wisdom only speeds up later runs, so failing to save it does not fail this one
+    if (!fft_config.getWisdomFile().empty()) {
+      try {
+        fftExportWisdom(fft_config.getWisdomFile());
+      }
+      catch (const Elements::Exception& e) {
+        logger.warn() << e.what();
+      }
+    }
+
     progress_mediator->done();
 
     if (prev_writen_rows > 0) {
@@ -0,0 +1,149 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _SEUTILS_BOUNDEDQUEUE_H_
+#define _SEUTILS_BOUNDEDQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace SourceXtractor {
+
+/**
+ * @class BoundedQueue
+ * @brief Fixed capacity, lock-free, multiple producer multiple consumer queue
+ *
+ * @details
+ * Ring buffer where each cell carries a sequence number telling whether it is free for the
+ * producer, or filled for the consumer, of a given lap (D. Vyukov's bounded MPMC queue).
+ * Producers and consumers only contend on an atomic counter each, and never block: tryPush and
+ * tryPop fail when the queue is full or empty. Waiting, if needed, is up to the caller.
+ *
+ * @tparam T
+ *    Element type. Must be default constructible and move assignable.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+
+  /**
+   * Constructor
+   * @param capacity
+   *    Minimum number of elements the queue can hold. Rounded up to a power of two.
+   */
+  explicit BoundedQueue(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_mask = size - 1;
+    m_cells.reset(new Cell[size]);
+    for (std::size_t i = 0; i < size; ++i) {
+      m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+    m_enqueue_pos.store(0, std::memory_order_relaxed);
+    m_dequeue_pos.store(0, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * Appends value to the queue
+   * @return
+   *    false if the queue is full, in which case value is left untouched
+   */
+  bool tryPush(T&& value) {
+    Cell* cell;
+    std::size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+      std::size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->m_value = std::move(value);
+    cell->m_sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Takes the oldest element out of the queue
+   * @return
+   *    false if the queue is empty, in which case value is left untouched
+   */
+  bool tryPop(T& value) {
+    Cell* cell;
+    std::size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &m_cells[pos & m_mask];
+      std::size_t sequence = cell->m_sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->m_value);
+    cell->m_value = T();
+    cell->m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::size_t capacity() const {
+    return m_mask + 1;
+  }
+
+private:
+  struct Cell {
+    std::atomic<std::size_t> m_sequence;
+    T m_value;
+  };
+
+  // Keep the producer and consumer counters on separate cache lines
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  std::unique_ptr<Cell[]> m_cells;
+  std::size_t m_mask;
+  char m_pad0[CACHE_LINE];
+  std::atomic<std::size_t> m_enqueue_pos;
+  char m_pad1[CACHE_LINE];
+  std::atomic<std::size_t> m_dequeue_pos;
+  char m_pad2[CACHE_LINE];
+};
+
+}
+
+#endif /* _SEUTILS_BOUNDEDQUEUE_H_ */
@@ -21,6 +21,8 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cassert>
+#include <limits>
 
 namespace SourceXtractor {
 
@@ -50,6 +52,12 @@ public:
   explicit KdTree(const std::vector<T>& data);
   std::vector<T> findPointsWithinRadius(Coord coord, double radius) const;
 
+  /**
+   * @return The element closest to coord. If several are at the same distance, any of them.
+   * @warning The tree must not be empty
+   */
+  T findNearest(Coord coord) const;
+
 private:
   class Node;
   class Leaf;
@@ -0,0 +1,113 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _SEUTILS_PARALLELFOR_H_
+#define _SEUTILS_PARALLELFOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace SourceXtractor {
+
+/**
+ * Something that runs tasks asynchronously, typically by submitting them to a thread pool
+ */
+using TaskExecutor = std::function<void(std::function<void()>)>;
+
+/**
+ * Calls body(i) for every i in [0, n), distributing the calls between the calling thread and
+ * tasks given to the executor. Returns when all the calls are done, rethrowing the first exception
+ * any of them raised.
+ *
+ * The calling thread takes part in the loop, and only ever waits for calls that are already running.
+ * The tasks given to the executor just claim the next pending index, so if they start late they find
+ * nothing left to do. It is therefore safe to call this from a task that runs on the same thread pool,
+ * even when all its threads are busy: in the worst case everything runs on the calling thread.
+ *
+ * @param executor
+ *    Runs the helper tasks. If empty, everything is run serially by the calling thread.
+ * @param n
+ *    Number of iterations
+ * @param body
+ *    Called once for each index. Calls for different indexes must be independent.
+ * @param max_helpers
+ *    Maximum number of tasks given to the executor
+ */
+inline void parallelFor(const TaskExecutor& executor, std::size_t n, const std::function<void(std::size_t)>& body,
+                        std::size_t max_helpers = std::thread::hardware_concurrency()) {
+  if (!executor || n < 2 || max_helpers == 0) {
+    for (std::size_t i = 0; i < n; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  // Shared with the helpers, which may start after this function returns
+  struct State {
+    std::function<void(std::size_t)> body;
+    std::size_t n;
+    std::atomic<std::size_t> next {0};
+    std::size_t done {0};
+    std::exception_ptr exception;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    void run() {
+      for (std::size_t i = next++; i < n; i = next++) {
+        std::exception_ptr error;
+        try {
+          body(i);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error && !exception) {
+          exception = error;
+        }
+        if (++done == n) {
+          condition.notify_all();
+        }
+      }
+    }
+  };
+
+  auto state = std::make_shared<State>();
+  state->body = body;
+  state->n = n;
+
+  std::size_t helpers = std::min(n - 1, max_helpers);
+  for (std::size_t i = 0; i < helpers; ++i) {
+    executor([state]() { state->run(); });
+  }
+  state->run();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->condition.wait(lock, [&state]() { return state->done == state->n; });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+}
+
+#endif /* _SEUTILS_PARALLELFOR_H_ */
@@ -0,0 +1,215 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PixelRunList.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef _SEUTILS_PIXELRUNLIST_H
+#define _SEUTILS_PIXELRUNLIST_H
+
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+#include "SEUtils/PixelCoordinate.h"
+
+namespace SourceXtractor {
+
+/**
+ * @struct PixelRun
+ * @brief Horizontal run of consecutive pixels, from m_x_start to m_x_end (both included)
+ */
+struct PixelRun {
+  int m_y, m_x_start, m_x_end;
+
+  PixelRun(int y, int x_start, int x_end) : m_y(y), m_x_start(x_start), m_x_end(x_end) {}
+
+  int size() const {
+    return m_x_end - m_x_start + 1;
+  }
+
+  bool operator==(const PixelRun& other) const {
+    return m_y == other.m_y && m_x_start == other.m_x_start && m_x_end == other.m_x_end;
+  }
+};
+
+/**
+ * @class PixelRunList
+ * @brief Run-length encoded list of pixel coordinates
+ *
+ * @details
+ *  Pixels are iterated in the order they were added, one PixelCoordinate at a time, so it can be used
+ *  as a list of coordinates. A pixel added right after its left neighbour extends the last run, so
+ *  objects scanned row by row take one run per row segment instead of one entry per pixel.
+ */
+class PixelRunList {
+public:
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PixelCoordinate;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PixelCoordinate*;
+    using reference = const PixelCoordinate&;
+
+    const_iterator() = default;
+
+    const_iterator(std::vector<PixelRun>::const_iterator run, std::vector<PixelRun>::const_iterator end)
+        : m_run(run), m_end(end) {
+      if (m_run != m_end) {
+        m_pixel = PixelCoordinate(m_run->m_x_start, m_run->m_y);
+      }
+    }
+
+    reference operator*() const {
+      return m_pixel;
+    }
+
+    pointer operator->() const {
+      return &m_pixel;
+    }
+
+    const_iterator& operator++() {
+      if (m_pixel.m_x < m_run->m_x_end) {
+        ++m_pixel.m_x;
+      } else if (++m_run != m_end) {
+        m_pixel = PixelCoordinate(m_run->m_x_start, m_run->m_y);
+      }
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return m_run == other.m_run && (m_run == m_end || m_pixel.m_x == other.m_pixel.m_x);
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+  private:
+    std::vector<PixelRun>::const_iterator m_run, m_end;
+    PixelCoordinate m_pixel;
+  };
+
+  using iterator = const_iterator;
+  using value_type = PixelCoordinate;
+
+  PixelRunList() : m_size(0) {}
+
+  PixelRunList(const std::vector<PixelCoordinate>& pixels) : m_size(0) {
+    for (auto& pixel : pixels) {
+      push_back(pixel);
+    }
+  }
+
+  PixelRunList(std::initializer_list<PixelCoordinate> pixels) : m_size(0) {
+    for (auto& pixel : pixels) {
+      push_back(pixel);
+    }
+  }
+
+  void push_back(const PixelCoordinate& pixel) {
+    if (!m_runs.empty() && m_runs.back().m_y == pixel.m_y && m_runs.back().m_x_end + 1 == pixel.m_x) {
+      ++m_runs.back().m_x_end;
+    } else {
+      m_runs.emplace_back(pixel.m_y, pixel.m_x, pixel.m_x);
+    }
+    ++m_size;
+  }
+
+  /// Add the pixels from x_start to x_end (both included) of the row y
+  void addRun(int y, int x_start, int x_end) {
+    if (!m_runs.empty() && m_runs.back().m_y == y && m_runs.back().m_x_end + 1 == x_start) {
+      m_runs.back().m_x_end = x_end;
+    } else {
+      m_runs.emplace_back(y, x_start, x_end);
+    }
+    m_size += x_end - x_start + 1;
+  }
+
+  /// Append the pixels of other, in O(number of runs)
+  void append(const PixelRunList& other) {
+    m_runs.reserve(m_runs.size() + other.m_runs.size());
+    for (auto& run : other.m_runs) {
+      addRun(run.m_y, run.m_x_start, run.m_x_end);
+    }
+  }
+
+  const std::vector<PixelRun>& getRuns() const {
+    return m_runs;
+  }
+
+  const_iterator begin() const {
+    return const_iterator(m_runs.begin(), m_runs.end());
+  }
+
+  const_iterator end() const {
+    return const_iterator(m_runs.end(), m_runs.end());
+  }
+
+  std::size_t size() const {
+    return m_size;
+  }
+
+  bool empty() const {
+    return m_size == 0;
+  }
+
+  PixelCoordinate front() const {
+    return PixelCoordinate(m_runs.front().m_x_start, m_runs.front().m_y);
+  }
+
+  void clear() {
+    m_runs.clear();
+    m_size = 0;
+  }
+
+  bool contains(const PixelCoordinate& pixel) const {
+    for (auto& run : m_runs) {
+      if (run.m_y == pixel.m_y && run.m_x_start <= pixel.m_x && pixel.m_x <= run.m_x_end) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Expand into a list of coordinates, in iteration order
+  std::vector<PixelCoordinate> toVector() const {
+    return std::vector<PixelCoordinate>(begin(), end());
+  }
+
+  bool operator==(const PixelRunList& other) const {
+    return m_size == other.m_size && m_runs == other.m_runs;
+  }
+
+private:
+  std::vector<PixelRun> m_runs;
+  std::size_t m_size;
+};
+
+} /* namespace SourceXtractor */
+
+#endif /* _SEUTILS_PIXELRUNLIST_H */
@@ -0,0 +1,111 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SEUtils/BoundedQueue.h"
+
+using namespace SourceXtractor;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (BoundedQueue_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( fifo_test ) {
+  BoundedQueue<std::unique_ptr<int>> queue(3);
+  BOOST_CHECK_EQUAL(queue.capacity(), 4);
+
+  std::unique_ptr<int> value;
+  BOOST_CHECK(!queue.tryPop(value));
+
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      BOOST_CHECK(queue.tryPush(std::unique_ptr<int>(new int(i))));
+    }
+    std::unique_ptr<int> extra(new int(-1));
+    BOOST_CHECK(!queue.tryPush(std::move(extra)));
+    BOOST_CHECK(extra);
+
+    for (int i = 0; i < 4; ++i) {
+      BOOST_CHECK(queue.tryPop(value));
+      BOOST_CHECK_EQUAL(*value, i);
+    }
+    BOOST_CHECK(!queue.tryPop(value));
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( concurrent_test ) {
+  const int producers = 4, consumers = 3, per_producer = 20000;
+  BoundedQueue<int> queue(16);
+  std::vector<std::vector<int>> received(consumers);
+  std::atomic<int> remaining {producers * per_producer};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < per_producer; ++i) {
+        int value = p * per_producer + i;
+        while (!queue.tryPush(std::move(value))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&queue, &received, &remaining, c]() {
+      int value;
+      while (remaining > 0) {
+        if (queue.tryPop(value)) {
+          received[c].push_back(value);
+          --remaining;
+        }
+        else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Everything is received once, and the values of a given producer in order
+  std::vector<int> seen(producers * per_producer, 0);
+  for (auto& values : received) {
+    std::vector<int> last(producers, -1);
+    for (auto value : values) {
+      ++seen[value];
+      BOOST_CHECK_GT(value, last[value / per_producer]);
+      last[value / per_producer] = value;
+    }
+  }
+  for (auto count : seen) {
+    BOOST_CHECK_EQUAL(count, 1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,97 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <vector>
+
+#include "SEUtils/KdTree.h"
+
+using namespace SourceXtractor;
+
+namespace {
+
+struct Point {
+  double x, y;
+  int index;
+};
+
+}
+
+namespace SourceXtractor {
+
+template <>
+struct KdTreeTraits<Point> {
+  static double getCoord(const Point& p, size_t index) {
+    return index == 0 ? p.x : p.y;
+  }
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (KdTree_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (findNearest_test) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<double> uniform{0., 1000.};
+
+  std::vector<Point> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back({uniform(generator), uniform(generator), i});
+  }
+  KdTree<Point, 2, 8> tree{points};
+
+  for (int i = 0; i < 200; ++i) {
+    double x = uniform(generator) * 1.2 - 100., y = uniform(generator) * 1.2 - 100.;
+
+    auto brute_force = std::min_element(points.begin(), points.end(), [x, y](const Point& a, const Point& b) {
+      return (a.x - x) * (a.x - x) + (a.y - y) * (a.y - y) < (b.x - x) * (b.x - x) + (b.y - y) * (b.y - y);
+    });
+    auto nearest = tree.findNearest({{x, y}});
+    BOOST_CHECK_EQUAL(nearest.index, brute_force->index);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (findNearestSingle_test) {
+  KdTree<Point> tree{{{5., 5., 0}}};
+  BOOST_CHECK_EQUAL(tree.findNearest({{100., -3.}}).index, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE (findPointsWithinRadius_test) {
+  std::vector<Point> points;
+  for (int i = 0; i < 20; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      points.push_back({double(i), double(j), i * 20 + j});
+    }
+  }
+  KdTree<Point, 2, 8> tree{points};
+
+  auto selection = tree.findPointsWithinRadius({{10., 10.}}, 1.5);
+  BOOST_CHECK_EQUAL(selection.size(), 9);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -0,0 +1,145 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "SEUtils/ParallelFor.h"
+
+using namespace SourceXtractor;
+
+namespace {
+
+// Minimal fixed size thread pool
+class TestPool {
+public:
+  explicit TestPool(int n) {
+    for (int i = 0; i < n; ++i) {
+      m_threads.emplace_back([this]() { loop(); });
+    }
+  }
+
+  ~TestPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  TaskExecutor executor() {
+    return [this](std::function<void()> task) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.emplace_back(std::move(task));
+      m_condition.notify_one();
+    };
+  }
+
+private:
+  void loop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) {
+          return;
+        }
+        task = std::move(m_queue.front());
+        m_queue.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void()>> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop = false;
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (ParallelFor_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( serial_test ) {
+  std::vector<int> visited(10, 0);
+  parallelFor(TaskExecutor{}, visited.size(), [&visited](std::size_t i) { visited[i] += i; });
+  for (std::size_t i = 0; i < visited.size(); ++i) {
+    BOOST_CHECK_EQUAL(visited[i], i);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( parallel_test ) {
+  TestPool pool(4);
+  std::vector<int> visited(1000, 0);
+  parallelFor(pool.executor(), visited.size(), [&visited](std::size_t i) { visited[i] += i; });
+  for (std::size_t i = 0; i < visited.size(); ++i) {
+    BOOST_CHECK_EQUAL(visited[i], i);
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( nested_test ) {
+  // Every thread of the pool runs an outer iteration which waits for inner ones: this must not deadlock
+  TestPool pool(2);
+  auto executor = pool.executor();
+  std::vector<std::vector<int>> visited(8, std::vector<int>(50, 0));
+  parallelFor(executor, visited.size(), [&](std::size_t i) {
+    parallelFor(executor, visited[i].size(), [&visited, i](std::size_t j) { visited[i][j] = 1; });
+  });
+  for (auto& inner : visited) {
+    for (auto v : inner) {
+      BOOST_CHECK_EQUAL(v, 1);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( exception_test ) {
+  TestPool pool(3);
+  std::atomic<int> calls {0};
+  BOOST_CHECK_THROW(parallelFor(pool.executor(), 100, [&calls](std::size_t i) {
+    ++calls;
+    if (i == 42) {
+      throw std::runtime_error("failure");
+    }
+  }), std::runtime_error);
+  // The rest of the iterations still run
+  BOOST_CHECK_EQUAL(calls, 100);
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()
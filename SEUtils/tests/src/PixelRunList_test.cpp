@@ -0,0 +1,107 @@
+/** Copyright © 2019 Université de Genève, LMU Munich - Faculty of Physics, IAP-CNRS/Sorbonne Université
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation; either version 3.0 of the License, or (at your option)
+ * any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+/*
+ * PixelRunList_test.cpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "SEUtils/PixelRunList.h"
+
+using namespace SourceXtractor;
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE (PixelRunList_test)
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( consecutive_pixels_test ) {
+  PixelRunList list;
+  for (int x = 3; x < 10; ++x) {
+    list.push_back({x, 5});
+  }
+  list.push_back({4, 6});
+
+  BOOST_CHECK_EQUAL(list.size(), 8);
+  BOOST_CHECK_EQUAL(list.getRuns().size(), 2);
+  BOOST_CHECK(list.getRuns()[0] == PixelRun(5, 3, 9));
+  BOOST_CHECK(list.getRuns()[1] == PixelRun(6, 4, 4));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( iteration_order_test ) {
+  // Out of order and duplicated pixels must be kept as they are
+  std::vector<PixelCoordinate> pixels {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {2, 1}, {0, 2}, {2, 2}, {2, 2}, {1, 0}};
+  PixelRunList list(pixels);
+
+  BOOST_CHECK_EQUAL(list.size(), pixels.size());
+  BOOST_CHECK(list.toVector() == pixels);
+  BOOST_CHECK(list.front() == PixelCoordinate(0, 0));
+
+  size_t i = 0;
+  for (auto& pixel : list) {
+    BOOST_CHECK(pixel == pixels[i++]);
+  }
+  BOOST_CHECK_EQUAL(i, pixels.size());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( append_test ) {
+  PixelRunList a {{0, 0}, {1, 0}};
+  PixelRunList b {{2, 0}, {3, 0}, {0, 1}};
+  a.append(b);
+
+  BOOST_CHECK_EQUAL(a.size(), 5);
+  // The first run of b continues the last run of a
+  BOOST_CHECK_EQUAL(a.getRuns().size(), 2);
+  BOOST_CHECK(a.toVector() == std::vector<PixelCoordinate>({{0, 0}, {1, 0}, {2, 0}, {3, 0}, {0, 1}}));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( contains_test ) {
+  PixelRunList list;
+  list.addRun(2, 10, 20);
+  list.addRun(3, 5, 5);
+
+  BOOST_CHECK_EQUAL(list.size(), 12);
+  BOOST_CHECK(list.contains({10, 2}));
+  BOOST_CHECK(list.contains({15, 2}));
+  BOOST_CHECK(list.contains({20, 2}));
+  BOOST_CHECK(list.contains({5, 3}));
+  BOOST_CHECK(!list.contains({9, 2}));
+  BOOST_CHECK(!list.contains({21, 2}));
+  BOOST_CHECK(!list.contains({6, 3}));
+  BOOST_CHECK(!list.contains({15, 4}));
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( empty_test ) {
+  PixelRunList list;
+  BOOST_CHECK(list.empty());
+  BOOST_CHECK(list.begin() == list.end());
+}
+
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE_END ()